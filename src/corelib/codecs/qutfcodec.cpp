@@ -145,6 +145,156 @@ static inline bool simdDecodeAscii(ushort *, const uchar *, const uchar *, const
 }
 #endif
 
+#if QT_COMPILER_SUPPORTS_HERE(SSE4_1)
+namespace {
+// PSHUFB masks that move the 16-bit lanes selected by an 8-bit mask to the
+// front of the register, in order
+struct Utf8CompressTable
+{
+    uchar masks[256][16];
+
+    Utf8CompressTable()
+    {
+        for (int m = 0; m < 256; ++m) {
+            int out = 0;
+            for (int lane = 0; lane < 8; ++lane) {
+                if (m & (1 << lane)) {
+                    masks[m][out++] = uchar(2 * lane);
+                    masks[m][out++] = uchar(2 * lane + 1);
+                }
+            }
+            while (out < 16)
+                masks[m][out++] = 0x80;
+        }
+    }
+};
+}
+Q_GLOBAL_STATIC(Utf8CompressTable, utf8CompressTable)
+
+QT_FUNCTION_TARGET(SSE4_1)
+static inline __m128i decodeUtf8Lanes(__m128i b0, __m128i b1, __m128i b2)
+{
+    // b0, b1 and b2 hold, for eight positions, the byte at that position and
+    // the two following ones (zero-extended to 16 bits). Decode each lane
+    // as if a character started there.
+    const __m128i mask3f = _mm_set1_epi16(0x3f);
+    const __m128i c1 = _mm_and_si128(b1, mask3f);
+    const __m128i c2 = _mm_and_si128(b2, mask3f);
+
+    // 110xxxxx 10yyyyyy
+    const __m128i two = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b0, _mm_set1_epi16(0x1f)), 6), c1);
+    // 1110xxxx 10yyyyyy 10zzzzzz
+    const __m128i three = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(b0, 12), _mm_slli_epi16(c1, 6)), c2);
+
+    const __m128i isMulti = _mm_cmpgt_epi16(b0, _mm_set1_epi16(0xbf));
+    const __m128i isThree = _mm_cmpgt_epi16(b0, _mm_set1_epi16(0xdf));
+    return _mm_blendv_epi8(_mm_blendv_epi8(b0, two, isMulti), three, isThree);
+}
+
+// Decodes 16-byte blocks made of well-formed one, two and three byte
+// sequences. Stops at pure US-ASCII blocks (simdDecodeAscii does those
+// faster), at four-byte sequences and at anything invalid, all of which
+// are left to the caller. Returns true if anything was decoded.
+QT_FUNCTION_TARGET(SSE4_1)
+static bool simdDecodeUtf8_sse4(ushort *&dst, const uchar *&src, const uchar *end)
+{
+    const Utf8CompressTable *table = utf8CompressTable();
+    const uchar *const start = src;
+
+    // each block reads two bytes past its end
+    while (end - src >= 18) {
+        const __m128i data = _mm_loadu_si128((const __m128i*)src);
+        const uint nonAscii = _mm_movemask_epi8(data);
+        if (!nonAscii)
+            break;
+
+        const __m128i next1 = _mm_loadu_si128((const __m128i*)(src + 1));
+        const __m128i next2 = _mm_loadu_si128((const __m128i*)(src + 2));
+
+        // classify the bytes; x >= y is max(x, y) == x for unsigned bytes
+#define GREATER_EQUAL(v, c)  _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(char(c))), v))
+        const uint cont = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8(char(0xc0))),
+                                                            _mm_set1_epi8(char(0x80))));
+        const uint geC2 = GREATER_EQUAL(data, 0xc2);
+        const uint geE0 = GREATER_EQUAL(data, 0xe0);
+        const uint geF0 = GREATER_EQUAL(data, 0xf0);
+        const uint next1GeA0 = GREATER_EQUAL(next1, 0xa0);
+#undef GREATER_EQUAL
+        const uint isE0 = _mm_movemask_epi8(_mm_cmpeq_epi8(data, _mm_set1_epi8(char(0xe0))));
+        const uint isED = _mm_movemask_epi8(_mm_cmpeq_epi8(data, _mm_set1_epi8(char(0xed))));
+
+        const uint lead2 = geC2 & ~geE0;
+        const uint lead3 = geE0 & ~geF0;
+
+        // 0xC0 and 0xC1 (overlong), four-byte leads and 0xF5-0xFF go to the
+        // scalar decoder, as do overlong three-byte forms and surrogates
+        const uint bad = (nonAscii & ~cont & ~geC2) | geF0
+                | (isE0 & ~next1GeA0) | (isED & next1GeA0);
+
+        // continuation bytes must be exactly where the lead bytes expect them
+        const uint expected = (lead2 << 1) | (lead3 << 1) | (lead3 << 2);
+        const uint stop = (bad | ((cont ^ expected) & 0xffff)) | 0x10000;
+        int length = qCountTrailingZeroBits(stop);
+
+        // don't split the last character
+        const uint starts = ~cont & ((1U << length) - 1);
+        if (!starts)
+            break;
+        const int last = 31 - qCountLeadingZeroBits(starts);
+        const int lastLength = 1 + ((lead2 >> last) & 1) + 2 * ((lead3 >> last) & 1);
+        if (last + lastLength > length)
+            length = last;
+        const uint decoded = starts & ((1U << length) - 1);
+        if (!decoded)
+            break;
+
+        // decode and compact each half
+        const __m128i lo = decodeUtf8Lanes(_mm_cvtepu8_epi16(data), _mm_cvtepu8_epi16(next1),
+                                           _mm_cvtepu8_epi16(next2));
+        const __m128i hi = decodeUtf8Lanes(_mm_cvtepu8_epi16(_mm_srli_si128(data, 8)),
+                                           _mm_cvtepu8_epi16(_mm_srli_si128(next1, 8)),
+                                           _mm_cvtepu8_epi16(_mm_srli_si128(next2, 8)));
+        const uint loMask = decoded & 0xff;
+        const uint hiMask = decoded >> 8;
+
+        // The stores may write past the decoded characters, but never past
+        // src + 16 in output positions, which the caller's buffer allows.
+        _mm_storeu_si128((__m128i*)dst, _mm_shuffle_epi8(lo, _mm_loadu_si128((const __m128i*)table->masks[loMask])));
+        dst += qPopulationCount(loMask);
+        _mm_storeu_si128((__m128i*)dst, _mm_shuffle_epi8(hi, _mm_loadu_si128((const __m128i*)table->masks[hiMask])));
+        dst += qPopulationCount(hiMask);
+        src += length;
+    }
+    return src != start;
+}
+
+static inline bool simdDecodeUtf8(ushort *&dst, const uchar *&src, const uchar *end)
+{
+    return qCpuHasFeature(SSE4_1) && simdDecodeUtf8_sse4(dst, src, end);
+}
+#else
+static inline bool simdDecodeUtf8(ushort *&, const uchar *&, const uchar *)
+{
+    return false;
+}
+#endif
+
+// Text where the SIMD decoder keeps stopping early (four-byte sequences,
+// errors) would pay for setting it up again before every character, so after
+// an attempt that did not get through a whole block, the next block's worth
+// of bytes is left to the scalar decoder.
+static inline bool simdDecodeUtf8Throttled(ushort *&dst, const uchar *&src, const uchar *end,
+                                           const uchar *&nextAttempt)
+{
+    if (src < nextAttempt)
+        return false;
+    const uchar *const start = src;
+    const bool decoded = simdDecodeUtf8(dst, src, end);
+    if (src - start < 16)
+        nextAttempt = src + 16;
+    return decoded;
+}
+
 QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
 {
     // create a QByteArray with the worst case scenario size
@@ -296,12 +446,17 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, const char *chars, int len) Q_DECL
             src += 3;
         }
 
+        const uchar *nextSimdAttempt = src;
         while (src < end) {
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
 
             do {
+                // decode whole blocks of multi-byte text at once, if we can
+                if (simdDecodeUtf8Throttled(dst, src, end, nextSimdAttempt) && src >= nextAscii)
+                    break;
+
                 uchar b = *src++;
                 int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, dst, src, end);
                 if (res < 0) {
@@ -386,9 +541,12 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     // main body, stateless decoding
     res = 0;
     const uchar *nextAscii = src;
+    const uchar *nextSimdAttempt = src;
     while (res >= 0 && src < end) {
         if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
             break;
+        if (headerdone && simdDecodeUtf8Throttled(dst, src, end, nextSimdAttempt) && src >= end)
+            break;
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
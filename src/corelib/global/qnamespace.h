@@ -1244,6 +1244,7 @@ public:
         DirectConnection,
         QueuedConnection,
         BlockingQueuedConnection,
+        CoalescedConnection,
         UniqueConnection =  0x80
     };
 
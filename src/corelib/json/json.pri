@@ -4,6 +4,7 @@ HEADERS += \
     json/qjsonobject.h \
     json/qjsonvalue.h \
     json/qjsonarray.h \
+    json/qjsonstream.h \
     json/qjsonwriter_p.h \
     json/qjsonparser_p.h
 
@@ -13,5 +14,6 @@ SOURCES += \
     json/qjsonobject.cpp \
     json/qjsonarray.cpp \
     json/qjsonvalue.cpp \
+    json/qjsonstream.cpp \
     json/qjsonwriter.cpp \
     json/qjsonparser.cpp
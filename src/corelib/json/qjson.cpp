@@ -33,6 +33,7 @@
 
 #include "qjson_p.h"
 #include <qalgorithms.h>
+#include <qfile.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -117,10 +118,27 @@ void Data::compact()
     }
     Q_ASSERT(offset == (int)b->tableOffset);
 
-    free(header);
+    if (ownsData)
+        free(header);
     header = h;
     this->alloc = alloc;
+    ownsData = true;
     compactionCounter = 0;
+
+    // containers have moved, check them again when they are accessed
+    if (validatedContainers) {
+        delete [] validatedContainers;
+        validatedContainers = 0;
+        enableValidationOnAccess();
+    }
+}
+
+Data::~Data()
+{
+    if (ownsData)
+        free(rawData);
+    delete [] validatedContainers;
+    delete mappedFile;
 }
 
 bool Data::valid() const
@@ -137,6 +155,69 @@ bool Data::valid() const
     return res;
 }
 
+/*!
+    \internal
+
+    Makes containers get checked the first time they are accessed instead of
+    validating the whole document up front. The root container has to be
+    checked by the caller.
+ */
+void Data::enableValidationOnAccess()
+{
+    Q_ASSERT(!validatedContainers);
+    const int words = (alloc / int(sizeof(offset)) + 31) / 32;
+    validatedContainers = new QAtomicInt[words];
+}
+
+/*!
+    \internal
+
+    Returns \c true if the container \a b can be accessed safely. For data
+    that is validated on access, this checks the container itself and the
+    storage of its direct members, but not the containers nested inside it.
+    The result is remembered, so the check runs once per container.
+ */
+bool Data::validateOnAccess(const Base *b) const
+{
+    if (!validatedContainers)
+        return true;
+
+    const uint pos = offsetOf(b);
+    if (pos & (sizeof(offset) - 1))
+        return false;
+
+    const uint index = pos / sizeof(offset);
+    QAtomicInt &word = validatedContainers[index / 32];
+    const int bit = 1 << (index & 31);
+    if (word.load() & bit)
+        return true;
+
+    if (b->size < sizeof(Base) || pos + b->size > uint(alloc))
+        return false;
+    const bool ok = b->is_object ? static_cast<const Object *>(b)->isValid(false)
+                                 : static_cast<const Array *>(b)->isValid(false);
+    if (ok)
+        word.fetchAndOrRelaxed(bit);
+    return ok;
+}
+
+/*!
+    \internal
+
+    Returns \c true if all of \a b, including nested containers, can be
+    accessed safely. Code that walks the binary structures directly instead
+    of going through QJsonValue has to call this first.
+ */
+bool Data::validateSubtree(const Base *b) const
+{
+    if (!validatedContainers)
+        return true;
+    if (!validateOnAccess(b))
+        return false;
+    return b->is_object ? static_cast<const Object *>(b)->isValid()
+                        : static_cast<const Array *>(b)->isValid();
+}
+
 
 int Base::reserveSpace(uint dataSize, int posInTable, uint numItems, bool replace)
 {
@@ -195,7 +276,7 @@ int Object::indexOf(const QString &key, bool *exists)
     return min;
 }
 
-bool Object::isValid() const
+bool Object::isValid(bool recursive) const
 {
     if (tableOffset + length*sizeof(offset) > size)
         return false;
@@ -212,7 +293,7 @@ bool Object::isValid() const
         QString key = e->key();
         if (key < lastKey)
             return false;
-        if (!e->value.isValid(this))
+        if (!e->value.isValid(this, recursive))
             return false;
         lastKey = key;
     }
@@ -221,13 +302,13 @@ bool Object::isValid() const
 
 
 
-bool Array::isValid() const
+bool Array::isValid(bool recursive) const
 {
     if (tableOffset + length*sizeof(offset) > size)
         return false;
 
     for (uint i = 0; i < length; ++i) {
-        if (!at(i).isValid(this))
+        if (!at(i).isValid(this, recursive))
             return false;
     }
     return true;
@@ -296,7 +377,7 @@ int Value::usedStorage(const Base *b) const
     return alignedSize(s);
 }
 
-bool Value::isValid(const Base *b) const
+bool Value::isValid(const Base *b, bool recursive) const
 {
     int offset = 0;
     switch (type) {
@@ -325,6 +406,8 @@ bool Value::isValid(const Base *b) const
         return true;
     if (s < 0 || offset + s > (int)b->tableOffset)
         return false;
+    if (!recursive)
+        return true;
     if (type == QJsonValue::Array)
         return static_cast<Array *>(base(b))->isValid();
     if (type == QJsonValue::Object)
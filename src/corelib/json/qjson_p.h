@@ -115,6 +115,9 @@ QT_BEGIN_NAMESPACE
     Other measurements have shown a slightly bigger binary size than a compact text
     representation where all possible whitespace was stripped out.
 */
+
+class QFile;
+
 namespace QJsonPrivate {
 
 class Array;
@@ -560,7 +563,7 @@ public:
     }
     int indexOf(const QString &key, bool *exists);
 
-    bool isValid() const;
+    bool isValid(bool recursive = true) const;
 };
 
 
@@ -570,7 +573,7 @@ public:
     inline Value at(int i) const;
     inline Value &operator [](int i);
 
-    bool isValid() const;
+    bool isValid(bool recursive = true) const;
 };
 
 
@@ -599,7 +602,7 @@ public:
     Latin1String asLatin1String(const Base *b) const;
     Base *base(const Base *b) const;
 
-    bool isValid(const Base *b) const;
+    bool isValid(const Base *b, bool recursive = true) const;
 
     static int requiredStorage(QJsonValue &v, bool *compressed);
     static uint valueToStore(const QJsonValue &v, uint offset);
@@ -743,13 +746,20 @@ public:
     };
     uint compactionCounter : 31;
     uint ownsData : 1;
+    // one bit for every 4 byte offset, set once the container starting there
+    // has been checked; only allocated for data that is validated on access
+    QAtomicInt *validatedContainers;
+    // the file rawData is mapped from, if any
+    QFile *mappedFile;
 
     inline Data(char *raw, int a)
-        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true)
+        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true),
+          validatedContainers(0), mappedFile(0)
     {
     }
     inline Data(int reserved, QJsonValue::Type valueType)
-        : rawData(0), compactionCounter(0), ownsData(true)
+        : rawData(0), compactionCounter(0), ownsData(true),
+          validatedContainers(0), mappedFile(0)
     {
         Q_ASSERT(valueType == QJsonValue::Array || valueType == QJsonValue::Object);
 
@@ -764,8 +774,7 @@ public:
         b->tableOffset = sizeof(Base);
         b->length = 0;
     }
-    inline ~Data()
-    { if (ownsData) free(rawData); }
+    ~Data();
 
     uint offsetOf(const void *ptr) const { return (uint)(((char *)ptr - rawData)); }
 
@@ -798,12 +807,19 @@ public:
         h->version = 1;
         Data *d = new Data(raw, size);
         d->compactionCounter = (b == header->root()) ? compactionCounter : 0;
+        // b itself has been checked, but the containers inside it might not have been
+        if (validatedContainers)
+            d->enableValidationOnAccess();
         return d;
     }
 
     void compact();
     bool valid() const;
 
+    void enableValidationOnAccess();
+    bool validateOnAccess(const Base *b) const;
+    bool validateSubtree(const Base *b) const;
+
 private:
     Q_DISABLE_COPY(Data)
 };
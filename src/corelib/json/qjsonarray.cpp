@@ -1163,7 +1163,8 @@ QDebug operator<<(QDebug dbg, const QJsonArray &a)
         return dbg;
     }
     QByteArray json;
-    QJsonPrivate::Writer::arrayToJson(a.a, json, 0, true);
+    if (a.d->validateSubtree(a.a))
+        QJsonPrivate::Writer::arrayToJson(a.a, json, 0, true);
     dbg.nospace() << "QJsonArray("
                   << json.constData() // print as utf-8 string without extra quotation marks
                   << ")";
@@ -38,6 +38,7 @@
 #include <qstringlist.h>
 #include <qvariant.h>
 #include <qdebug.h>
+#include <qfile.h>
 #include "qjsonwriter_p.h"
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
@@ -67,8 +68,8 @@ QT_BEGIN_NAMESPACE
     and isObject(). The array or object contained in the document can be retrieved using
     array() or object() and then read or manipulated.
 
-    A document can also be created from a stored binary representation using fromBinaryData() or
-    fromRawData().
+    A document can also be created from a stored binary representation using fromBinaryData(),
+    fromRawData() or fromBinaryFile().
 
     \sa {JSON Support in Qt}, {JSON Save Game Example}
 */
@@ -150,14 +151,39 @@ QJsonDocument &QJsonDocument::operator =(const QJsonDocument &other)
 /*! \enum QJsonDocument::DataValidation
 
   This value is used to tell QJsonDocument whether to validate the binary data
-  when converting to a QJsonDocument using fromBinaryData() or fromRawData().
+  when converting to a QJsonDocument using fromBinaryData(), fromRawData() or
+  fromBinaryFile().
 
   \value Validate Validate the data before using it. This is the default.
   \value BypassValidation Bypasses data validation. Only use if you received the
   data from a trusted place and know it's valid, as using of invalid data can crash
   the application.
+  \value ValidateOnAccess Only validate the top-level object or array up front.
+  Every nested object or array is validated the first time it is accessed, so
+  the cost of validation is only paid for the parts of the document that are
+  actually used. Nested objects or arrays that turn out to be invalid are
+  returned as undefined values, and toJson() returns an empty result if the
+  document contains invalid data. This value was introduced in Qt 5.7.
   */
 
+static bool validateData(QJsonPrivate::Data *d, QJsonDocument::DataValidation validation)
+{
+    switch (validation) {
+    case QJsonDocument::Validate:
+        return d->valid();
+    case QJsonDocument::BypassValidation:
+        return true;
+    case QJsonDocument::ValidateOnAccess:
+        break;
+    }
+
+    if (d->alloc < int(sizeof(QJsonPrivate::Header) + sizeof(QJsonPrivate::Base))
+        || d->header->tag != QJsonDocument::BinaryFormatTag || d->header->version != 1u)
+        return false;
+    d->enableValidationOnAccess();
+    return d->validateOnAccess(d->header->root());
+}
+
 /*!
  Creates a QJsonDocument that uses the first \a size bytes from
  \a data. It assumes \a data contains a binary encoded JSON document.
@@ -185,7 +211,7 @@ QJsonDocument QJsonDocument::fromRawData(const char *data, int size, DataValidat
     QJsonPrivate::Data *d = new QJsonPrivate::Data((char *)data, size);
     d->ownsData = false;
 
-    if (validation != BypassValidation && !d->valid()) {
+    if (!validateData(d, validation)) {
         delete d;
         return QJsonDocument();
     }
@@ -242,7 +268,66 @@ QJsonDocument QJsonDocument::fromBinaryData(const QByteArray &data, DataValidati
     memcpy(raw, data.constData(), size);
     QJsonPrivate::Data *d = new QJsonPrivate::Data(raw, size);
 
-    if (validation != BypassValidation && !d->valid()) {
+    if (!validateData(d, validation)) {
+        delete d;
+        return QJsonDocument();
+    }
+
+    return QJsonDocument(d);
+}
+
+/*!
+ \since 5.7
+
+ Creates a QJsonDocument from the binary representation stored in the file
+ \a fileName, as written from toBinaryData() or rawData().
+
+ Where possible, the file is mapped into memory instead of being read, and
+ the document uses the mapped data directly. The mapping is private to the
+ document: modifying the document never changes the file. Together with
+ ValidateOnAccess for \a validation, opening a large document only costs
+ time for the parts of it that are actually accessed.
+
+ If the file cannot be opened or does not contain valid data, the method
+ returns a null document.
+
+ \sa fromBinaryData(), fromRawData(), isNull(), DataValidation
+ */
+QJsonDocument QJsonDocument::fromBinaryFile(const QString &fileName, DataValidation validation)
+{
+    QFile *file = new QFile(fileName);
+    if (!file->open(QIODevice::ReadOnly)) {
+        delete file;
+        return QJsonDocument();
+    }
+
+    const qint64 fileSize = file->size();
+    if (fileSize < qint64(sizeof(QJsonPrivate::Header) + sizeof(QJsonPrivate::Base))
+        || fileSize > qint64(INT_MAX)) {
+        delete file;
+        return QJsonDocument();
+    }
+
+    uchar *mapped = file->map(0, fileSize, QFileDevice::MapPrivateOption);
+    if (!mapped) {
+        // not all file engines support mapping
+        const QByteArray data = file->readAll();
+        delete file;
+        return fromBinaryData(data, validation);
+    }
+
+    QJsonPrivate::Header *h = reinterpret_cast<QJsonPrivate::Header *>(mapped);
+    const quint64 size = sizeof(QJsonPrivate::Header) + quint64(h->root()->size);
+    if (h->tag != QJsonDocument::BinaryFormatTag || h->version != 1u || size > quint64(fileSize)) {
+        delete file;
+        return QJsonDocument();
+    }
+
+    QJsonPrivate::Data *d = new QJsonPrivate::Data(reinterpret_cast<char *>(mapped), int(size));
+    d->ownsData = false;
+    d->mappedFile = file;
+
+    if (!validateData(d, validation)) {
         delete d;
         return QJsonDocument();
     }
@@ -341,6 +426,10 @@ QByteArray QJsonDocument::toJson(JsonFormat format) const
 
     QByteArray json;
 
+    // with ValidateOnAccess, parts of the document might not have been checked yet
+    if (!d->validateSubtree(d->header->root()))
+        return json;
+
     if (d->header->root()->isArray())
         QJsonPrivate::Writer::arrayToJson(static_cast<QJsonPrivate::Array *>(d->header->root()), json, 0, (format == Compact));
     else
@@ -568,10 +657,12 @@ QDebug operator<<(QDebug dbg, const QJsonDocument &o)
         return dbg;
     }
     QByteArray json;
-    if (o.d->header->root()->isArray())
-        QJsonPrivate::Writer::arrayToJson(static_cast<QJsonPrivate::Array *>(o.d->header->root()), json, 0, true);
-    else
-        QJsonPrivate::Writer::objectToJson(static_cast<QJsonPrivate::Object *>(o.d->header->root()), json, 0, true);
+    if (o.d->validateSubtree(o.d->header->root())) {
+        if (o.d->header->root()->isArray())
+            QJsonPrivate::Writer::arrayToJson(static_cast<QJsonPrivate::Array *>(o.d->header->root()), json, 0, true);
+        else
+            QJsonPrivate::Writer::objectToJson(static_cast<QJsonPrivate::Object *>(o.d->header->root()), json, 0, true);
+    }
     dbg.nospace() << "QJsonDocument("
                   << json.constData() // print as utf-8 string without extra quotation marks
                   << ')';
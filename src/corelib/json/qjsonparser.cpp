@@ -766,80 +766,6 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
 
         unescaped = %x20-21 / %x23-5B / %x5D-10FFFF
  */
-static inline bool addHexDigit(char digit, uint *result)
-{
-    *result <<= 4;
-    if (digit >= '0' && digit <= '9')
-        *result |= (digit - '0');
-    else if (digit >= 'a' && digit <= 'f')
-        *result |= (digit - 'a') + 10;
-    else if (digit >= 'A' && digit <= 'F')
-        *result |= (digit - 'A') + 10;
-    else
-        return false;
-    return true;
-}
-
-static inline bool scanEscapeSequence(const char *&json, const char *end, uint *ch)
-{
-    ++json;
-    if (json >= end)
-        return false;
-
-    DEBUG << "scan escape" << (char)*json;
-    uint escaped = *json++;
-    switch (escaped) {
-    case '"':
-        *ch = '"'; break;
-    case '\\':
-        *ch = '\\'; break;
-    case '/':
-        *ch = '/'; break;
-    case 'b':
-        *ch = 0x8; break;
-    case 'f':
-        *ch = 0xc; break;
-    case 'n':
-        *ch = 0xa; break;
-    case 'r':
-        *ch = 0xd; break;
-    case 't':
-        *ch = 0x9; break;
-    case 'u': {
-        *ch = 0;
-        if (json > end - 4)
-            return false;
-        for (int i = 0; i < 4; ++i) {
-            if (!addHexDigit(*json, ch))
-                return false;
-            ++json;
-        }
-        return true;
-    }
-    default:
-        // this is not as strict as one could be, but allows for more Json files
-        // to be parsed correctly.
-        *ch = escaped;
-        return true;
-    }
-    return true;
-}
-
-static inline bool scanUtf8Char(const char *&json, const char *end, uint *result)
-{
-    const uchar *&src = reinterpret_cast<const uchar *&>(json);
-    const uchar *uend = reinterpret_cast<const uchar *>(end);
-    uchar b = *src++;
-    int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, result, src, uend);
-    if (res < 0) {
-        // decoding error, backtrack the character we read above
-        --json;
-        return false;
-    }
-
-    return true;
-}
-
 bool Parser::parseString(bool *latin1)
 {
     *latin1 = true;
@@ -0,0 +1,1616 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qjsonstream.h"
+
+#include <qbuffer.h>
+#include <qjsonarray.h>
+#include <qjsonobject.h>
+#include <qvarlengtharray.h>
+#include <qvector.h>
+
+#include "qjsonparser_p.h"
+#include "qjsonwriter_p.h"
+#include "private/qlocale_tools_p.h"
+
+QT_BEGIN_NAMESPACE
+
+using namespace QJsonPrivate;
+
+// same limit as QJsonPrivate::Parser
+static const int nestingLimit = 1024;
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.7
+
+    \brief The QJsonStreamReader class provides a fast parser for reading
+    JSON documents token by token.
+
+    QJsonDocument::fromJson() converts the whole input into an in-memory
+    tree before any of it can be inspected, so the memory needed grows
+    with the size of the document. QJsonStreamReader is a pull parser in
+    the style of QXmlStreamReader: the application calls readNext() to
+    advance to the next token and only the current token is held in
+    memory. This makes it possible to process arbitrarily large documents,
+    such as long arrays of records, in constant memory.
+
+    The reader is fed either from a QIODevice set with setDevice() or
+    from chunks of data passed to addData(). The first token returned by
+    readNext() is always StartDocument and the last one is EndDocument.
+    In between, every object and array is reported as a StartObject or
+    StartArray token followed by its contents and a matching EndObject or
+    EndArray token. Scalar values are reported as Null, Bool, Double or
+    String tokens; value() returns the value of such a token. For tokens
+    that are direct members of an object, name() returns the member name.
+
+    \snippet code/src_corelib_json_qjsonstream.cpp 0
+
+    readValue() reads the current value, including the complete contents
+    of an object or array, into a QJsonValue. Combining it with readNext()
+    allows parts of a document to be handled with the convenient
+    QJsonObject and QJsonArray API while the document as a whole is still
+    streamed:
+
+    \snippet code/src_corelib_json_qjsonstream.cpp 1
+
+    \section1 Incremental Parsing
+
+    When the data available so far ends in the middle of the document,
+    readNext() returns Invalid and error() returns
+    PrematureEndOfDocumentError. This is not a fatal error: once more data
+    has been passed to addData(), or has arrived on the device, calling
+    readNext() resumes parsing with the token that was incomplete.
+
+    A number at the top level of a document cannot be told apart from the
+    beginning of a longer number until the input ends, and the document
+    itself is only complete once it is known that nothing follows it. The
+    number and the EndDocument token are therefore only reported at the
+    end of the input: when a device() that is not sequential is at its
+    end, or a sequential one has been closed, or after finishInput() has
+    been called. Until then, readNext() reports
+    PrematureEndOfDocumentError.
+
+    Any other error is fatal: readNext() keeps returning Invalid and
+    parseError() describes the problem and where it occurred.
+
+    Unlike QJsonDocument::fromJson(), QJsonStreamReader accepts any JSON
+    value at the top level of a document, and does not detect duplicate
+    member names in objects.
+
+    \sa QJsonStreamWriter, QJsonDocument, QXmlStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token the reader just read.
+
+    \value NoToken The reader has not yet read anything.
+    \value Invalid An error has occurred, reported in error() and
+    errorString().
+    \value StartDocument The reader is about to read a document.
+    \value EndDocument The reader has read a complete document.
+    \value StartObject The reader has read the opening brace of an object.
+    \value EndObject The reader has read the closing brace of an object.
+    \value StartArray The reader has read the opening bracket of an array.
+    \value EndArray The reader has read the closing bracket of an array.
+    \value Null The reader has read a \c null value.
+    \value Bool The reader has read \c true or \c false. Use value() to
+    retrieve it.
+    \value Double The reader has read a number. Use value() to retrieve it.
+    \value String The reader has read a string. Use value() to retrieve it.
+*/
+
+/*!
+    \enum QJsonStreamReader::Error
+
+    This enum specifies the different error cases.
+
+    \value NoError No error has occurred.
+    \value NotWellFormedError The parser internally raised an error due to
+    the read JSON not being well-formed. parseError() contains the details.
+    \value PrematureEndOfDocumentError The input stream ended before a
+    complete JSON document was parsed. This error can be recovered from.
+*/
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum State {
+        BeforeDocument,
+        ExpectRootValue,
+        ExpectFirstElement,
+        ExpectElement,
+        ExpectFirstMember,
+        ExpectMember,
+        ExpectSeparator,
+        ExpectEndOfDocument,
+        Finished
+    };
+
+    enum Result {
+        Ok,
+        NeedMoreData,
+        Failed
+    };
+
+    QJsonStreamReaderPrivate();
+
+    void init();
+    void parseNext();
+    bool fetchMore();
+    bool inputEnded() const;
+    void compact();
+
+    Result scanToken(const char *&json, const char *end, bool atEof);
+    Result scanValue(const char *&json, const char *end, bool atEof);
+    Result scanString(const char *&json, const char *end, QString *string);
+    Result scanNumber(const char *&json, const char *end, bool atEof, double *number);
+    Result scanLiteral(const char *&json, const char *end, const char *literal, int length);
+
+    void raiseError(QJsonStreamReader::Error e, QJsonParseError::ParseError pe, qint64 offset);
+
+    QIODevice *device;
+    bool inputComplete;
+    QByteArray buffer;
+    int pos;
+    qint64 discarded;
+    int readSize;
+    int bufferSizeAtError;
+
+    QByteArray containers;
+    State state;
+
+    QJsonStreamReader::TokenType type;
+    QString name;
+    QJsonValue value;
+
+    QJsonStreamReader::Error error;
+    QJsonParseError::ParseError parseError;
+    qint64 errorOffset;
+
+    // result of the token being scanned, committed once it is complete
+    QJsonStreamReader::TokenType nextType;
+    QString nextName;
+    QJsonValue nextValue;
+    State nextState;
+};
+
+QJsonStreamReaderPrivate::QJsonStreamReaderPrivate()
+    : device(0)
+{
+    init();
+}
+
+void QJsonStreamReaderPrivate::init()
+{
+    inputComplete = false;
+    buffer.clear();
+    pos = 0;
+    discarded = 0;
+    readSize = 16384;
+    bufferSizeAtError = 0;
+    containers.clear();
+    state = BeforeDocument;
+    type = QJsonStreamReader::NoToken;
+    name.clear();
+    value = QJsonValue(QJsonValue::Undefined);
+    error = QJsonStreamReader::NoError;
+    parseError = QJsonParseError::NoError;
+    errorOffset = 0;
+}
+
+void QJsonStreamReaderPrivate::raiseError(QJsonStreamReader::Error e, QJsonParseError::ParseError pe, qint64 offset)
+{
+    type = QJsonStreamReader::Invalid;
+    name.clear();
+    value = QJsonValue(QJsonValue::Undefined);
+    error = e;
+    parseError = pe;
+    errorOffset = offset;
+    bufferSizeAtError = buffer.size();
+}
+
+// drops the bytes that belong to tokens that have already been reported
+void QJsonStreamReaderPrivate::compact()
+{
+    if (pos) {
+        buffer.remove(0, pos);
+        discarded += pos;
+        bufferSizeAtError -= pos;
+        pos = 0;
+    }
+}
+
+bool QJsonStreamReaderPrivate::fetchMore()
+{
+    if (!device || !device->isOpen())
+        return false;
+
+    compact();
+
+    // read at least as much as we already hold, so that a token spanning
+    // many reads is rescanned a logarithmic number of times only
+    const int chunk = qMax(readSize, buffer.size());
+    const int oldSize = buffer.size();
+    buffer.resize(oldSize + chunk);
+    const qint64 n = device->read(buffer.data() + oldSize, chunk);
+    buffer.resize(oldSize + int(qMax(n, Q_INT64_C(0))));
+    return n > 0;
+}
+
+// Returns true if no more data can follow what has been read: a socket
+// that has no data yet is at its end too, but only until more arrives.
+bool QJsonStreamReaderPrivate::inputEnded() const
+{
+    if (inputComplete)
+        return true;
+    if (!device)
+        return false;
+    return device->isSequential() ? !device->isOpen() : device->atEnd();
+}
+
+void QJsonStreamReaderPrivate::parseNext()
+{
+    bool atEof = false;
+    forever {
+        // the pending error describes what is wrong if the input ends here
+        parseError = containers.isEmpty() ? QJsonParseError::IllegalValue
+                     : containers.endsWith('{') ? QJsonParseError::UnterminatedObject
+                     : QJsonParseError::UnterminatedArray;
+
+        const char *begin = buffer.constData() + pos;
+        const char *json = begin;
+        const Result result = scanToken(json, buffer.constData() + buffer.size(), atEof);
+
+        switch (result) {
+        case Ok:
+            pos += int(json - begin);
+            type = nextType;
+            name = nextName;
+            value = nextValue;
+            state = nextState;
+            return;
+        case Failed:
+            raiseError(QJsonStreamReader::NotWellFormedError, parseError,
+                       discarded + pos + (json - begin));
+            return;
+        case NeedMoreData:
+            if (fetchMore())
+                continue;
+            if (!atEof && inputEnded()) {
+                // one more pass to complete what can be completed at the end of the input
+                atEof = true;
+                continue;
+            }
+            raiseError(QJsonStreamReader::PrematureEndOfDocumentError, parseError,
+                       discarded + buffer.size());
+            return;
+        }
+    }
+}
+
+static inline void skipWhitespace(const char *&json, const char *end)
+{
+    while (json < end && (*json == ' ' || *json == '\t' || *json == '\n' || *json == '\r'))
+        ++json;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::scanToken(const char *&json, const char *end, bool atEof)
+{
+    nextName = QString();
+    nextValue = QJsonValue(QJsonValue::Undefined);
+    nextState = state;
+    bool afterSeparator = false;
+
+    switch (state) {
+    case BeforeDocument:
+    case Finished:
+        Q_UNREACHABLE();
+        return Failed;
+
+    case ExpectRootValue:
+        if (discarded == 0 && pos == 0) {
+            // skip a UTF-8 byte order mark
+            static const char bom[] = "\xef\xbb\xbf";
+            int i = 0;
+            while (i < 3 && json + i < end && json[i] == bom[i])
+                ++i;
+            if (i == 3)
+                json += 3;
+            else if (json + i == end && !atEof)
+                return NeedMoreData;
+        }
+        skipWhitespace(json, end);
+        return scanValue(json, end, atEof);
+
+    case ExpectFirstElement:
+        skipWhitespace(json, end);
+        if (json < end && *json == ']')
+            break;
+        return scanValue(json, end, atEof);
+
+    case ExpectFirstMember:
+        skipWhitespace(json, end);
+        break;
+
+    case ExpectSeparator:
+        skipWhitespace(json, end);
+        if (json >= end)
+            return NeedMoreData;
+        if (*json == ',') {
+            ++json;
+            skipWhitespace(json, end);
+            if (containers.endsWith('['))
+                return scanValue(json, end, atEof);
+            afterSeparator = true;
+        } else if (*json != ']' && *json != '}') {
+            parseError = QJsonParseError::MissingValueSeparator;
+            return Failed;
+        }
+        break;
+
+    case ExpectElement:
+    case ExpectMember:
+        Q_UNREACHABLE();
+        return Failed;
+
+    case ExpectEndOfDocument:
+        skipWhitespace(json, end);
+        if (json < end) {
+            parseError = QJsonParseError::GarbageAtEnd;
+            return Failed;
+        }
+        if (!atEof)
+            return NeedMoreData;
+        nextType = QJsonStreamReader::EndDocument;
+        nextState = Finished;
+        return Ok;
+    }
+
+    if (json >= end)
+        return NeedMoreData;
+
+    // the end of a container
+    if (!afterSeparator && (*json == ']' || *json == '}')) {
+        const bool isObject = containers.endsWith('{');
+        if ((*json == '}') != isObject) {
+            parseError = isObject ? QJsonParseError::UnterminatedObject
+                                  : QJsonParseError::UnterminatedArray;
+            return Failed;
+        }
+        ++json;
+        nextType = isObject ? QJsonStreamReader::EndObject : QJsonStreamReader::EndArray;
+        nextState = containers.size() == 1 ? ExpectEndOfDocument : ExpectSeparator;
+        containers.chop(1);
+        return Ok;
+    }
+
+    // a member of an object
+    if (*json != '"') {
+        parseError = afterSeparator ? QJsonParseError::MissingObject
+                                    : QJsonParseError::UnterminatedObject;
+        return Failed;
+    }
+    QString memberName;
+    Result result = scanString(json, end, &memberName);
+    if (result != Ok)
+        return result;
+    skipWhitespace(json, end);
+    if (json >= end) {
+        parseError = QJsonParseError::UnterminatedObject;
+        return NeedMoreData;
+    }
+    if (*json != ':') {
+        parseError = QJsonParseError::MissingNameSeparator;
+        return Failed;
+    }
+    ++json;
+    skipWhitespace(json, end);
+    result = scanValue(json, end, atEof);
+    if (result == Ok)
+        nextName = memberName;
+    return result;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::scanValue(const char *&json, const char *end, bool atEof)
+{
+    if (json >= end)
+        return NeedMoreData;
+
+    Result result;
+    switch (*json) {
+    case '{':
+    case '[':
+        if (containers.size() >= nestingLimit) {
+            parseError = QJsonParseError::DeepNesting;
+            return Failed;
+        }
+        nextType = *json == '{' ? QJsonStreamReader::StartObject : QJsonStreamReader::StartArray;
+        nextState = *json == '{' ? ExpectFirstMember : ExpectFirstElement;
+        // committed right away: nothing can fail after this point
+        containers.append(*json);
+        ++json;
+        return Ok;
+    case '"': {
+        QString string;
+        result = scanString(json, end, &string);
+        if (result != Ok)
+            return result;
+        nextType = QJsonStreamReader::String;
+        nextValue = string;
+        break;
+    }
+    case 't':
+        result = scanLiteral(json, end, "true", 4);
+        if (result != Ok)
+            return result;
+        nextType = QJsonStreamReader::Bool;
+        nextValue = true;
+        break;
+    case 'f':
+        result = scanLiteral(json, end, "false", 5);
+        if (result != Ok)
+            return result;
+        nextType = QJsonStreamReader::Bool;
+        nextValue = false;
+        break;
+    case 'n':
+        result = scanLiteral(json, end, "null", 4);
+        if (result != Ok)
+            return result;
+        nextType = QJsonStreamReader::Null;
+        nextValue = QJsonValue();
+        break;
+    default:
+        if (*json == '-' || (*json >= '0' && *json <= '9')) {
+            double d;
+            result = scanNumber(json, end, atEof, &d);
+            if (result != Ok)
+                return result;
+            nextType = QJsonStreamReader::Double;
+            nextValue = d;
+            break;
+        }
+        parseError = QJsonParseError::IllegalValue;
+        return Failed;
+    }
+
+    nextState = containers.isEmpty() ? ExpectEndOfDocument : ExpectSeparator;
+    return Ok;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::scanLiteral(const char *&json, const char *end, const char *literal, int length)
+{
+    for (int i = 0; i < length; ++i) {
+        if (json + i >= end)
+            return NeedMoreData;
+        if (json[i] != literal[i]) {
+            parseError = QJsonParseError::IllegalValue;
+            return Failed;
+        }
+    }
+    json += length;
+    return Ok;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::scanNumber(const char *&json, const char *end, bool atEof, double *number)
+{
+    // same grammar as QJsonPrivate::Parser::parseNumber()
+    const char *start = json;
+
+    if (json < end && *json == '-')
+        ++json;
+
+    if (json < end && *json == '0') {
+        ++json;
+    } else {
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+
+    if (json < end && *json == '.') {
+        ++json;
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+
+    if (json < end && (*json == 'e' || *json == 'E')) {
+        ++json;
+        if (json < end && (*json == '-' || *json == '+'))
+            ++json;
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+
+    // the number may continue in data that has not arrived yet
+    if (json >= end && !(atEof && containers.isEmpty())) {
+        parseError = QJsonParseError::TerminationByNumber;
+        return NeedMoreData;
+    }
+
+    const int length = int(json - start);
+    QVarLengthArray<char, 64> digits(length + 1);
+    memcpy(digits.data(), start, length);
+    digits[length] = '\0';
+
+    bool ok = false;
+    int processed = 0;
+    *number = asciiToDouble(digits.constData(), length, ok, processed);
+    if (!ok || processed != length) {
+        json = start;
+        parseError = QJsonParseError::IllegalNumber;
+        return Failed;
+    }
+    return Ok;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::scanString(const char *&json, const char *end, QString *string)
+{
+    Q_ASSERT(*json == '"');
+
+    // find the closing quote first, so that decoding only ever sees complete input
+    const char *stringEnd = json + 1;
+    while (stringEnd < end && *stringEnd != '"')
+        stringEnd += (*stringEnd == '\\') ? 2 : 1;
+    if (stringEnd >= end) {
+        parseError = QJsonParseError::UnterminatedString;
+        return NeedMoreData;
+    }
+
+    ++json;
+
+    // every input byte yields at most one UTF-16 code unit
+    string->resize(int(stringEnd - json));
+    ushort *out = reinterpret_cast<ushort *>(string->data());
+    ushort *const outStart = out;
+
+    while (json < stringEnd) {
+        const uchar c = *json;
+        if (c < 0x80 && c != '\\') {
+            *out++ = c;
+            ++json;
+            continue;
+        }
+
+        uint ch = 0;
+        if (c == '\\') {
+            const char *escape = json;
+            if (!scanEscapeSequence(json, stringEnd, &ch)) {
+                json = escape;
+                parseError = QJsonParseError::IllegalEscapeSequence;
+                return Failed;
+            }
+        } else if (!scanUtf8Char(json, stringEnd, &ch)) {
+            parseError = QJsonParseError::IllegalUTF8String;
+            return Failed;
+        }
+
+        if (QChar::requiresSurrogates(ch)) {
+            *out++ = QChar::highSurrogate(ch);
+            *out++ = QChar::lowSurrogate(ch);
+        } else {
+            *out++ = ushort(ch);
+        }
+    }
+    string->resize(int(out - outStart));
+
+    ++json;
+    return Ok;
+}
+
+/*!
+    Constructs a stream reader.
+
+    \sa setDevice(), addData()
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Creates a new stream reader that reads from \a device.
+
+    \sa setDevice(), clear()
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Creates a new stream reader that reads from \a data. The data is
+    the complete input, as if finishInput() had been called; to feed the
+    reader in chunks, use the default constructor and addData().
+
+    \sa addData(), clear(), setDevice()
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    addData(data);
+    d_ptr->inputComplete = true;
+}
+
+/*!
+    Destructs the reader.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the current device to \a device. Setting the device resets
+    the stream to its initial state.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamReader);
+    d->init();
+    d->device = device;
+}
+
+/*!
+    Returns the current device associated with the QJsonStreamReader,
+    or 0 if no device has been assigned.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->device;
+}
+
+/*!
+    Adds more \a data for the reader to read. This function does
+    nothing if the reader has a device().
+
+    \sa readNext(), clear()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    Q_D(QJsonStreamReader);
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    d->compact();
+    d->buffer += data;
+}
+
+/*!
+    Tells the reader that the input ends after the data added so far, so
+    that a number at the top level of the document, and the end of the
+    document, can be reported. Call it after the last addData(), or once
+    a sequential device() such as a socket has received all of its data.
+
+    A PrematureEndOfDocumentError reported before this function was
+    called can be resumed by calling readNext().
+
+    \sa addData(), readNext(), atEnd()
+*/
+void QJsonStreamReader::finishInput()
+{
+    Q_D(QJsonStreamReader);
+    if (d->inputComplete)
+        return;
+    d->inputComplete = true;
+    if (d->type == Invalid && d->error == PrematureEndOfDocumentError)
+        d->bufferSizeAtError = -1; // not atEnd(): readNext() can now complete the document
+}
+
+/*!
+    Removes any device() or data from the reader and resets its
+    internal state to the initial state.
+
+    \sa addData()
+*/
+void QJsonStreamReader::clear()
+{
+    Q_D(QJsonStreamReader);
+    d->init();
+    d->device = 0;
+}
+
+/*!
+    Returns \c true if the reader has read until the end of the JSON
+    document, or if an error() has occurred and reading has been
+    aborted. Otherwise, it returns \c false.
+
+    When atEnd() and hasError() return true and error() returns
+    PrematureEndOfDocumentError, it means the JSON has been well-formed
+    so far, but a complete JSON document has not been parsed. The next
+    chunk of JSON can be added with addData(), if the JSON is being read
+    from a QByteArray, or by waiting for more data to arrive if the
+    JSON is being read from a QIODevice. Either way, atEnd() will
+    return false once more data is available.
+
+    \sa hasError(), error(), device(), QIODevice::atEnd()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    Q_D(const QJsonStreamReader);
+    if (d->type == Invalid && d->error == PrematureEndOfDocumentError) {
+        if (d->bufferSizeAtError < 0)
+            return false;
+        if (d->device)
+            return d->device->atEnd();
+        return d->buffer.size() == d->bufferSizeAtError;
+    }
+    return d->type == Invalid || d->type == EndDocument;
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    With one exception, once an error() is reported by readNext(),
+    further reading of the JSON stream is not possible. Then atEnd()
+    returns \c true, hasError() returns \c true, and this function returns
+    QJsonStreamReader::Invalid.
+
+    The exception is when error() returns PrematureEndOfDocumentError.
+    This error is reported when the end of an otherwise well-formed
+    chunk of JSON is reached, but the chunk doesn't represent a complete
+    JSON document. In that case, parsing \e can be resumed by calling
+    addData() to add the next chunk of JSON, when the stream is being
+    read from a QByteArray, or by waiting for more data to arrive when
+    the stream is being read from a device().
+
+    Once EndDocument has been reported, this function keeps returning
+    EndDocument.
+
+    \sa tokenType(), tokenString()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    Q_D(QJsonStreamReader);
+    switch (d->state) {
+    case QJsonStreamReaderPrivate::BeforeDocument:
+        d->type = StartDocument;
+        d->state = QJsonStreamReaderPrivate::ExpectRootValue;
+        return d->type;
+    case QJsonStreamReaderPrivate::Finished:
+        return d->type;
+    default:
+        break;
+    }
+
+    if (d->type == Invalid) {
+        if (d->error != PrematureEndOfDocumentError)
+            return d->type;
+        // resume after more data has arrived
+        d->error = NoError;
+        d->parseError = QJsonParseError::NoError;
+    }
+
+    d->parseNext();
+    return d->type;
+}
+
+/*!
+    Reads the current value and returns it.
+
+    If the current token is a Null, Bool, Double or String token, its
+    value() is returned. If the current token is StartObject or StartArray,
+    the complete object or array is read and returned, and the reader is
+    positioned on the matching EndObject or EndArray token. For any other
+    token, or if an error occurs while reading, an undefined QJsonValue is
+    returned.
+
+    \sa value(), skipCurrentValue()
+*/
+QJsonValue QJsonStreamReader::readValue()
+{
+    Q_D(QJsonStreamReader);
+    switch (d->type) {
+    case Null:
+    case Bool:
+    case Double:
+    case String:
+        return d->value;
+    case StartObject: {
+        QJsonObject object;
+        forever {
+            switch (readNext()) {
+            case EndObject:
+                return object;
+            case Invalid:
+                return QJsonValue(QJsonValue::Undefined);
+            default: {
+                const QString key = d->name;
+                object.insert(key, readValue());
+                break;
+            }
+            }
+        }
+    }
+    case StartArray: {
+        QJsonArray array;
+        forever {
+            switch (readNext()) {
+            case EndArray:
+                return array;
+            case Invalid:
+                return QJsonValue(QJsonValue::Undefined);
+            default:
+                array.append(readValue());
+                break;
+            }
+        }
+    }
+    default:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+}
+
+/*!
+    Reads until the end of the current value, ignoring any content.
+
+    If the current token is StartObject or StartArray, this function reads
+    up to and including the matching EndObject or EndArray token. For any
+    other token it does nothing.
+
+    \sa readValue()
+*/
+void QJsonStreamReader::skipCurrentValue()
+{
+    Q_D(QJsonStreamReader);
+    if (d->type != StartObject && d->type != StartArray)
+        return;
+
+    int depth = 1;
+    while (depth) {
+        switch (readNext()) {
+        case StartObject:
+        case StartArray:
+            ++depth;
+            break;
+        case EndObject:
+        case EndArray:
+            --depth;
+            break;
+        case Invalid:
+            return;
+        default:
+            break;
+        }
+    }
+}
+
+/*!
+    Returns the type of the current token.
+
+    The current token can also be queried with the convenience functions
+    isStartDocument(), isEndDocument(), isStartObject(), isEndObject(),
+    isStartArray(), isEndArray() and isValue().
+
+    \sa tokenString()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type;
+}
+
+/*!
+    Returns the reader's current token as string.
+
+    \sa tokenType()
+*/
+QString QJsonStreamReader::tokenString() const
+{
+    Q_D(const QJsonStreamReader);
+    static const char *const names[] = {
+        "NoToken",
+        "Invalid",
+        "StartDocument",
+        "EndDocument",
+        "StartObject",
+        "EndObject",
+        "StartArray",
+        "EndArray",
+        "Null",
+        "Bool",
+        "Double",
+        "String"
+    };
+    return QLatin1String(names[d->type]);
+}
+
+/*!
+    \fn bool QJsonStreamReader::isStartDocument() const
+
+    Returns \c true if tokenType() equals \l StartDocument; otherwise
+    returns \c false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndDocument() const
+
+    Returns \c true if tokenType() equals \l EndDocument; otherwise
+    returns \c false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isStartObject() const
+
+    Returns \c true if tokenType() equals \l StartObject; otherwise
+    returns \c false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndObject() const
+
+    Returns \c true if tokenType() equals \l EndObject; otherwise
+    returns \c false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isStartArray() const
+
+    Returns \c true if tokenType() equals \l StartArray; otherwise
+    returns \c false.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndArray() const
+
+    Returns \c true if tokenType() equals \l EndArray; otherwise
+    returns \c false.
+*/
+
+/*!
+    Returns \c true if the current token is a Null, Bool, Double or
+    String token; otherwise returns \c false.
+
+    \sa value()
+*/
+bool QJsonStreamReader::isValue() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type >= Null && d->type <= String;
+}
+
+/*!
+    Returns the number of objects and arrays that are currently open.
+    The depth includes the object or array started by the current token,
+    but not one ended by it.
+*/
+int QJsonStreamReader::depth() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->containers.size();
+}
+
+/*!
+    Returns the number of bytes of input consumed so far.
+*/
+qint64 QJsonStreamReader::characterOffset() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->discarded + d->pos;
+}
+
+/*!
+    Returns the member name of the current token if it is a direct member
+    of an object; otherwise returns a null string.
+
+    \sa value()
+*/
+QString QJsonStreamReader::name() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->name;
+}
+
+/*!
+    Returns the value of the current token if it is a Null, Bool, Double
+    or String token; otherwise returns an undefined QJsonValue.
+
+    \sa readValue(), name()
+*/
+QJsonValue QJsonStreamReader::value() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->value;
+}
+
+/*!
+    Returns the type of the current error, or NoError if no error occurred.
+
+    \sa errorString(), parseError()
+*/
+QJsonStreamReader::Error QJsonStreamReader::error() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->error;
+}
+
+/*!
+    Returns the error message that was set when the current error
+    occurred.
+
+    \sa error(), parseError()
+*/
+QString QJsonStreamReader::errorString() const
+{
+    return parseError().errorString();
+}
+
+/*!
+    Returns a description of the current error and the offset in the
+    input at which it occurred.
+
+    \sa error(), errorString()
+*/
+QJsonParseError QJsonStreamReader::parseError() const
+{
+    Q_D(const QJsonStreamReader);
+    QJsonParseError e;
+    e.offset = int(d->errorOffset);
+    e.error = d->error == NoError ? QJsonParseError::NoError : d->parseError;
+    return e;
+}
+
+/*!
+    \fn bool QJsonStreamReader::hasError() const
+
+    Returns \c true if an error has occurred, otherwise \c false.
+
+    \sa errorString(), error()
+*/
+
+#ifndef QT_JSON_READONLY
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.7
+
+    \brief The QJsonStreamWriter class provides a JSON writer with a
+    simple streaming API.
+
+    QJsonStreamWriter is the counterpart to QJsonStreamReader for writing
+    JSON. It writes each value to a QIODevice as soon as it is passed in,
+    so that large documents can be produced without first building them
+    as a QJsonDocument.
+
+    Objects and arrays are opened with writeStartObject() and
+    writeStartArray() and closed with writeEndObject() and writeEndArray().
+    Values are written with writeValue(); a QJsonValue holding an object or
+    an array is written out completely. Inside an object, every member is
+    written with one of the overloads taking a member name. writeEndDocument()
+    closes all objects and arrays that are still open.
+
+    \snippet code/src_corelib_json_qjsonstream.cpp 2
+
+    The output has the same layout as QJsonDocument::toJson() for the
+    format set with setFormat(), which defaults to
+    QJsonDocument::Indented.
+
+    \sa QJsonStreamReader, QJsonDocument, QXmlStreamWriter
+*/
+
+class QJsonStreamWriterPrivate
+{
+    QJsonStreamWriter *q_ptr;
+    Q_DECLARE_PUBLIC(QJsonStreamWriter)
+public:
+    QJsonStreamWriterPrivate(QJsonStreamWriter *q);
+    ~QJsonStreamWriterPrivate();
+
+    void write(const QByteArray &data);
+    bool startElement(const char *function, const QString *name, QByteArray &out);
+    void finishElement(QByteArray &out);
+    void writeStart(const QString *name, char bracket);
+    void writeEnd(char bracket);
+    void writeValue(const QString *name, const QJsonValue &value);
+    void valueToJson(const QJsonValue &value, QByteArray &out);
+
+    QIODevice *device;
+    bool deleteDevice;
+    bool compact;
+    bool hasError;
+    bool documentComplete;
+
+    struct Container {
+        char bracket;
+        bool hasElements;
+    };
+    QVector<Container> containers;
+};
+
+QJsonStreamWriterPrivate::QJsonStreamWriterPrivate(QJsonStreamWriter *q)
+    : q_ptr(q), device(0), deleteDevice(false), compact(false), hasError(false),
+      documentComplete(false)
+{
+}
+
+QJsonStreamWriterPrivate::~QJsonStreamWriterPrivate()
+{
+    if (deleteDevice)
+        delete device;
+}
+
+void QJsonStreamWriterPrivate::write(const QByteArray &data)
+{
+    if (!device || hasError)
+        return;
+    if (device->write(data) != data.size())
+        hasError = true;
+}
+
+// Writes the separator, indentation and member name that precede a value into
+// \a out. Returns false if a value cannot be written at this point.
+bool QJsonStreamWriterPrivate::startElement(const char *function, const QString *name, QByteArray &out)
+{
+    if (containers.isEmpty()) {
+        if (documentComplete) {
+            qWarning("QJsonStreamWriter::%s: The document has already been completed", function);
+            return false;
+        }
+        if (name) {
+            qWarning("QJsonStreamWriter::%s: Cannot write a named value outside of an object", function);
+            return false;
+        }
+        return true;
+    }
+
+    Container &c = containers.last();
+    if (c.bracket == '{' && !name) {
+        qWarning("QJsonStreamWriter::%s: Object members need a name", function);
+        return false;
+    }
+    if (c.bracket == '[' && name) {
+        qWarning("QJsonStreamWriter::%s: Array elements cannot have a name", function);
+        return false;
+    }
+
+    if (c.hasElements)
+        out += compact ? "," : ",\n";
+    c.hasElements = true;
+    if (!compact)
+        out += QByteArray(4 * containers.size(), ' ');
+    if (name) {
+        out += '"';
+        out += Writer::escapedString(*name);
+        out += compact ? "\":" : "\": ";
+    }
+    return true;
+}
+
+// Terminates the document after its root value, like QJsonDocument::toJson() does.
+void QJsonStreamWriterPrivate::finishElement(QByteArray &out)
+{
+    if (!containers.isEmpty())
+        return;
+    documentComplete = true;
+    if (!compact)
+        out += '\n';
+}
+
+void QJsonStreamWriterPrivate::writeStart(const QString *name, char bracket)
+{
+    QByteArray out;
+    if (!startElement(bracket == '{' ? "writeStartObject" : "writeStartArray", name, out))
+        return;
+    out += bracket;
+    if (!compact)
+        out += '\n';
+    const Container c = { bracket, false };
+    containers.append(c);
+    write(out);
+}
+
+void QJsonStreamWriterPrivate::writeEnd(char bracket)
+{
+    if (containers.isEmpty() || containers.last().bracket != bracket) {
+        qWarning("QJsonStreamWriter::%s: No %s is open", bracket == '{' ? "writeEndObject" : "writeEndArray",
+                 bracket == '{' ? "object" : "array");
+        return;
+    }
+
+    QByteArray out;
+    const bool hasElements = containers.last().hasElements;
+    containers.removeLast();
+    if (!compact) {
+        if (hasElements)
+            out += '\n';
+        out += QByteArray(4 * containers.size(), ' ');
+    }
+    out += bracket == '{' ? '}' : ']';
+    finishElement(out);
+    write(out);
+}
+
+void QJsonStreamWriterPrivate::writeValue(const QString *name, const QJsonValue &value)
+{
+    if (value.isUndefined()) {
+        qWarning("QJsonStreamWriter::writeValue: Cannot write an undefined value");
+        return;
+    }
+    QByteArray out;
+    if (!startElement("writeValue", name, out))
+        return;
+    valueToJson(value, out);
+    finishElement(out);
+    write(out);
+}
+
+void QJsonStreamWriterPrivate::valueToJson(const QJsonValue &value, QByteArray &out)
+{
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        out += value.toBool() ? "true" : "false";
+        break;
+    case QJsonValue::Double: {
+        const double d = value.toDouble();
+        if (qIsFinite(d))
+            out += QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
+        else
+            out += "null"; // +INF || -INF || NaN (see RFC4627#section2.4)
+        break;
+    }
+    case QJsonValue::String:
+        out += '"';
+        out += Writer::escapedString(value.toString());
+        out += '"';
+        break;
+    case QJsonValue::Object:
+    case QJsonValue::Array: {
+        // reuse the QJsonDocument serializer, re-indenting its output to
+        // the current nesting depth
+        QJsonDocument document;
+        if (value.isObject())
+            document.setObject(value.toObject());
+        else
+            document.setArray(value.toArray());
+        const QByteArray json = document.toJson(compact ? QJsonDocument::Compact
+                                                        : QJsonDocument::Indented);
+        if (compact || containers.isEmpty()) {
+            out += json;
+            if (!compact)
+                out.chop(1); // finishElement() adds the final newline
+        } else {
+            const QByteArray indent(4 * containers.size(), ' ');
+            int from = 0;
+            forever {
+                const int newline = json.indexOf('\n', from);
+                if (newline < 0 || newline == json.size() - 1) {
+                    out += json.mid(from, newline < 0 ? -1 : newline - from);
+                    break;
+                }
+                out += json.mid(from, newline + 1 - from);
+                out += indent;
+                from = newline + 1;
+            }
+        }
+        break;
+    }
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        out += "null";
+        break;
+    }
+}
+
+/*!
+    Constructs a stream writer.
+
+    \sa setDevice()
+*/
+QJsonStreamWriter::QJsonStreamWriter()
+    : d_ptr(new QJsonStreamWriterPrivate(this))
+{
+}
+
+/*!
+    Constructs a stream writer that writes into \a device.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : d_ptr(new QJsonStreamWriterPrivate(this))
+{
+    Q_D(QJsonStreamWriter);
+    d->device = device;
+}
+
+/*!
+    Constructs a stream writer that writes into \a array. This is the
+    same as creating a JSON writer that operates on a QBuffer device
+    which in turn operates on \a array.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *array)
+    : d_ptr(new QJsonStreamWriterPrivate(this))
+{
+    Q_D(QJsonStreamWriter);
+    d->device = new QBuffer(array);
+    d->device->open(QIODevice::WriteOnly);
+    d->deleteDevice = true;
+}
+
+/*!
+    Destructor.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+}
+
+/*!
+    Sets the current device to \a device. If you want the stream to
+    write into a QByteArray, you can create a QBuffer device.
+
+    Setting a different device starts a new document: any containers left
+    open on the previous device are discarded and the error status is
+    cleared.
+
+    \sa device(), hasError()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamWriter);
+    if (device == d->device)
+        return;
+    if (d->deleteDevice) {
+        delete d->device;
+        d->deleteDevice = false;
+    }
+    d->device = device;
+    d->hasError = false;
+    d->documentComplete = false;
+    d->containers.clear();
+}
+
+/*!
+    Returns the device associated with the QJsonStreamWriter, or 0 if
+    no device has been assigned.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->device;
+}
+
+/*!
+    Sets the output format to \a format. The default is
+    QJsonDocument::Indented.
+
+    The format should be set before writing the document starts.
+
+    \sa format()
+*/
+void QJsonStreamWriter::setFormat(QJsonDocument::JsonFormat format)
+{
+    Q_D(QJsonStreamWriter);
+    d->compact = format == QJsonDocument::Compact;
+}
+
+/*!
+    Returns the output format.
+
+    \sa setFormat()
+*/
+QJsonDocument::JsonFormat QJsonStreamWriter::format() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->compact ? QJsonDocument::Compact : QJsonDocument::Indented;
+}
+
+/*!
+    Writes the start of an object. The object must be the root of the
+    document or an element of an array.
+
+    \sa writeEndObject()
+*/
+void QJsonStreamWriter::writeStartObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeStart(0, '{');
+}
+
+/*!
+    \overload
+
+    Writes the start of an object that is the member \a name of the
+    current object.
+*/
+void QJsonStreamWriter::writeStartObject(const QString &name)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeStart(&name, '{');
+}
+
+/*!
+    Closes the object started last.
+
+    \sa writeStartObject()
+*/
+void QJsonStreamWriter::writeEndObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeEnd('{');
+}
+
+/*!
+    Writes the start of an array. The array must be the root of the
+    document or an element of an array.
+
+    \sa writeEndArray()
+*/
+void QJsonStreamWriter::writeStartArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeStart(0, '[');
+}
+
+/*!
+    \overload
+
+    Writes the start of an array that is the member \a name of the
+    current object.
+*/
+void QJsonStreamWriter::writeStartArray(const QString &name)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeStart(&name, '[');
+}
+
+/*!
+    Closes the array started last.
+
+    \sa writeStartArray()
+*/
+void QJsonStreamWriter::writeEndArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->writeEnd('[');
+}
+
+/*!
+    Writes \a value as the root of the document or as an element of the
+    current array. Objects and arrays are written out completely.
+*/
+void QJsonStreamWriter::writeValue(const QJsonValue &value)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeValue(0, value);
+}
+
+/*!
+    \overload
+
+    Writes \a value as the member \a name of the current object.
+*/
+void QJsonStreamWriter::writeValue(const QString &name, const QJsonValue &value)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeValue(&name, value);
+}
+
+/*!
+    Closes all remaining open objects and arrays.
+*/
+void QJsonStreamWriter::writeEndDocument()
+{
+    Q_D(QJsonStreamWriter);
+    while (!d->containers.isEmpty())
+        d->writeEnd(d->containers.last().bracket);
+}
+
+/*!
+    Writes the current state of the \a reader. All possible valid
+    states are supported.
+
+    The purpose of this function is to support chained processing of
+    JSON data.
+
+    \sa QJsonStreamReader::tokenType()
+*/
+void QJsonStreamWriter::writeCurrentToken(const QJsonStreamReader &reader)
+{
+    Q_D(QJsonStreamWriter);
+    const QString name = reader.name();
+    const QString *member = (!d->containers.isEmpty() && d->containers.last().bracket == '{') ? &name : 0;
+
+    switch (reader.tokenType()) {
+    case QJsonStreamReader::StartObject:
+        d->writeStart(member, '{');
+        break;
+    case QJsonStreamReader::EndObject:
+        d->writeEnd('{');
+        break;
+    case QJsonStreamReader::StartArray:
+        d->writeStart(member, '[');
+        break;
+    case QJsonStreamReader::EndArray:
+        d->writeEnd('[');
+        break;
+    case QJsonStreamReader::Null:
+    case QJsonStreamReader::Bool:
+    case QJsonStreamReader::Double:
+    case QJsonStreamReader::String:
+        d->writeValue(member, reader.value());
+        break;
+    case QJsonStreamReader::EndDocument:
+        writeEndDocument();
+        break;
+    case QJsonStreamReader::NoToken:
+    case QJsonStreamReader::Invalid:
+    case QJsonStreamReader::StartDocument:
+        break;
+    }
+}
+
+/*!
+    Returns the number of objects and arrays that are currently open.
+*/
+int QJsonStreamWriter::depth() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->containers.size();
+}
+
+/*!
+    Returns \c true if writing failed.
+
+    This can happen if the stream failed to write to the underlying
+    device.
+
+    The error status is only reset by setting a different device with
+    setDevice(). Writes happening after the error occurred are ignored,
+    even if the error condition is cleared.
+
+    \sa setDevice()
+*/
+bool QJsonStreamWriter::hasError() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->hasError;
+}
+
+#endif // QT_JSON_READONLY
+
+QT_END_NAMESPACE
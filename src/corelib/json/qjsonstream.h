@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QJSONSTREAM_H
+#define QJSONSTREAM_H
+
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qscopedpointer.h>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+class QJsonStreamReaderPrivate;
+
+class Q_CORE_EXPORT QJsonStreamReader
+{
+public:
+    enum TokenType {
+        NoToken = 0,
+        Invalid,
+        StartDocument,
+        EndDocument,
+        StartObject,
+        EndObject,
+        StartArray,
+        EndArray,
+        Null,
+        Bool,
+        Double,
+        String
+    };
+
+    QJsonStreamReader();
+    explicit QJsonStreamReader(QIODevice *device);
+    explicit QJsonStreamReader(const QByteArray &data);
+    ~QJsonStreamReader();
+
+    void setDevice(QIODevice *device);
+    QIODevice *device() const;
+    void addData(const QByteArray &data);
+    void finishInput();
+    void clear();
+
+    bool atEnd() const;
+    TokenType readNext();
+
+    QJsonValue readValue();
+    void skipCurrentValue();
+
+    TokenType tokenType() const;
+    QString tokenString() const;
+
+    inline bool isStartDocument() const { return tokenType() == StartDocument; }
+    inline bool isEndDocument() const { return tokenType() == EndDocument; }
+    inline bool isStartObject() const { return tokenType() == StartObject; }
+    inline bool isEndObject() const { return tokenType() == EndObject; }
+    inline bool isStartArray() const { return tokenType() == StartArray; }
+    inline bool isEndArray() const { return tokenType() == EndArray; }
+    bool isValue() const;
+
+    int depth() const;
+    qint64 characterOffset() const;
+
+    QString name() const;
+    QJsonValue value() const;
+
+    enum Error {
+        NoError,
+        NotWellFormedError,
+        PrematureEndOfDocumentError
+    };
+    Error error() const;
+    QString errorString() const;
+    QJsonParseError parseError() const;
+
+    inline bool hasError() const
+    {
+        return error() != NoError;
+    }
+
+private:
+    Q_DISABLE_COPY(QJsonStreamReader)
+    Q_DECLARE_PRIVATE(QJsonStreamReader)
+    QScopedPointer<QJsonStreamReaderPrivate> d_ptr;
+};
+
+#ifndef QT_JSON_READONLY
+
+class QJsonStreamWriterPrivate;
+
+class Q_CORE_EXPORT QJsonStreamWriter
+{
+public:
+    QJsonStreamWriter();
+    explicit QJsonStreamWriter(QIODevice *device);
+    explicit QJsonStreamWriter(QByteArray *array);
+    ~QJsonStreamWriter();
+
+    void setDevice(QIODevice *device);
+    QIODevice *device() const;
+
+    void setFormat(QJsonDocument::JsonFormat format);
+    QJsonDocument::JsonFormat format() const;
+
+    void writeStartObject();
+    void writeStartObject(const QString &name);
+    void writeEndObject();
+
+    void writeStartArray();
+    void writeStartArray(const QString &name);
+    void writeEndArray();
+
+    void writeValue(const QJsonValue &value);
+    void writeValue(const QString &name, const QJsonValue &value);
+
+    void writeEndDocument();
+
+    void writeCurrentToken(const QJsonStreamReader &reader);
+
+    int depth() const;
+    bool hasError() const;
+
+private:
+    Q_DISABLE_COPY(QJsonStreamWriter)
+    Q_DECLARE_PRIVATE(QJsonStreamWriter)
+    QScopedPointer<QJsonStreamWriterPrivate> d_ptr;
+};
+
+#endif // QT_JSON_READONLY
+
+QT_END_NAMESPACE
+
+#endif // QJSONSTREAM_H
@@ -128,6 +128,11 @@ QJsonValue::QJsonValue(QJsonPrivate::Data *data, QJsonPrivate::Base *base, const
     }
     case Array:
     case Object:
+        if (!data->validateOnAccess(v.base(base))) {
+            t = Undefined;
+            dbl = 0;
+            break;
+        }
         d = data;
         this->base = v.base(base);
         break;
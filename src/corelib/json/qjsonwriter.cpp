@@ -49,7 +49,7 @@ static inline uchar hexdig(uint u)
     return (u < 0xa ? '0' + u : 'a' + u - 0xa);
 }
 
-static QByteArray escapedString(const QString &s)
+QByteArray Writer::escapedString(const QString &s)
 {
     const uchar replacement = '?';
     QByteArray ba(s.length(), Qt::Uninitialized);
@@ -131,7 +131,7 @@ static void valueToJson(const QJsonPrivate::Base *b, const QJsonPrivate::Value &
     }
     case QJsonValue::String:
         json += '"';
-        json += escapedString(v.toString(b));
+        json += Writer::escapedString(v.toString(b));
         json += '"';
         break;
     case QJsonValue::Array:
@@ -187,7 +187,7 @@ static void objectContentToJson(const QJsonPrivate::Object *o, QByteArray &json,
         QJsonPrivate::Entry *e = o->entryAt(i);
         json += indentString;
         json += '"';
-        json += escapedString(e->key());
+        json += Writer::escapedString(e->key());
         json += compact ? "\":" : "\": ";
         valueToJson(o, e->value, json, indent, compact);
 
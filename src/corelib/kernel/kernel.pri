@@ -151,6 +151,14 @@ unix|integrity {
     contains(QT_CONFIG, poll_ppoll): DEFINES += QT_HAVE_POLL QT_HAVE_PPOLL
     contains(QT_CONFIG, poll_pollts): DEFINES += QT_HAVE_POLL QT_HAVE_POLLTS
 
+    linux:contains(QT_CONFIG, eventfd) {
+        SOURCES += \
+            kernel/qeventdispatcher_epoll.cpp
+        HEADERS += \
+            kernel/qeventdispatcher_epoll_p.h
+        DEFINES += QT_HAVE_EPOLL
+    }
+
     contains(QT_CONFIG, glib) {
         SOURCES += \
             kernel/qeventdispatcher_glib.cpp
@@ -72,6 +72,9 @@
 #  if !defined(QT_NO_GLIB)
 #   include "qeventdispatcher_glib_p.h"
 #  endif
+#  if defined(QT_HAVE_EPOLL)
+#   include "qeventdispatcher_epoll_p.h"
+#  endif
 # endif
 # include "qeventdispatcher_unix_p.h"
 #endif
@@ -305,7 +308,9 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
-    return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
+    // events still in the intake are not counted individually
+    return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset
+            + (currentThreadData->postEventList.hasIntake() ? 1 : 0);
 }
 
 QAbstractEventDispatcher *QCoreApplicationPrivate::eventDispatcher = 0;
@@ -454,6 +459,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         QMutexLocker locker(&threadData->postEventList.mutex);
+        threadData->postEventList.drainIntake();
         for (int i = 0; i < threadData->postEventList.size(); ++i) {
             const QPostEvent &pe = threadData->postEventList.at(i);
             if (pe.event) {
@@ -480,13 +486,24 @@ void QCoreApplicationPrivate::createEventDispatcher()
         eventDispatcher = new QEventDispatcherCoreFoundation(q);
     else
         eventDispatcher = new QEventDispatcherUNIX(q);
-#  elif !defined(QT_NO_GLIB)
+#  else
+#    if defined(QT_HAVE_EPOLL)
+    bool ok = false;
+    int value = qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL", &ok);
+    if (ok && value > 0) {
+        eventDispatcher = new QEventDispatcherEpoll(value > 1 ? QEventDispatcherEpoll::EdgeTriggered
+                                                              : QEventDispatcherEpoll::LevelTriggered, q);
+        return;
+    }
+#    endif
+#    if !defined(QT_NO_GLIB)
     if (qEnvironmentVariableIsEmpty("QT_NO_GLIB") && QEventDispatcherGlib::versionSupported())
         eventDispatcher = new QEventDispatcherGlib(q);
     else
         eventDispatcher = new QEventDispatcherUNIX(q);
-#  else
+#    else
         eventDispatcher = new QEventDispatcherUNIX(q);
+#    endif
 #  endif
 #elif defined(Q_OS_WINRT)
     eventDispatcher = new QEventDispatcherWinRT(q);
@@ -1361,6 +1378,43 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    // Queued calls at normal priority are never compressed and need no
+    // sorting, so they are published in the lock-free intake of the
+    // receiver's thread instead of contending for the mutex. The intake is
+    // moved into the list by the next one to lock it, at the latest by
+    // sendPostedEvents().
+    if (event->type() == QEvent::MetaCall && priority == Qt::NormalEventPriority) {
+        QPostEventList &postEventList = data->postEventList;
+        {
+            QScopedPointer<QEvent> eventDeleter(event);
+            postEventList.allocateIntake();
+            eventDeleter.take();
+        }
+
+        postEventList.intakePosters.ref();
+        if (Q_LIKELY(data == *pdata)) {
+            // QObject::moveToThread() waits for intakePosters to drop to
+            // zero before draining, so the event cannot get stranded here
+            event->posted = true;
+            receiver->d_func()->intakeEvents.ref();
+            if (postEventList.pushIntake(QPostEvent(receiver, event, priority))) {
+                postEventList.intakePosters.deref();
+
+                QAbstractEventDispatcher* dispatcher = data->eventDispatcher.loadAcquire();
+                if (dispatcher)
+                    dispatcher->wakeUp();
+                return;
+            }
+
+            // the intake is full; the locked path below drains it
+            receiver->d_func()->intakeEvents.deref();
+            event->posted = false;
+        }
+        // otherwise the object is moving to another thread; the locked
+        // path below follows it
+        postEventList.intakePosters.deref();
+    }
+
     // lock the post event mutex
     data->postEventList.mutex.lock();
 
@@ -1380,6 +1434,9 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 
     QMutexUnlocker locker(&data->postEventList.mutex);
 
+    // keep the posting order of events published in the intake
+    data->postEventList.drainIntake();
+
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
         && self && self->compressEvent(event, receiver, &data->postEventList)) {
@@ -1489,6 +1546,11 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
 
     QMutexLocker locker(&data->postEventList.mutex);
 
+    // take everything posted through the intake since the last pass; events
+    // pushed while we are sending are left for the next pass, just like the
+    // ones inserted after insertionOffset
+    data->postEventList.drainIntake();
+
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
     // events, canWait will be set to false.
@@ -1644,6 +1706,7 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     QThreadData *data = receiver ? receiver->d_func()->threadData : QThreadData::current();
     QMutexLocker locker(&data->postEventList.mutex);
+    data->postEventList.drainIntake();
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -1709,6 +1772,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->postEventList.drainIntake();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
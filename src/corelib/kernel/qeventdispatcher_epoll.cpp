@@ -0,0 +1,519 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplatformdefs.h"
+
+#include "qcoreapplication.h"
+#include "qsocketnotifier.h"
+#include "qthread.h"
+
+#include "qeventdispatcher_epoll_p.h"
+#include <private/qthread_p.h>
+#include <private/qcoreapplication_p.h>
+#include <private/qcore_unix_p.h>
+
+#include <errno.h>
+#include <stdio.h>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+QT_BEGIN_NAMESPACE
+
+enum {
+    // upper bound for the number of events fetched per epoll_wait(); anything
+    // beyond this is picked up on the next iteration of the event loop
+    MaxEpollEvents = 256
+};
+
+static quint32 epollEventsFor(const QEpollSocketNotifiers &sn)
+{
+    quint32 events = 0;
+    if (sn.notifiers[QSocketNotifier::Read])
+        events |= EPOLLIN;
+    if (sn.notifiers[QSocketNotifier::Write])
+        events |= EPOLLOUT;
+    if (sn.notifiers[QSocketNotifier::Exception])
+        events |= EPOLLPRI;
+    return events;
+}
+
+static bool epollAdd(int epfd, int fd, quint32 events)
+{
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.fd = fd;
+    return epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+QEventDispatcherEpollPrivate::QEventDispatcherEpollPrivate(QEventDispatcherEpoll::TriggerMode mode)
+    : triggerMode(mode), epollFd(-1), controlFd(-1), wakeUpFd(-1), timerFd(-1), timerArmed(false)
+{
+    armedDeadline.tv_sec = armedDeadline.tv_nsec = 0;
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    controlFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeUpFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    if (Q_UNLIKELY(epollFd == -1 || controlFd == -1 || wakeUpFd == -1 || timerFd == -1))
+        qFatal("QEventDispatcherEpollPrivate(): Unable to create epoll descriptors: %s",
+               qPrintable(qt_error_string()));
+
+    // the control descriptors are level-triggered regardless of the trigger
+    // mode, as they are drained explicitly after every wake up
+    if (Q_UNLIKELY(!epollAdd(epollFd, wakeUpFd, EPOLLIN) || !epollAdd(epollFd, timerFd, EPOLLIN)
+                   || !epollAdd(controlFd, wakeUpFd, EPOLLIN) || !epollAdd(controlFd, timerFd, EPOLLIN)))
+        qFatal("QEventDispatcherEpollPrivate(): Unable to watch control descriptors: %s",
+               qPrintable(qt_error_string()));
+}
+
+QEventDispatcherEpollPrivate::~QEventDispatcherEpollPrivate()
+{
+    qt_safe_close(timerFd);
+    qt_safe_close(wakeUpFd);
+    qt_safe_close(controlFd);
+    qt_safe_close(epollFd);
+
+    // cleanup timers
+    qDeleteAll(timerList);
+}
+
+void QEventDispatcherEpollPrivate::armTimer(const timespec &wait)
+{
+    timespec deadline = timerList.currentTime + wait;
+    if (timerArmed && deadline == armedDeadline)
+        return;
+
+    itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value = wait;
+    if (timerfd_settime(timerFd, 0, &spec, 0) == -1) {
+        perror("timerfd_settime");
+        return;
+    }
+    timerArmed = true;
+    armedDeadline = deadline;
+}
+
+void QEventDispatcherEpollPrivate::disarmTimer()
+{
+    if (!timerArmed)
+        return;
+
+    itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    timerfd_settime(timerFd, 0, &spec, 0);
+    timerArmed = false;
+}
+
+/*
+    Synchronizes the epoll registration of \a fd with the notifiers in \a sn.
+    Returns \c false if the descriptor can no longer be watched.
+*/
+bool QEventDispatcherEpollPrivate::updateSocketNotifiers(int fd, QEpollSocketNotifiers &sn)
+{
+    const quint32 events = epollEventsFor(sn);
+    if (events == sn.events)
+        return true;
+
+    const quint32 oldEvents = sn.events;
+    sn.events = events;
+
+    if (unpollableFds.contains(fd)) {
+        if (!events)
+            unpollableFds.removeOne(fd);
+        return true;
+    }
+
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    if (triggerMode == QEventDispatcherEpoll::EdgeTriggered)
+        ev.events |= EPOLLET;
+    ev.data.fd = fd;
+
+    if (!events) {
+        // the descriptor may already have been closed, in which case the
+        // kernel removed it from the interest list on its own
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, &ev);
+        return true;
+    }
+
+    int ret = epoll_ctl(epollFd, oldEvents ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev);
+    if (ret == -1 && errno == ENOENT) {
+        // closed and reused descriptor
+        ret = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    } else if (ret == -1 && errno == EEXIST) {
+        ret = epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+    }
+
+    if (ret == -1 && errno == EPERM) {
+        // regular files and directories can't be watched by epoll; select()
+        // reports them as always ready, so we do the same
+        unpollableFds.append(fd);
+        return true;
+    }
+    return ret == 0;
+}
+
+void QEventDispatcherEpollPrivate::markPending(const QEpollSocketNotifiers &sn, quint32 revents)
+{
+    if (sn.notifiers[QSocketNotifier::Read] && (revents & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+        pendingNotifiers.append(sn.notifiers[QSocketNotifier::Read]);
+    if (sn.notifiers[QSocketNotifier::Write] && (revents & (EPOLLOUT | EPOLLHUP | EPOLLERR)))
+        pendingNotifiers.append(sn.notifiers[QSocketNotifier::Write]);
+    if (sn.notifiers[QSocketNotifier::Exception] && (revents & EPOLLPRI))
+        pendingNotifiers.append(sn.notifiers[QSocketNotifier::Exception]);
+}
+
+int QEventDispatcherEpollPrivate::doWait(QEventLoop::ProcessEventsFlags flags, int timeout)
+{
+    const bool includeSockets = !(flags & QEventLoop::ExcludeSocketNotifiers);
+    if (includeSockets && !unpollableFds.isEmpty())
+        timeout = 0;
+
+    epoll_event events[MaxEpollEvents];
+    int nsel;
+    do {
+        nsel = epoll_wait(includeSockets ? epollFd : controlFd, events, MaxEpollEvents, timeout);
+    } while (nsel == -1 && errno == EINTR);
+
+    if (nsel == -1) {
+        // EBADF, EFAULT or EINVAL... shouldn't happen, so let's complain to
+        // stderr and hope someone sends us a bug report
+        perror("epoll_wait");
+        return 0;
+    }
+
+    int nevents = 0;
+    for (int i = 0; i < nsel; ++i) {
+        const int fd = events[i].data.fd;
+        if (fd == wakeUpFd) {
+            // some other thread woke us up... consume the counter so that
+            // epoll_wait doesn't immediately return next time
+            eventfd_t value;
+            eventfd_read(wakeUpFd, &value);
+            if (!wakeUps.testAndSetRelease(1, 0)) {
+                // hopefully, this is dead code
+                qWarning("QEventDispatcherEpoll: internal error, wakeUps.testAndSetRelease(1, 0) failed!");
+            }
+            ++nevents;
+        } else if (fd == timerFd) {
+            quint64 expirations;
+            qt_safe_read(timerFd, &expirations, sizeof(expirations));
+            timerArmed = false;
+        } else {
+            QHash<int, QEpollSocketNotifiers>::const_iterator it = socketNotifiers.constFind(fd);
+            if (it != socketNotifiers.constEnd())
+                markPending(it.value(), events[i].events);
+        }
+    }
+
+    if (includeSockets) {
+        for (int i = 0; i < unpollableFds.size(); ++i)
+            markPending(socketNotifiers.value(unpollableFds.at(i)), EPOLLIN | EPOLLOUT | EPOLLPRI);
+        nevents += activateSocketNotifiers();
+    }
+    return nevents;
+}
+
+int QEventDispatcherEpollPrivate::activateSocketNotifiers()
+{
+    if (pendingNotifiers.isEmpty())
+        return 0;
+
+    // activate entries; notifiers unregistered by an earlier receiver are
+    // removed from the pending list in unregisterSocketNotifier()
+    int n_act = 0;
+    QEvent event(QEvent::SockAct);
+    while (!pendingNotifiers.isEmpty()) {
+        QSocketNotifier *notifier = pendingNotifiers.takeFirst();
+        QCoreApplication::sendEvent(notifier, &event);
+        ++n_act;
+    }
+    return n_act;
+}
+
+/*!
+    \internal
+    \class QEventDispatcherEpoll
+
+    QEventDispatcherEpoll is a Linux event dispatcher built on epoll(7). Socket
+    notifiers are registered with the kernel incrementally, so the cost of an
+    event loop iteration depends on the number of ready descriptors rather than
+    on the number of registered ones, and descriptors are not limited to
+    FD_SETSIZE. Timers are driven through a timerfd.
+
+    It is selected by setting the \c QT_EVENT_DISPATCHER_EPOLL environment
+    variable to 1 (level-triggered) or 2 (edge-triggered). In edge-triggered
+    mode a socket notifier is only activated again once new data arrives or
+    the notifier is re-enabled, so receivers must drain the socket completely.
+*/
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(QObject *parent)
+    : QAbstractEventDispatcher(*new QEventDispatcherEpollPrivate(LevelTriggered), parent)
+{ }
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(TriggerMode mode, QObject *parent)
+    : QAbstractEventDispatcher(*new QEventDispatcherEpollPrivate(mode), parent)
+{ }
+
+QEventDispatcherEpoll::~QEventDispatcherEpoll()
+{
+}
+
+QEventDispatcherEpoll::TriggerMode QEventDispatcherEpoll::triggerMode() const
+{
+    Q_D(const QEventDispatcherEpoll);
+    return d->triggerMode;
+}
+
+/*!
+    \internal
+*/
+void QEventDispatcherEpoll::registerTimer(int timerId, int interval, Qt::TimerType timerType, QObject *obj)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1 || interval < 0 || !obj) {
+        qWarning("QEventDispatcherEpoll::registerTimer: invalid arguments");
+        return;
+    } else if (obj->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::registerTimer: timers cannot be started from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    d->timerList.registerTimer(timerId, interval, timerType, obj);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimer(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: invalid argument");
+        return false;
+    } else if (thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimer(timerId);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimers(QObject *object)
+{
+#ifndef QT_NO_DEBUG
+    if (!object) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: invalid argument");
+        return false;
+    } else if (object->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimers(object);
+}
+
+QList<QEventDispatcherEpoll::TimerInfo>
+QEventDispatcherEpoll::registeredTimers(QObject *object) const
+{
+    if (!object) {
+        qWarning("QEventDispatcherEpoll:registeredTimers: invalid argument");
+        return QList<TimerInfo>();
+    }
+
+    Q_D(const QEventDispatcherEpoll);
+    return d->timerList.registeredTimers(object);
+}
+
+int QEventDispatcherEpoll::remainingTime(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::remainingTime: invalid argument");
+        return -1;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.timerRemainingTime(timerId);
+}
+
+void QEventDispatcherEpoll::registerSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    int type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (sockfd < 0) {
+        qWarning("QSocketNotifier: Internal error");
+        return;
+    } else if (notifier->thread() != thread()
+               || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifiers cannot be enabled from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    QEpollSocketNotifiers &sn = d->socketNotifiers[sockfd];
+    if (sn.notifiers[type]) {
+        static const char *t[] = { "Read", "Write", "Exception" };
+        qWarning("QSocketNotifier: Multiple socket notifiers for "
+                 "same socket %d and type %s", sockfd, t[type]);
+    }
+    sn.notifiers[type] = notifier;
+
+    if (!d->updateSocketNotifiers(sockfd, sn)) {
+        static const char *t[] = { "Read", "Write", "Exception" };
+        qWarning("QSocketNotifier: Invalid socket %d and type '%s', disabling...",
+                 sockfd, t[type]);
+        notifier->setEnabled(false);
+    }
+}
+
+void QEventDispatcherEpoll::unregisterSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    int type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (sockfd < 0) {
+        qWarning("QSocketNotifier: Internal error");
+        return;
+    } else if (notifier->thread() != thread()
+               || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifiers cannot be disabled from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    QHash<int, QEpollSocketNotifiers>::iterator it = d->socketNotifiers.find(sockfd);
+    if (it == d->socketNotifiers.end() || it->notifiers[type] != notifier) // not found
+        return;
+
+    it->notifiers[type] = 0;
+    d->pendingNotifiers.removeOne(notifier);     // remove from activation list
+
+    d->updateSocketNotifiers(sockfd, *it);
+    if (!it->events)
+        d->socketNotifiers.erase(it);
+}
+
+bool QEventDispatcherEpoll::processEvents(QEventLoop::ProcessEventsFlags flags)
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.store(0);
+
+    // we are awake, broadcast it
+    emit awake();
+    QCoreApplicationPrivate::sendPostedEvents(0, 0, d->threadData);
+
+    int nevents = 0;
+    const bool canWait = (d->threadData->canWaitLocked()
+                          && !d->interrupt.load()
+                          && (flags & QEventLoop::WaitForMoreEvents));
+
+    if (canWait)
+        emit aboutToBlock();
+
+    if (!d->interrupt.load()) {
+        // the timerfd wakes us up for the next timer, so we only pass a
+        // timeout to epoll_wait() when we must not block at all
+        int timeout = -1;
+        timespec wait_tm = { 0l, 0l };
+        if (!(flags & QEventLoop::X11ExcludeTimers) && d->timerList.timerWait(wait_tm)) {
+            if (wait_tm.tv_sec == 0 && wait_tm.tv_nsec == 0)
+                timeout = 0;
+            else
+                d->armTimer(wait_tm);
+        } else {
+            d->disarmTimer();
+        }
+
+        if (!canWait)
+            timeout = 0;
+
+        nevents = d->doWait(flags, timeout);
+
+        // activate timers
+        if (! (flags & QEventLoop::X11ExcludeTimers)) {
+            nevents += d->timerList.activateTimers();
+        }
+    }
+    // return true if we handled events, false otherwise
+    return (nevents > 0);
+}
+
+bool QEventDispatcherEpoll::hasPendingEvents()
+{
+    extern uint qGlobalPostedEventsCount(); // from qapplication.cpp
+    return qGlobalPostedEventsCount();
+}
+
+void QEventDispatcherEpoll::wakeUp()
+{
+    Q_D(QEventDispatcherEpoll);
+    if (d->wakeUps.testAndSetAcquire(0, 1)) {
+        eventfd_t value = 1;
+        int ret;
+        EINTR_LOOP(ret, eventfd_write(d->wakeUpFd, value));
+    }
+}
+
+void QEventDispatcherEpoll::interrupt()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.store(1);
+    wakeUp();
+}
+
+void QEventDispatcherEpoll::flush()
+{ }
+
+QT_END_NAMESPACE
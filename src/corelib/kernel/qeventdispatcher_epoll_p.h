@@ -0,0 +1,144 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QEVENTDISPATCHER_EPOLL_P_H
+#define QEVENTDISPATCHER_EPOLL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "QtCore/qabstracteventdispatcher.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qvector.h"
+#include "private/qabstracteventdispatcher_p.h"
+#include "private/qtimerinfo_unix_p.h"
+
+QT_BEGIN_NAMESPACE
+
+struct QEpollSocketNotifiers
+{
+    QEpollSocketNotifiers() : events(0)
+    { notifiers[0] = notifiers[1] = notifiers[2] = 0; }
+
+    // indexed by QSocketNotifier::Type
+    QSocketNotifier *notifiers[3];
+    quint32 events;
+};
+
+class QEventDispatcherEpollPrivate;
+
+class Q_CORE_EXPORT QEventDispatcherEpoll : public QAbstractEventDispatcher
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QEventDispatcherEpoll)
+
+public:
+    enum TriggerMode {
+        LevelTriggered,
+        EdgeTriggered
+    };
+
+    explicit QEventDispatcherEpoll(QObject *parent = 0);
+    explicit QEventDispatcherEpoll(TriggerMode mode, QObject *parent = 0);
+    ~QEventDispatcherEpoll();
+
+    TriggerMode triggerMode() const;
+
+    bool processEvents(QEventLoop::ProcessEventsFlags flags) Q_DECL_OVERRIDE;
+    bool hasPendingEvents() Q_DECL_OVERRIDE;
+
+    void registerSocketNotifier(QSocketNotifier *notifier) Q_DECL_FINAL;
+    void unregisterSocketNotifier(QSocketNotifier *notifier) Q_DECL_FINAL;
+
+    void registerTimer(int timerId, int interval, Qt::TimerType timerType, QObject *object) Q_DECL_FINAL;
+    bool unregisterTimer(int timerId) Q_DECL_FINAL;
+    bool unregisterTimers(QObject *object) Q_DECL_FINAL;
+    QList<TimerInfo> registeredTimers(QObject *object) const Q_DECL_FINAL;
+
+    int remainingTime(int timerId) Q_DECL_FINAL;
+
+    void wakeUp() Q_DECL_FINAL;
+    void interrupt() Q_DECL_FINAL;
+    void flush() Q_DECL_OVERRIDE;
+};
+
+class Q_CORE_EXPORT QEventDispatcherEpollPrivate : public QAbstractEventDispatcherPrivate
+{
+    Q_DECLARE_PUBLIC(QEventDispatcherEpoll)
+
+public:
+    explicit QEventDispatcherEpollPrivate(QEventDispatcherEpoll::TriggerMode mode);
+    ~QEventDispatcherEpollPrivate();
+
+    int doWait(QEventLoop::ProcessEventsFlags flags, int timeout);
+    void armTimer(const timespec &wait);
+    void disarmTimer();
+    bool updateSocketNotifiers(int fd, QEpollSocketNotifiers &sn);
+    void markPending(const QEpollSocketNotifiers &sn, quint32 revents);
+    int activateSocketNotifiers();
+
+    QEventDispatcherEpoll::TriggerMode triggerMode;
+
+    // epollFd watches everything; controlFd only the wake-up and timer
+    // descriptors, and is used when socket notifiers are excluded
+    int epollFd;
+    int controlFd;
+    int wakeUpFd;
+    int timerFd;
+
+    // absolute deadline the timerfd is armed for, if any
+    bool timerArmed;
+    timespec armedDeadline;
+
+    QTimerInfoList timerList;
+
+    QHash<int, QEpollSocketNotifiers> socketNotifiers;
+    // descriptors epoll refuses (regular files); they are always ready
+    QVector<int> unpollableFds;
+    QVector<QSocketNotifier *> pendingNotifiers;
+
+    QAtomicInt wakeUps;
+    QAtomicInt interrupt; // bool
+};
+
+QT_END_NAMESPACE
+
+#endif // QEVENTDISPATCHER_EPOLL_P_H
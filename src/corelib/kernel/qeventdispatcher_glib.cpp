@@ -137,10 +137,11 @@ static gboolean timerSourceCheckHelper(GTimerSource *src)
         || (src->processEventsFlags & QEventLoop::X11ExcludeTimers))
         return false;
 
-    if (src->timerList.updateCurrentTime() < src->timerList.first()->timeout)
+    timespec tv = { 0l, 0l };
+    if (!src->timerList.timerWait(tv))
         return false;
 
-    return true;
+    return tv.tv_sec == 0 && tv.tv_nsec == 0;
 }
 
 static gboolean timerSourcePrepare(GSource *source, gint *timeout)
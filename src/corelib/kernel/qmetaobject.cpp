@@ -2181,6 +2181,10 @@ bool QMetaMethod::invoke(QObject *object,
                          : Qt::QueuedConnection;
     }
 
+    // there is no connection whose pending call could be updated
+    if (connectionType == Qt::CoalescedConnection)
+        connectionType = Qt::QueuedConnection;
+
 #ifdef QT_NO_THREAD
     if (connectionType == Qt::BlockingQueuedConnection) {
         connectionType = Qt::DirectConnection;
@@ -140,6 +140,20 @@ static inline QMutex *signalSlotLock(const QObject *o)
         uint(quintptr(o)) % sizeof(_q_ObjectMutexPool)/sizeof(QBasicMutex)]);
 }
 
+static QBasicMutex _q_PendingCallMutexPool[31];
+
+/**
+ * \internal
+ * mutex to be locked when accessing the pending call of a Qt::CoalescedConnection.
+ * It is never held while locking another mutex, so the queued call can be
+ * detached from any thread, with or without the post event list locked.
+ */
+static inline QMutex *pendingCallLock(const QObjectPrivate::Connection *c)
+{
+    return static_cast<QMutex *>(&_q_PendingCallMutexPool[
+        uint(quintptr(c)) % sizeof(_q_PendingCallMutexPool)/sizeof(QBasicMutex)]);
+}
+
 // ### Qt >= 5.6, remove qt_add/removeObject
 extern "C" Q_CORE_EXPORT void qt_addObject(QObject *)
 {}
@@ -240,7 +254,7 @@ QObjectPrivate::~QObjectPrivate()
         }
     }
 
-    if (postedEvents)
+    if (postedEvents || intakeEvents.load())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     threadData->deref();
@@ -271,6 +285,38 @@ static void computeOffsets(const QMetaObject *metaobject, int *signalOffset, int
     }
 }
 
+struct QSignalEmissionTable;
+
+/*
+    The emission tables of a sender, one for each signal: the table of
+    signal i is tables[i + 1], for the signals below count - 1. tables[0]
+    holds only the connections to all signals, and serves the signals above
+    that.
+
+    activate() reads the array without locking. It is only replaced, with
+    the mutex locked, when the sender turns out to have more signals than
+    the array has room for; the replaced array is kept until the vector is
+    deleted, as emissions may still be reading it.
+*/
+struct QSignalEmissionTables
+{
+    QSignalEmissionTables(int count, QSignalEmissionTables *previous)
+        : previous(previous), count(count), tables(new QAtomicPointer<QSignalEmissionTable>[count])
+    { }
+    ~QSignalEmissionTables()
+    {
+        delete [] tables;
+        delete previous;
+    }
+
+    QAtomicPointer<QSignalEmissionTable> &forSignal(int signal) const
+    { return tables[signal + 1 < count ? signal + 1 : 0]; }
+
+    QSignalEmissionTables *previous;
+    const int count;
+    QAtomicPointer<QSignalEmissionTable> *tables;
+};
+
 /*
     This vector contains the all connections from an object.
 
@@ -285,18 +331,35 @@ static void computeOffsets(const QMetaObject *metaobject, int *signalOffset, int
     Each Connection is also part of a 'senders' linked list. The mutex
     of the receiver must be locked when touching the pointers of this
     linked list.
+
+    QMetaObject::activate() does not walk the lists: it reads the
+    QSignalEmissionTable of the signal, built from them, without locking
+    the mutex.
 */
 class QObjectConnectionListVector : public QVector<QObjectPrivate::ConnectionList>
 {
 public:
-    bool orphaned; //the QObject owner of this vector has been destroyed while the vector was inUse
+    QAtomicInt orphaned; //the QObject owner of this vector has been destroyed while the vector was inUse or emitting
     bool dirty; //some Connection have been disconnected (their receiver is 0) but not removed from the list yet
     int inUse; //number of functions that are currently accessing this object or its connections
     QObjectPrivate::ConnectionList allsignals;
 
-    QObjectConnectionListVector()
-        : QVector<QObjectPrivate::ConnectionList>(), orphaned(false), dirty(false), inUse(0)
+    // snapshots of the lists read by activate(), a table is 0 until the
+    // next emission of its signal builds it
+    QAtomicPointer<QSignalEmissionTables> emissionTables;
+    // number of activate() calls that may be reading a table (published or retired)
+    QAtomicInt emitting;
+    // tables that were unpublished while an emission was running
+    QAtomicPointer<QSignalEmissionTable> retired;
+
+    explicit QObjectConnectionListVector(int signalCount)
+        : QVector<QObjectPrivate::ConnectionList>(), orphaned(0), dirty(false), inUse(0),
+          emissionTables(new QSignalEmissionTables(signalCount + 1, Q_NULLPTR))
     { }
+    ~QObjectConnectionListVector()
+    {
+        delete emissionTables.load();
+    }
 
     QObjectPrivate::ConnectionList &operator[](int at)
     {
@@ -304,8 +367,175 @@ public:
             return allsignals;
         return QVector<QObjectPrivate::ConnectionList>::operator[](at);
     }
+    const QObjectPrivate::ConnectionList &list(int signal) const
+    {
+        if (signal < 0)
+            return allsignals;
+        return at(signal);
+    }
+
+    void resizeLists(int size);
+    void unpublishTables(int signal);
+    QSignalEmissionTable *takeRetiredTables();
+    QSignalEmissionTable *invalidateTables(int signal)
+    {
+        unpublishTables(signal);
+        return takeRetiredTables();
+    }
+
+private:
+    void unpublish(QAtomicPointer<QSignalEmissionTable> &table);
+};
+
+/*
+    QSignalEmissionTable is an immutable copy of the connections of one
+    signal of a sender, followed by the connections to all signals, laid
+    out in one block so that emitting the signal reads its receivers from
+    contiguous memory.
+
+    The table holds a reference to each Connection and to its slot object,
+    so it stays valid after they are disconnected; activate() skips entries
+    whose receiver has been reset to 0.
+
+    The first emission of a signal after its list changed builds the table
+    with the mutex locked and publishes it. Connecting or disconnecting
+    unpublishes the table of that signal only (unpublishTables()), or all
+    of them for connections to all signals; an unpublished table is deleted
+    as soon as no emission is running (takeRetiredTables()), outside of the
+    mutex since destroying a slot object may lock a mutex of the pool.
+*/
+struct QSignalEmissionTable
+{
+    struct Entry
+    {
+        QObjectPrivate::Connection *connection;
+        QtPrivate::QSlotObjectBase *slotObj; // 0 unless connection->isSlotObject
+    };
+
+    QSignalEmissionTable *nextRetired;
+    int count;
+    Entry *entries;
+
+    const Entry *begin() const
+    { return entries; }
+    const Entry *end() const
+    { return entries + count; }
+
+    static QSignalEmissionTable *create(const QObjectConnectionListVector &lists, int signal);
+    static void destroy(QSignalEmissionTable *table);
 };
 
+QSignalEmissionTable *QSignalEmissionTable::create(const QObjectConnectionListVector &lists, int signal)
+{
+    // the connections of the signal come first, as they were made for it
+    const QObjectPrivate::ConnectionList *sources[] = {
+        signal >= 0 && signal < lists.count() ? &lists.at(signal) : Q_NULLPTR,
+        &lists.allsignals
+    };
+    int count = 0;
+    for (int i = 0; i < 2; ++i) {
+        if (!sources[i])
+            continue;
+        for (const QObjectPrivate::Connection *c = sources[i]->first; c; c = c->nextConnectionList) {
+            if (c->receiver.load())
+                ++count;
+        }
+    }
+
+    void *block = malloc(sizeof(QSignalEmissionTable) + count * sizeof(Entry));
+    Q_CHECK_PTR(block);
+    QSignalEmissionTable *table = static_cast<QSignalEmissionTable *>(block);
+    table->nextRetired = 0;
+    table->count = count;
+    table->entries = reinterpret_cast<Entry *>(table + 1);
+
+    Entry *e = table->entries;
+    for (int i = 0; i < 2; ++i) {
+        if (!sources[i])
+            continue;
+        for (QObjectPrivate::Connection *c = sources[i]->first; c; c = c->nextConnectionList) {
+            if (!c->receiver.load())
+                continue;
+            c->ref();
+            e->connection = c;
+            e->slotObj = 0;
+            if (c->isSlotObject) {
+                c->slotObj->ref();
+                e->slotObj = c->slotObj;
+            }
+            ++e;
+        }
+    }
+    return table;
+}
+
+// Deletes \a table and the tables retired after it.
+void QSignalEmissionTable::destroy(QSignalEmissionTable *table)
+{
+    while (table) {
+        QSignalEmissionTable *next = table->nextRetired;
+        for (Entry *e = table->entries; e != table->entries + table->count; ++e) {
+            if (e->slotObj)
+                e->slotObj->destroyIfLastRef();
+            e->connection->deref();
+        }
+        free(table);
+        table = next;
+    }
+}
+
+// Resizes the vector to hold \a size signals. The mutex of the sender must
+// be locked.
+void QObjectConnectionListVector::resizeLists(int size)
+{
+    resize(size);
+    QSignalEmissionTables *tables = emissionTables.load();
+    if (size < tables->count)
+        return;
+
+    // An emission still reading the old array finds no tables there and
+    // builds them in the new one, once it gets the mutex.
+    QSignalEmissionTables *grown = new QSignalEmissionTables(size + 1, tables);
+    for (int i = 0; i < tables->count; ++i)
+        grown->tables[i].store(tables->tables[i].fetchAndStoreRelaxed(0));
+    emissionTables.storeRelease(grown);
+}
+
+// The mutex of the sender must be locked.
+void QObjectConnectionListVector::unpublish(QAtomicPointer<QSignalEmissionTable> &table)
+{
+    if (QSignalEmissionTable *old = table.fetchAndStoreOrdered(0)) {
+        old->nextRetired = retired.load();
+        retired.store(old);
+    }
+}
+
+// Unpublishes the table of \a signal, or every table if \a signal is -1,
+// since all tables hold the connections to all signals. The mutex of the
+// sender must be locked.
+void QObjectConnectionListVector::unpublishTables(int signal)
+{
+    QSignalEmissionTables *tables = emissionTables.load();
+    if (signal >= 0) {
+        unpublish(tables->forSignal(signal));
+    } else {
+        for (int i = 0; i < tables->count; ++i)
+            unpublish(tables->tables[i]);
+    }
+}
+
+// The mutex of the sender must be locked. Returns the retired tables if
+// no emission can read them anymore; the caller deletes them with
+// QSignalEmissionTable::destroy() once the mutex is unlocked.
+QSignalEmissionTable *QObjectConnectionListVector::takeRetiredTables()
+{
+    // pairs with the emitting.ref() in activate(): either that emission
+    // is counted here, or it will not find the unpublished table
+    if (!retired.load() || emitting.fetchAndAddOrdered(0) != 0)
+        return 0;
+    return retired.fetchAndStoreRelaxed(0);
+}
+
 // Used by QAccessibleWidget
 bool QObjectPrivate::isSender(const QObject *receiver, const char *signal) const
 {
@@ -314,13 +544,13 @@ bool QObjectPrivate::isSender(const QObject *receiver, const char *signal) const
     if (signal_index < 0)
         return false;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
+    if (QObjectConnectionListVector *connectionLists = this->connectionLists.load()) {
         if (signal_index < connectionLists->count()) {
             const QObjectPrivate::Connection *c =
                 connectionLists->at(signal_index).first;
 
             while (c) {
-                if (c->receiver == receiver)
+                if (c->receiver.load() == receiver)
                     return true;
                 c = c->nextConnectionList;
             }
@@ -338,13 +568,13 @@ QObjectList QObjectPrivate::receiverList(const char *signal) const
     if (signal_index < 0)
         return returnValue;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
+    if (QObjectConnectionListVector *connectionLists = this->connectionLists.load()) {
         if (signal_index < connectionLists->count()) {
             const QObjectPrivate::Connection *c = connectionLists->at(signal_index).first;
 
             while (c) {
-                if (c->receiver)
-                    returnValue << c->receiver;
+                if (c->receiver.load())
+                    returnValue << c->receiver.load();
                 c = c->nextConnectionList;
             }
         }
@@ -375,10 +605,15 @@ QObjectList QObjectPrivate::senderList() const
 void QObjectPrivate::addConnection(int signal, Connection *c)
 {
     Q_ASSERT(c->sender == q_ptr);
-    if (!connectionLists)
-        connectionLists = new QObjectConnectionListVector();
+    QObjectConnectionListVector *connectionLists = this->connectionLists.load();
+    if (!connectionLists) {
+        // activate() reads the pointer without locking
+        connectionLists = new QObjectConnectionListVector(
+                    QMetaObjectPrivate::absoluteSignalCount(q_ptr->metaObject()));
+        this->connectionLists.storeRelease(connectionLists);
+    }
     if (signal >= connectionLists->count())
-        connectionLists->resize(signal + 1);
+        connectionLists->resizeLists(signal + 1);
 
     ConnectionList &connectionList = (*connectionLists)[signal];
     if (connectionList.last) {
@@ -389,8 +624,13 @@ void QObjectPrivate::addConnection(int signal, Connection *c)
     connectionList.last = c;
 
     cleanConnectionLists();
+    // the next emission of the signal rebuilds its table; the retired one is
+    // deleted later, since the slot objects it references cannot be
+    // destroyed here
+    connectionLists->unpublishTables(signal);
+    c->receiverThreadData.store(QObjectPrivate::get(c->receiver.load())->threadData);
 
-    c->prev = &(QObjectPrivate::get(c->receiver)->senders);
+    c->prev = &(QObjectPrivate::get(c->receiver.load())->senders);
     c->next = *c->prev;
     *c->prev = c;
     if (c->next)
@@ -405,6 +645,7 @@ void QObjectPrivate::addConnection(int signal, Connection *c)
 
 void QObjectPrivate::cleanConnectionLists()
 {
+    QObjectConnectionListVector *connectionLists = this->connectionLists.load();
     if (connectionLists->dirty && !connectionLists->inUse) {
         // remove broken connections
         for (int signal = -1; signal < connectionLists->count(); ++signal) {
@@ -419,7 +660,7 @@ void QObjectPrivate::cleanConnectionLists()
             QObjectPrivate::Connection **prev = &connectionList.first;
             QObjectPrivate::Connection *c = *prev;
             while (c) {
-                if (c->receiver) {
+                if (c->receiver.load()) {
                     last = c;
                     prev = &c->nextConnectionList;
                     c = *prev;
@@ -447,7 +688,8 @@ QMetaCallEvent::QMetaCallEvent(ushort method_offset, ushort method_relative, QOb
                                int nargs, int *types, void **args, QSemaphore *semaphore)
     : QEvent(MetaCall), slotObj_(0), sender_(sender), signalId_(signalId),
       nargs_(nargs), types_(types), args_(args), semaphore_(semaphore),
-      callFunction_(callFunction), method_offset_(method_offset), method_relative_(method_relative)
+      callFunction_(callFunction), method_offset_(method_offset), method_relative_(method_relative),
+      connection_(0)
 { }
 
 /*!
@@ -457,7 +699,8 @@ QMetaCallEvent::QMetaCallEvent(QtPrivate::QSlotObjectBase *slotO, const QObject
                                int nargs, int *types, void **args, QSemaphore *semaphore)
     : QEvent(MetaCall), slotObj_(slotO), sender_(sender), signalId_(signalId),
       nargs_(nargs), types_(types), args_(args), semaphore_(semaphore),
-      callFunction_(0), method_offset_(0), method_relative_(ushort(-1))
+      callFunction_(0), method_offset_(0), method_relative_(ushort(-1)),
+      connection_(0)
 {
     if (slotObj_)
         slotObj_->ref();
@@ -468,6 +711,7 @@ QMetaCallEvent::QMetaCallEvent(QtPrivate::QSlotObjectBase *slotO, const QObject
  */
 QMetaCallEvent::~QMetaCallEvent()
 {
+    detachFromConnection();
     if (types_) {
         for (int i = 0; i < nargs_; ++i) {
             if (types_[i] && args_[i])
@@ -498,6 +742,42 @@ void QMetaCallEvent::placeMetaCall(QObject *object)
     }
 }
 
+/*!
+    \internal
+    Makes this event the pending call of the Qt::CoalescedConnection \a c:
+    until it is delivered, further emissions replace its arguments instead
+    of queuing another call.
+ */
+void QMetaCallEvent::attachToConnection(QObjectPrivate::Connection *c)
+{
+    Q_ASSERT(!connection_);
+    c->ref();
+    connection_ = c;
+
+    QMutexLocker locker(pendingCallLock(c));
+    Q_ASSERT(!c->pendingCall);
+    c->pendingCall = this;
+}
+
+/*!
+    \internal
+    Stops further emissions from replacing the arguments of this event. Called
+    right before the call is placed, or when the event is deleted undelivered.
+ */
+void QMetaCallEvent::detachFromConnection()
+{
+    if (!connection_)
+        return;
+
+    {
+        QMutexLocker locker(pendingCallLock(connection_));
+        if (connection_->pendingCall == this)
+            connection_->pendingCall = 0;
+    }
+    connection_->deref();
+    connection_ = 0;
+}
+
 /*!
     \class QSignalBlocker
     \brief Exception-safe wrapper around QObject::blockSignals()
@@ -928,33 +1208,33 @@ QObject::~QObject()
         d->currentSender->ref = 0;
     d->currentSender = 0;
 
-    if (d->connectionLists || d->senders) {
+    if (d->connectionLists.load() || d->senders) {
         QMutex *signalSlotMutex = signalSlotLock(this);
         QMutexLocker locker(signalSlotMutex);
 
         // disconnect all receivers
-        if (d->connectionLists) {
-            ++d->connectionLists->inUse;
-            int connectionListsCount = d->connectionLists->count();
+        if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+            ++connectionLists->inUse;
+            int connectionListsCount = connectionLists->count();
             for (int signal = -1; signal < connectionListsCount; ++signal) {
                 QObjectPrivate::ConnectionList &connectionList =
-                    (*d->connectionLists)[signal];
+                    (*connectionLists)[signal];
 
                 while (QObjectPrivate::Connection *c = connectionList.first) {
-                    if (!c->receiver) {
+                    if (!c->receiver.load()) {
                         connectionList.first = c->nextConnectionList;
                         c->deref();
                         continue;
                     }
 
-                    QMutex *m = signalSlotLock(c->receiver);
+                    QMutex *m = signalSlotLock(c->receiver.load());
                     bool needToUnlock = QOrderedMutexLocker::relock(signalSlotMutex, m);
 
-                    if (c->receiver) {
+                    if (c->receiver.load()) {
                         *c->prev = c->next;
                         if (c->next) c->next->prev = c->prev;
                     }
-                    c->receiver = 0;
+                    c->receiver.storeRelease(0);
                     if (needToUnlock)
                         m->unlock();
 
@@ -971,12 +1251,19 @@ QObject::~QObject()
                 }
             }
 
-            if (!--d->connectionLists->inUse) {
-                delete d->connectionLists;
+            QSignalEmissionTable *tables = connectionLists->invalidateTables(-1);
+            if (!--connectionLists->inUse && !connectionLists->emitting.load()) {
+                delete connectionLists;
             } else {
-                d->connectionLists->orphaned = true;
+                connectionLists->orphaned.storeRelease(1);
+            }
+            d->connectionLists.store(0);
+
+            if (tables) {
+                locker.unlock();
+                QSignalEmissionTable::destroy(tables);
+                locker.relock();
             }
-            d->connectionLists = 0;
         }
 
         /* Disconnect all senders:
@@ -1005,10 +1292,13 @@ QObject::~QObject()
                 m->unlock();
                 continue;
             }
-            node->receiver = 0;
-            QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists;
-            if (senderLists)
+            node->receiver.storeRelease(0);
+            QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists.load();
+            QSignalEmissionTable *tables = Q_NULLPTR;
+            if (senderLists) {
                 senderLists->dirty = true;
+                tables = senderLists->invalidateTables(node->signal_index);
+            }
 
             QtPrivate::QSlotObjectBase *slotObj = Q_NULLPTR;
             if (node->isSlotObject) {
@@ -1020,11 +1310,13 @@ QObject::~QObject()
             if (needToUnlock)
                 m->unlock();
 
-            if (slotObj) {
+            if (slotObj || tables) {
                 if (node)
                     node->prev = &node;
                 locker.unlock();
-                slotObj->destroyIfLastRef();
+                QSignalEmissionTable::destroy(tables);
+                if (slotObj)
+                    slotObj->destroyIfLastRef();
                 locker.relock();
             }
         }
@@ -1250,6 +1542,7 @@ bool QObject::event(QEvent *e)
     case QEvent::MetaCall:
         {
             QMetaCallEvent *mce = static_cast<QMetaCallEvent*>(e);
+            mce->detachFromConnection();
 
             QConnectionSenderSwitcher sw(this, const_cast<QObject*>(mce->sender()), mce->signalId());
 
@@ -1425,6 +1718,40 @@ QThread *QObject::thread() const
     return d_func()->threadData->thread;
 }
 
+static void moveStrandedPostedEvents(QThreadData *currentData, QThreadData *targetData)
+{
+    int eventsMoved = 0;
+    for (int i = 0; i < currentData->postEventList.size(); ++i) {
+        const QPostEvent &pe = currentData->postEventList.at(i);
+        if (!pe.event || QObjectPrivate::get(pe.receiver)->threadData == currentData)
+            continue;
+        Q_ASSERT(QObjectPrivate::get(pe.receiver)->threadData == targetData);
+        targetData->postEventList.addEvent(pe);
+        const_cast<QPostEvent &>(pe).event = 0;
+        ++eventsMoved;
+    }
+    if (eventsMoved > 0 && targetData->eventDispatcher.load()) {
+        targetData->canWait = false;
+        targetData->eventDispatcher.load()->wakeUp();
+    }
+}
+
+// Records the new thread of \a object and of its children in the connections
+// to them. This is done after the move, without the event list mutexes (a
+// sender's mutex is locked while posting): until then, QMetaObject::activate()
+// locks the sender's mutex to find out where the receiver lives.
+static void updateReceiverThreadData(QObject *object, QThreadData *targetData)
+{
+    QObjectPrivate *d = QObjectPrivate::get(object);
+    {
+        QMutexLocker locker(signalSlotLock(object));
+        for (QObjectPrivate::Connection *c = d->senders; c; c = c->next)
+            c->receiverThreadData.storeRelease(targetData);
+    }
+    for (int i = 0; i < d->children.size(); ++i)
+        updateReceiverThreadData(d->children.at(i), targetData);
+}
+
 /*!
     Changes the thread affinity for this object and its children. The
     object cannot be moved if it has a parent. Event processing will
@@ -1509,10 +1836,18 @@ void QObject::moveToThread(QThread *targetThread)
     currentData->ref();
 
     // move the object
+    currentData->postEventList.drainIntake();
     d_func()->setThreadData_helper(currentData, targetData);
 
+    // an event for one of the moved objects may have been published in the
+    // intake by a thread that read the old thread data; move it as well
+    if (currentData->postEventList.waitForAndDrainIntake())
+        moveStrandedPostedEvents(currentData, targetData);
+
     locker.unlock();
 
+    updateReceiverThreadData(this, targetData);
+
     // now currentData can commit suicide if it wants to
     currentData->deref();
 }
@@ -2422,12 +2757,12 @@ int QObject::receivers(const char *signal) const
         }
 
         QMutexLocker locker(signalSlotLock(this));
-        if (d->connectionLists) {
-            if (signal_index < d->connectionLists->count()) {
+        if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+            if (signal_index < connectionLists->count()) {
                 const QObjectPrivate::Connection *c =
-                    d->connectionLists->at(signal_index).first;
+                    connectionLists->at(signal_index).first;
                 while (c) {
-                    receivers += c->receiver ? 1 : 0;
+                    receivers += c->receiver.load() ? 1 : 0;
                     c = c->nextConnectionList;
                 }
             }
@@ -2473,12 +2808,12 @@ bool QObject::isSignalConnected(const QMetaMethod &signal) const
         return d->isSignalConnected(signalIndex);
 
     QMutexLocker locker(signalSlotLock(this));
-    if (d->connectionLists) {
-        if (signalIndex < uint(d->connectionLists->count())) {
+    if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        if (signalIndex < uint(connectionLists->count())) {
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signalIndex).first;
+                connectionLists->at(signalIndex).first;
             while (c) {
-                if (c->receiver)
+                if (c->receiver.load())
                     return true;
                 c = c->nextConnectionList;
             }
@@ -2726,7 +3061,7 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const char *sign
     }
 
     int *types = 0;
-    if ((type == Qt::QueuedConnection)
+    if ((type == Qt::QueuedConnection || type == Qt::CoalescedConnection)
             && !(types = queuedConnectionTypes(signalTypes.constData(), signalTypes.size()))) {
         return QMetaObject::Connection(0);
     }
@@ -2807,7 +3142,7 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const QMetaMetho
     }
 
     int *types = 0;
-    if ((type == Qt::QueuedConnection)
+    if ((type == Qt::QueuedConnection || type == Qt::CoalescedConnection)
             && !(types = queuedConnectionTypes(signal.parameterTypes())))
         return QMetaObject::Connection(0);
 
@@ -3250,7 +3585,7 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
                                signalSlotLock(receiver));
 
     if (type & Qt::UniqueConnection) {
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
         if (connectionLists && connectionLists->count() > signal_index) {
             const QObjectPrivate::Connection *c2 =
                 (*connectionLists)[signal_index].first;
@@ -3269,7 +3604,7 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     QScopedPointer<QObjectPrivate::Connection> c(new QObjectPrivate::Connection);
     c->sender = s;
     c->signal_index = signal_index;
-    c->receiver = r;
+    c->receiver.store(r);
     c->method_relative = method_index;
     c->method_offset = method_offset;
     c->connectionType = type;
@@ -3327,18 +3662,18 @@ bool QMetaObjectPrivate::disconnectHelper(QObjectPrivate::Connection *c,
 {
     bool success = false;
     while (c) {
-        if (c->receiver
-            && (receiver == 0 || (c->receiver == receiver
+        if (c->receiver.load()
+            && (receiver == 0 || (c->receiver.load() == receiver
                            && (method_index < 0 || (!c->isSlotObject && c->method() == method_index))
                            && (slot == 0 || (c->isSlotObject && c->slotObj->compare(slot)))))) {
             bool needToUnlock = false;
             QMutex *receiverMutex = 0;
-            if (c->receiver) {
-                receiverMutex = signalSlotLock(c->receiver);
+            if (c->receiver.load()) {
+                receiverMutex = signalSlotLock(c->receiver.load());
                 // need to relock this receiver and sender in the correct order
                 needToUnlock = QOrderedMutexLocker::relock(senderMutex, receiverMutex);
             }
-            if (c->receiver) {
+            if (c->receiver.load()) {
                 *c->prev = c->next;
                 if (c->next)
                     c->next->prev = c->prev;
@@ -3347,7 +3682,7 @@ bool QMetaObjectPrivate::disconnectHelper(QObjectPrivate::Connection *c,
             if (needToUnlock)
                 receiverMutex->unlock();
 
-            c->receiver = 0;
+            c->receiver.storeRelease(0);
 
             if (c->isSlotObject) {
                 c->isSlotObject = false;
@@ -3383,7 +3718,7 @@ bool QMetaObjectPrivate::disconnect(const QObject *sender,
     QMutex *senderMutex = signalSlotLock(sender);
     QMutexLocker locker(senderMutex);
 
-    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
     if (!connectionLists)
         return false;
 
@@ -3399,6 +3734,7 @@ bool QMetaObjectPrivate::disconnect(const QObject *sender,
             if (disconnectHelper(c, receiver, method_index, slot, senderMutex, disconnectType)) {
                 success = true;
                 connectionLists->dirty = true;
+                connectionLists->unpublishTables(sig_index);
             }
         }
     } else if (signal_index < connectionLists->count()) {
@@ -3407,15 +3743,18 @@ bool QMetaObjectPrivate::disconnect(const QObject *sender,
         if (disconnectHelper(c, receiver, method_index, slot, senderMutex, disconnectType)) {
             success = true;
             connectionLists->dirty = true;
+            connectionLists->unpublishTables(signal_index);
         }
     }
 
+    QSignalEmissionTable *tables = success ? connectionLists->takeRetiredTables() : Q_NULLPTR;
     --connectionLists->inUse;
     Q_ASSERT(connectionLists->inUse >= 0);
-    if (connectionLists->orphaned && !connectionLists->inUse)
+    if (connectionLists->orphaned.load() && !connectionLists->inUse && !connectionLists->emitting.load())
         delete connectionLists;
 
     locker.unlock();
+    QSignalEmissionTable::destroy(tables);
     if (success) {
         QMetaMethod smethod = QMetaObjectPrivate::signal(smeta, signal_index);
         if (smethod.isValid())
@@ -3568,7 +3907,7 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
             args[n] = QMetaType::create(types[n], argv[n]);
         locker.relock();
 
-        if (!c->receiver) {
+        if (!c->receiver.load()) {
             locker.unlock();
             // we have been disconnected while the mutex was unlocked
             for (int n = 1; n < nargs; ++n)
@@ -3580,10 +3919,29 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
         }
     }
 
+    if (c->connectionType == Qt::CoalescedConnection) {
+        QMutexLocker pendingLocker(pendingCallLock(c));
+        if (QMetaCallEvent *pending = c->pendingCall) {
+            // the previous emission has not been delivered yet; let it
+            // carry the latest arguments instead of queuing another call
+            args = pending->exchangeArgs(args);
+            pendingLocker.unlock();
+            locker.unlock();
+            for (int n = 1; n < nargs; ++n)
+                QMetaType::destroy(types[n], args[n]);
+            free(types);
+            free(args);
+            locker.relock();
+            return;
+        }
+    }
+
     QMetaCallEvent *ev = c->isSlotObject ?
         new QMetaCallEvent(c->slotObj, sender, signal, nargs, types, args) :
         new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal, nargs, types, args);
-    QCoreApplication::postEvent(c->receiver, ev);
+    if (c->connectionType == Qt::CoalescedConnection)
+        ev->attachToConnection(c);
+    QCoreApplication::postEvent(c->receiver.load(), ev);
 }
 
 /*!
@@ -3621,64 +3979,90 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
                                                          argv ? argv : empty_argv);
     }
 
+    // pairs with the storeRelease() in addConnection(), as this is read
+    // without the sender's mutex
+    QObjectConnectionListVector *connectionLists = sender->d_func()->connectionLists.loadAcquire();
+    if (!connectionLists) {
+        if (qt_signal_spy_callback_set.signal_end_callback != 0)
+            qt_signal_spy_callback_set.signal_end_callback(sender, signal_index);
+        return;
+    }
+
+    QMutex *senderMutex = signalSlotLock(sender);
     Qt::HANDLE currentThreadId = QThread::currentThreadId();
+    QThreadData *currentThreadData = QThreadData::current(false);
 
     {
-    QMutexLocker locker(signalSlotLock(sender));
-    struct ConnectionListsRef {
+    // The table and the connections it references stay alive as long as
+    // we are counted in emitting (see takeRetiredTables()).
+    struct EmissionRef {
         QObjectConnectionListVector *connectionLists;
-        ConnectionListsRef(QObjectConnectionListVector *connectionLists) : connectionLists(connectionLists)
+        QMutex *mutex;
+        EmissionRef(QObjectConnectionListVector *connectionLists, QMutex *mutex)
+            : connectionLists(connectionLists), mutex(mutex)
         {
-            if (connectionLists)
-                ++connectionLists->inUse;
+            connectionLists->emitting.ref();
         }
-        ~ConnectionListsRef()
+        ~EmissionRef()
         {
-            if (!connectionLists)
+            if (connectionLists->emitting.deref()
+                || (!connectionLists->retired.load() && !connectionLists->orphaned.loadAcquire()))
                 return;
 
-            --connectionLists->inUse;
-            Q_ASSERT(connectionLists->inUse >= 0);
-            if (connectionLists->orphaned) {
-                if (!connectionLists->inUse)
-                    delete connectionLists;
-            }
+            QMutexLocker locker(mutex);
+            QSignalEmissionTable *tables = connectionLists->takeRetiredTables();
+            if (connectionLists->orphaned.load() && !connectionLists->inUse && !connectionLists->emitting.load())
+                delete connectionLists;
+            locker.unlock();
+            QSignalEmissionTable::destroy(tables);
         }
-
-        QObjectConnectionListVector *operator->() const { return connectionLists; }
     };
-    ConnectionListsRef connectionLists = sender->d_func()->connectionLists;
-    if (!connectionLists.connectionLists) {
-        locker.unlock();
-        if (qt_signal_spy_callback_set.signal_end_callback != 0)
-            qt_signal_spy_callback_set.signal_end_callback(sender, signal_index);
-        return;
+    EmissionRef emission(connectionLists, senderMutex);
+    QSignalEmissionTable *table =
+            connectionLists->emissionTables.loadAcquire()->forSignal(signal_index).loadAcquire();
+    if (!table) {
+        QMutexLocker locker(senderMutex);
+        QAtomicPointer<QSignalEmissionTable> &published =
+                connectionLists->emissionTables.load()->forSignal(signal_index);
+        table = published.load();
+        if (!table) {
+            table = QSignalEmissionTable::create(*connectionLists, signal_index);
+            published.storeRelease(table);
+        }
     }
 
-    const QObjectPrivate::ConnectionList *list;
-    if (signal_index < connectionLists->count())
-        list = &connectionLists->at(signal_index);
-    else
-        list = &connectionLists->allsignals;
+    for (const QSignalEmissionTable::Entry *e = table->begin(); e != table->end(); ++e) {
+        QObjectPrivate::Connection *c = e->connection;
+        // pairs with the storeRelease() of the disconnecting thread
+        QObject *receiver = c->receiver.loadAcquire();
+        if (!receiver)
+            continue;
 
-    do {
-        QObjectPrivate::Connection *c = list->first;
-        if (!c) continue;
-        // We need to check against last here to ensure that signals added
-        // during the signal emission are not emitted in this emission.
-        QObjectPrivate::Connection *last = list->last;
-
-        do {
-            if (!c->receiver)
+        // A receiver that lives in this thread cannot be destroyed while
+        // we call it, so the sender's mutex is not needed. The receiver
+        // itself is not looked at without the mutex, as another thread may
+        // be destroying it: the thread data recorded in the connection
+        // tells where it lives. It is only out of date while the receiver
+        // is moved to this thread by another one, which makes us lock, or
+        // within moveToThread() of this thread, which does not emit there.
+        // Direct calls to other threads rely on the receiver outliving
+        // the emission anyway, so they do not lock either.
+        bool receiverInSameThread = currentThreadData
+            && c->receiverThreadData.loadAcquire() == currentThreadData;
+
+        if (c->connectionType != Qt::DirectConnection
+            && (!receiverInSameThread || c->connectionType != Qt::AutoConnection)) {
+            QMutexLocker locker(senderMutex);
+            receiver = c->receiver.load();
+            if (!receiver)
                 continue;
-
-            QObject * const receiver = c->receiver;
-            const bool receiverInSameThread = currentThreadId == receiver->d_func()->threadData->threadId;
+            receiverInSameThread = currentThreadId == receiver->d_func()->threadData->threadId;
 
             // determine if this connection should be sent immediately or
             // put into the event queue
             if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
-                || (c->connectionType == Qt::QueuedConnection)) {
+                || (c->connectionType == Qt::QueuedConnection)
+                || (c->connectionType == Qt::CoalescedConnection)) {
                 queued_activate(sender, signal_index, c, argv ? argv : empty_argv, locker);
                 continue;
 #ifndef QT_NO_THREAD
@@ -3691,75 +4075,52 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
                     receiver->metaObject()->className(), receiver);
                 }
                 QSemaphore semaphore;
-                QMetaCallEvent *ev = c->isSlotObject ?
-                    new QMetaCallEvent(c->slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
+                QMetaCallEvent *ev = e->slotObj ?
+                    new QMetaCallEvent(e->slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
                     new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore);
                 QCoreApplication::postEvent(receiver, ev);
                 semaphore.acquire();
-                locker.relock();
                 continue;
 #endif
             }
+        }
 
-            QConnectionSenderSwitcher sw;
-
-            if (receiverInSameThread) {
-                sw.switchSender(receiver, sender, signal_index);
-            }
-            const QObjectPrivate::StaticMetaCallFunction callFunction = c->callFunction;
-            const int method_relative = c->method_relative;
-            if (c->isSlotObject) {
-                c->slotObj->ref();
-                QScopedPointer<QtPrivate::QSlotObjectBase, QSlotObjectBaseDeleter> obj(c->slotObj);
-                locker.unlock();
-                obj->call(receiver, argv ? argv : empty_argv);
-
-                // Make sure the slot object gets destroyed before the mutex is locked again, as the
-                // destructor of the slot object might also lock a mutex from the signalSlotLock() mutex pool,
-                // and that would deadlock if the pool happens to return the same mutex.
-                obj.reset();
-
-                locker.relock();
-            } else if (callFunction && c->method_offset <= receiver->metaObject()->methodOffset()) {
-                //we compare the vtable to make sure we are not in the destructor of the object.
-                locker.unlock();
-                const int methodIndex = c->method();
-                if (qt_signal_spy_callback_set.slot_begin_callback != 0)
-                    qt_signal_spy_callback_set.slot_begin_callback(receiver, methodIndex, argv ? argv : empty_argv);
-
-                callFunction(receiver, QMetaObject::InvokeMetaMethod, method_relative, argv ? argv : empty_argv);
-
-                if (qt_signal_spy_callback_set.slot_end_callback != 0)
-                    qt_signal_spy_callback_set.slot_end_callback(receiver, methodIndex);
-                locker.relock();
-            } else {
-                const int method = method_relative + c->method_offset;
-                locker.unlock();
-
-                if (qt_signal_spy_callback_set.slot_begin_callback != 0) {
-                    qt_signal_spy_callback_set.slot_begin_callback(receiver,
-                                                                method,
-                                                                argv ? argv : empty_argv);
-                }
-
-                metacall(receiver, QMetaObject::InvokeMetaMethod, method, argv ? argv : empty_argv);
+        QConnectionSenderSwitcher sw;
 
-                if (qt_signal_spy_callback_set.slot_end_callback != 0)
-                    qt_signal_spy_callback_set.slot_end_callback(receiver, method);
+        if (receiverInSameThread) {
+            sw.switchSender(receiver, sender, signal_index);
+        }
+        if (e->slotObj) {
+            // the table holds a reference to the slot object
+            e->slotObj->call(receiver, argv ? argv : empty_argv);
+        } else if (c->callFunction && c->method_offset <= receiver->metaObject()->methodOffset()) {
+            //we compare the vtable to make sure we are not in the destructor of the object.
+            const int methodIndex = c->method();
+            if (qt_signal_spy_callback_set.slot_begin_callback != 0)
+                qt_signal_spy_callback_set.slot_begin_callback(receiver, methodIndex, argv ? argv : empty_argv);
+
+            c->callFunction(receiver, QMetaObject::InvokeMetaMethod, c->method_relative, argv ? argv : empty_argv);
+
+            if (qt_signal_spy_callback_set.slot_end_callback != 0)
+                qt_signal_spy_callback_set.slot_end_callback(receiver, methodIndex);
+        } else {
+            const int method = c->method_relative + c->method_offset;
 
-                locker.relock();
+            if (qt_signal_spy_callback_set.slot_begin_callback != 0) {
+                qt_signal_spy_callback_set.slot_begin_callback(receiver,
+                                                            method,
+                                                            argv ? argv : empty_argv);
             }
 
-            if (connectionLists->orphaned)
-                break;
-        } while (c != last && (c = c->nextConnectionList) != 0);
+            metacall(receiver, QMetaObject::InvokeMetaMethod, method, argv ? argv : empty_argv);
 
-        if (connectionLists->orphaned)
-            break;
-    } while (list != &connectionLists->allsignals &&
-        //start over for all signals;
-        ((list = &connectionLists->allsignals), true));
+            if (qt_signal_spy_callback_set.slot_end_callback != 0)
+                qt_signal_spy_callback_set.slot_end_callback(receiver, method);
+        }
 
+        if (connectionLists->orphaned.loadAcquire())
+            break;
+    }
     }
 
     if (qt_signal_spy_callback_set.signal_end_callback != 0)
@@ -4006,16 +4367,16 @@ void QObject::dumpObjectInfo()
     // first, look for connections where this object is the sender
     qDebug("  SIGNALS OUT");
 
-    if (d->connectionLists) {
-        for (int signal_index = 0; signal_index < d->connectionLists->count(); ++signal_index) {
+    if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        for (int signal_index = 0; signal_index < connectionLists->count(); ++signal_index) {
             const QMetaMethod signal = QMetaObjectPrivate::signal(metaObject(), signal_index);
             qDebug("        signal: %s", signal.methodSignature().constData());
 
             // receivers
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signal_index).first;
+                connectionLists->at(signal_index).first;
             while (c) {
-                if (!c->receiver) {
+                if (!c->receiver.load()) {
                     qDebug("          <Disconnected receiver>");
                     c = c->nextConnectionList;
                     continue;
@@ -4025,11 +4386,11 @@ void QObject::dumpObjectInfo()
                     c = c->nextConnectionList;
                     continue;
                 }
-                const QMetaObject *receiverMetaObject = c->receiver->metaObject();
+                const QMetaObject *receiverMetaObject = c->receiver.load()->metaObject();
                 const QMetaMethod method = receiverMetaObject->method(c->method());
                 qDebug("          --> %s::%s %s",
                        receiverMetaObject->className(),
-                       c->receiver->objectName().isEmpty() ? "unnamed" : qPrintable(c->receiver->objectName()),
+                       c->receiver.load()->objectName().isEmpty() ? "unnamed" : qPrintable(c->receiver.load()->objectName()),
                        method.methodSignature().constData());
                 c = c->nextConnectionList;
             }
@@ -4684,7 +5045,7 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
                                signalSlotLock(receiver));
 
     if (type & Qt::UniqueConnection) {
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
         if (connectionLists && connectionLists->count() > signal_index) {
             const QObjectPrivate::Connection *c2 =
                 (*connectionLists)[signal_index].first;
@@ -4703,7 +5064,7 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     QScopedPointer<QObjectPrivate::Connection> c(new QObjectPrivate::Connection);
     c->sender = s;
     c->signal_index = signal_index;
-    c->receiver = r;
+    c->receiver.store(r);
     c->slotObj = slotObj;
     c->connectionType = type;
     c->isSlotObject = true;
@@ -4735,24 +5096,27 @@ bool QObject::disconnect(const QMetaObject::Connection &connection)
 {
     QObjectPrivate::Connection *c = static_cast<QObjectPrivate::Connection *>(connection.d_ptr);
 
-    if (!c || !c->receiver)
+    if (!c || !c->receiver.load())
         return false;
 
     QMutex *senderMutex = signalSlotLock(c->sender);
-    QMutex *receiverMutex = signalSlotLock(c->receiver);
+    QMutex *receiverMutex = signalSlotLock(c->receiver.load());
 
+    QSignalEmissionTable *tables;
     {
         QOrderedMutexLocker locker(senderMutex, receiverMutex);
 
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(c->sender)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(c->sender)->connectionLists.load();
         Q_ASSERT(connectionLists);
         connectionLists->dirty = true;
 
         *c->prev = c->next;
         if (c->next)
             c->next->prev = c->prev;
-        c->receiver = 0;
+        c->receiver.storeRelease(0);
+        tables = connectionLists->invalidateTables(c->signal_index);
     }
+    QSignalEmissionTable::destroy(tables);
 
     // destroy the QSlotObject, if possible
     if (c->isSlotObject) {
@@ -4938,7 +5302,7 @@ bool QMetaObject::Connection::isConnected_helper() const
     Q_ASSERT(d_ptr);    // we're only called from operator RestrictedBool() const
     QObjectPrivate::Connection *c = static_cast<QObjectPrivate::Connection *>(d_ptr);
 
-    return c->receiver;
+    return c->receiver.load();
 }
 
 
@@ -60,6 +60,7 @@ QT_BEGIN_NAMESPACE
 class QVariant;
 class QThreadData;
 class QObjectConnectionListVector;
+class QMetaCallEvent;
 namespace QtSharedPointer { struct ExternalRefCountData; }
 
 /* for Qt Test */
@@ -120,7 +121,9 @@ public:
     struct Connection
     {
         QObject *sender;
-        QObject *receiver;
+        // written with the mutexes of the sender and of the receiver
+        // locked, read without locking by QMetaObject::activate()
+        QAtomicPointer<QObject> receiver;
         union {
             StaticMetaCallFunction callFunction;
             QtPrivate::QSlotObjectBase *slotObj;
@@ -130,15 +133,21 @@ public:
         //senders linked list
         Connection *next;
         Connection **prev;
+        // latest undelivered call of a Qt::CoalescedConnection
+        // (protected by the pending call mutex, see qobject.cpp)
+        QMetaCallEvent *pendingCall;
+        // thread data of the receiver, as last seen; only compared against,
+        // never dereferenced (see QMetaObject::activate())
+        QAtomicPointer<QThreadData> receiverThreadData;
         QAtomicPointer<const int> argumentTypes;
         QAtomicInt ref_;
         ushort method_offset;
         ushort method_relative;
         uint signal_index : 27; // In signal range (see QObjectPrivate::signalIndex())
-        ushort connectionType : 3; // 0 == auto, 1 == direct, 2 == queued, 4 == blocking
+        ushort connectionType : 3; // 0 == auto, 1 == direct, 2 == queued, 3 == blocking, 4 == coalesced
         ushort isSlotObject : 1;
         ushort ownArgumentTypes : 1;
-        Connection() : nextConnectionList(0), ref_(2), ownArgumentTypes(true) {
+        Connection() : nextConnectionList(0), pendingCall(0), ref_(2), ownArgumentTypes(true) {
             //ref_ is 2 for the use in the internal lists, and for the use in QMetaObject::Connection
         }
         ~Connection();
@@ -146,7 +155,7 @@ public:
         void ref() { ref_.ref(); }
         void deref() {
             if (!ref_.deref()) {
-                Q_ASSERT(!receiver);
+                Q_ASSERT(!receiver.load());
                 delete this;
             }
         }
@@ -219,7 +228,8 @@ public:
     ExtraData *extraData;    // extra data set by the user
     QThreadData *threadData; // id of the thread that owns the object
 
-    QObjectConnectionListVector *connectionLists;
+    // set once under the mutex, read without it by QMetaObject::activate()
+    QAtomicPointer<QObjectConnectionListVector> connectionLists;
 
     Connection *senders;     // linked list of connections connected to this object
     Sender *currentSender;   // object currently activating the object
@@ -233,6 +243,10 @@ public:
     // these objects are all used to indicate that a QObject was deleted
     // plus QPointer, which keeps a separate list
     QAtomicPointer<QtSharedPointer::ExternalRefCountData> sharedRefcount;
+
+    // posted events still in the lock-free intake of the thread's
+    // QPostEventList; they move to postedEvents when it is drained
+    QAtomicInt intakeEvents;
 };
 
 
@@ -327,7 +341,8 @@ inline QMetaObject::Connection QObjectPrivate::connect(const typename QtPrivate:
                       "Return type of the slot is not compatible with the return type of the signal.");
 
     const int *types = 0;
-    if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection)
+    if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection
+        || type == Qt::CoalescedConnection)
         types = QtPrivate::ConnectionTypes<typename SignalType::Arguments>::types();
 
     return QObject::connectImpl(sender, reinterpret_cast<void **>(&signal),
@@ -377,6 +392,10 @@ public:
 
     virtual void placeMetaCall(QObject *object);
 
+    void attachToConnection(QObjectPrivate::Connection *c);
+    void detachFromConnection();
+    void **exchangeArgs(void **args) { qSwap(args_, args); return args; }
+
 private:
     QtPrivate::QSlotObjectBase *slotObj_;
     const QObject *sender_;
@@ -388,6 +407,7 @@ private:
     QObjectPrivate::StaticMetaCallFunction callFunction_;
     ushort method_offset_;
     ushort method_relative_;
+    QObjectPrivate::Connection *connection_;
 };
 
 class QBoolBlocker
@@ -33,6 +33,7 @@
 
 #include <qelapsedtimer.h>
 #include <qcoreapplication.h>
+#include <qvarlengtharray.h>
 
 #include "private/qcore_unix_p.h"
 #include "private/qtimerinfo_unix_p.h"
@@ -46,10 +47,29 @@
 
 #include <sys/times.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
 
+static inline qint64 timespecToTick(const timespec &t)
+{
+    return qint64(t.tv_sec) * 1000 + t.tv_nsec / (1000 * 1000);
+}
+
+static inline bool timerLessThan(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    if (t1->timeout == t2->timeout)
+        return t1->sequence < t2->sequence;
+    return t1->timeout < t2->timeout;
+}
+
+static inline quint64 rotateRight(quint64 bits, uint n)
+{
+    return n ? (bits >> n) | (bits << (64 - n)) : bits;
+}
+
 /*
  * Internal functions for manipulating timer data structures.  The
  * timerBitVec array is used for keeping track of timer identifiers.
@@ -76,6 +96,14 @@ QTimerInfoList::QTimerInfoList()
     }
 #endif
 
+    memset(wheel, 0, sizeof(wheel));
+    memset(occupiedSlots, 0, sizeof(occupiedSlots));
+    wheelTime = timespecToTick(qt_gettime());
+    dueTimers = 0;
+    nextSequence = 0;
+    nextTimerInfo = 0;
+    nextTimerInfoValid = true;
+
     firstTimerInfo = 0;
 }
 
@@ -144,10 +172,20 @@ bool QTimerInfoList::timeChanged(timespec *delta)
 void QTimerInfoList::timerRepair(const timespec &diff)
 {
     // repair all timers
-    for (int i = 0; i < size(); ++i) {
-        QTimerInfo *t = at(i);
+    for (const_iterator it = begin(); it != end(); ++it) {
+        QTimerInfo *t = *it;
         t->timeout = t->timeout + diff;
     }
+
+    // and rebuild the wheel around the new time
+    memset(wheel, 0, sizeof(wheel));
+    memset(occupiedSlots, 0, sizeof(occupiedSlots));
+    wheelTime = timespecToTick(currentTime);
+    dueTimers = 0;
+    for (const_iterator it = begin(); it != end(); ++it)
+        linkTimer(*it);
+    nextTimerInfo = 0;
+    nextTimerInfoValid = false;
 }
 
 void QTimerInfoList::repairTimersIfNeeded()
@@ -168,17 +206,196 @@ void QTimerInfoList::repairTimersIfNeeded()
 #endif
 
 /*
-  insert timer info into list
+  put a timer into the wheel slot for its timeout
 */
-void QTimerInfoList::timerInsert(QTimerInfo *ti)
+void QTimerInfoList::linkTimer(QTimerInfo *t)
+{
+    // timers that are already due go into the slot of the current
+    // millisecond, the ones too far away into the last slot of the top level
+    qint64 delta = qMax(timespecToTick(t->timeout) - wheelTime, Q_INT64_C(0));
+    delta = qMin(delta, (Q_INT64_C(1) << (WheelBits * WheelLevels)) - 1);
+    const qint64 tick = wheelTime + delta;
+
+    int level = 0;
+    while (delta >= WheelSize) {
+        delta >>= WheelBits;
+        ++level;
+    }
+    const int index = int(tick >> (level * WheelBits)) & (WheelSize - 1);
+
+    t->slot = level * WheelSize + index;
+    t->prev = &wheel[t->slot];
+    t->next = wheel[t->slot];
+    if (t->next)
+        t->next->prev = &t->next;
+    wheel[t->slot] = t;
+    occupiedSlots[level] |= Q_UINT64_C(1) << index;
+}
+
+/*
+  take a timer out of its wheel slot or out of the due list
+*/
+void QTimerInfoList::unlinkTimer(QTimerInfo *t)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
+    *t->prev = t->next;
+    if (t->next)
+        t->next->prev = t->prev;
+    if (t->slot >= 0 && !wheel[t->slot])
+        occupiedSlots[t->slot / WheelSize] &= ~(Q_UINT64_C(1) << (t->slot % WheelSize));
+    if (t == nextTimerInfo) {
+        nextTimerInfo = 0;
+        nextTimerInfoValid = false;
+    }
+}
+
+/*
+  move the timers of the slots starting at this millisecond one level down;
+  the wheel must have been turned to it already
+*/
+void QTimerInfoList::cascadeTimers(qint64 tick)
+{
+    for (int level = 1; level < WheelLevels; ++level) {
+        const int shift = level * WheelBits;
+        if (tick & ((Q_INT64_C(1) << shift) - 1))
             break;
+        const int index = int(tick >> shift) & (WheelSize - 1);
+        QTimerInfo *t = wheel[level * WheelSize + index];
+        wheel[level * WheelSize + index] = 0;
+        occupiedSlots[level] &= ~(Q_UINT64_C(1) << index);
+        while (t) {
+            QTimerInfo *next = t->next;
+            linkTimer(t);
+            t = next;
+        }
+    }
+}
+
+/*
+  turn the wheel to currentTime, moving the timers that have expired to the
+  due list
+*/
+void QTimerInfoList::collectExpiredTimers(const timespec &currentTime)
+{
+    QVarLengthArray<QTimerInfo *, 32> expired;
+    const qint64 currentTick = timespecToTick(currentTime);
+
+    // all timers in the slots of the past milliseconds have expired
+    while (wheelTime < currentTick) {
+        const int index = int(wheelTime) & (WheelSize - 1);
+        for (QTimerInfo *t = wheel[index]; t; t = t->next)
+            expired.append(t);
+        wheel[index] = 0;
+        occupiedSlots[0] &= ~(Q_UINT64_C(1) << index);
+
+        // skip ahead to the next millisecond that has either timers of its
+        // own or a slot to cascade
+        qint64 next = currentTick;
+        for (int level = 0; level < WheelLevels; ++level) {
+            const int shift = level * WheelBits;
+            const qint64 first = (wheelTime >> shift) + 1;
+            const quint64 bits = rotateRight(occupiedSlots[level], uint(first & (WheelSize - 1)));
+            if (bits)
+                next = qMin(next, (first + qCountTrailingZeroBits(bits)) << shift);
+        }
+        wheelTime = next;
+        cascadeTimers(wheelTime);
+    }
+
+    // the slot of the current millisecond may hold timers due later in it
+    QTimerInfo *t = wheel[int(wheelTime) & (WheelSize - 1)];
+    while (t) {
+        QTimerInfo *next = t->next;
+        if (!(currentTime < t->timeout)) {
+            unlinkTimer(t);
+            expired.append(t);
+        }
+        t = next;
+    }
+
+    if (expired.isEmpty())
+        return;
+    nextTimerInfo = 0;
+    nextTimerInfoValid = false;
+
+    // merge them into the due list, which is sorted like the timers were
+    // inserted one by one
+    std::sort(expired.begin(), expired.end(), timerLessThan);
+    QTimerInfo **link = &dueTimers;
+    for (int i = 0; i < expired.size(); ++i) {
+        QTimerInfo *t = expired.at(i);
+        while (*link && timerLessThan(*link, t))
+            link = &(*link)->next;
+        t->slot = -1;
+        t->prev = link;
+        t->next = *link;
+        if (t->next)
+            t->next->prev = &t->next;
+        *link = t;
+        link = &t->next;
+    }
+}
+
+/*
+  Returns the timer in the wheel that will expire first, skipping the ones
+  being activated, or null if there is none.
+*/
+QTimerInfo *QTimerInfoList::findNextTimer()
+{
+    if (nextTimerInfoValid)
+        return nextTimerInfo;
+
+    QTimerInfo *best = 0;
+    for (int level = 0; level < WheelLevels; ++level) {
+        // level 0 starts at the current millisecond, the other levels at
+        // their next slot boundary
+        const int shift = level * WheelBits;
+        const qint64 first = level ? (wheelTime >> shift) + 1 : wheelTime;
+        quint64 bits = rotateRight(occupiedSlots[level], uint(first & (WheelSize - 1)));
+        while (bits) {
+            const uint distance = qCountTrailingZeroBits(bits);
+            bits &= bits - 1;
+
+            // no timer in this slot expires before the slot starts
+            if (best && ((first + distance) << shift) > timespecToTick(best->timeout))
+                break;
+            const int index = int(first + distance) & (WheelSize - 1);
+            for (QTimerInfo *t = wheel[level * WheelSize + index]; t; t = t->next) {
+                if (!t->activateRef && (!best || timerLessThan(t, best)))
+                    best = t;
+            }
+        }
+    }
+
+    nextTimerInfo = best;
+    nextTimerInfoValid = true;
+    return best;
+}
+
+/*
+  keep the next timer up to date after t's activateRef has changed
+*/
+void QTimerInfoList::timerActivationChanged(QTimerInfo *t)
+{
+    if (t->slot < 0 || !nextTimerInfoValid)
+        return;
+    if (t->activateRef) {
+        if (t == nextTimerInfo)
+            nextTimerInfoValid = false;
+    } else if (!nextTimerInfo || timerLessThan(t, nextTimerInfo)) {
+        nextTimerInfo = t;
     }
-    insert(index+1, ti);
+}
+
+/*
+  insert timer info into the wheel
+*/
+void QTimerInfoList::timerInsert(QTimerInfo *ti)
+{
+    ti->sequence = nextSequence++;
+    linkTimer(ti);
+    if (nextTimerInfoValid && !ti->activateRef
+        && (!nextTimerInfo || timerLessThan(ti, nextTimerInfo)))
+        nextTimerInfo = ti;
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -383,12 +600,14 @@ bool QTimerInfoList::timerWait(timespec &tm)
 
     // Find first waiting timer not already active
     QTimerInfo *t = 0;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
+    for (QTimerInfo *due = dueTimers; due; due = due->next) {
+        if (!due->activateRef) {
+            t = due;
             break;
         }
     }
+    if (!t)
+        t = findNextTimer();
 
     if (!t)
       return false;
@@ -416,16 +635,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timers.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -444,6 +660,10 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     t->timerType = timerType;
     t->obj = object;
     t->activateRef = 0;
+    t->next = 0;
+    t->prev = 0;
+    t->sequence = 0;
+    t->slot = -1;
 
     timespec expected = updateCurrentTime() + interval;
 
@@ -487,6 +707,8 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
             ++t->timeout.tv_sec;
     }
 
+    timers.insert(timerId, t);
+    objectTimers.insert(object, t);
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
@@ -502,40 +724,36 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            return true;
-        }
+    QTimerInfo *t = timers.take(timerId);
+    if (!t) {
+        // id not found
+        return false;
     }
-    // id not found
-    return false;
+    objectTimers.remove(t->obj, t);
+    unlinkTimer(t);
+    if (t == firstTimerInfo)
+        firstTimerInfo = 0;
+    if (t->activateRef)
+        *(t->activateRef) = 0;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->obj == object) {
-            // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            // move back one so that we don't skip the new current item
-            --i;
-        }
+    const QList<QTimerInfo *> list = objectTimers.values(object);
+    objectTimers.remove(object);
+    for (int i = 0; i < list.count(); ++i) {
+        QTimerInfo *t = list.at(i);
+        timers.remove(t->id);
+        unlinkTimer(t);
+        if (t == firstTimerInfo)
+            firstTimerInfo = 0;
+        if (t->activateRef)
+            *(t->activateRef) = 0;
+        delete t;
     }
     return true;
 }
@@ -543,15 +761,14 @@ bool QTimerInfoList::unregisterTimers(QObject *object)
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
     QList<QAbstractEventDispatcher::TimerInfo> list;
-    for (int i = 0; i < count(); ++i) {
-        const QTimerInfo * const t = at(i);
-        if (t->obj == object) {
-            list << QAbstractEventDispatcher::TimerInfo(t->id,
-                                                        (t->timerType == Qt::VeryCoarseTimer
-                                                         ? t->interval * 1000
-                                                         : t->interval),
-                                                        t->timerType);
-        }
+    QMultiHash<QObject *, QTimerInfo *>::const_iterator it = objectTimers.constFind(object);
+    for ( ; it != objectTimers.constEnd() && it.key() == object; ++it) {
+        const QTimerInfo * const t = it.value();
+        list << QAbstractEventDispatcher::TimerInfo(t->id,
+                                                    (t->timerType == Qt::VeryCoarseTimer
+                                                     ? t->interval * 1000
+                                                     : t->interval),
+                                                    t->timerType);
     }
     return list;
 }
@@ -570,21 +787,21 @@ int QTimerInfoList::activateTimers()
     timespec currentTime = updateCurrentTime();
     // qDebug() << "Thread" << QThread::currentThreadId() << "woken up at" << currentTime;
     repairTimersIfNeeded();
-
+    collectExpiredTimers(currentTime);
 
     // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
+    for (const QTimerInfo *t = dueTimers; t; t = t->next) {
+        if (currentTime < t->timeout)
             break;
         maxCount++;
     }
 
     //fire the timers.
     while (maxCount--) {
-        if (isEmpty())
+        if (!dueTimers)
             break;
 
-        QTimerInfo *currentTimerInfo = first();
+        QTimerInfo *currentTimerInfo = dueTimers;
         if (currentTime < currentTimerInfo->timeout)
             break; // no timer has expired
 
@@ -599,7 +816,7 @@ int QTimerInfoList::activateTimers()
         }
 
         // remove from list
-        removeFirst();
+        unlinkTimer(currentTimerInfo);
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
@@ -632,12 +849,15 @@ int QTimerInfoList::activateTimers()
         if (!currentTimerInfo->activateRef) {
             // send event, but don't allow it to recurse
             currentTimerInfo->activateRef = &currentTimerInfo;
+            timerActivationChanged(currentTimerInfo);
 
             QTimerEvent e(currentTimerInfo->id);
             QCoreApplication::sendEvent(currentTimerInfo->obj, &e);
 
-            if (currentTimerInfo)
+            if (currentTimerInfo) {
                 currentTimerInfo->activateRef = 0;
+                timerActivationChanged(currentTimerInfo);
+            }
         }
     }
 
@@ -48,6 +48,7 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
 
 #include <sys/time.h> // struct timeval
 
@@ -62,6 +63,11 @@ struct QTimerInfo {
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
 
+    QTimerInfo *next; // - next timer in the same wheel slot or in the due list
+    QTimerInfo **prev; // - pointer that links to this timer
+    quint64 sequence; // - insertion order, orders timers with equal timeouts
+    int slot;         // - wheel slot, or -1 when in the due list
+
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
     float cumulativeError;
@@ -69,7 +75,17 @@ struct QTimerInfo {
 #endif
 };
 
-class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
+// The timers are kept in a hierarchical timing wheel with a resolution of
+// one millisecond: level 0 has one slot per millisecond, and each slot of a
+// level covers a whole turn of the level below it. A timer is placed on the
+// lowest level that can hold its timeout, so registering and unregistering
+// are constant-time; the slots of the higher levels are cascaded downwards as
+// the wheel turns. Coarse timers share their rounded timeouts, so they end up
+// in the same slots and expire together.
+//
+// Expired timers are moved from the wheel to the due list, which is sorted by
+// timeout and registration order, and activateTimers() fires them from there.
+class Q_CORE_EXPORT QTimerInfoList
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
     timespec previousTime;
@@ -81,12 +97,44 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     void timerRepair(const timespec &);
 #endif
 
+    enum {
+        WheelBits = 6,
+        WheelSize = 1 << WheelBits,
+        WheelLevels = 6
+    };
+
+    QHash<int, QTimerInfo *> timers;
+    QMultiHash<QObject *, QTimerInfo *> objectTimers;
+
+    QTimerInfo *wheel[WheelLevels * WheelSize];
+    quint64 occupiedSlots[WheelLevels];
+    qint64 wheelTime; // first millisecond not yet moved to the due list
+    QTimerInfo *dueTimers;
+    quint64 nextSequence;
+
+    // earliest timer in the wheel not being activated, if nextTimerInfoValid
+    QTimerInfo *nextTimerInfo;
+    bool nextTimerInfoValid;
+
+    void linkTimer(QTimerInfo *t);
+    void unlinkTimer(QTimerInfo *t);
+    void cascadeTimers(qint64 tick);
+    void collectExpiredTimers(const timespec &currentTime);
+    QTimerInfo *findNextTimer();
+    void timerActivationChanged(QTimerInfo *t);
+
     // state variables used by activateTimers()
     QTimerInfo *firstTimerInfo;
 
 public:
     QTimerInfoList();
 
+    typedef QHash<int, QTimerInfo *>::const_iterator const_iterator;
+    const_iterator begin() const { return timers.constBegin(); }
+    const_iterator end() const { return timers.constEnd(); }
+    bool isEmpty() const { return timers.isEmpty(); }
+    int size() const { return timers.size(); }
+
     timespec currentTime;
     timespec updateCurrentTime();
 
@@ -54,22 +54,40 @@ QT_BEGIN_NAMESPACE
 
 struct QReadWriteLockPrivate
 {
-    QReadWriteLockPrivate(QReadWriteLock::RecursionMode recursionMode)
-        : accessCount(0), waitingReaders(0), waitingWriters(0),
-          recursive(recursionMode == QReadWriteLock::Recursive), currentWriter(0)
+    explicit QReadWriteLockPrivate(bool isRecursive = false)
+        : readerCount(0), writerCount(0), waitingReaders(0), waitingWriters(0),
+          recursive(isRecursive), id(0), currentWriter(0)
     { }
 
     QMutex mutex;
-    QWaitCondition readerWait;
     QWaitCondition writerWait;
+    QWaitCondition readerWait;
 
-    int accessCount;
+    int readerCount;
+    int writerCount;
     int waitingReaders;
     int waitingWriters;
 
     bool recursive;
+
+    // called with the mutex locked
+    bool lockForRead(int timeout);
+    bool lockForWrite(int timeout);
+    void unlock();
+
+    // memory management: non-recursive instances are only used while the
+    // lock is contended, and come from a free list
+    int id;
+    static QReadWriteLockPrivate *allocate();
+    void release();
+
+    // recursive lock handling, called with the mutex unlocked
     Qt::HANDLE currentWriter;
     QHash<Qt::HANDLE, int> currentReaders;
+
+    bool recursiveLockForRead(int timeout);
+    bool recursiveLockForWrite(int timeout);
+    void recursiveUnlock();
 };
 
 QT_END_NAMESPACE
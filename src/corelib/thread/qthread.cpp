@@ -75,6 +75,7 @@ QThreadData::~QThreadData()
     thread = 0;
     delete t;
 
+    postEventList.drainIntake();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -87,6 +88,83 @@ QThreadData::~QThreadData()
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
+// allocates the intake ring buffer, unless another poster already did
+void QPostEventList::allocateIntake()
+{
+    if (intake.loadAcquire())
+        return;
+    IntakeSlot *ring = new IntakeSlot[IntakeSize];
+    for (uint i = 0; i < IntakeSize; ++i)
+        ring[i].sequence.store(i);
+    if (!intake.testAndSetOrdered(Q_NULLPTR, ring))
+        delete [] ring;
+}
+
+// publishes ev in the intake without locking the mutex; returns false if
+// the intake is full, in which case the event has to go through the list
+bool QPostEventList::pushIntake(const QPostEvent &ev)
+{
+    IntakeSlot *ring = intake.loadAcquire();
+    uint pos = intakeTail.load();
+    forever {
+        IntakeSlot &slot = ring[pos % IntakeSize];
+        const int diff = int(slot.sequence.loadAcquire() - pos);
+        if (diff == 0) {
+            if (intakeTail.testAndSetRelaxed(pos, pos + 1, pos)) {
+                slot.event = ev;
+                slot.sequence.storeRelease(pos + 1);
+                return true;
+            }
+        } else if (diff < 0) {
+            // the slot from the previous round has not been drained yet
+            return false;
+        } else {
+            pos = intakeTail.load();
+        }
+    }
+}
+
+// moves the events from the intake into the list, in posting order. A slot
+// that is claimed but not published yet is waited for: its poster is just
+// storing the event, and leaving the events behind it in the intake would
+// let later posts overtake them. Must be called with the mutex locked.
+bool QPostEventList::drainIntake()
+{
+    if (!hasIntake())
+        return false;
+
+    IntakeSlot *ring = intake.loadAcquire();
+    const uint end = intakeTail.load();
+    for (uint pos = intakeHead.load(); pos != end; ++pos) {
+        IntakeSlot &slot = ring[pos % IntakeSize];
+        while (slot.sequence.loadAcquire() != pos + 1) {
+#ifndef QT_NO_THREAD
+            QThread::yieldCurrentThread();
+#endif
+        }
+        QObjectPrivate *receiver = QObjectPrivate::get(slot.event.receiver);
+        ++receiver->postedEvents;
+        receiver->intakeEvents.deref();
+        addEvent(slot.event);
+        slot.sequence.storeRelease(pos + IntakeSize);
+    }
+    intakeHead.store(end);
+    return true;
+}
+
+// waits for the posters that may still publish in the intake, then drains
+// it. Used after the thread data of receivers has changed, so that no event
+// for them stays behind. Must be called with the mutex locked.
+bool QPostEventList::waitForAndDrainIntake()
+{
+#ifndef QT_NO_THREAD
+    // the ordered read pairs with the ordered increment in postEvent()
+    while (intakePosters.fetchAndAddOrdered(0) != 0)
+        QThread::yieldCurrentThread();
+#endif
+    return drainIntake();
+}
+
 void QThreadData::ref()
 {
 #ifndef QT_NO_THREAD
@@ -107,9 +107,36 @@ public:
 
     QMutex mutex;
 
+    // lock-free intake for events that need neither compression nor sorting
+    // on insertion (see QCoreApplication::postEvent()). Posters claim a slot
+    // in a ring buffer without taking the mutex; whoever holds the mutex
+    // moves the published events into the list with drainIntake().
+    struct IntakeSlot
+    {
+        QAtomicInteger<uint> sequence;
+        QPostEvent event;
+    };
+    enum { IntakeSize = 256 };
+    QAtomicPointer<IntakeSlot> intake; // allocated by the first poster
+    QAtomicInteger<uint> intakeHead; // only written with the mutex locked
+    QAtomicInteger<uint> intakeTail;
+    // number of posters currently between choosing this list and publishing
+    QAtomicInt intakePosters;
+
     inline QPostEventList()
-        : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0)
+        : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0),
+          intake(Q_NULLPTR), intakeHead(0), intakeTail(0), intakePosters(0)
     { }
+    inline ~QPostEventList()
+    { delete [] intake.load(); }
+
+    inline bool hasIntake() const
+    { return intakeHead.load() != intakeTail.load(); }
+
+    void allocateIntake();
+    bool pushIntake(const QPostEvent &ev);
+    bool drainIntake();
+    bool waitForAndDrainIntake();
 
     void addEvent(const QPostEvent &ev) {
         int priority = ev.priority;
@@ -245,7 +272,7 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postEventList.hasIntake();
     }
 
     // This class provides per-thread (by way of being a QThreadData
@@ -44,6 +44,9 @@
 #  if !defined(QT_NO_GLIB)
 #    include "../kernel/qeventdispatcher_glib_p.h"
 #  endif
+#  if defined(QT_HAVE_EPOLL)
+#    include "../kernel/qeventdispatcher_epoll_p.h"
+#  endif
 #endif
 
 #include <private/qeventdispatcher_unix_p.h>
@@ -255,15 +258,27 @@ void QThreadPrivate::createEventDispatcher(QThreadData *data)
         data->eventDispatcher.storeRelease(new QEventDispatcherCoreFoundation);
     else
         data->eventDispatcher.storeRelease(new QEventDispatcherUNIX);
-#elif !defined(QT_NO_GLIB)
+#else
+#  if defined(QT_HAVE_EPOLL)
+    bool ok = false;
+    int value = qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL", &ok);
+    if (ok && value > 0) {
+        data->eventDispatcher.storeRelease(new QEventDispatcherEpoll(value > 1 ? QEventDispatcherEpoll::EdgeTriggered
+                                                                               : QEventDispatcherEpoll::LevelTriggered));
+        data->eventDispatcher.load()->startingUp();
+        return;
+    }
+#  endif
+#  if !defined(QT_NO_GLIB)
     if (qEnvironmentVariableIsEmpty("QT_NO_GLIB")
         && qEnvironmentVariableIsEmpty("QT_NO_THREADED_GLIB")
         && QEventDispatcherGlib::versionSupported())
         data->eventDispatcher.storeRelease(new QEventDispatcherGlib);
     else
         data->eventDispatcher.storeRelease(new QEventDispatcherUNIX);
-#else
+#  else
     data->eventDispatcher.storeRelease(new QEventDispatcherUNIX);
+#  endif
 #endif
 
     data->eventDispatcher.load()->startingUp();
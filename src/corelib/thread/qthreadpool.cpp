@@ -34,6 +34,7 @@
 #include "qthreadpool.h"
 #include "qthreadpool_p.h"
 #include "qelapsedtimer.h"
+#include "qmutexpool_p.h"
 
 #include <algorithm>
 
@@ -56,8 +57,39 @@ public:
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // tasks started from this thread while the pool was busy; only this
+    // thread appends to the queue, other threads may steal from it
+    QMutex localMutex;
+    QQueue<QRunnable *> localQueue;
 };
 
+#if defined(Q_COMPILER_THREAD_LOCAL)
+static thread_local QThreadPoolThread *currentPoolThread = 0;
+#endif
+
+/*
+    Auto-deleting runnables may be started from several threads while they
+    are queued on different threads' local queues, so their reference count
+    is guarded by a mutex of its own rather than by the pool mutex.
+*/
+void QThreadPoolPrivate::refRunnable(QRunnable *runnable)
+{
+    if (runnable->autoDelete()) {
+        QMutexLocker locker(QMutexPool::globalInstanceGet(runnable));
+        ++runnable->ref;
+    }
+}
+
+// returns \c true if the caller must delete \a runnable
+bool QThreadPoolPrivate::derefRunnable(QRunnable *runnable)
+{
+    if (!runnable->autoDelete())
+        return false;
+    QMutexLocker locker(QMutexPool::globalInstanceGet(runnable));
+    return !--runnable->ref;
+}
+
 /*
     QThreadPool private class.
 */
@@ -75,6 +107,10 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    currentPoolThread = this;
+#endif
+
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -84,7 +120,6 @@ void QThreadPoolThread::run()
             if (r) {
                 const bool autoDelete = r->autoDelete();
 
-
                 // run the task
                 locker.unlock();
 #ifndef QT_NO_EXCEPTIONS
@@ -100,19 +135,36 @@ void QThreadPoolThread::run()
                     throw;
                 }
 #endif
-                locker.relock();
-
-                if (autoDelete && !--r->ref)
+                if (autoDelete && QThreadPoolPrivate::derefRunnable(r))
                     delete r;
+
+                // tasks this thread queued itself don't need the pool mutex
+                r = manager->takeLocalTask(this);
+                if (r)
+                    continue;
+
+                locker.relock();
             }
 
             // if too many threads are active, expire this thread
             if (manager->tooManyThreadsActive())
                 break;
 
-            r = !manager->queue.isEmpty() ? manager->queue.takeFirst().first : 0;
+            r = manager->takeQueuedTask();
+            if (!r)
+                r = manager->stealTask(this);
+            if (!r) {
+                // this thread is about to become available: tell start() to
+                // stop queueing locally, then look again for tasks queued
+                // before it noticed
+                manager->saturated.fetchAndStoreOrdered(0);
+                r = manager->stealTask(this);
+            }
         } while (r != 0);
 
+        // don't sit on tasks other threads could run
+        manager->requeueLocalTasks(this);
+
         if (manager->isExiting) {
             registerThreadInactive();
             break;
@@ -122,16 +174,21 @@ void QThreadPoolThread::run()
         bool expired = manager->tooManyThreadsActive();
         if (!expired) {
             manager->waitingThreads.enqueue(this);
+            manager->idleThreadCount.ref();
             registerThreadInactive();
             // wait for work, exiting after the expiry timeout is reached
             runnableReady.wait(locker.mutex(), manager->expiryTimeout);
             ++manager->activeThreads;
-            if (manager->waitingThreads.removeOne(this))
+            if (manager->waitingThreads.removeOne(this)) {
+                manager->idleThreadCount.deref();
                 expired = true;
+            }
         }
         if (expired) {
             manager->expiredThreads.enqueue(this);
             registerThreadInactive();
+            // the thread can be restarted
+            manager->saturated.fetchAndStoreOrdered(0);
             break;
         }
     }
@@ -170,7 +227,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
     if (waitingThreads.count() > 0) {
         // recycle an available thread
         enqueueTask(task);
-        waitingThreads.takeFirst()->runnableReady.wakeOne();
+        wakeWaitingThread();
         return true;
     }
 
@@ -181,8 +238,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
 
         ++activeThreads;
 
-        if (task->autoDelete())
-            ++task->ref;
+        refRunnable(task);
         thread->runnable = task;
         thread->start();
         return true;
@@ -200,8 +256,9 @@ inline bool operator<(const QPair<QRunnable *, int> &p, int priority)
 
 void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
 {
-    if (runnable->autoDelete())
-        ++runnable->ref;
+    refRunnable(runnable);
+    if (priority > 0)
+        prioritizedTaskCount.ref();
 
     // put it on the queue
     QList<QPair<QRunnable *, int> >::const_iterator begin = queue.constBegin();
@@ -221,9 +278,150 @@ int QThreadPoolPrivate::activeThreadCount() const
 
 void QThreadPoolPrivate::tryToStartMoreThreads()
 {
+    saturated.fetchAndStoreOrdered(0);
+
     // try to push tasks on the queue to any available threads
-    while (!queue.isEmpty() && tryStart(queue.first().first))
+    while (!queue.isEmpty() && tryStart(queue.first().first)) {
+        if (queue.first().second > 0)
+            prioritizedTaskCount.deref();
         queue.removeFirst();
+    }
+
+    // and then the tasks waiting on the threads' local queues
+    while (queue.isEmpty() && activeThreadCount() < maxThreadCount) {
+        QRunnable *r = stealTask(0);
+        if (!r)
+            break;
+        // tryStart() takes another reference
+        tryStart(r);
+        derefRunnable(r);
+    }
+}
+
+/*!
+    \internal
+    Removes the first task from the queue and returns it, or returns 0 if the
+    queue is empty. The pool mutex must be locked.
+*/
+QRunnable *QThreadPoolPrivate::takeQueuedTask()
+{
+    if (queue.isEmpty())
+        return 0;
+    const QPair<QRunnable *, int> task = queue.takeFirst();
+    if (task.second > 0)
+        prioritizedTaskCount.deref();
+    return task.first;
+}
+
+/*!
+    \internal
+    Wakes up the thread that has been waiting for work the longest. The pool
+    mutex must be locked and waitingThreads must not be empty.
+*/
+void QThreadPoolPrivate::wakeWaitingThread()
+{
+    idleThreadCount.deref();
+    waitingThreads.takeFirst()->runnableReady.wakeOne();
+}
+
+/*!
+    \internal
+    Queues \a runnable on the calling thread's local queue, without locking
+    the pool mutex, if the calling thread is one of this pool's threads and
+    no other thread could run the task anyway. Returns \c false if the task
+    must go through the shared queue instead, so that a thread is started or
+    woken up for it.
+
+    Local tasks are run by the owning thread once its current task returns,
+    or stolen by threads of the pool that run out of work.
+*/
+bool QThreadPoolPrivate::tryEnqueueLocal(QRunnable *runnable)
+{
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    QThreadPoolThread *thread = currentPoolThread;
+    if (!thread || thread->manager != this)
+        return false;
+
+    // while a thread can be started or woken up, the task must get it;
+    // reset() clears the flag too, so exiting pools never get here
+    if (!saturated.loadAcquire())
+        return false;
+
+    // tasks with a priority must not be overtaken by local tasks
+    if (prioritizedTaskCount.load())
+        return false;
+
+    refRunnable(runnable);
+    {
+        QMutexLocker localLocker(&thread->localMutex);
+        thread->localQueue.enqueue(runnable);
+    }
+
+    // a thread that became available in the meantime either sees the task
+    // when it looks at the local queues, or cleared the flag before that
+    if (!saturated.fetchAndAddOrdered(0) || idleThreadCount.load() > 0) {
+        QMutexLocker locker(&mutex);
+        if (!waitingThreads.isEmpty())
+            wakeWaitingThread();
+        else
+            tryToStartMoreThreads();
+    }
+    return true;
+#else
+    Q_UNUSED(runnable);
+    return false;
+#endif
+}
+
+/*!
+    \internal
+    Returns the next task from \a thread's local queue, or 0 if it is empty
+    or if prioritized tasks are waiting in the shared queue.
+*/
+QRunnable *QThreadPoolPrivate::takeLocalTask(QThreadPoolThread *thread)
+{
+    if (prioritizedTaskCount.load())
+        return 0;
+
+    QMutexLocker localLocker(&thread->localMutex);
+    return !thread->localQueue.isEmpty() ? thread->localQueue.dequeue() : 0;
+}
+
+/*!
+    \internal
+    Takes a task from the local queue of another thread of the pool, or
+    returns 0 if there is none. Threads whose queue is being used are
+    skipped. The pool mutex must be locked.
+*/
+QRunnable *QThreadPoolPrivate::stealTask(QThreadPoolThread *thief)
+{
+    for (QSet<QThreadPoolThread *>::const_iterator it = allThreads.constBegin();
+         it != allThreads.constEnd(); ++it) {
+        QThreadPoolThread *victim = *it;
+        if (victim == thief || !victim->localMutex.tryLock())
+            continue;
+        QRunnable *r = !victim->localQueue.isEmpty() ? victim->localQueue.dequeue() : 0;
+        victim->localMutex.unlock();
+        if (r)
+            return r;
+    }
+    return 0;
+}
+
+/*!
+    \internal
+    Moves the tasks left in \a thread's local queue to the shared queue. The
+    pool mutex must be locked.
+*/
+void QThreadPoolPrivate::requeueLocalTasks(QThreadPoolThread *thread)
+{
+    QMutexLocker localLocker(&thread->localMutex);
+    while (!thread->localQueue.isEmpty()) {
+        QRunnable *r = thread->localQueue.dequeue();
+        // enqueueTask() takes another reference
+        enqueueTask(r);
+        derefRunnable(r);
+    }
 }
 
 bool QThreadPoolPrivate::tooManyThreadsActive() const
@@ -242,8 +440,7 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
     allThreads.insert(thread.data());
     ++activeThreads;
 
-    if (runnable->autoDelete())
-        ++runnable->ref;
+    refRunnable(runnable);
     thread->runnable = runnable;
     thread.take()->start();
 }
@@ -256,6 +453,7 @@ void QThreadPoolPrivate::reset()
 {
     QMutexLocker locker(&mutex);
     isExiting = true;
+    saturated.fetchAndStoreOrdered(0);
 
     while (!allThreads.empty()) {
         // move the contents of the set out so that we can iterate without the lock
@@ -274,6 +472,7 @@ void QThreadPoolPrivate::reset()
     }
 
     waitingThreads.clear();
+    idleThreadCount.store(0);
     expiredThreads.clear();
 
     isExiting = false;
@@ -302,10 +501,22 @@ void QThreadPoolPrivate::clear()
     for (QList<QPair<QRunnable *, int> >::const_iterator it = queue.constBegin();
          it != queue.constEnd(); ++it) {
         QRunnable* r = it->first;
-        if (r->autoDelete() && !--r->ref)
+        if (derefRunnable(r))
             delete r;
     }
     queue.clear();
+    prioritizedTaskCount.store(0);
+
+    for (QSet<QThreadPoolThread *>::const_iterator it = allThreads.constBegin();
+         it != allThreads.constEnd(); ++it) {
+        QThreadPoolThread *thread = *it;
+        QMutexLocker localLocker(&thread->localMutex);
+        while (!thread->localQueue.isEmpty()) {
+            QRunnable *r = thread->localQueue.dequeue();
+            if (derefRunnable(r))
+                delete r;
+        }
+    }
 }
 
 /*!
@@ -324,11 +535,21 @@ bool QThreadPoolPrivate::stealRunnable(QRunnable *runnable)
 
         while (it != end) {
             if (it->first == runnable) {
+                if (it->second > 0)
+                    prioritizedTaskCount.deref();
                 queue.erase(it);
                 return true;
             }
             ++it;
         }
+
+        for (QSet<QThreadPoolThread *>::const_iterator it = allThreads.constBegin();
+             it != allThreads.constEnd(); ++it) {
+            QThreadPoolThread *thread = *it;
+            QMutexLocker localLocker(&thread->localMutex);
+            if (thread->localQueue.removeOne(runnable))
+                return true;
+        }
     }
 
     return false;
@@ -344,8 +565,7 @@ void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
 {
     if (!stealRunnable(runnable))
         return;
-    const bool autoDelete = runnable->autoDelete();
-    bool del = autoDelete && !--runnable->ref;
+    bool del = derefRunnable(runnable);
 
     runnable->run();
 
@@ -401,6 +621,14 @@ void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
     implementing time-consuming operations that are not visible to the
     QThreadPool.
 
+    A task started from one of the pool's own threads while every thread
+    is busy is queued on that thread, without locking the pool, and run
+    once its current task returns; idle threads steal such tasks. Likewise,
+    tryStart() fails without locking while every thread is busy. Other
+    calls, and a thread that finishes a task without a local one to run
+    next, still lock the pool to take work from the shared queue or to
+    wait for more.
+
     Note that QThreadPool is a low-level class for managing threads, see
     the Qt Concurrent module for higher level alternatives.
 
@@ -452,12 +680,17 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (priority == 0 && d->tryEnqueueLocal(runnable))
+        return;
+
     QMutexLocker locker(&d->mutex);
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
 
         if (!d->waitingThreads.isEmpty())
-            d->waitingThreads.takeFirst()->runnableReady.wakeOne();
+            d->wakeWaitingThread();
+        else if (!d->isExiting)
+            d->saturated.storeRelease(1);
     }
 }
 
@@ -484,10 +717,20 @@ bool QThreadPool::tryStart(QRunnable *runnable)
 
     Q_D(QThreadPool);
 
+    // Qt Concurrent calls this from every worker, over and over, to find out
+    // whether it can use one more thread: while every thread is busy, say
+    // no without the mutex. The flag is cleared before a thread becomes
+    // available, so at worst a thread that is just finishing is missed.
+    if (d->saturated.loadAcquire())
+        return false;
+
     QMutexLocker locker(&d->mutex);
 
-    if (d->allThreads.isEmpty() == false && d->activeThreadCount() >= d->maxThreadCount)
+    if (d->allThreads.isEmpty() == false && d->activeThreadCount() >= d->maxThreadCount) {
+        if (d->waitingThreads.isEmpty() && !d->isExiting)
+            d->saturated.storeRelease(1);
         return false;
+    }
 
     return d->tryStart(runnable);
 }
@@ -649,7 +892,7 @@ void QThreadPool::cancel(QRunnable *runnable)
     Q_D(QThreadPool);
     if (!d->stealRunnable(runnable))
         return;
-    if (runnable->autoDelete() && !--runnable->ref) {
+    if (QThreadPoolPrivate::derefRunnable(runnable)) {
         delete runnable;
     }
 }
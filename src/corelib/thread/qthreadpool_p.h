@@ -79,6 +79,16 @@ public:
     bool stealRunnable(QRunnable *runnable);
     void stealAndRunRunnable(QRunnable *runnable);
 
+    static void refRunnable(QRunnable *runnable);
+    static bool derefRunnable(QRunnable *runnable);
+
+    QRunnable *takeQueuedTask();
+    void wakeWaitingThread();
+    bool tryEnqueueLocal(QRunnable *runnable);
+    QRunnable *takeLocalTask(QThreadPoolThread *thread);
+    QRunnable *stealTask(QThreadPoolThread *thief);
+    void requeueLocalTasks(QThreadPoolThread *thread);
+
     mutable QMutex mutex;
     QSet<QThreadPoolThread *> allThreads;
     QQueue<QThreadPoolThread *> waitingThreads;
@@ -91,6 +101,14 @@ public:
     int maxThreadCount;
     int reservedThreads;
     int activeThreads;
+
+    // read without the mutex by the local queue fast path
+    QAtomicInt idleThreadCount;      // waitingThreads.count()
+    QAtomicInt prioritizedTaskCount; // tasks in queue with a priority above 0
+    // set by start() and tryStart() when they find every thread busy,
+    // cleared whenever a thread may become available; only the local
+    // queues and the failure path of tryStart() trust it
+    QAtomicInt saturated;
 };
 
 QT_END_NAMESPACE
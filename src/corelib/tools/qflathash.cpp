@@ -0,0 +1,612 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qflathash.h"
+#include "qalgorithms.h"
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+const QFlatHashData QFlatHashData::shared_null = { Q_REFCOUNT_INITIALIZE_STATIC, 0, 0, 0, 0, 0, 0 };
+
+/*!
+    \internal
+
+    Allocates a block for \a numBuckets buckets (a power of two) and
+    \a numSlots slots in total, with all slots empty.
+*/
+QFlatHashData *QFlatHashData::allocate(int numBuckets, int numSlots, int nodeSize, int nodeAlign, uint seed)
+{
+    Q_ASSERT(numBuckets > 0 && (numBuckets & (numBuckets - 1)) == 0);
+    Q_ASSERT(numSlots >= numBuckets);
+
+    const int alignment = qMax<int>(nodeAlign, Q_ALIGNOF(QFlatHashData));
+    const size_t hashesEnd = sizeof(QFlatHashData) + size_t(numSlots) * sizeof(uint);
+    const size_t offset = (hashesEnd + nodeAlign - 1) & ~size_t(nodeAlign - 1);
+
+    QFlatHashData *d = static_cast<QFlatHashData *>(qMallocAligned(offset + size_t(numSlots) * nodeSize,
+                                                                   alignment));
+    Q_CHECK_PTR(d);
+    d->ref.initializeOwned();
+    d->size = 0;
+    d->numBuckets = numBuckets;
+    d->numSlots = numSlots;
+    d->hashOffset = int(sizeof(QFlatHashData));
+    d->nodeOffset = int(offset);
+    d->seed = seed;
+    memset(d->hashes(), 0, size_t(numSlots) * sizeof(uint));
+    return d;
+}
+
+/*!
+    \internal
+
+    \overload
+
+    Uses the default overflow area for \a numBuckets.
+*/
+QFlatHashData *QFlatHashData::allocate(int numBuckets, int nodeSize, int nodeAlign, uint seed)
+{
+    return allocate(numBuckets, numBuckets + overflowSlots(numBuckets), nodeSize, nodeAlign, seed);
+}
+
+/*!
+    \internal
+
+    Frees the block. The nodes must have been destroyed already.
+*/
+void QFlatHashData::free(QFlatHashData *d)
+{
+    qFreeAligned(d);
+}
+
+/*!
+    \internal
+
+    Returns the number of buckets needed to hold \a size entries at a load
+    factor of at most 7/8.
+*/
+int QFlatHashData::bucketsForSize(int size)
+{
+    int buckets = 8;
+    while (buckets - buckets / 8 < size) {
+        if (buckets > (INT_MAX >> 2))
+            qBadAlloc();
+        buckets *= 2;
+    }
+    return buckets;
+}
+
+/*!
+    \internal
+
+    Returns the number of slots appended to \a numBuckets buckets so that
+    probe sequences starting in the last buckets do not have to wrap around.
+    The longest probe sequence of a Robin Hood table grows with the
+    logarithm of its size.
+*/
+int QFlatHashData::overflowSlots(int numBuckets)
+{
+    const int log2 = 31 - int(qCountLeadingZeroBits(quint32(numBuckets)));
+    return qMax(4, 2 * log2);
+}
+
+/*!
+    \class QFlatHash
+    \inmodule QtCore
+    \brief The QFlatHash class is a template class that provides an open-addressing hash table.
+    \since 5.7
+
+    \ingroup tools
+    \ingroup shared
+
+    \reentrant
+
+    QFlatHash\<Key, T\> stores (key, value) pairs and provides very fast
+    lookup of the value associated with a key. It offers the most commonly
+    used subset of the QHash API, and uses the same qHash() and
+    \c{operator==()} functions to hash and compare keys, so any key type
+    that can be used with QHash can be used with QFlatHash.
+
+    Unlike QHash, which allocates every item separately and chains colliding
+    items from a bucket array, QFlatHash stores all items in a single
+    contiguous array and resolves collisions with linear probing (using the
+    \e{Robin Hood} strategy, which keeps probe sequences short). Inserting
+    an item does not allocate memory unless the table needs to grow, and
+    looking up or iterating over items touches far fewer cache lines. This
+    makes QFlatHash a good choice for hot lookup tables with small keys and
+    values.
+
+    The price is that items are moved in memory when the table grows and
+    when other items are inserted or removed. References and iterators to
+    items are therefore invalidated by any modification of the hash, and
+    large value types are better stored in a QHash. QFlatHash does not
+    support multiple values per key.
+
+    Like all Qt containers, QFlatHash is \l{implicitly shared}.
+
+    \snippet code/src_corelib_tools_qflathash.cpp 0
+
+    Iteration order is arbitrary and may change whenever the hash is
+    modified.
+
+    \sa QHash
+*/
+
+/*! \fn QFlatHash::QFlatHash()
+
+    Constructs an empty hash.
+
+    \sa clear()
+*/
+
+/*! \fn QFlatHash::QFlatHash(std::initializer_list<std::pair<Key,T> > list)
+
+    Constructs a hash with a copy of each of the elements in the
+    initializer list \a list.
+
+    This function is only available if the program is being
+    compiled in C++11 mode.
+*/
+
+/*! \fn QFlatHash::QFlatHash(const QFlatHash &other)
+
+    Constructs a copy of \a other.
+
+    This operation occurs in \l{constant time}, because QFlatHash is
+    \l{implicitly shared}.
+*/
+
+/*! \fn QFlatHash::QFlatHash(QFlatHash &&other)
+
+    Move-constructs a QFlatHash instance, making it point at the same
+    object that \a other was pointing to.
+*/
+
+/*! \fn QFlatHash::~QFlatHash()
+
+    Destroys the hash. References to the values in the hash and all
+    iterators of this hash become invalid.
+*/
+
+/*! \fn QFlatHash &QFlatHash::operator=(const QFlatHash &other)
+
+    Assigns \a other to this hash and returns a reference to this hash.
+*/
+
+/*! \fn QFlatHash &QFlatHash::operator=(QFlatHash &&other)
+
+    Move-assigns \a other to this QFlatHash instance.
+*/
+
+/*! \fn void QFlatHash::swap(QFlatHash &other)
+
+    Swaps hash \a other with this hash. This operation is very
+    fast and never fails.
+*/
+
+/*! \fn bool QFlatHash::operator==(const QFlatHash &other) const
+
+    Returns \c true if \a other is equal to this hash; otherwise returns
+    false.
+
+    Two hashes are considered equal if they contain the same (key,
+    value) pairs.
+
+    This function requires the value type to implement \c operator==().
+*/
+
+/*! \fn bool QFlatHash::operator!=(const QFlatHash &other) const
+
+    Returns \c true if \a other is not equal to this hash; otherwise
+    returns \c false.
+*/
+
+/*! \fn int QFlatHash::size() const
+
+    Returns the number of items in the hash.
+
+    \sa isEmpty(), count()
+*/
+
+/*! \fn int QFlatHash::count() const
+
+    Same as size().
+*/
+
+/*! \fn bool QFlatHash::isEmpty() const
+
+    Returns \c true if the hash contains no items; otherwise returns
+    false.
+
+    \sa size()
+*/
+
+/*! \fn bool QFlatHash::empty() const
+
+    This function is provided for STL compatibility. It is equivalent
+    to isEmpty(), returning true if the hash is empty; otherwise
+    returns \c false.
+*/
+
+/*! \fn int QFlatHash::capacity() const
+
+    Returns the number of items the hash can hold without growing.
+
+    \sa reserve(), squeeze()
+*/
+
+/*! \fn void QFlatHash::reserve(int size)
+
+    Ensures that the hash can hold at least \a size items without
+    growing. Calling reserve() before inserting a known number of items
+    avoids moving the items repeatedly while the hash grows.
+
+    \sa capacity(), squeeze()
+*/
+
+/*! \fn void QFlatHash::squeeze()
+
+    Shrinks the hash to the smallest capacity that still holds its
+    items.
+
+    \sa reserve(), capacity()
+*/
+
+/*! \fn void QFlatHash::detach()
+
+    \internal
+
+    Detaches this hash from any other hashes with which it may share
+    data.
+*/
+
+/*! \fn bool QFlatHash::isDetached() const
+
+    \internal
+
+    Returns \c true if the hash's internal data isn't shared with any
+    other hash object; otherwise returns \c false.
+*/
+
+/*! \fn bool QFlatHash::isSharedWith(const QFlatHash &other) const
+
+    \internal
+*/
+
+/*! \fn void QFlatHash::clear()
+
+    Removes all items from the hash and releases its memory.
+
+    \sa remove()
+*/
+
+/*! \fn int QFlatHash::remove(const Key &key)
+
+    Removes the item that has the \a key from the hash. Returns 1 if
+    the item was found, 0 otherwise.
+
+    \sa clear(), take()
+*/
+
+/*! \fn T QFlatHash::take(const Key &key)
+
+    Removes the item with the \a key from the hash and returns
+    the value associated with it.
+
+    If the item does not exist in the hash, the function simply
+    returns a \l{default-constructed value}.
+
+    \sa remove()
+*/
+
+/*! \fn bool QFlatHash::contains(const Key &key) const
+
+    Returns \c true if the hash contains an item with the \a key;
+    otherwise returns \c false.
+*/
+
+/*! \fn const T QFlatHash::value(const Key &key) const
+
+    Returns the value associated with the \a key.
+
+    If the hash contains no item with the \a key, the function
+    returns a \l{default-constructed value}.
+
+    \sa contains(), operator[]()
+*/
+
+/*! \fn const T QFlatHash::value(const Key &key, const T &defaultValue) const
+    \overload
+
+    If the hash contains no item with the given \a key, the function returns
+    \a defaultValue.
+*/
+
+/*! \fn T &QFlatHash::operator[](const Key &key)
+
+    Returns the value associated with the \a key as a modifiable
+    reference.
+
+    If the hash contains no item with the \a key, the function inserts
+    a \l{default-constructed value} into the hash with the \a key, and
+    returns a reference to it. The reference is invalidated by the next
+    modification of the hash.
+
+    \sa insert(), value()
+*/
+
+/*! \fn const T QFlatHash::operator[](const Key &key) const
+
+    \overload
+
+    Same as value().
+*/
+
+/*! \fn QList<Key> QFlatHash::keys() const
+
+    Returns a list containing all the keys in the hash, in an
+    arbitrary order.
+
+    \sa values()
+*/
+
+/*! \fn QList<T> QFlatHash::values() const
+
+    Returns a list containing all the values in the hash, in an
+    arbitrary order.
+
+    \sa keys()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::begin()
+
+    Returns an \l{STL-style iterators}{STL-style iterator} pointing to the first item in
+    the hash.
+
+    \sa constBegin(), end()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::begin() const
+
+    \overload
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::cbegin() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the first item
+    in the hash.
+
+    \sa begin(), cend()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::constBegin() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the first item
+    in the hash.
+
+    \sa begin(), constEnd()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::end()
+
+    Returns an \l{STL-style iterators}{STL-style iterator} pointing to the imaginary item
+    after the last item in the hash.
+
+    \sa begin(), constEnd()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::end() const
+
+    \overload
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::cend() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the imaginary
+    item after the last item in the hash.
+
+    \sa cbegin(), end()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::constEnd() const
+
+    Returns a const \l{STL-style iterators}{STL-style iterator} pointing to the imaginary
+    item after the last item in the hash.
+
+    \sa constBegin(), end()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::erase(iterator pos)
+
+    Removes the (key, value) pair associated with the iterator \a pos
+    from the hash, and returns an iterator to the next item in the
+    hash.
+
+    Unlike other modifications, erase() keeps the remaining iterators
+    usable for continuing the iteration, so that items can be removed
+    while iterating over the hash:
+
+    \snippet code/src_corelib_tools_qflathash.cpp 1
+
+    \sa remove(), take(), find()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::insert(const Key &key, const T &value)
+
+    Inserts a new item with the \a key and a value of \a value.
+
+    If there is already an item with the \a key, that item's value
+    is replaced with \a value.
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::find(const Key &key)
+
+    Returns an iterator pointing to the item with the \a key in the
+    hash.
+
+    If the hash contains no item with the \a key, the function
+    returns end().
+
+    \sa value()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::find(const Key &key) const
+
+    \overload
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::constFind(const Key &key) const
+
+    Returns an iterator pointing to the item with the \a key in the
+    hash.
+
+    If the hash contains no item with the \a key, the function
+    returns constEnd().
+
+    \sa find()
+*/
+
+/*! \typedef QFlatHash::difference_type
+
+    Typedef for ptrdiff_t. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::key_type
+
+    Typedef for Key. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::mapped_type
+
+    Typedef for T. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::size_type
+
+    Typedef for int. Provided for STL compatibility.
+*/
+
+/*! \class QFlatHash::iterator
+    \inmodule QtCore
+    \brief The QFlatHash::iterator class provides an STL-style non-const iterator for QFlatHash.
+
+    QFlatHash\<Key, T\>::iterator allows you to iterate over a QFlatHash
+    and to modify the value (but not the key) associated with a particular
+    key. It is a forward iterator.
+
+    Iterators are invalidated by any modification of the hash other than
+    through erase() and assignments to values.
+
+    \sa QFlatHash::const_iterator
+*/
+
+/*! \class QFlatHash::const_iterator
+    \inmodule QtCore
+    \brief The QFlatHash::const_iterator class provides an STL-style const iterator for QFlatHash.
+
+    QFlatHash\<Key, T\>::const_iterator allows you to iterate over a
+    QFlatHash. It is a forward iterator.
+
+    \sa QFlatHash::iterator
+*/
+
+/*! \fn QFlatHash::iterator::iterator()
+    \fn QFlatHash::const_iterator::const_iterator()
+
+    Constructs an uninitialized iterator.
+*/
+
+/*! \fn QFlatHash::const_iterator::const_iterator(const iterator &other)
+
+    Constructs a copy of \a other.
+*/
+
+/*! \fn const Key &QFlatHash::iterator::key() const
+    \fn const Key &QFlatHash::const_iterator::key() const
+
+    Returns the current item's key.
+*/
+
+/*! \fn T &QFlatHash::iterator::value() const
+    \fn const T &QFlatHash::const_iterator::value() const
+
+    Returns the current item's value.
+*/
+
+/*! \fn T &QFlatHash::iterator::operator*() const
+    \fn const T &QFlatHash::const_iterator::operator*() const
+
+    Returns the current item's value. Same as value().
+*/
+
+/*! \fn T *QFlatHash::iterator::operator->() const
+    \fn const T *QFlatHash::const_iterator::operator->() const
+
+    Returns a pointer to the current item's value.
+*/
+
+/*! \fn bool QFlatHash::iterator::operator==(const iterator &other) const
+    \fn bool QFlatHash::const_iterator::operator==(const const_iterator &other) const
+
+    Returns \c true if \a other points to the same item as this
+    iterator; otherwise returns \c false.
+*/
+
+/*! \fn bool QFlatHash::iterator::operator!=(const iterator &other) const
+    \fn bool QFlatHash::const_iterator::operator!=(const const_iterator &other) const
+
+    Returns \c true if \a other points to a different item than this
+    iterator; otherwise returns \c false.
+*/
+
+/*! \fn QFlatHash::iterator &QFlatHash::iterator::operator++()
+    \fn QFlatHash::const_iterator &QFlatHash::const_iterator::operator++()
+
+    The prefix ++ operator (\c{++i}) advances the iterator to the
+    next item in the hash and returns an iterator to the new current
+    item.
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::iterator::operator++(int)
+    \fn QFlatHash::const_iterator QFlatHash::const_iterator::operator++(int)
+
+    \overload
+
+    The postfix ++ operator (\c{i++}) advances the iterator to the
+    next item in the hash and returns an iterator to the previously
+    current item.
+*/
+
+QT_END_NAMESPACE
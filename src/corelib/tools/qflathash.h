@@ -0,0 +1,615 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrefcount.h>
+
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+#include <initializer_list>
+#endif
+
+#include <new>
+
+QT_BEGIN_NAMESPACE
+
+struct Q_CORE_EXPORT QFlatHashData
+{
+    QtPrivate::RefCount ref;
+    int size;
+    int numBuckets;     // power of two; a key's home bucket is hash & (numBuckets - 1)
+    int numSlots;       // numBuckets plus the overflow area probes may run into
+    int hashOffset;     // byte offsets of the slot arrays from the start of the block
+    int nodeOffset;
+    uint seed;
+
+    // One entry per slot: 0 for an empty slot, otherwise the hash of the
+    // key stored there with the top bit set. Entries never wrap around,
+    // so a slot's probe distance is its index minus its home bucket.
+    inline uint *hashes() { return reinterpret_cast<uint *>(reinterpret_cast<char *>(this) + hashOffset); }
+    inline const uint *hashes() const { return reinterpret_cast<const uint *>(reinterpret_cast<const char *>(this) + hashOffset); }
+    inline void *nodes() { return reinterpret_cast<char *>(this) + nodeOffset; }
+    inline const void *nodes() const { return reinterpret_cast<const char *>(this) + nodeOffset; }
+
+    inline int nextSlot(int i) const
+    {
+        const uint *h = hashes();
+        while (++i < numSlots && !h[i]) {}
+        return i;
+    }
+
+    static QFlatHashData *allocate(int numBuckets, int numSlots, int nodeSize, int nodeAlign, uint seed);
+    static QFlatHashData *allocate(int numBuckets, int nodeSize, int nodeAlign, uint seed);
+    static void free(QFlatHashData *d);
+    static int bucketsForSize(int size);
+    static int overflowSlots(int numBuckets);
+    static uint globalSeed();
+
+    static const QFlatHashData shared_null;
+};
+
+template <class Key, class T>
+struct QFlatHashNode
+{
+    Key key;
+    T value;
+
+    inline QFlatHashNode(const Key &key0, const T &value0) : key(key0), value(value0) {}
+};
+
+template <class Key, class T>
+class QFlatHash
+{
+    typedef QFlatHashNode<Key, T> Node;
+
+    QFlatHashData *d;
+
+    static inline Node *nodes(QFlatHashData *x) { return static_cast<Node *>(x->nodes()); }
+    static inline const Node *nodes(const QFlatHashData *x) { return static_cast<const Node *>(x->nodes()); }
+    static inline QFlatHashData *allocate(int numBuckets, int numSlots, uint seed)
+    { return QFlatHashData::allocate(numBuckets, numSlots, sizeof(Node), Q_ALIGNOF(Node), seed); }
+
+    static inline uint hashOf(const Key &key, uint seed) { return qHash(key, seed) | 0x80000000U; }
+
+    int findSlot(const Key &key, uint h) const;
+    static bool placeNode(QFlatHashData *x, uint &h, Node &carry, int *placedAt);
+    static void insertNode(QFlatHashData *&x, uint h, Node &carry);
+    static QFlatHashData *rehashed(QFlatHashData *x, int numBuckets, int numSlots);
+    static void freeData(QFlatHashData *x);
+    void detach_helper();
+    void eraseSlot(int i);
+    int insertSlot(const Key &key, const T &value);
+
+public:
+    inline QFlatHash() Q_DECL_NOTHROW : d(const_cast<QFlatHashData *>(&QFlatHashData::shared_null)) { }
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    inline QFlatHash(std::initializer_list<std::pair<Key,T> > list)
+        : d(const_cast<QFlatHashData *>(&QFlatHashData::shared_null))
+    {
+        reserve(int(list.size()));
+        for (typename std::initializer_list<std::pair<Key,T> >::const_iterator it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+#endif
+    QFlatHash(const QFlatHash &other) : d(other.d) { d->ref.ref(); }
+    ~QFlatHash() { if (!d->ref.deref()) freeData(d); }
+
+    QFlatHash &operator=(const QFlatHash &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    QFlatHash(QFlatHash &&other) Q_DECL_NOTHROW : d(other.d) { other.d = const_cast<QFlatHashData *>(&QFlatHashData::shared_null); }
+    QFlatHash &operator=(QFlatHash &&other) Q_DECL_NOTHROW
+    { QFlatHash moved(std::move(other)); swap(moved); return *this; }
+#endif
+    void swap(QFlatHash &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash &other) const;
+    bool operator!=(const QFlatHash &other) const { return !(*this == other); }
+
+    inline int size() const { return d->size; }
+    inline int count() const { return d->size; }
+    inline bool isEmpty() const { return d->size == 0; }
+
+    inline int capacity() const { return d->numBuckets - d->numBuckets / 8; }
+    void reserve(int size);
+    inline void squeeze() { reserve(d->size); }
+
+    inline void detach() { if (d->ref.isShared()) detach_helper(); }
+    inline bool isDetached() const { return !d->ref.isShared(); }
+    bool isSharedWith(const QFlatHash &other) const { return d == other.d; }
+
+    void clear();
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    bool contains(const Key &key) const;
+    const T value(const Key &key) const;
+    const T value(const Key &key, const T &defaultValue) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const;
+
+    QList<Key> keys() const;
+    QList<T> values() const;
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class const_iterator;
+        friend class QFlatHash<Key, T>;
+        QFlatHashData *d;
+        int i;
+
+        inline iterator(QFlatHashData *data, int slot) : d(data), i(slot) { }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        inline iterator() : d(Q_NULLPTR), i(0) { }
+
+        inline const Key &key() const { return nodes(d)[i].key; }
+        inline T &value() const { return nodes(d)[i].value; }
+        inline T &operator*() const { return nodes(d)[i].value; }
+        inline T *operator->() const { return &nodes(d)[i].value; }
+        inline bool operator==(const iterator &o) const { return i == o.i; }
+        inline bool operator!=(const iterator &o) const { return i != o.i; }
+
+        inline iterator &operator++() { i = d->nextSlot(i); return *this; }
+        inline iterator operator++(int) { iterator r = *this; i = d->nextSlot(i); return r; }
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class iterator;
+        friend class QFlatHash<Key, T>;
+        const QFlatHashData *d;
+        int i;
+
+        inline const_iterator(const QFlatHashData *data, int slot) : d(data), i(slot) { }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() : d(Q_NULLPTR), i(0) { }
+        inline const_iterator(const iterator &o) : d(o.d), i(o.i) { }
+
+        inline const Key &key() const { return nodes(d)[i].key; }
+        inline const T &value() const { return nodes(d)[i].value; }
+        inline const T &operator*() const { return nodes(d)[i].value; }
+        inline const T *operator->() const { return &nodes(d)[i].value; }
+        inline bool operator==(const const_iterator &o) const { return i == o.i; }
+        inline bool operator!=(const const_iterator &o) const { return i != o.i; }
+
+        inline const_iterator &operator++() { i = d->nextSlot(i); return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; i = d->nextSlot(i); return r; }
+    };
+    friend class const_iterator;
+
+    // STL style
+    inline iterator begin() { detach(); return iterator(d, d->nextSlot(-1)); }
+    inline const_iterator begin() const { return const_iterator(d, d->nextSlot(-1)); }
+    inline const_iterator cbegin() const { return const_iterator(d, d->nextSlot(-1)); }
+    inline const_iterator constBegin() const { return const_iterator(d, d->nextSlot(-1)); }
+    inline iterator end() { detach(); return iterator(d, d->numSlots); }
+    inline const_iterator end() const { return const_iterator(d, d->numSlots); }
+    inline const_iterator cend() const { return const_iterator(d, d->numSlots); }
+    inline const_iterator constEnd() const { return const_iterator(d, d->numSlots); }
+
+    iterator erase(iterator it);
+    iterator insert(const Key &key, const T &value);
+    iterator find(const Key &key);
+    const_iterator find(const Key &key) const;
+    const_iterator constFind(const Key &key) const;
+
+    // STL compatibility
+    typedef T mapped_type;
+    typedef Key key_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const { return isEmpty(); }
+};
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::freeData(QFlatHashData *x)
+{
+    if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex) {
+        const uint *h = x->hashes();
+        Node *n = nodes(x);
+        for (int i = 0; i < x->numSlots; ++i) {
+            if (h[i])
+                n[i].~Node();
+        }
+    }
+    QFlatHashData::free(x);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::detach_helper()
+{
+    QFlatHashData *x;
+    if (d == &QFlatHashData::shared_null) {
+        x = QFlatHashData::allocate(QFlatHashData::bucketsForSize(0), sizeof(Node), Q_ALIGNOF(Node),
+                                    QFlatHashData::globalSeed());
+    } else {
+        // same geometry and seed, so every node keeps its slot
+        x = allocate(d->numBuckets, d->numSlots, d->seed);
+        const uint *h = d->hashes();
+        const Node *src = nodes(d);
+        Node *dst = nodes(x);
+        QT_TRY {
+            for (int i = 0; i < d->numSlots; ++i) {
+                if (h[i]) {
+                    new (dst + i) Node(src[i]);
+                    x->hashes()[i] = h[i];
+                    ++x->size;
+                }
+            }
+        } QT_CATCH(...) {
+            freeData(x);
+            QT_RETHROW;
+        }
+    }
+    if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE QFlatHash<Key, T> &QFlatHash<Key, T>::operator=(const QFlatHash &other)
+{
+    if (d != other.d) {
+        QFlatHashData *o = other.d;
+        o->ref.ref();
+        if (!d->ref.deref())
+            freeData(d);
+        d = o;
+    }
+    return *this;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::findSlot(const Key &key, uint h) const
+{
+    if (d->numBuckets == 0)
+        return -1;
+    const uint *hashes = d->hashes();
+    const Node *n = nodes(d);
+    const uint mask = uint(d->numBuckets - 1);
+    const int numSlots = d->numSlots;
+    int i = int(h & mask);
+    // Robin Hood invariant: once we meet an entry closer to its home bucket
+    // than we are to ours, the key cannot be further along
+    for (int dist = 0; i < numSlots; ++i, ++dist) {
+        const uint s = hashes[i];
+        if (s == h && n[i].key == key)
+            return i;
+        if (!s || i - int(s & mask) < dist)
+            return -1;
+    }
+    return -1;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::placeNode(QFlatHashData *x, uint &h, Node &carry, int *placedAt)
+{
+    uint *hashes = x->hashes();
+    Node *n = nodes(x);
+    const uint mask = uint(x->numBuckets - 1);
+    int i = int(h & mask);
+    for (int dist = 0; i < x->numSlots; ++i, ++dist) {
+        const uint s = hashes[i];
+        if (!s) {
+            new (n + i) Node(std::move(carry));
+            hashes[i] = h;
+            ++x->size;
+            if (*placedAt < 0)
+                *placedAt = i;
+            return true;
+        }
+        const int existing = i - int(s & mask);
+        if (existing < dist) {
+            // take the slot from the entry that is closer to home and
+            // carry that one along instead
+            qSwap(n[i], carry);
+            hashes[i] = h;
+            h = s;
+            dist = existing;
+            if (*placedAt < 0)
+                *placedAt = i;
+        }
+    }
+    // ran off the end of the overflow area; carry and h hold the entry
+    // that still needs a slot
+    return false;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::insertNode(QFlatHashData *&x, uint h, Node &carry)
+{
+    int placedAt = -1;
+    while (!placeNode(x, h, carry, &placedAt)) {
+        // A long probe sequence in a sparse table means the hash function
+        // clusters the keys; growing the overflow area is cheaper than
+        // doubling the bucket array over and over again.
+        if (x->size * 2 >= x->numBuckets)
+            x = rehashed(x, x->numBuckets * 2, 0);
+        else
+            x = rehashed(x, x->numBuckets, x->numBuckets + 2 * (x->numSlots - x->numBuckets));
+    }
+}
+
+// Moves the nodes of the unshared x into a new block and frees x.
+// A numSlots of 0 selects the default overflow area for numBuckets.
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QFlatHashData *QFlatHash<Key, T>::rehashed(QFlatHashData *x, int numBuckets, int numSlots)
+{
+    if (!numSlots)
+        numSlots = numBuckets + QFlatHashData::overflowSlots(numBuckets);
+    QFlatHashData *y = allocate(numBuckets, numSlots, x->seed);
+    uint *h = x->hashes();
+    Node *n = nodes(x);
+    for (int i = 0; i < x->numSlots; ++i) {
+        if (!h[i])
+            continue;
+        insertNode(y, h[i], n[i]);
+        n[i].~Node();
+        h[i] = 0;
+    }
+    QFlatHashData::free(x);
+    return y;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::insertSlot(const Key &key, const T &value)
+{
+    const uint h = hashOf(key, d->seed);
+    // key and value may refer to an entry of this hash: copy them before
+    // growing frees the block
+    Node carry(key, value);
+    if ((d->size + 1) * 8 > d->numBuckets * 7)
+        d = rehashed(d, QFlatHashData::bucketsForSize(d->size + 1), 0);
+
+    int placedAt = -1;
+    uint ch = h;
+    if (placeNode(d, ch, carry, &placedAt))
+        return placedAt;
+    // growing the overflow area moves the new entry again
+    const Key placedKey = placedAt < 0 ? carry.key : nodes(d)[placedAt].key;
+    insertNode(d, ch, carry);
+    return findSlot(placedKey, h);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::eraseSlot(int i)
+{
+    uint *hashes = d->hashes();
+    Node *n = nodes(d);
+    const uint mask = uint(d->numBuckets - 1);
+    n[i].~Node();
+    // backward shift: pull the following entries of the cluster one slot
+    // closer to home, so that no tombstones are needed
+    int j = i + 1;
+    while (j < d->numSlots && hashes[j] && uint(j) != (hashes[j] & mask)) {
+        new (n + i) Node(std::move(n[j]));
+        n[j].~Node();
+        hashes[i] = hashes[j];
+        i = j++;
+    }
+    hashes[i] = 0;
+    --d->size;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::clear()
+{
+    *this = QFlatHash();
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int asize)
+{
+    const int buckets = QFlatHashData::bucketsForSize(qMax(asize, d->size));
+    if (buckets == d->numBuckets || (asize <= 0 && d == &QFlatHashData::shared_null))
+        return;
+    if (d->ref.isShared())
+        detach_helper();
+    d = rehashed(d, buckets, 0);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE bool QFlatHash<Key, T>::contains(const Key &key) const
+{
+    return d->size && findSlot(key, hashOf(key, d->seed)) >= 0;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &key) const
+{
+    const int i = d->size ? findSlot(key, hashOf(key, d->seed)) : -1;
+    return i < 0 ? T() : nodes(d)[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &key, const T &defaultValue) const
+{
+    const int i = d->size ? findSlot(key, hashOf(key, d->seed)) : -1;
+    return i < 0 ? defaultValue : nodes(d)[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &key)
+{
+    detach();
+    int i = findSlot(key, hashOf(key, d->seed));
+    if (i < 0)
+        i = insertSlot(key, T());
+    return nodes(d)[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::operator[](const Key &key) const
+{
+    return value(key);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &key, const T &value)
+{
+    detach();
+    int i = findSlot(key, hashOf(key, d->seed));
+    if (i >= 0)
+        nodes(d)[i].value = value;
+    else
+        i = insertSlot(key, value);
+    return iterator(d, i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::remove(const Key &key)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return 0;
+    detach();
+    const int i = findSlot(key, hashOf(key, d->seed));
+    if (i < 0)
+        return 0;
+    eraseSlot(i);
+    return 1;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &key)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return T();
+    detach();
+    const int i = findSlot(key, hashOf(key, d->seed));
+    if (i < 0)
+        return T();
+    T t = std::move(nodes(d)[i].value);
+    eraseSlot(i);
+    return t;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(iterator it)
+{
+    if (it == iterator(d, d->numSlots))
+        return it;
+    if (d->ref.isShared()) {
+        // the iterator points into the shared block; the detached copy has
+        // the same layout, so the slot index stays valid
+        detach_helper();
+        it.d = d;
+    }
+    eraseSlot(it.i);
+    // entries only ever move towards lower slots, so the one that took
+    // this slot (if any) has not been visited yet
+    if (!d->hashes()[it.i])
+        ++it;
+    return it;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &key)
+{
+    detach();
+    const int i = findSlot(key, hashOf(key, d->seed));
+    return iterator(d, i < 0 ? d->numSlots : i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::find(const Key &key) const
+{
+    return constFind(key);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constFind(const Key &key) const
+{
+    const int i = d->size ? findSlot(key, hashOf(key, d->seed)) : -1;
+    return const_iterator(d, i < 0 ? d->numSlots : i);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator it = begin(), e = end(); it != e; ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator it = begin(), e = end(); it != e; ++it)
+        res.append(it.value());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (d == other.d)
+        return true;
+
+    for (const_iterator it = begin(), e = end(); it != e; ++it) {
+        const_iterator oit = other.constFind(it.key());
+        if (oit == other.constEnd() || !(oit.value() == it.value()))
+            return false;
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_H
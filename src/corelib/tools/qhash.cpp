@@ -41,6 +41,7 @@
 #include <stdlib.h>
 
 #include "qhash.h"
+#include "qflathash.h"
 
 #ifdef truncate
 #undef truncate
@@ -290,6 +291,17 @@ static void qt_initialize_qhash_seed()
     }
 }
 
+/*!
+    \internal
+
+    Returns the global QHash seed, initializing it if necessary.
+*/
+uint QFlatHashData::globalSeed()
+{
+    qt_initialize_qhash_seed(); // may throw
+    return uint(qt_qhash_seed.load());
+}
+
 /*! \relates QHash
     \since 5.6
 
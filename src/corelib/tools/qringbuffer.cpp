@@ -63,6 +63,30 @@ const char *QRingBuffer::readPointerAtPosition(qint64 pos, qint64 &length) const
     return 0;
 }
 
+/*!
+    \internal
+
+    Stores pointers to at most \a maxCount contiguous blocks of buffered data
+    in \a data, and their sizes in \a lengths, in reading order. Returns the
+    number of blocks stored. This allows the whole buffer to be handed to
+    a vectored write without copying it.
+*/
+int QRingBuffer::readPointers(const char **data, qint64 *lengths, int maxCount) const
+{
+    int count = 0;
+    qint64 pos = head;
+    for (int i = 0; count < maxCount && i < buffers.size(); ++i) {
+        const qint64 blockLength = (i == tailBuffer ? tail : buffers[i].size());
+        if (blockLength > pos) {
+            data[count] = buffers[i].constData() + pos;
+            lengths[count] = blockLength - pos;
+            ++count;
+        }
+        pos = 0;
+    }
+    return count;
+}
+
 void QRingBuffer::free(qint64 bytes)
 {
     Q_ASSERT(bytes <= bufferSize);
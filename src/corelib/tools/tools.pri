@@ -26,6 +26,7 @@ HEADERS +=  \
         tools/qdatetimeparser_p.h \
         tools/qdoublescanprint_p.h \
         tools/qeasingcurve.h \
+        tools/qflathash.h \
         tools/qfreelist_p.h \
         tools/qhash.h \
         tools/qhashfunctions.h \
@@ -93,6 +94,7 @@ SOURCES += \
         tools/qdatetimeparser.cpp \
         tools/qeasingcurve.cpp \
         tools/qelapsedtimer.cpp \
+        tools/qflathash.cpp \
         tools/qfreelist.cpp \
         tools/qhash.cpp \
         tools/qline.cpp \
@@ -7,8 +7,11 @@ HEADERS += \
     access/qhttpnetworkreply_p.h \
     access/qhttpnetworkconnection_p.h \
     access/qhttpnetworkconnectionchannel_p.h \
+    access/qhttpcontentdecoder_p.h \
     access/qabstractprotocolhandler_p.h \
     access/qhttpprotocolhandler_p.h \
+    access/qhpack_p.h \
+    access/qhttp2protocolhandler_p.h \
     access/qspdyprotocolhandler_p.h \
     access/qnetworkaccessauthenticationmanager_p.h \
     access/qnetworkaccessmanager.h \
@@ -36,6 +39,7 @@ HEADERS += \
     access/qnetworkdiskcache_p.h \
     access/qnetworkdiskcache.h \
     access/qhttpthreaddelegate_p.h \
+    access/qhttpconnectionpolicy.h \
     access/qhttpmultipart.h \
     access/qhttpmultipart_p.h
 
@@ -46,8 +50,11 @@ SOURCES += \
     access/qhttpnetworkreply.cpp \
     access/qhttpnetworkconnection.cpp \
     access/qhttpnetworkconnectionchannel.cpp \
+    access/qhttpcontentdecoder.cpp \
     access/qabstractprotocolhandler.cpp \
     access/qhttpprotocolhandler.cpp \
+    access/qhpack.cpp \
+    access/qhttp2protocolhandler.cpp \
     access/qspdyprotocolhandler.cpp \
     access/qnetworkaccessauthenticationmanager.cpp \
     access/qnetworkaccessmanager.cpp \
@@ -68,6 +75,7 @@ SOURCES += \
     access/qabstractnetworkcache.cpp \
     access/qnetworkdiskcache.cpp \
     access/qhttpthreaddelegate.cpp \
+    access/qhttpconnectionpolicy.cpp \
     access/qhttpmultipart.cpp
 
 mac: LIBS_PRIVATE += -framework Security
@@ -0,0 +1,592 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhpack_p.h"
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+// RFC 7541, Appendix A
+static const struct
+{
+    const char *name;
+    const char *value;
+} staticTable[QHPackTable::StaticTableSize] = {
+    { ":authority", "" },
+    { ":method", "GET" },
+    { ":method", "POST" },
+    { ":path", "/" },
+    { ":path", "/index.html" },
+    { ":scheme", "http" },
+    { ":scheme", "https" },
+    { ":status", "200" },
+    { ":status", "204" },
+    { ":status", "206" },
+    { ":status", "304" },
+    { ":status", "400" },
+    { ":status", "404" },
+    { ":status", "500" },
+    { "accept-charset", "" },
+    { "accept-encoding", "gzip, deflate" },
+    { "accept-language", "" },
+    { "accept-ranges", "" },
+    { "accept", "" },
+    { "access-control-allow-origin", "" },
+    { "age", "" },
+    { "allow", "" },
+    { "authorization", "" },
+    { "cache-control", "" },
+    { "content-disposition", "" },
+    { "content-encoding", "" },
+    { "content-language", "" },
+    { "content-length", "" },
+    { "content-location", "" },
+    { "content-range", "" },
+    { "content-type", "" },
+    { "cookie", "" },
+    { "date", "" },
+    { "etag", "" },
+    { "expect", "" },
+    { "expires", "" },
+    { "from", "" },
+    { "host", "" },
+    { "if-match", "" },
+    { "if-modified-since", "" },
+    { "if-none-match", "" },
+    { "if-range", "" },
+    { "if-unmodified-since", "" },
+    { "last-modified", "" },
+    { "link", "" },
+    { "location", "" },
+    { "max-forwards", "" },
+    { "proxy-authenticate", "" },
+    { "proxy-authorization", "" },
+    { "range", "" },
+    { "referer", "" },
+    { "refresh", "" },
+    { "retry-after", "" },
+    { "server", "" },
+    { "set-cookie", "" },
+    { "strict-transport-security", "" },
+    { "transfer-encoding", "" },
+    { "user-agent", "" },
+    { "vary", "" },
+    { "via", "" },
+    { "www-authenticate", "" }
+};
+
+// RFC 7541, Appendix B; the last entry is EOS
+static const struct
+{
+    quint32 code;
+    quint8 bitLength;
+} huffmanCodes[257] = {
+    { 0x1ff8, 13 }, { 0x7fffd8, 23 }, { 0xfffffe2, 28 }, { 0xfffffe3, 28 }, // 0
+    { 0xfffffe4, 28 }, { 0xfffffe5, 28 }, { 0xfffffe6, 28 }, { 0xfffffe7, 28 }, // 4
+    { 0xfffffe8, 28 }, { 0xffffea, 24 }, { 0x3ffffffc, 30 }, { 0xfffffe9, 28 }, // 8
+    { 0xfffffea, 28 }, { 0x3ffffffd, 30 }, { 0xfffffeb, 28 }, { 0xfffffec, 28 }, // 12
+    { 0xfffffed, 28 }, { 0xfffffee, 28 }, { 0xfffffef, 28 }, { 0xffffff0, 28 }, // 16
+    { 0xffffff1, 28 }, { 0xffffff2, 28 }, { 0x3ffffffe, 30 }, { 0xffffff3, 28 }, // 20
+    { 0xffffff4, 28 }, { 0xffffff5, 28 }, { 0xffffff6, 28 }, { 0xffffff7, 28 }, // 24
+    { 0xffffff8, 28 }, { 0xffffff9, 28 }, { 0xffffffa, 28 }, { 0xffffffb, 28 }, // 28
+    { 0x14, 6 }, { 0x3f8, 10 }, { 0x3f9, 10 }, { 0xffa, 12 }, // 32
+    { 0x1ff9, 13 }, { 0x15, 6 }, { 0xf8, 8 }, { 0x7fa, 11 }, // 36
+    { 0x3fa, 10 }, { 0x3fb, 10 }, { 0xf9, 8 }, { 0x7fb, 11 }, // 40
+    { 0xfa, 8 }, { 0x16, 6 }, { 0x17, 6 }, { 0x18, 6 }, // 44
+    { 0x0, 5 }, { 0x1, 5 }, { 0x2, 5 }, { 0x19, 6 }, // 48
+    { 0x1a, 6 }, { 0x1b, 6 }, { 0x1c, 6 }, { 0x1d, 6 }, // 52
+    { 0x1e, 6 }, { 0x1f, 6 }, { 0x5c, 7 }, { 0xfb, 8 }, // 56
+    { 0x7ffc, 15 }, { 0x20, 6 }, { 0xffb, 12 }, { 0x3fc, 10 }, // 60
+    { 0x1ffa, 13 }, { 0x21, 6 }, { 0x5d, 7 }, { 0x5e, 7 }, // 64
+    { 0x5f, 7 }, { 0x60, 7 }, { 0x61, 7 }, { 0x62, 7 }, // 68
+    { 0x63, 7 }, { 0x64, 7 }, { 0x65, 7 }, { 0x66, 7 }, // 72
+    { 0x67, 7 }, { 0x68, 7 }, { 0x69, 7 }, { 0x6a, 7 }, // 76
+    { 0x6b, 7 }, { 0x6c, 7 }, { 0x6d, 7 }, { 0x6e, 7 }, // 80
+    { 0x6f, 7 }, { 0x70, 7 }, { 0x71, 7 }, { 0x72, 7 }, // 84
+    { 0xfc, 8 }, { 0x73, 7 }, { 0xfd, 8 }, { 0x1ffb, 13 }, // 88
+    { 0x7fff0, 19 }, { 0x1ffc, 13 }, { 0x3ffc, 14 }, { 0x22, 6 }, // 92
+    { 0x7ffd, 15 }, { 0x3, 5 }, { 0x23, 6 }, { 0x4, 5 }, // 96
+    { 0x24, 6 }, { 0x5, 5 }, { 0x25, 6 }, { 0x26, 6 }, // 100
+    { 0x27, 6 }, { 0x6, 5 }, { 0x74, 7 }, { 0x75, 7 }, // 104
+    { 0x28, 6 }, { 0x29, 6 }, { 0x2a, 6 }, { 0x7, 5 }, // 108
+    { 0x2b, 6 }, { 0x76, 7 }, { 0x2c, 6 }, { 0x8, 5 }, // 112
+    { 0x9, 5 }, { 0x2d, 6 }, { 0x77, 7 }, { 0x78, 7 }, // 116
+    { 0x79, 7 }, { 0x7a, 7 }, { 0x7b, 7 }, { 0x7ffe, 15 }, // 120
+    { 0x7fc, 11 }, { 0x3ffd, 14 }, { 0x1ffd, 13 }, { 0xffffffc, 28 }, // 124
+    { 0xfffe6, 20 }, { 0x3fffd2, 22 }, { 0xfffe7, 20 }, { 0xfffe8, 20 }, // 128
+    { 0x3fffd3, 22 }, { 0x3fffd4, 22 }, { 0x3fffd5, 22 }, { 0x7fffd9, 23 }, // 132
+    { 0x3fffd6, 22 }, { 0x7fffda, 23 }, { 0x7fffdb, 23 }, { 0x7fffdc, 23 }, // 136
+    { 0x7fffdd, 23 }, { 0x7fffde, 23 }, { 0xffffeb, 24 }, { 0x7fffdf, 23 }, // 140
+    { 0xffffec, 24 }, { 0xffffed, 24 }, { 0x3fffd7, 22 }, { 0x7fffe0, 23 }, // 144
+    { 0xffffee, 24 }, { 0x7fffe1, 23 }, { 0x7fffe2, 23 }, { 0x7fffe3, 23 }, // 148
+    { 0x7fffe4, 23 }, { 0x1fffdc, 21 }, { 0x3fffd8, 22 }, { 0x7fffe5, 23 }, // 152
+    { 0x3fffd9, 22 }, { 0x7fffe6, 23 }, { 0x7fffe7, 23 }, { 0xffffef, 24 }, // 156
+    { 0x3fffda, 22 }, { 0x1fffdd, 21 }, { 0xfffe9, 20 }, { 0x3fffdb, 22 }, // 160
+    { 0x3fffdc, 22 }, { 0x7fffe8, 23 }, { 0x7fffe9, 23 }, { 0x1fffde, 21 }, // 164
+    { 0x7fffea, 23 }, { 0x3fffdd, 22 }, { 0x3fffde, 22 }, { 0xfffff0, 24 }, // 168
+    { 0x1fffdf, 21 }, { 0x3fffdf, 22 }, { 0x7fffeb, 23 }, { 0x7fffec, 23 }, // 172
+    { 0x1fffe0, 21 }, { 0x1fffe1, 21 }, { 0x3fffe0, 22 }, { 0x1fffe2, 21 }, // 176
+    { 0x7fffed, 23 }, { 0x3fffe1, 22 }, { 0x7fffee, 23 }, { 0x7fffef, 23 }, // 180
+    { 0xfffea, 20 }, { 0x3fffe2, 22 }, { 0x3fffe3, 22 }, { 0x3fffe4, 22 }, // 184
+    { 0x7ffff0, 23 }, { 0x3fffe5, 22 }, { 0x3fffe6, 22 }, { 0x7ffff1, 23 }, // 188
+    { 0x3ffffe0, 26 }, { 0x3ffffe1, 26 }, { 0xfffeb, 20 }, { 0x7fff1, 19 }, // 192
+    { 0x3fffe7, 22 }, { 0x7ffff2, 23 }, { 0x3fffe8, 22 }, { 0x1ffffec, 25 }, // 196
+    { 0x3ffffe2, 26 }, { 0x3ffffe3, 26 }, { 0x3ffffe4, 26 }, { 0x7ffffde, 27 }, // 200
+    { 0x7ffffdf, 27 }, { 0x3ffffe5, 26 }, { 0xfffff1, 24 }, { 0x1ffffed, 25 }, // 204
+    { 0x7fff2, 19 }, { 0x1fffe3, 21 }, { 0x3ffffe6, 26 }, { 0x7ffffe0, 27 }, // 208
+    { 0x7ffffe1, 27 }, { 0x3ffffe7, 26 }, { 0x7ffffe2, 27 }, { 0xfffff2, 24 }, // 212
+    { 0x1fffe4, 21 }, { 0x1fffe5, 21 }, { 0x3ffffe8, 26 }, { 0x3ffffe9, 26 }, // 216
+    { 0xffffffd, 28 }, { 0x7ffffe3, 27 }, { 0x7ffffe4, 27 }, { 0x7ffffe5, 27 }, // 220
+    { 0xfffec, 20 }, { 0xfffff3, 24 }, { 0xfffed, 20 }, { 0x1fffe6, 21 }, // 224
+    { 0x3fffe9, 22 }, { 0x1fffe7, 21 }, { 0x1fffe8, 21 }, { 0x7ffff3, 23 }, // 228
+    { 0x3fffea, 22 }, { 0x3fffeb, 22 }, { 0x1ffffee, 25 }, { 0x1ffffef, 25 }, // 232
+    { 0xfffff4, 24 }, { 0xfffff5, 24 }, { 0x3ffffea, 26 }, { 0x7ffff4, 23 }, // 236
+    { 0x3ffffeb, 26 }, { 0x7ffffe6, 27 }, { 0x3ffffec, 26 }, { 0x3ffffed, 26 }, // 240
+    { 0x7ffffe7, 27 }, { 0x7ffffe8, 27 }, { 0x7ffffe9, 27 }, { 0x7ffffea, 27 }, // 244
+    { 0x7ffffeb, 27 }, { 0xffffffe, 28 }, { 0x7ffffec, 27 }, { 0x7ffffed, 27 }, // 248
+    { 0x7ffffee, 27 }, { 0x7ffffef, 27 }, { 0x7fffff0, 27 }, { 0x3ffffee, 26 }, // 252
+    { 0x3fffffff, 30 }, // 256
+};
+
+// the code is canonical: codes of the same length are consecutive numbers,
+// assigned to the symbols in this order
+static const ushort huffmanSymbols[257] = {
+    48, 49, 50, 97, 99, 101, 105, 111, 115, 116, 32, 37,
+    45, 46, 47, 51, 52, 53, 54, 55, 56, 57, 61, 65,
+    95, 98, 100, 102, 103, 104, 108, 109, 110, 112, 114, 117,
+    58, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76,
+    77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 89,
+    106, 107, 113, 118, 119, 120, 121, 122, 38, 42, 44, 59,
+    88, 90, 33, 34, 40, 41, 63, 39, 43, 124, 35, 62,
+    0, 36, 64, 91, 93, 126, 94, 125, 60, 96, 123, 92,
+    195, 208, 128, 130, 131, 162, 184, 194, 224, 226, 153, 161,
+    167, 172, 176, 177, 179, 209, 216, 217, 227, 229, 230, 129,
+    132, 133, 134, 136, 146, 154, 156, 160, 163, 164, 169, 170,
+    173, 178, 181, 185, 186, 187, 189, 190, 196, 198, 228, 232,
+    233, 1, 135, 137, 138, 139, 140, 141, 143, 147, 149, 150,
+    151, 152, 155, 157, 158, 165, 166, 168, 174, 175, 180, 182,
+    183, 188, 191, 197, 231, 239, 9, 142, 144, 145, 148, 159,
+    171, 206, 215, 225, 236, 237, 199, 207, 234, 235, 192, 193,
+    200, 201, 202, 205, 210, 213, 218, 219, 238, 240, 242, 243,
+    255, 203, 204, 211, 212, 214, 221, 222, 223, 241, 244, 245,
+    246, 247, 248, 250, 251, 252, 253, 254, 2, 3, 4, 5,
+    6, 7, 8, 11, 12, 14, 15, 16, 17, 18, 19, 20,
+    21, 23, 24, 25, 26, 27, 28, 29, 30, 31, 127, 220,
+    249, 10, 13, 22, 256,
+};
+
+static const struct
+{
+    quint32 firstCode;
+    ushort count;
+    ushort offset; // into huffmanSymbols
+} huffmanLengths[31] = {
+    { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 },
+    { 0, 0, 0 }, { 0x0, 10, 0 }, { 0x14, 26, 10 }, { 0x5c, 32, 36 },
+    { 0xf8, 6, 68 }, { 0, 0, 0 }, { 0x3f8, 5, 74 }, { 0x7fa, 3, 79 },
+    { 0xffa, 2, 82 }, { 0x1ff8, 6, 84 }, { 0x3ffc, 2, 90 }, { 0x7ffc, 3, 92 },
+    { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0x7fff0, 3, 95 },
+    { 0xfffe6, 8, 98 }, { 0x1fffdc, 13, 106 }, { 0x3fffd2, 26, 119 }, { 0x7fffd8, 29, 145 },
+    { 0xffffea, 12, 174 }, { 0x1ffffec, 4, 186 }, { 0x3ffffe0, 15, 190 }, { 0x7ffffde, 19, 205 },
+    { 0xfffffe2, 29, 224 }, { 0, 0, 0 }, { 0x3ffffffc, 4, 253 },
+};
+
+static inline QByteArray rawData(const char *string)
+{
+    return QByteArray::fromRawData(string, int(qstrlen(string)));
+}
+
+static inline quint32 entrySize(const QByteArray &name, const QByteArray &value)
+{
+    return quint32(name.size() + value.size()) + QHPackTable::EntryOverhead;
+}
+
+// RFC 7541, 5.1: integers use an N-bit prefix in the first octet
+static void encodeInteger(QByteArray *out, uchar pattern, int prefixBits, quint32 value)
+{
+    const quint32 maximumPrefix = (1u << prefixBits) - 1;
+    if (value < maximumPrefix) {
+        out->append(char(pattern | value));
+        return;
+    }
+    out->append(char(pattern | maximumPrefix));
+    value -= maximumPrefix;
+    while (value >= 0x80) {
+        out->append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out->append(char(value));
+}
+
+static bool decodeInteger(const uchar *&pos, const uchar *end, int prefixBits, quint32 *value)
+{
+    if (pos == end)
+        return false;
+
+    const quint32 maximumPrefix = (1u << prefixBits) - 1;
+    quint64 result = *pos++ & maximumPrefix;
+    if (result < maximumPrefix) {
+        *value = quint32(result);
+        return true;
+    }
+
+    for (int shift = 0; pos != end && shift <= 28; shift += 7) {
+        const uchar octet = *pos++;
+        result += quint64(octet & 0x7f) << shift;
+        if (result > 0xffffffffu)
+            return false;
+        if (!(octet & 0x80)) {
+            *value = quint32(result);
+            return true;
+        }
+    }
+    return false; // truncated or too large
+}
+
+static int huffmanEncodedSize(const QByteArray &input)
+{
+    quint64 bits = 0;
+    for (int i = 0; i < input.size(); ++i)
+        bits += huffmanCodes[uchar(input.at(i))].bitLength;
+    return int((bits + 7) / 8);
+}
+
+namespace QHPack {
+
+QByteArray huffmanEncode(const QByteArray &input)
+{
+    QByteArray output;
+    output.reserve(huffmanEncodedSize(input));
+
+    // at most 7 pending bits plus one 30 bit code: fits into 64 bits
+    quint64 bits = 0;
+    int pendingBits = 0;
+    for (int i = 0; i < input.size(); ++i) {
+        const uchar symbol = uchar(input.at(i));
+        bits = (bits << huffmanCodes[symbol].bitLength) | huffmanCodes[symbol].code;
+        pendingBits += huffmanCodes[symbol].bitLength;
+        while (pendingBits >= 8) {
+            pendingBits -= 8;
+            output.append(char(bits >> pendingBits));
+        }
+    }
+    // pad with the most significant bits of EOS, i.e. with ones
+    if (pendingBits)
+        output.append(char((bits << (8 - pendingBits)) | (0xff >> pendingBits)));
+    return output;
+}
+
+bool huffmanDecode(const char *input, int length, QByteArray *output)
+{
+    output->reserve(output->size() + length * 8 / 5);
+
+    quint32 code = 0;
+    int codeLength = 0;
+    for (int i = 0; i < length; ++i) {
+        const uchar octet = uchar(input[i]);
+        for (int bit = 7; bit >= 0; --bit) {
+            code = (code << 1) | ((octet >> bit) & 1);
+            ++codeLength;
+
+            const quint32 offset = code - huffmanLengths[codeLength].firstCode;
+            if (code >= huffmanLengths[codeLength].firstCode
+                    && offset < huffmanLengths[codeLength].count) {
+                const ushort symbol = huffmanSymbols[huffmanLengths[codeLength].offset + offset];
+                if (symbol == 256)
+                    return false; // RFC 7541, 5.2: EOS is a decoding error
+                output->append(char(symbol));
+                code = 0;
+                codeLength = 0;
+            } else if (codeLength == 30) {
+                return false;
+            }
+        }
+    }
+
+    // the padding must be shorter than a byte and consist of ones only
+    return codeLength < 8 && code == (1u << codeLength) - 1;
+}
+
+} // namespace QHPack
+
+/*!
+    \class QHPackTable
+    \internal
+
+    The HPACK header table: the static table followed by a dynamic table
+    whose size is bounded by maximumSize().
+*/
+QHPackTable::QHPackTable(quint32 maximumSize)
+    : m_size(0), m_maximumSize(maximumSize)
+{
+}
+
+void QHPackTable::setMaximumSize(quint32 size)
+{
+    m_maximumSize = size;
+    evict(size);
+}
+
+bool QHPackTable::field(quint32 index, QHPackHeaderField *field) const
+{
+    if (index == 0)
+        return false;
+    if (index <= StaticTableSize) {
+        field->first = rawData(staticTable[index - 1].name);
+        field->second = rawData(staticTable[index - 1].value);
+        return true;
+    }
+    index -= StaticTableSize + 1;
+    if (index >= quint32(m_entries.size()))
+        return false;
+    *field = m_entries.at(index);
+    return true;
+}
+
+void QHPackTable::insert(const QByteArray &name, const QByteArray &value)
+{
+    const quint32 size = entrySize(name, value);
+    if (size > m_maximumSize) {
+        // RFC 7541, 4.4: an entry larger than the table empties it
+        evict(0);
+        return;
+    }
+    evict(m_maximumSize - size);
+    m_entries.prepend(qMakePair(name, value));
+    m_size += size;
+}
+
+quint32 QHPackTable::indexOf(const QByteArray &name, const QByteArray &value, bool *nameOnly) const
+{
+    quint32 nameIndex = 0;
+    for (int i = 0; i < StaticTableSize; ++i) {
+        if (name == rawData(staticTable[i].name)) {
+            if (value == rawData(staticTable[i].value)) {
+                *nameOnly = false;
+                return i + 1;
+            }
+            if (!nameIndex)
+                nameIndex = i + 1;
+        }
+    }
+    for (int i = 0; i < m_entries.size(); ++i) {
+        const QHPackHeaderField &entry = m_entries.at(i);
+        if (entry.first == name) {
+            if (entry.second == value) {
+                *nameOnly = false;
+                return StaticTableSize + 1 + i;
+            }
+            if (!nameIndex)
+                nameIndex = StaticTableSize + 1 + i;
+        }
+    }
+    *nameOnly = true;
+    return nameIndex;
+}
+
+void QHPackTable::evict(quint32 targetSize)
+{
+    while (m_size > targetSize && !m_entries.isEmpty()) {
+        const QHPackHeaderField entry = m_entries.takeLast();
+        m_size -= entrySize(entry.first, entry.second);
+    }
+}
+
+/*!
+    \class QHPackEncoder
+    \internal
+
+    Encodes header lists into HPACK header blocks. Fields are added to the
+    dynamic table unless they are large or sensitive.
+*/
+QHPackEncoder::QHPackEncoder(bool useHuffman)
+    : m_useHuffman(useHuffman), m_sizeUpdatePending(false)
+{
+}
+
+void QHPackEncoder::setMaximumTableSize(quint32 size)
+{
+    // the peer's limit is an upper bound; we never use more than the default
+    size = qMin(size, quint32(QHPackTable::DefaultMaximumSize));
+    if (size != m_table.maximumSize()) {
+        m_table.setMaximumSize(size);
+        m_sizeUpdatePending = true;
+    }
+}
+
+static bool isSensitiveField(const QByteArray &name, const QByteArray &value)
+{
+    // RFC 7541, 7.1.3: keep credentials and short, guessable cookies out of
+    // the compression context
+    if (name == "authorization" || name == "proxy-authorization")
+        return true;
+    return name == "cookie" && value.size() < 20;
+}
+
+QByteArray QHPackEncoder::encode(const QHPackHeaderList &headers)
+{
+    QByteArray block;
+    block.reserve(headers.size() * 16);
+
+    if (m_sizeUpdatePending) {
+        encodeInteger(&block, 0x20, 5, m_table.maximumSize());
+        m_sizeUpdatePending = false;
+    }
+
+    for (int i = 0; i < headers.size(); ++i) {
+        const QByteArray &name = headers.at(i).first;
+        const QByteArray &value = headers.at(i).second;
+
+        bool nameOnly = true;
+        const quint32 index = m_table.indexOf(name, value, &nameOnly);
+        if (index && !nameOnly) {
+            encodeInteger(&block, 0x80, 7, index);
+            continue;
+        }
+
+        if (isSensitiveField(name, value)) {
+            encodeInteger(&block, 0x10, 4, index); // never indexed
+        } else if (entrySize(name, value) > m_table.maximumSize() / 2) {
+            encodeInteger(&block, 0x00, 4, index); // would evict too much
+        } else {
+            encodeInteger(&block, 0x40, 6, index); // incremental indexing
+            m_table.insert(name, value);
+        }
+        if (!index)
+            encodeString(&block, name);
+        encodeString(&block, value);
+    }
+    return block;
+}
+
+void QHPackEncoder::encodeString(QByteArray *out, const QByteArray &string) const
+{
+    if (m_useHuffman) {
+        const int huffmanSize = huffmanEncodedSize(string);
+        if (huffmanSize < string.size()) {
+            encodeInteger(out, 0x80, 7, huffmanSize);
+            out->append(QHPack::huffmanEncode(string));
+            return;
+        }
+    }
+    encodeInteger(out, 0x00, 7, string.size());
+    out->append(string);
+}
+
+/*!
+    \class QHPackDecoder
+    \internal
+
+    Decodes HPACK header blocks. Every block received on a connection must be
+    decoded, even if its stream is gone, to keep the dynamic table in sync.
+*/
+QHPackDecoder::QHPackDecoder(quint32 maximumTableSize)
+    : m_table(maximumTableSize), m_maximumTableSize(maximumTableSize)
+{
+}
+
+static bool decodeString(const uchar *&pos, const uchar *end, QByteArray *string)
+{
+    if (pos == end)
+        return false;
+    const bool huffman = *pos & 0x80;
+    quint32 length = 0;
+    if (!decodeInteger(pos, end, 7, &length) || length > quint32(end - pos))
+        return false;
+
+    const char *data = reinterpret_cast<const char *>(pos);
+    pos += length;
+    if (!huffman) {
+        *string = QByteArray(data, int(length));
+        return true;
+    }
+    string->clear();
+    return QHPack::huffmanDecode(data, int(length), string);
+}
+
+bool QHPackDecoder::decode(const QByteArray &block, QHPackHeaderList *headers)
+{
+    const uchar *pos = reinterpret_cast<const uchar *>(block.constData());
+    const uchar *const end = pos + block.size();
+    quint32 listSize = 0;
+
+    while (pos != end) {
+        const uchar pattern = *pos;
+        quint32 index = 0;
+        QHPackHeaderField field;
+
+        if (pattern & 0x80) {
+            // 6.1: indexed header field
+            if (!decodeInteger(pos, end, 7, &index) || !m_table.field(index, &field))
+                return false;
+        } else if ((pattern & 0xe0) == 0x20) {
+            // 6.3: dynamic table size update, only allowed before any field
+            quint32 size = 0;
+            if (!headers->isEmpty() || !decodeInteger(pos, end, 5, &size)
+                    || size > m_maximumTableSize) {
+                return false;
+            }
+            m_table.setMaximumSize(size);
+            continue;
+        } else {
+            // 6.2: literal header field, with incremental indexing (01),
+            // without indexing (0000) or never indexed (0001)
+            const bool indexing = pattern & 0x40;
+            if (!decodeInteger(pos, end, indexing ? 6 : 4, &index))
+                return false;
+            if (index) {
+                if (!m_table.field(index, &field))
+                    return false;
+                field.first = QByteArray(field.first.constData(), field.first.size());
+            } else if (!decodeString(pos, end, &field.first)) {
+                return false;
+            }
+            if (!decodeString(pos, end, &field.second))
+                return false;
+            if (indexing)
+                m_table.insert(field.first, field.second);
+        }
+
+        listSize += entrySize(field.first, field.second);
+        if (listSize > MaximumHeaderListSize)
+            return false;
+        headers->append(field);
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
@@ -0,0 +1,147 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QHPACK_P_H
+#define QHPACK_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qpair.h>
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+// HPACK header compression for HTTP/2, see RFC 7541
+
+typedef QPair<QByteArray, QByteArray> QHPackHeaderField;
+typedef QList<QHPackHeaderField> QHPackHeaderList;
+
+class Q_AUTOTEST_EXPORT QHPackTable
+{
+public:
+    enum {
+        StaticTableSize = 61,
+        DefaultMaximumSize = 4096,
+        // RFC 7541, 4.1: name and value length plus 32 octets overhead
+        EntryOverhead = 32
+    };
+
+    explicit QHPackTable(quint32 maximumSize = DefaultMaximumSize);
+
+    quint32 maximumSize() const { return m_maximumSize; }
+    void setMaximumSize(quint32 size);
+    quint32 size() const { return m_size; }
+    int dynamicCount() const { return m_entries.count(); }
+
+    // index is 1-based and covers the static table followed by the dynamic one
+    bool field(quint32 index, QHPackHeaderField *field) const;
+    void insert(const QByteArray &name, const QByteArray &value);
+
+    // returns the index of the best match, or 0; *nameOnly is set if the
+    // value did not match
+    quint32 indexOf(const QByteArray &name, const QByteArray &value, bool *nameOnly) const;
+
+private:
+    void evict(quint32 targetSize);
+
+    QList<QHPackHeaderField> m_entries; // newest first
+    quint32 m_size;
+    quint32 m_maximumSize;
+};
+
+class Q_AUTOTEST_EXPORT QHPackEncoder
+{
+public:
+    explicit QHPackEncoder(bool useHuffman = true);
+
+    // the peer's SETTINGS_HEADER_TABLE_SIZE; announced in the next block
+    void setMaximumTableSize(quint32 size);
+    const QHPackTable &table() const { return m_table; }
+
+    // names must already be lower case
+    QByteArray encode(const QHPackHeaderList &headers);
+
+private:
+    void encodeString(QByteArray *out, const QByteArray &string) const;
+
+    QHPackTable m_table;
+    bool m_useHuffman;
+    bool m_sizeUpdatePending;
+};
+
+class Q_AUTOTEST_EXPORT QHPackDecoder
+{
+public:
+    enum {
+        // advertised as SETTINGS_MAX_HEADER_LIST_SIZE
+        MaximumHeaderListSize = 256 * 1024
+    };
+
+    // maximumTableSize is our SETTINGS_HEADER_TABLE_SIZE
+    explicit QHPackDecoder(quint32 maximumTableSize = QHPackTable::DefaultMaximumSize);
+
+    const QHPackTable &table() const { return m_table; }
+
+    // decodes a complete header block; returns false on a compression error,
+    // after which the connection can no longer be used
+    bool decode(const QByteArray &block, QHPackHeaderList *headers);
+
+private:
+    QHPackTable m_table;
+    quint32 m_maximumTableSize;
+};
+
+namespace QHPack {
+Q_AUTOTEST_EXPORT QByteArray huffmanEncode(const QByteArray &input);
+Q_AUTOTEST_EXPORT bool huffmanDecode(const char *input, int length, QByteArray *output);
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
+
+#endif // QHPACK_P_H
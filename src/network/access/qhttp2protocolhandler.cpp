@@ -0,0 +1,973 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <private/qhttp2protocolhandler_p.h>
+#include <private/qnoncontiguousbytedevice_p.h>
+#include <private/qhttpnetworkconnectionchannel_p.h>
+#include <QtCore/QtEndian>
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+static const char connectionPreface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+static const int frameHeaderSize = 9;
+static const quint32 defaultMaxFrameSize = 16384; // also the largest frame we accept
+static const qint32 defaultWindowSize = 65535;
+static const qint32 maxWindowSize = 0x7fffffff;
+
+// what we advertise: per stream via SETTINGS, per connection via WINDOW_UPDATE
+static const qint32 streamReceiveWindow = 1024 * 1024;
+static const qint32 connectionReceiveWindow = 16 * 1024 * 1024;
+
+// used until the server tells us otherwise
+static const quint32 defaultMaxConcurrentStreams = 100;
+
+static inline quint32 readUInt32(const char *data)
+{
+    return qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(data));
+}
+
+static inline void appendUInt32(QByteArray *output, quint32 value)
+{
+    uchar data[4];
+    qToBigEndian<quint32>(value, data);
+    output->append(reinterpret_cast<const char *>(data), 4);
+}
+
+static void appendSetting(QByteArray *output, quint16 identifier, quint32 value)
+{
+    output->append(char(identifier >> 8));
+    output->append(char(identifier));
+    appendUInt32(output, value);
+}
+
+static bool isConnectionSpecificHeader(const QByteArray &name)
+{
+    // RFC 7540, 8.1.2.2: these must not be sent over HTTP/2
+    return name == "connection" || name == "host" || name == "keep-alive"
+            || name == "proxy-connection" || name == "transfer-encoding"
+            || name == "upgrade" || name == "http2-settings";
+}
+
+QHttp2ProtocolHandler::QHttp2ProtocolHandler(QHttpNetworkConnectionChannel *channel)
+    : QObject(0), QAbstractProtocolHandler(channel),
+      m_nextStreamID(1),
+      m_maxConcurrentStreams(defaultMaxConcurrentStreams),
+      m_sendWindow(defaultWindowSize),
+      m_receiveWindow(connectionReceiveWindow),
+      m_peerInitialWindowSize(defaultWindowSize),
+      m_peerMaxFrameSize(defaultMaxFrameSize),
+      m_continuedStreamID(0),
+      m_endStreamAfterHeaders(false),
+      m_peerSettingsReceived(false),
+      m_goingAway(false),
+      m_closing(false)
+{
+    connect(m_socket, SIGNAL(disconnected()), this, SLOT(_q_socketDisconnected()));
+
+    // RFC 7540, 3.5: the client connection preface is the magic string
+    // followed by our SETTINGS; we do not need to wait for the server's
+    // preface before sending it
+    m_socket->write(connectionPreface, sizeof connectionPreface - 1);
+
+    QByteArray settings;
+    appendSetting(&settings, SETTINGS_ENABLE_PUSH, 0);
+    appendSetting(&settings, SETTINGS_INITIAL_WINDOW_SIZE, streamReceiveWindow);
+    appendSetting(&settings, SETTINGS_MAX_HEADER_LIST_SIZE, QHPackDecoder::MaximumHeaderListSize);
+    sendFrame(FrameType_SETTINGS, 0, 0, settings.constData(), settings.size());
+
+    // the connection window can only be changed with WINDOW_UPDATE
+    sendWINDOW_UPDATE(0, connectionReceiveWindow - defaultWindowSize);
+}
+
+QHttp2ProtocolHandler::~QHttp2ProtocolHandler()
+{
+}
+
+bool QHttp2ProtocolHandler::sendRequest()
+{
+    Q_ASSERT(!m_reply);
+
+    // wait for the server's SETTINGS, they tell us how many streams we may open
+    if (!m_peerSettingsReceived || m_goingAway || m_closing)
+        return true;
+
+    QMultiMap<int, HttpMessagePair> &requests = m_channel->spdyRequestsToSend;
+    while (!requests.isEmpty() && quint32(m_activeStreams.size()) < m_maxConcurrentStreams) {
+        if (m_nextStreamID > quint32(maxWindowSize)) {
+            // stream IDs are exhausted, finish this connection and open a new one
+            m_goingAway = true;
+            closeIfDone();
+            break;
+        }
+
+        // requests are ordered by priority; the oldest one of a priority
+        // is the last of its key in the map
+        QMultiMap<int, HttpMessagePair>::iterator it = requests.upperBound(requests.firstKey());
+        --it;
+        HttpMessagePair pair = *it;
+        requests.erase(it);
+
+        QHttpNetworkReply *reply = pair.second;
+        QHttpNetworkReplyPrivate *replyPrivate = reply->d_func();
+        reply->setHttp2WasUsed(true);
+        reply->setRequest(pair.first);
+        replyPrivate->connection = m_connection;
+        replyPrivate->connectionChannel = m_channel;
+        replyPrivate->autoDecompress = pair.first.d->autoDecompress;
+        replyPrivate->totallyUploadedData = 0;
+        connect(reply, SIGNAL(destroyed(QObject*)), this, SLOT(_q_replyDestroyed(QObject*)));
+
+        Stream stream;
+        stream.pair = pair;
+        stream.id = m_nextStreamID;
+        stream.sendWindow = m_peerInitialWindowSize;
+        stream.receiveWindow = streamReceiveWindow;
+        m_nextStreamID += 2; // client initiated streams are odd
+
+        Stream &activeStream = m_activeStreams[stream.id] = stream;
+        sendHEADERS(activeStream);
+    }
+    return true;
+}
+
+void QHttp2ProtocolHandler::_q_replyDestroyed(QObject *reply)
+{
+    QHash<quint32, Stream>::iterator it = m_activeStreams.begin();
+    for (; it != m_activeStreams.end(); ++it) {
+        if (it->pair.second == reply) {
+            const quint32 streamID = it->id;
+            if (QNonContiguousByteDevice *device = it->pair.first.uploadByteDevice())
+                device->disconnect(this);
+            m_activeStreams.erase(it);
+            sendRST_STREAM(streamID, ErrorCode_CANCEL);
+
+            if (!m_channel->spdyRequestsToSend.isEmpty())
+                QMetaObject::invokeMethod(m_connection, "_q_startNextRequest", Qt::QueuedConnection);
+            closeIfDone();
+            return;
+        }
+    }
+}
+
+void QHttp2ProtocolHandler::_q_uploadDataReadyRead()
+{
+    QNonContiguousByteDevice *device = qobject_cast<QNonContiguousByteDevice *>(sender());
+    Q_ASSERT(device);
+    QHash<quint32, Stream>::iterator it = m_activeStreams.begin();
+    for (; it != m_activeStreams.end(); ++it) {
+        if (it->uploading && it->pair.first.uploadByteDevice() == device) {
+            uploadData(*it);
+            return;
+        }
+    }
+}
+
+void QHttp2ProtocolHandler::_q_socketDisconnected()
+{
+    // see _q_receiveReply()
+    if (!qobject_cast<QHttpNetworkConnection*>(m_connection))
+        return;
+
+    const QString errorString = m_connection->d_func()->errorDetail(QNetworkReply::RemoteHostClosedError,
+                                                                    m_socket);
+    while (!m_activeStreams.isEmpty())
+        finishStreamWithError(*m_activeStreams.begin(), QNetworkReply::RemoteHostClosedError, errorString);
+
+    // the queued requests will get a new connection
+    if (!m_channel->spdyRequestsToSend.isEmpty())
+        QMetaObject::invokeMethod(m_connection, "_q_startNextRequest", Qt::QueuedConnection);
+}
+
+void QHttp2ProtocolHandler::_q_receiveReply()
+{
+    Q_ASSERT(m_socket);
+
+    // only run when the QHttpNetworkConnection is not currently being destructed, e.g.
+    // this function is called from _q_disconnected which is called because
+    // of ~QHttpNetworkConnectionPrivate
+    if (!qobject_cast<QHttpNetworkConnection*>(m_connection))
+        return;
+
+    if (m_closing) {
+        m_socket->readAll(); // the channel is being closed, drop everything
+        return;
+    }
+
+    m_buffer += m_socket->readAll();
+
+    int position = 0;
+    while (m_buffer.size() - position >= frameHeaderSize) {
+        const char *header = m_buffer.constData() + position;
+        const quint32 length = readUInt32(header) >> 8;
+        if (length > defaultMaxFrameSize) {
+            connectionError(ErrorCode_FRAME_SIZE_ERROR, "HTTP/2 frame exceeds the maximum frame size");
+            return;
+        }
+        if (quint32(m_buffer.size() - position) < frameHeaderSize + length)
+            break; // wait for the rest of the frame
+
+        const FrameType type = FrameType(uchar(header[3]));
+        const uchar flags = uchar(header[4]);
+        const quint32 streamID = readUInt32(header + 5) & 0x7fffffff;
+        const QByteArray payload = m_buffer.mid(position + frameHeaderSize, length);
+        position += frameHeaderSize + length;
+
+        if (!handleFrame(type, flags, streamID, payload))
+            return; // connection error, m_buffer is of no use anymore
+    }
+    m_buffer.remove(0, position);
+}
+
+void QHttp2ProtocolHandler::_q_readyRead()
+{
+    _q_receiveReply();
+}
+
+void QHttp2ProtocolHandler::sendFrame(FrameType type, uchar flags, quint32 streamID,
+                                      const char *payload, quint32 length)
+{
+    Q_ASSERT(length < (1u << 24));
+    char header[frameHeaderSize];
+    header[0] = char(length >> 16);
+    header[1] = char(length >> 8);
+    header[2] = char(length);
+    header[3] = char(type);
+    header[4] = char(flags);
+    qToBigEndian<quint32>(streamID, reinterpret_cast<uchar *>(header + 5));
+
+    m_socket->write(header, frameHeaderSize);
+    if (length)
+        m_socket->write(payload, length);
+}
+
+void QHttp2ProtocolHandler::sendHEADERS(Stream &stream)
+{
+    const QHttpNetworkRequest &request = stream.pair.first;
+
+    // RFC 7540, 8.1.2.3: pseudo-header fields come first
+    QHPackHeaderList headers;
+    headers.reserve(request.header().size() + 4);
+    headers.append(qMakePair(QByteArray(":method"), request.methodName()));
+    headers.append(qMakePair(QByteArray(":scheme"), request.url().scheme().toLatin1()));
+    headers.append(qMakePair(QByteArray(":authority"),
+                             request.url().authority(QUrl::FullyEncoded | QUrl::RemoveUserInfo).toLatin1()));
+    headers.append(qMakePair(QByteArray(":path"), request.uri(false)));
+
+    const QList<QPair<QByteArray, QByteArray> > fields = request.header();
+    for (int i = 0; i < fields.size(); ++i) {
+        // header field names must be lowercase in HTTP/2
+        const QByteArray name = fields.at(i).first.toLower();
+        if (isConnectionSpecificHeader(name))
+            continue;
+        if (name == "te" && fields.at(i).second != "trailers")
+            continue;
+        headers.append(qMakePair(name, fields.at(i).second));
+    }
+
+    const QByteArray block = m_encoder.encode(headers);
+
+    // weight: stream dependency 0, not exclusive, weight - 1
+    char priority[5] = { 0, 0, 0, 0, 15 };
+    switch (request.priority()) {
+    case QHttpNetworkRequest::HighPriority:
+        priority[4] = char(255);
+        break;
+    case QHttpNetworkRequest::NormalPriority:
+        break;
+    case QHttpNetworkRequest::LowPriority:
+        priority[4] = 0;
+        break;
+    }
+
+    const bool hasBody = request.uploadByteDevice();
+    uchar flags = FrameFlag_PRIORITY;
+    if (!hasBody)
+        flags |= FrameFlag_END_STREAM;
+
+    // the block is split into a HEADERS frame and as many CONTINUATION frames as needed
+    int fragmentSize = qMin<int>(block.size(), m_peerMaxFrameSize - sizeof priority);
+    if (fragmentSize == block.size())
+        flags |= FrameFlag_END_HEADERS;
+
+    QByteArray payload;
+    payload.reserve(sizeof priority + fragmentSize);
+    payload.append(priority, sizeof priority);
+    payload.append(block.constData(), fragmentSize);
+    sendFrame(FrameType_HEADERS, flags, stream.id, payload.constData(), payload.size());
+
+    for (int offset = fragmentSize; offset < block.size(); offset += fragmentSize) {
+        fragmentSize = qMin<int>(block.size() - offset, m_peerMaxFrameSize);
+        const uchar continuationFlags = offset + fragmentSize == block.size() ? FrameFlag_END_HEADERS : 0;
+        sendFrame(FrameType_CONTINUATION, continuationFlags, stream.id,
+                  block.constData() + offset, fragmentSize);
+    }
+
+    if (hasBody) {
+        stream.uploading = true;
+        QObject::connect(request.uploadByteDevice(), SIGNAL(readyRead()), this,
+                         SLOT(_q_uploadDataReadyRead()), Qt::QueuedConnection);
+        uploadData(stream);
+    }
+}
+
+void QHttp2ProtocolHandler::sendRST_STREAM(quint32 streamID, ErrorCode errorCode)
+{
+    char payload[4];
+    qToBigEndian<quint32>(errorCode, reinterpret_cast<uchar *>(payload));
+    sendFrame(FrameType_RST_STREAM, 0, streamID, payload, sizeof payload);
+}
+
+void QHttp2ProtocolHandler::sendGOAWAY(ErrorCode errorCode)
+{
+    // we never accept streams from the server, so the last stream ID is 0
+    char payload[8];
+    qToBigEndian<quint32>(0, reinterpret_cast<uchar *>(payload));
+    qToBigEndian<quint32>(errorCode, reinterpret_cast<uchar *>(payload + 4));
+    sendFrame(FrameType_GOAWAY, 0, 0, payload, sizeof payload);
+}
+
+void QHttp2ProtocolHandler::sendWINDOW_UPDATE(quint32 streamID, quint32 delta)
+{
+    char payload[4];
+    qToBigEndian<quint32>(delta, reinterpret_cast<uchar *>(payload));
+    sendFrame(FrameType_WINDOW_UPDATE, 0, streamID, payload, sizeof payload);
+}
+
+bool QHttp2ProtocolHandler::uploadData(Stream &stream)
+{
+    const QHttpNetworkRequest &request = stream.pair.first;
+    QHttpNetworkReply *reply = stream.pair.second;
+    QHttpNetworkReplyPrivate *replyPrivate = reply->d_func();
+    QNonContiguousByteDevice *device = request.uploadByteDevice();
+    Q_ASSERT(device);
+
+    while (stream.uploading) {
+        if (device->atEnd()) {
+            // the last DATA frame did not know it was the last one
+            sendFrame(FrameType_DATA, FrameFlag_END_STREAM, stream.id, 0, 0);
+            stream.uploading = false;
+            break;
+        }
+
+        // both the connection and the stream window limit what we may send
+        const qint32 window = qMin(m_sendWindow, stream.sendWindow);
+        if (window <= 0)
+            return true; // wait for WINDOW_UPDATE
+
+        qint64 readSize = 0;
+        const char *data = device->readPointer(qMin<qint64>(window, m_peerMaxFrameSize), readSize);
+        if (readSize == -1) {
+            // premature eof happened
+            sendRST_STREAM(stream.id, ErrorCode_CANCEL);
+            finishStreamWithError(stream, QNetworkReply::UnknownNetworkError,
+                                  m_connection->d_func()->errorDetail(QNetworkReply::UnknownNetworkError,
+                                                                      m_socket));
+            return false;
+        } else if (!data || readSize == 0) {
+            return true; // nothing to read currently, wait for readyRead
+        }
+
+        replyPrivate->totallyUploadedData += readSize;
+        const bool last = request.contentLength() >= 0
+                && replyPrivate->totallyUploadedData >= request.contentLength();
+        sendFrame(FrameType_DATA, last ? FrameFlag_END_STREAM : 0, stream.id, data, quint32(readSize));
+        device->advanceReadPointer(readSize);
+        m_sendWindow -= qint32(readSize);
+        stream.sendWindow -= qint32(readSize);
+        if (last)
+            stream.uploading = false;
+
+        emit reply->dataSendProgress(replyPrivate->totallyUploadedData, request.contentLength());
+    }
+
+    device->disconnect(this);
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleFrame(FrameType type, uchar flags, quint32 streamID,
+                                        const QByteArray &payload)
+{
+    // RFC 7540, 6.10: nothing may interrupt a header block
+    if (m_continuedStreamID && type != FrameType_CONTINUATION) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 header block was interrupted");
+        return false;
+    }
+
+    switch (type) {
+    case FrameType_DATA:
+        return handleDATA(flags, streamID, payload);
+    case FrameType_HEADERS:
+        return handleHEADERS(flags, streamID, payload);
+    case FrameType_PRIORITY:
+        // we do not act on the server's priorities
+        if (!streamID) {
+            connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 PRIORITY frame on stream 0");
+            return false;
+        }
+        return true;
+    case FrameType_RST_STREAM:
+        return handleRST_STREAM(streamID, payload);
+    case FrameType_SETTINGS:
+        return handleSETTINGS(flags, streamID, payload);
+    case FrameType_PUSH_PROMISE:
+        // we disabled server push in our SETTINGS
+        connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 server push was not enabled");
+        return false;
+    case FrameType_PING:
+        return handlePING(flags, streamID, payload);
+    case FrameType_GOAWAY:
+        return handleGOAWAY(streamID, payload);
+    case FrameType_WINDOW_UPDATE:
+        return handleWINDOW_UPDATE(streamID, payload);
+    case FrameType_CONTINUATION:
+        return handleCONTINUATION(flags, streamID, payload);
+    }
+
+    // RFC 7540, 4.1: unknown frame types must be ignored
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleDATA(uchar flags, quint32 streamID, const QByteArray &payload)
+{
+    if (!streamID) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 DATA frame on stream 0");
+        return false;
+    }
+
+    // flow control counts the whole payload, padding included
+    const qint32 length = payload.size();
+    m_receiveWindow -= length;
+    if (m_receiveWindow < 0) {
+        connectionError(ErrorCode_FLOW_CONTROL_ERROR, "HTTP/2 server exceeded the connection window");
+        return false;
+    }
+    if (m_receiveWindow < connectionReceiveWindow / 2) {
+        sendWINDOW_UPDATE(0, connectionReceiveWindow - m_receiveWindow);
+        m_receiveWindow = connectionReceiveWindow;
+    }
+
+    QHash<quint32, Stream>::iterator it = m_activeStreams.find(streamID);
+    if (it == m_activeStreams.end()) {
+        if (streamID >= m_nextStreamID) {
+            connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 DATA frame on an idle stream");
+            return false;
+        }
+        return true; // a stream we already closed or reset
+    }
+
+    int dataStart = 0;
+    int dataLength = length;
+    if (flags & FrameFlag_PADDED) {
+        const int padLength = length ? uchar(payload.at(0)) : 0;
+        if (!length || padLength >= length) {
+            connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 DATA frame with invalid padding");
+            return false;
+        }
+        dataStart = 1;
+        dataLength = length - 1 - padLength;
+    }
+
+    Stream &stream = *it;
+    stream.receiveWindow -= length;
+    if (stream.receiveWindow < 0 || !stream.headersReceived) {
+        const bool flowControl = stream.receiveWindow < 0;
+        sendRST_STREAM(streamID, flowControl ? ErrorCode_FLOW_CONTROL_ERROR : ErrorCode_PROTOCOL_ERROR);
+        finishStreamWithError(stream, QNetworkReply::ProtocolFailure,
+                              flowControl ? tr("HTTP/2 server exceeded the stream window")
+                                          : tr("HTTP/2 DATA frame before the response headers"));
+        return true;
+    }
+
+    QHttpNetworkReply *httpReply = stream.pair.second;
+    QHttpNetworkReplyPrivate *replyPrivate = httpReply->d_func();
+
+    if (dataLength > 0) {
+        replyPrivate->totalProgress += dataLength;
+
+        // autoDecompress was cleared when the headers arrived unless the
+        // reply has a content-coding that can be decoded
+        if (replyPrivate->autoDecompress) {
+            if (replyPrivate->decodeBodyData(payload.constData() + dataStart, dataLength,
+                                             &replyPrivate->responseData) < 0) {
+                sendRST_STREAM(streamID, ErrorCode_CANCEL);
+                finishStreamWithError(stream, QNetworkReply::ProtocolFailure,
+                                      m_connection->d_func()->errorDetail(QNetworkReply::ProtocolFailure,
+                                                                          m_socket));
+                return true;
+            }
+        } else {
+            replyPrivate->responseData.append(dataStart || dataLength != length
+                                              ? payload.mid(dataStart, dataLength) : payload);
+        }
+
+        if (replyPrivate->shouldEmitSignals()) {
+            emit httpReply->readyRead();
+            emit httpReply->dataReadProgress(replyPrivate->totalProgress, httpReply->contentLength());
+        }
+
+        // the reply may have been aborted and deleted from a slot
+        it = m_activeStreams.find(streamID);
+        if (it == m_activeStreams.end())
+            return true;
+    }
+
+    if (flags & FrameFlag_END_STREAM) {
+        finishStream(*it);
+    } else if (it->receiveWindow < streamReceiveWindow / 2) {
+        sendWINDOW_UPDATE(streamID, streamReceiveWindow - it->receiveWindow);
+        it->receiveWindow = streamReceiveWindow;
+    }
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleHEADERS(uchar flags, quint32 streamID, const QByteArray &payload)
+{
+    if (!streamID) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 HEADERS frame on stream 0");
+        return false;
+    }
+
+    int start = 0;
+    int end = payload.size();
+    if (flags & FrameFlag_PADDED) {
+        if (payload.isEmpty()) {
+            connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 HEADERS frame with invalid padding");
+            return false;
+        }
+        start = 1;
+        end -= uchar(payload.at(0));
+    }
+    if (flags & FrameFlag_PRIORITY)
+        start += 5;
+    if (start > end) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 HEADERS frame is too short");
+        return false;
+    }
+
+    m_headerBlock = payload.mid(start, end - start);
+    m_endStreamAfterHeaders = flags & FrameFlag_END_STREAM;
+    if (flags & FrameFlag_END_HEADERS)
+        return handleHeaderBlock(streamID);
+
+    m_continuedStreamID = streamID;
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleCONTINUATION(uchar flags, quint32 streamID, const QByteArray &payload)
+{
+    if (!m_continuedStreamID || streamID != m_continuedStreamID) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "unexpected HTTP/2 CONTINUATION frame");
+        return false;
+    }
+
+    m_headerBlock += payload;
+    if (m_headerBlock.size() > QHPackDecoder::MaximumHeaderListSize) {
+        connectionError(ErrorCode_ENHANCE_YOUR_CALM, "HTTP/2 header block is too large");
+        return false;
+    }
+
+    if (!(flags & FrameFlag_END_HEADERS))
+        return true;
+    m_continuedStreamID = 0;
+    return handleHeaderBlock(streamID);
+}
+
+bool QHttp2ProtocolHandler::handleHeaderBlock(quint32 streamID)
+{
+    // every block has to be decoded to keep the HPACK context in sync,
+    // even if the stream is gone
+    QHPackHeaderList headers;
+    const bool decoded = m_decoder.decode(m_headerBlock, &headers);
+    m_headerBlock.clear();
+    if (!decoded) {
+        connectionError(ErrorCode_COMPRESSION_ERROR, "HTTP/2 header decompression failed");
+        return false;
+    }
+
+    QHash<quint32, Stream>::iterator it = m_activeStreams.find(streamID);
+    if (it == m_activeStreams.end()) {
+        if (streamID >= m_nextStreamID) {
+            connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 HEADERS frame on an idle stream");
+            return false;
+        }
+        return true;
+    }
+
+    Stream &stream = *it;
+    QHttpNetworkReply *httpReply = stream.pair.second;
+    QHttpNetworkReplyPrivate *replyPrivate = httpReply->d_func();
+    const bool trailers = stream.headersReceived;
+
+    if (!trailers) {
+        int statusCode = 0;
+        for (int i = 0; i < headers.size(); ++i) {
+            if (headers.at(i).first == ":status") {
+                statusCode = headers.at(i).second.toInt();
+                break;
+            }
+        }
+        if (statusCode < 100 || statusCode > 999) {
+            sendRST_STREAM(streamID, ErrorCode_PROTOCOL_ERROR);
+            finishStreamWithError(stream, QNetworkReply::ProtocolFailure,
+                                  tr("HTTP/2 response without a valid status"));
+            return true;
+        }
+        if (statusCode < 200)
+            return true; // informational, the final response follows
+
+        stream.headersReceived = true;
+        replyPrivate->statusCode = statusCode;
+        replyPrivate->reasonPhrase.clear(); // HTTP/2 has no reason phrase
+        replyPrivate->majorVersion = 2;
+        replyPrivate->minorVersion = 0;
+    }
+
+    for (int i = 0; i < headers.size(); ++i) {
+        if (!headers.at(i).first.startsWith(':'))
+            replyPrivate->fields.append(headers.at(i));
+    }
+
+    if (!trailers) {
+        if (replyPrivate->autoDecompress && replyPrivate->isCompressed())
+            replyPrivate->removeAutoDecompressHeader();
+        else
+            replyPrivate->autoDecompress = false;
+
+        emit httpReply->headerChanged();
+
+        // the reply may have been aborted and deleted from a slot
+        it = m_activeStreams.find(streamID);
+        if (it == m_activeStreams.end())
+            return true;
+    }
+
+    if (m_endStreamAfterHeaders)
+        finishStream(*it);
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleRST_STREAM(quint32 streamID, const QByteArray &payload)
+{
+    if (!streamID) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 RST_STREAM frame on stream 0");
+        return false;
+    }
+    if (payload.size() != 4) {
+        connectionError(ErrorCode_FRAME_SIZE_ERROR, "HTTP/2 RST_STREAM frame has the wrong size");
+        return false;
+    }
+
+    QHash<quint32, Stream>::iterator it = m_activeStreams.find(streamID);
+    if (it == m_activeStreams.end())
+        return true;
+
+    const quint32 errorCode = readUInt32(payload.constData());
+    switch (errorCode) {
+    case ErrorCode_REFUSED_STREAM:
+        // RFC 7540, 8.1.4: the server did not process it, it is safe to retry
+        requeueStream(*it);
+        QMetaObject::invokeMethod(m_connection, "_q_startNextRequest", Qt::QueuedConnection);
+        break;
+    case ErrorCode_INTERNAL_ERROR:
+        finishStreamWithError(*it, QNetworkReply::InternalServerError,
+                              tr("HTTP/2 stream was reset because of an internal server error"));
+        break;
+    case ErrorCode_CANCEL:
+        finishStreamWithError(*it, QNetworkReply::OperationCanceledError,
+                              tr("HTTP/2 stream was cancelled by the server"));
+        break;
+    default:
+        finishStreamWithError(*it, QNetworkReply::ProtocolFailure,
+                              tr("HTTP/2 stream was reset by the server (error code %1)").arg(errorCode));
+        break;
+    }
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleSETTINGS(uchar flags, quint32 streamID, const QByteArray &payload)
+{
+    if (streamID) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 SETTINGS frame on a stream");
+        return false;
+    }
+    if (flags & FrameFlag_ACK) {
+        if (!payload.isEmpty()) {
+            connectionError(ErrorCode_FRAME_SIZE_ERROR, "HTTP/2 SETTINGS acknowledgement with payload");
+            return false;
+        }
+        return true;
+    }
+    if (payload.size() % 6) {
+        connectionError(ErrorCode_FRAME_SIZE_ERROR, "HTTP/2 SETTINGS frame has the wrong size");
+        return false;
+    }
+
+    for (int offset = 0; offset < payload.size(); offset += 6) {
+        const quint16 identifier = qFromBigEndian<quint16>(
+                    reinterpret_cast<const uchar *>(payload.constData() + offset));
+        const quint32 value = readUInt32(payload.constData() + offset + 2);
+
+        switch (identifier) {
+        case SETTINGS_HEADER_TABLE_SIZE:
+            m_encoder.setMaximumTableSize(value);
+            break;
+        case SETTINGS_ENABLE_PUSH:
+            if (value > 1) {
+                connectionError(ErrorCode_PROTOCOL_ERROR, "invalid HTTP/2 SETTINGS_ENABLE_PUSH");
+                return false;
+            }
+            break;
+        case SETTINGS_MAX_CONCURRENT_STREAMS:
+            m_maxConcurrentStreams = value;
+            break;
+        case SETTINGS_INITIAL_WINDOW_SIZE: {
+            if (value > quint32(maxWindowSize)) {
+                connectionError(ErrorCode_FLOW_CONTROL_ERROR, "invalid HTTP/2 SETTINGS_INITIAL_WINDOW_SIZE");
+                return false;
+            }
+            // RFC 7540, 6.9.2: the change applies to all open streams
+            const qint64 delta = qint64(value) - m_peerInitialWindowSize;
+            QHash<quint32, Stream>::iterator it = m_activeStreams.begin();
+            for (; it != m_activeStreams.end(); ++it) {
+                if (it->sendWindow + delta > maxWindowSize) {
+                    connectionError(ErrorCode_FLOW_CONTROL_ERROR, "HTTP/2 stream window overflow");
+                    return false;
+                }
+                it->sendWindow += qint32(delta);
+            }
+            m_peerInitialWindowSize = qint32(value);
+            break;
+        }
+        case SETTINGS_MAX_FRAME_SIZE:
+            if (value < defaultMaxFrameSize || value > 0xffffff) {
+                connectionError(ErrorCode_PROTOCOL_ERROR, "invalid HTTP/2 SETTINGS_MAX_FRAME_SIZE");
+                return false;
+            }
+            m_peerMaxFrameSize = value;
+            break;
+        default:
+            // SETTINGS_MAX_HEADER_LIST_SIZE is advisory, unknown settings must be ignored
+            break;
+        }
+    }
+
+    sendFrame(FrameType_SETTINGS, FrameFlag_ACK, 0, 0, 0);
+
+    // the windows may have grown and more streams may be allowed now
+    QList<quint32> uploading;
+    for (QHash<quint32, Stream>::const_iterator it = m_activeStreams.constBegin();
+         it != m_activeStreams.constEnd(); ++it) {
+        if (it->uploading)
+            uploading.append(it->id);
+    }
+    for (int i = 0; i < uploading.size(); ++i) {
+        QHash<quint32, Stream>::iterator it = m_activeStreams.find(uploading.at(i));
+        if (it != m_activeStreams.end())
+            uploadData(*it);
+    }
+
+    m_peerSettingsReceived = true;
+    sendRequest();
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handlePING(uchar flags, quint32 streamID, const QByteArray &payload)
+{
+    if (streamID) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 PING frame on a stream");
+        return false;
+    }
+    if (payload.size() != 8) {
+        connectionError(ErrorCode_FRAME_SIZE_ERROR, "HTTP/2 PING frame has the wrong size");
+        return false;
+    }
+    if (!(flags & FrameFlag_ACK))
+        sendFrame(FrameType_PING, FrameFlag_ACK, 0, payload.constData(), payload.size());
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleGOAWAY(quint32 streamID, const QByteArray &payload)
+{
+    if (streamID) {
+        connectionError(ErrorCode_PROTOCOL_ERROR, "HTTP/2 GOAWAY frame on a stream");
+        return false;
+    }
+    if (payload.size() < 8) {
+        connectionError(ErrorCode_FRAME_SIZE_ERROR, "HTTP/2 GOAWAY frame is too short");
+        return false;
+    }
+
+    // streams above the last processed one were not touched by the server
+    // and can be retried on a new connection
+    const quint32 lastStreamID = readUInt32(payload.constData()) & 0x7fffffff;
+    QList<quint32> unprocessed;
+    for (QHash<quint32, Stream>::const_iterator it = m_activeStreams.constBegin();
+         it != m_activeStreams.constEnd(); ++it) {
+        if (it->id > lastStreamID)
+            unprocessed.append(it->id);
+    }
+    for (int i = 0; i < unprocessed.size(); ++i)
+        requeueStream(m_activeStreams[unprocessed.at(i)]);
+
+    m_goingAway = true;
+    closeIfDone();
+    return true;
+}
+
+bool QHttp2ProtocolHandler::handleWINDOW_UPDATE(quint32 streamID, const QByteArray &payload)
+{
+    if (payload.size() != 4) {
+        connectionError(ErrorCode_FRAME_SIZE_ERROR, "HTTP/2 WINDOW_UPDATE frame has the wrong size");
+        return false;
+    }
+
+    const quint32 delta = readUInt32(payload.constData()) & 0x7fffffff;
+    if (!streamID) {
+        if (!delta || qint64(m_sendWindow) + delta > maxWindowSize) {
+            connectionError(ErrorCode_FLOW_CONTROL_ERROR, "invalid HTTP/2 connection window update");
+            return false;
+        }
+        m_sendWindow += qint32(delta);
+
+        QList<quint32> uploading;
+        for (QHash<quint32, Stream>::const_iterator it = m_activeStreams.constBegin();
+             it != m_activeStreams.constEnd(); ++it) {
+            if (it->uploading)
+                uploading.append(it->id);
+        }
+        for (int i = 0; i < uploading.size() && m_sendWindow > 0; ++i) {
+            QHash<quint32, Stream>::iterator it = m_activeStreams.find(uploading.at(i));
+            if (it != m_activeStreams.end())
+                uploadData(*it);
+        }
+        return true;
+    }
+
+    QHash<quint32, Stream>::iterator it = m_activeStreams.find(streamID);
+    if (it == m_activeStreams.end())
+        return true;
+
+    if (!delta || qint64(it->sendWindow) + delta > maxWindowSize) {
+        sendRST_STREAM(streamID, delta ? ErrorCode_FLOW_CONTROL_ERROR : ErrorCode_PROTOCOL_ERROR);
+        finishStreamWithError(*it, QNetworkReply::ProtocolFailure,
+                              tr("invalid HTTP/2 stream window update"));
+        return true;
+    }
+    it->sendWindow += qint32(delta);
+    if (it->uploading)
+        uploadData(*it);
+    return true;
+}
+
+void QHttp2ProtocolHandler::connectionError(ErrorCode errorCode, const char *errorMessage)
+{
+    if (m_closing)
+        return;
+    m_closing = true;
+
+    sendGOAWAY(errorCode);
+
+    const QString errorString = tr(errorMessage);
+    while (!m_activeStreams.isEmpty())
+        finishStreamWithError(*m_activeStreams.begin(), QNetworkReply::ProtocolFailure, errorString);
+
+    // queued requests are sent once the channel has reconnected
+    m_channel->close();
+}
+
+void QHttp2ProtocolHandler::finishStream(Stream &stream)
+{
+    QHttpNetworkReply *httpReply = stream.pair.second;
+    httpReply->d_func()->state = QHttpNetworkReplyPrivate::AllDoneState;
+    removeStream(stream);
+    emit httpReply->finished();
+
+    if (!m_channel->spdyRequestsToSend.isEmpty())
+        QMetaObject::invokeMethod(m_connection, "_q_startNextRequest", Qt::QueuedConnection);
+    closeIfDone();
+}
+
+void QHttp2ProtocolHandler::finishStreamWithError(Stream &stream, QNetworkReply::NetworkError errorCode,
+                                                  const QString &errorMessage)
+{
+    QHttpNetworkReply *httpReply = stream.pair.second;
+    removeStream(stream);
+    httpReply->d_func()->errorString = errorMessage;
+    emit httpReply->finishedWithError(errorCode, errorMessage);
+
+    if (!m_channel->spdyRequestsToSend.isEmpty())
+        QMetaObject::invokeMethod(m_connection, "_q_startNextRequest", Qt::QueuedConnection);
+    closeIfDone();
+}
+
+void QHttp2ProtocolHandler::requeueStream(Stream &stream)
+{
+    const HttpMessagePair pair = stream.pair;
+    removeStream(stream);
+
+    QNonContiguousByteDevice *device = pair.first.uploadByteDevice();
+    if (device && !device->reset()) {
+        const QString errorString = m_connection->d_func()->errorDetail(QNetworkReply::ContentReSendError,
+                                                                        m_socket);
+        pair.second->d_func()->errorString = errorString;
+        emit pair.second->finishedWithError(QNetworkReply::ContentReSendError, errorString);
+        return;
+    }
+    m_channel->spdyRequestsToSend.insertMulti(pair.first.priority(), pair);
+}
+
+void QHttp2ProtocolHandler::removeStream(Stream &stream)
+{
+    const quint32 streamID = stream.id;
+    stream.pair.second->disconnect(this);
+    if (QNonContiguousByteDevice *device = stream.pair.first.uploadByteDevice())
+        device->disconnect(this);
+    m_activeStreams.remove(streamID);
+}
+
+void QHttp2ProtocolHandler::closeIfDone()
+{
+    // after GOAWAY no new streams may be opened on this connection
+    if (m_goingAway && m_activeStreams.isEmpty() && !m_closing) {
+        m_closing = true;
+        m_channel->close();
+    }
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
@@ -0,0 +1,194 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QHTTP2PROTOCOLHANDLER_P_H
+#define QHTTP2PROTOCOLHANDLER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qabstractprotocolhandler_p.h>
+#include <private/qhpack_p.h>
+#include <private/qhttpnetworkrequest_p.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtCore/qhash.h>
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+#ifndef HttpMessagePair
+typedef QPair<QHttpNetworkRequest, QHttpNetworkReply*> HttpMessagePair;
+#endif
+
+class QHttp2ProtocolHandler : public QObject, public QAbstractProtocolHandler {
+    Q_OBJECT
+public:
+    QHttp2ProtocolHandler(QHttpNetworkConnectionChannel *channel);
+    ~QHttp2ProtocolHandler();
+
+    virtual void _q_receiveReply() Q_DECL_OVERRIDE;
+    virtual void _q_readyRead() Q_DECL_OVERRIDE;
+    virtual bool sendRequest() Q_DECL_OVERRIDE;
+
+private slots:
+    void _q_uploadDataReadyRead();
+    void _q_replyDestroyed(QObject*);
+    void _q_socketDisconnected();
+
+private:
+    // RFC 7540, 6
+    enum FrameType {
+        FrameType_DATA = 0x0,
+        FrameType_HEADERS = 0x1,
+        FrameType_PRIORITY = 0x2,
+        FrameType_RST_STREAM = 0x3,
+        FrameType_SETTINGS = 0x4,
+        FrameType_PUSH_PROMISE = 0x5,
+        FrameType_PING = 0x6,
+        FrameType_GOAWAY = 0x7,
+        FrameType_WINDOW_UPDATE = 0x8,
+        FrameType_CONTINUATION = 0x9
+    };
+
+    enum FrameFlag {
+        FrameFlag_END_STREAM = 0x1,
+        FrameFlag_ACK = 0x1,
+        FrameFlag_END_HEADERS = 0x4,
+        FrameFlag_PADDED = 0x8,
+        FrameFlag_PRIORITY = 0x20
+    };
+
+    // RFC 7540, 6.5.2
+    enum SettingsID {
+        SETTINGS_HEADER_TABLE_SIZE = 0x1,
+        SETTINGS_ENABLE_PUSH = 0x2,
+        SETTINGS_MAX_CONCURRENT_STREAMS = 0x3,
+        SETTINGS_INITIAL_WINDOW_SIZE = 0x4,
+        SETTINGS_MAX_FRAME_SIZE = 0x5,
+        SETTINGS_MAX_HEADER_LIST_SIZE = 0x6
+    };
+
+    // RFC 7540, 7
+    enum ErrorCode {
+        ErrorCode_NO_ERROR = 0x0,
+        ErrorCode_PROTOCOL_ERROR = 0x1,
+        ErrorCode_INTERNAL_ERROR = 0x2,
+        ErrorCode_FLOW_CONTROL_ERROR = 0x3,
+        ErrorCode_SETTINGS_TIMEOUT = 0x4,
+        ErrorCode_STREAM_CLOSED = 0x5,
+        ErrorCode_FRAME_SIZE_ERROR = 0x6,
+        ErrorCode_REFUSED_STREAM = 0x7,
+        ErrorCode_CANCEL = 0x8,
+        ErrorCode_COMPRESSION_ERROR = 0x9,
+        ErrorCode_CONNECT_ERROR = 0xa,
+        ErrorCode_ENHANCE_YOUR_CALM = 0xb,
+        ErrorCode_INADEQUATE_SECURITY = 0xc,
+        ErrorCode_HTTP_1_1_REQUIRED = 0xd
+    };
+
+    struct Stream
+    {
+        Stream() : id(0), sendWindow(0), receiveWindow(0), uploading(false), headersReceived(false) {}
+
+        HttpMessagePair pair;
+        quint32 id;
+        qint32 sendWindow;
+        qint32 receiveWindow;
+        bool uploading;
+        bool headersReceived;
+    };
+
+    void sendFrame(FrameType type, uchar flags, quint32 streamID,
+                   const char *payload, quint32 length);
+    void sendHEADERS(Stream &stream);
+    void sendRST_STREAM(quint32 streamID, ErrorCode errorCode);
+    void sendGOAWAY(ErrorCode errorCode);
+    void sendWINDOW_UPDATE(quint32 streamID, quint32 delta);
+    bool uploadData(Stream &stream);
+
+    bool handleFrame(FrameType type, uchar flags, quint32 streamID, const QByteArray &payload);
+    bool handleDATA(uchar flags, quint32 streamID, const QByteArray &payload);
+    bool handleHEADERS(uchar flags, quint32 streamID, const QByteArray &payload);
+    bool handleCONTINUATION(uchar flags, quint32 streamID, const QByteArray &payload);
+    bool handleRST_STREAM(quint32 streamID, const QByteArray &payload);
+    bool handleSETTINGS(uchar flags, quint32 streamID, const QByteArray &payload);
+    bool handlePING(uchar flags, quint32 streamID, const QByteArray &payload);
+    bool handleGOAWAY(quint32 streamID, const QByteArray &payload);
+    bool handleWINDOW_UPDATE(quint32 streamID, const QByteArray &payload);
+    bool handleHeaderBlock(quint32 streamID);
+
+    void connectionError(ErrorCode errorCode, const char *errorMessage);
+    void finishStream(Stream &stream);
+    void finishStreamWithError(Stream &stream, QNetworkReply::NetworkError errorCode,
+                               const QString &errorMessage);
+    void requeueStream(Stream &stream);
+    void removeStream(Stream &stream);
+    void closeIfDone();
+
+    QHash<quint32, Stream> m_activeStreams;
+    quint32 m_nextStreamID;
+    quint32 m_maxConcurrentStreams;
+
+    // flow control, RFC 7540 6.9
+    qint32 m_sendWindow;
+    qint32 m_receiveWindow;
+    qint32 m_peerInitialWindowSize;
+    quint32 m_peerMaxFrameSize;
+
+    QHPackEncoder m_encoder;
+    QHPackDecoder m_decoder;
+
+    QByteArray m_buffer; // received but not yet processed frames
+    QByteArray m_headerBlock; // header block fragments awaiting CONTINUATION
+    quint32 m_continuedStreamID;
+    bool m_endStreamAfterHeaders;
+    bool m_peerSettingsReceived;
+    bool m_goingAway;
+    bool m_closing;
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
+
+#endif // QHTTP2PROTOCOLHANDLER_P_H
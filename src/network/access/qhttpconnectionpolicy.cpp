@@ -0,0 +1,223 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttpconnectionpolicy.h"
+
+QT_BEGIN_NAMESPACE
+
+class QHttpConnectionPolicyPrivate : public QSharedData
+{
+public:
+    QHttpConnectionPolicyPrivate()
+        : maximumConnectionCount(6),
+          maximumPipelineLength(3),
+          idleTimeout(120),
+          pipeliningEnabled(false)
+    { }
+
+    bool operator==(const QHttpConnectionPolicyPrivate &other) const
+    {
+        return maximumConnectionCount == other.maximumConnectionCount
+            && maximumPipelineLength == other.maximumPipelineLength
+            && idleTimeout == other.idleTimeout
+            && pipeliningEnabled == other.pipeliningEnabled;
+    }
+
+    int maximumConnectionCount;
+    int maximumPipelineLength;
+    int idleTimeout;
+    bool pipeliningEnabled;
+};
+
+/*!
+    \class QHttpConnectionPolicy
+    \brief The QHttpConnectionPolicy class describes how QNetworkAccessManager
+    uses the connections to an HTTP server.
+    \since 5.7
+
+    \ingroup network
+    \ingroup shared
+    \inmodule QtNetwork
+
+    For HTTP/1.1, QNetworkAccessManager opens up to six persistent
+    connections to each server and sends one request at a time on each of
+    them. This suits a browser that talks to many servers, but an application
+    that sends most of its requests to a single server can do better with
+    more connections and with HTTP pipelining, where several requests are
+    sent on a connection without waiting for the replies.
+
+    A policy is set for all servers or for a single host with
+    QNetworkAccessManager::setHttpConnectionPolicy():
+
+    \snippet code/src_network_access_qhttpconnectionpolicy.cpp 0
+
+    The policy applies to HTTP and HTTPS connections that are opened after
+    it has been set.
+
+    \sa QNetworkAccessManager::setHttpConnectionPolicy(),
+    QNetworkRequest::HttpPipeliningAllowedAttribute
+*/
+
+/*!
+    Constructs a policy with the default settings: six connections per
+    server, no pipelining unless a request allows it and an idle timeout of
+    two minutes.
+*/
+QHttpConnectionPolicy::QHttpConnectionPolicy()
+    : d(new QHttpConnectionPolicyPrivate)
+{
+}
+
+/*!
+    Creates a copy of \a other.
+*/
+QHttpConnectionPolicy::QHttpConnectionPolicy(const QHttpConnectionPolicy &other)
+    : d(other.d)
+{
+}
+
+/*!
+    Destroys the policy.
+*/
+QHttpConnectionPolicy::~QHttpConnectionPolicy()
+{
+}
+
+/*!
+    Makes this policy a copy of \a other.
+*/
+QHttpConnectionPolicy &QHttpConnectionPolicy::operator=(const QHttpConnectionPolicy &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    \fn void QHttpConnectionPolicy::swap(QHttpConnectionPolicy &other)
+
+    Swaps this policy with \a other. This function is very fast and never
+    fails.
+*/
+
+/*!
+    Returns \c true if this policy has the same settings as \a other.
+
+    \sa operator!=()
+*/
+bool QHttpConnectionPolicy::operator==(const QHttpConnectionPolicy &other) const
+{
+    return d == other.d || *d == *other.d;
+}
+
+/*!
+    \fn bool QHttpConnectionPolicy::operator!=(const QHttpConnectionPolicy &other) const
+
+    Returns \c true if this policy has different settings than \a other.
+
+    \sa operator==()
+*/
+
+/*!
+    Sets the maximum number of connections that are opened to a server at
+    the same time to \a count. The default is 6. Values less than 1 are
+    treated as 1.
+
+    Connections are only opened when there are requests waiting for one.
+*/
+void QHttpConnectionPolicy::setMaximumConnectionCount(int count)
+{
+    d->maximumConnectionCount = qBound(1, count, 0xffff);
+}
+
+int QHttpConnectionPolicy::maximumConnectionCount() const
+{
+    return d->maximumConnectionCount;
+}
+
+/*!
+    If \a enable is true, GET requests are pipelined unless the
+    QNetworkRequest::HttpPipeliningAllowedAttribute of the request is set
+    to \c false. By default, only requests that set this attribute to
+    \c true are pipelined.
+
+    Pipelining only works with servers that support it; it is turned off for
+    connections whose server does not announce HTTP/1.1 persistent
+    connections.
+
+    \sa setMaximumPipelineLength()
+*/
+void QHttpConnectionPolicy::setPipeliningEnabled(bool enable)
+{
+    d->pipeliningEnabled = enable;
+}
+
+bool QHttpConnectionPolicy::isPipeliningEnabled() const
+{
+    return d->pipeliningEnabled;
+}
+
+/*!
+    Sets the number of requests that are sent on a connection while it is
+    still waiting for the reply to the current request to \a length. The
+    default is 3.
+*/
+void QHttpConnectionPolicy::setMaximumPipelineLength(int length)
+{
+    d->maximumPipelineLength = qMax(1, length);
+}
+
+int QHttpConnectionPolicy::maximumPipelineLength() const
+{
+    return d->maximumPipelineLength;
+}
+
+/*!
+    Sets the time after which the connections to a server are closed when
+    no request has used them to \a seconds. The default is 120 seconds.
+
+    Servers close idle connections after a timeout of their own, so a value
+    greater than the server's keep-alive timeout does not keep connections
+    open for longer.
+*/
+void QHttpConnectionPolicy::setIdleTimeout(int seconds)
+{
+    d->idleTimeout = qMax(0, seconds);
+}
+
+int QHttpConnectionPolicy::idleTimeout() const
+{
+    return d->idleTimeout;
+}
+
+QT_END_NAMESPACE
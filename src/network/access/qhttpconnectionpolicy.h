@@ -0,0 +1,82 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QHTTPCONNECTIONPOLICY_H
+#define QHTTPCONNECTIONPOLICY_H
+
+#include <QtCore/QSharedDataPointer>
+
+QT_BEGIN_NAMESPACE
+
+
+class QHttpConnectionPolicyPrivate;
+
+class Q_NETWORK_EXPORT QHttpConnectionPolicy
+{
+public:
+    QHttpConnectionPolicy();
+    QHttpConnectionPolicy(const QHttpConnectionPolicy &other);
+    ~QHttpConnectionPolicy();
+#ifdef Q_COMPILER_RVALUE_REFS
+    QHttpConnectionPolicy &operator=(QHttpConnectionPolicy &&other) Q_DECL_NOTHROW { swap(other); return *this; }
+#endif
+    QHttpConnectionPolicy &operator=(const QHttpConnectionPolicy &other);
+
+    void swap(QHttpConnectionPolicy &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    bool operator==(const QHttpConnectionPolicy &other) const;
+    inline bool operator!=(const QHttpConnectionPolicy &other) const
+    { return !operator==(other); }
+
+    void setMaximumConnectionCount(int count);
+    int maximumConnectionCount() const;
+
+    void setPipeliningEnabled(bool enable);
+    bool isPipeliningEnabled() const;
+
+    void setMaximumPipelineLength(int length);
+    int maximumPipelineLength() const;
+
+    void setIdleTimeout(int seconds);
+    int idleTimeout() const;
+
+private:
+    QSharedDataPointer<QHttpConnectionPolicyPrivate> d;
+};
+
+Q_DECLARE_SHARED(QHttpConnectionPolicy)
+
+QT_END_NAMESPACE
+
+#endif // QHTTPCONNECTIONPOLICY_H
@@ -0,0 +1,291 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qhttpcontentdecoder_p.h"
+
+#ifndef QT_NO_HTTP
+
+#include <private/qbytedata_p.h>
+#include <QtCore/qmutex.h>
+
+#ifndef QT_NO_COMPRESS
+#include <zlib.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+QHttpContentDecoder::~QHttpContentDecoder()
+{
+}
+
+#ifndef QT_NO_COMPRESS
+class QHttpZlibDecoder : public QHttpContentDecoder
+{
+public:
+    QHttpZlibDecoder();
+    ~QHttpZlibDecoder();
+
+    bool isValid() const { return initialized; }
+    qint64 decode(const char *data, qint64 size, QByteDataBuffer *out) Q_DECL_OVERRIDE;
+
+private:
+    bool initialize(int windowBits);
+
+    enum {
+        MinimumBlockSize = 4 * 1024,
+        MaximumBlockSize = 64 * 1024
+    };
+
+    z_stream stream;
+    // the input seen before any output, to start over as raw deflate
+    QByteArray consumedInput;
+    bool initialized;
+    // also set once it's too late to start over
+    bool triedRawDeflate;
+    bool finished;
+};
+
+QHttpZlibDecoder::QHttpZlibDecoder()
+    : initialized(false), triedRawDeflate(false), finished(false)
+{
+    // "windowBits can also be greater than 15 for optional gzip decoding.
+    // Add 32 to windowBits to enable zlib and gzip decoding with automatic header detection"
+    // http://www.zlib.net/manual.html
+    initialize(MAX_WBITS + 32);
+}
+
+QHttpZlibDecoder::~QHttpZlibDecoder()
+{
+    if (initialized)
+        inflateEnd(&stream);
+}
+
+bool QHttpZlibDecoder::initialize(int windowBits)
+{
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    stream.avail_in = 0;
+    stream.next_in = Z_NULL;
+    initialized = inflateInit2(&stream, windowBits) == Z_OK;
+    return initialized;
+}
+
+qint64 QHttpZlibDecoder::decode(const char *data, qint64 size, QByteDataBuffer *out)
+{
+    if (!initialized)
+        return -1;
+
+    qint64 written = 0;
+    // zlib does not change the input, so it is safe to const_cast here
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream.avail_in = uInt(size);
+
+    QByteArray input;
+    bool more = stream.avail_in > 0;
+    while (more && !finished) {
+        // Inflate straight into the block the reader will get; a guess of
+        // four times the input keeps blocks reasonably full for text.
+        QByteArray block(int(qBound<qint64>(MinimumBlockSize, qint64(stream.avail_in) * 4,
+                                            MaximumBlockSize)),
+                         Qt::Uninitialized);
+        stream.next_out = reinterpret_cast<Bytef *>(block.data());
+        stream.avail_out = uInt(block.size());
+
+        const int ret = inflate(&stream, Z_NO_FLUSH);
+        if (ret == Z_DATA_ERROR && !triedRawDeflate && stream.total_out == 0) {
+            // Some servers send "deflate" as raw RFC 1951 data instead of the
+            // zlib format; start over with everything received so far.
+            triedRawDeflate = true;
+            inflateEnd(&stream);
+            if (!initialize(-MAX_WBITS))
+                return -1;
+            input = consumedInput + QByteArray::fromRawData(data, int(size));
+            consumedInput.clear();
+            stream.next_in = reinterpret_cast<Bytef *>(input.data());
+            stream.avail_in = uInt(input.size());
+            continue;
+        }
+        // Z_BUF_ERROR only means that no progress was possible: all input
+        // has been consumed and no output was pending
+        if (ret == Z_BUF_ERROR)
+            break;
+        // all other negative return codes are errors; in the context of HTTP
+        // compression, Z_NEED_DICT is also an error
+        if (ret < 0 || ret == Z_NEED_DICT)
+            return -1;
+
+        const int produced = block.size() - int(stream.avail_out);
+        if (produced) {
+            block.resize(produced);
+            out->append(block);
+            written += produced;
+        }
+        if (ret == Z_STREAM_END)
+            finished = true;
+        // a full block may leave output pending inside zlib after the last
+        // input has been consumed
+        more = stream.avail_in > 0 || stream.avail_out == 0;
+    }
+
+    if (!triedRawDeflate && stream.total_out == 0
+        && consumedInput.size() + size <= MinimumBlockSize) {
+        consumedInput.append(data, int(size));
+    } else if (!triedRawDeflate) {
+        // once there is output, or more input than any zlib or gzip header
+        // is rejected after, it's too late to start over
+        triedRawDeflate = true;
+        consumedInput.clear();
+    }
+    return written;
+}
+#endif // QT_NO_COMPRESS
+
+class QHttpContentDecoderFactoryData: public QList<QHttpContentDecoderFactory *>
+{
+public:
+    QHttpContentDecoderFactoryData()
+    {
+        valid.ref();
+    }
+    ~QHttpContentDecoderFactoryData()
+    {
+        QMutexLocker locker(&mutex);
+        valid.deref();
+    }
+
+    QMutex mutex;
+    // this is used to avoid (re)constructing factory data from destructors of other global classes
+    static QBasicAtomicInt valid;
+};
+Q_GLOBAL_STATIC(QHttpContentDecoderFactoryData, factoryData)
+QBasicAtomicInt QHttpContentDecoderFactoryData::valid = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+static bool isBuiltInEncoding(const QByteArray &encoding)
+{
+#ifndef QT_NO_COMPRESS
+    return encoding == "gzip" || encoding == "deflate";
+#else
+    Q_UNUSED(encoding);
+    return false;
+#endif
+}
+
+QHttpContentDecoderFactory::QHttpContentDecoderFactory()
+{
+    QMutexLocker locker(&factoryData()->mutex);
+    factoryData()->append(this);
+}
+
+QHttpContentDecoderFactory::~QHttpContentDecoderFactory()
+{
+    if (QHttpContentDecoderFactoryData::valid.load()) {
+        QMutexLocker locker(&factoryData()->mutex);
+        factoryData()->removeAll(this);
+    }
+}
+
+bool QHttpContentDecoderFactory::isSupported(const QByteArray &encoding)
+{
+    const QByteArray name = encoding.trimmed().toLower();
+    if (name.isEmpty())
+        return false;
+    if (isBuiltInEncoding(name))
+        return true;
+
+    if (QHttpContentDecoderFactoryData::valid.load()) {
+        QMutexLocker locker(&factoryData()->mutex);
+        QHttpContentDecoderFactoryData::ConstIterator it = factoryData()->constBegin(),
+                                                     end = factoryData()->constEnd();
+        for ( ; it != end; ++it) {
+            if ((*it)->supportedEncodings().contains(name))
+                return true;
+        }
+    }
+    return false;
+}
+
+QHttpContentDecoder *QHttpContentDecoderFactory::createDecoder(const QByteArray &encoding)
+{
+    const QByteArray name = encoding.trimmed().toLower();
+    if (name.isEmpty())
+        return 0;
+
+    if (QHttpContentDecoderFactoryData::valid.load()) {
+        QMutexLocker locker(&factoryData()->mutex);
+        QHttpContentDecoderFactoryData::ConstIterator it = factoryData()->constBegin(),
+                                                     end = factoryData()->constEnd();
+        for ( ; it != end; ++it) {
+            if ((*it)->supportedEncodings().contains(name)) {
+                if (QHttpContentDecoder *decoder = (*it)->create(name))
+                    return decoder;
+            }
+        }
+    }
+
+#ifndef QT_NO_COMPRESS
+    if (isBuiltInEncoding(name)) {
+        QHttpZlibDecoder *decoder = new QHttpZlibDecoder;
+        if (decoder->isValid())
+            return decoder;
+        delete decoder;
+    }
+#endif
+    return 0;
+}
+
+QByteArray QHttpContentDecoderFactory::acceptEncoding()
+{
+    QList<QByteArray> encodings;
+#ifndef QT_NO_COMPRESS
+    encodings << QByteArrayLiteral("gzip") << QByteArrayLiteral("deflate");
+#endif
+
+    if (QHttpContentDecoderFactoryData::valid.load()) {
+        QMutexLocker locker(&factoryData()->mutex);
+        QHttpContentDecoderFactoryData::ConstIterator it = factoryData()->constBegin(),
+                                                     end = factoryData()->constEnd();
+        for ( ; it != end; ++it) {
+            const QList<QByteArray> supported = (*it)->supportedEncodings();
+            for (int i = 0; i < supported.count(); ++i) {
+                if (!encodings.contains(supported.at(i)))
+                    encodings << supported.at(i);
+            }
+        }
+    }
+    return encodings.join(", ");
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
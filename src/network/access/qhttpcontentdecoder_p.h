@@ -0,0 +1,94 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QHTTPCONTENTDECODER_P_H
+#define QHTTPCONTENTDECODER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the Network Access API.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+
+#ifndef QT_NO_HTTP
+
+QT_BEGIN_NAMESPACE
+
+class QByteDataBuffer;
+
+// Decodes one HTTP content-coding (RFC 7231, 3.1.2.1) of a reply body.
+// Input arrives in arbitrary pieces as it is read from the connection.
+class Q_NETWORK_EXPORT QHttpContentDecoder
+{
+public:
+    virtual ~QHttpContentDecoder();
+
+    // Decodes size bytes and appends the output to out. Implementations
+    // should write into the blocks they append rather than into a temporary
+    // buffer, since those blocks are handed to the reader as they are.
+    // Returns the number of bytes appended, or -1 if the data is corrupt.
+    virtual qint64 decode(const char *data, qint64 size, QByteDataBuffer *out) = 0;
+};
+
+// Constructing a factory registers it; registered factories take precedence
+// over the built-in gzip and deflate decoders.
+class Q_NETWORK_EXPORT QHttpContentDecoderFactory
+{
+public:
+    QHttpContentDecoderFactory();
+    virtual ~QHttpContentDecoderFactory();
+
+    // lower case content-codings, e.g. "br"
+    virtual QList<QByteArray> supportedEncodings() const = 0;
+    virtual QHttpContentDecoder *create(const QByteArray &encoding) const = 0;
+
+    static bool isSupported(const QByteArray &encoding);
+    static QHttpContentDecoder *createDecoder(const QByteArray &encoding);
+    // the value sent as Accept-Encoding, or empty if nothing can be decoded
+    static QByteArray acceptEncoding();
+};
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_HTTP
+
+#endif // QHTTPCONTENTDECODER_P_H
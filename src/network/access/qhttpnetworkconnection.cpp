@@ -35,6 +35,7 @@
 #include <private/qabstractsocket_p.h>
 #include "qhttpnetworkconnectionchannel_p.h"
 #include "private/qnoncontiguousbytedevice_p.h"
+#include "private/qhttpcontentdecoder_p.h"
 #include <private/qnetworkrequest_p.h>
 #include <private/qobject_p.h>
 #include <private/qauthenticator_p.h>
@@ -75,15 +76,13 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(const QString &host
 : state(RunningState),
   networkLayerState(Unknown),
   hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true)
-#ifndef QT_NO_SSL
-, channelCount((type == QHttpNetworkConnection::ConnectionTypeSPDY) ? 1 : defaultHttpChannelCount)
-#else
-, channelCount(defaultHttpChannelCount)
-#endif // QT_NO_SSL
+, channelCount((type == QHttpNetworkConnection::ConnectionTypeSPDY
+                || type == QHttpNetworkConnection::ConnectionTypeHTTP2) ? 1 : defaultHttpChannelCount)
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
   , preConnectRequests(0)
+  , pipelineLength(defaultPipelineLength)
   , connectionType(type)
 {
     channels = new QHttpNetworkConnectionChannel[channelCount];
@@ -99,6 +98,7 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(quint16 channelCoun
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
   , preConnectRequests(0)
+  , pipelineLength(defaultPipelineLength)
   , connectionType(type)
 {
     channels = new QHttpNetworkConnectionChannel[channelCount];
@@ -283,19 +283,21 @@ void QHttpNetworkConnectionPrivate::prepareRequest(HttpMessagePair &messagePair)
 #endif
 
     // If the request had a accept-encoding set, we better not mess
-    // with it. If it was not set, we announce that we understand gzip
-    // and remember this fact in request.d->autoDecompress so that
-    // we can later decompress the HTTP reply if it has such an
-    // encoding.
+    // with it. If it was not set, we announce the content-codings we
+    // can decode (gzip and deflate, plus those of registered
+    // QHttpContentDecoderFactory instances) and remember this fact in
+    // request.d->autoDecompress so that we can later decode the HTTP
+    // reply if it has such an encoding.
     value = request.headerField("accept-encoding");
     if (value.isEmpty()) {
-#ifndef QT_NO_COMPRESS
-        request.setHeaderField("Accept-Encoding", "gzip, deflate");
-        request.d->autoDecompress = true;
-#else
-        // if zlib is not available set this to false always
-        request.d->autoDecompress = false;
-#endif
+        const QByteArray acceptEncoding = QHttpContentDecoderFactory::acceptEncoding();
+        if (!acceptEncoding.isEmpty()) {
+            request.setHeaderField("Accept-Encoding", acceptEncoding);
+            request.d->autoDecompress = true;
+        } else {
+            // no decoder is available (e.g. no zlib)
+            request.d->autoDecompress = false;
+        }
     }
 
     // some websites mandate an accept-language header and fail
@@ -609,13 +611,11 @@ QHttpNetworkReply* QHttpNetworkConnectionPrivate::queueRequest(const QHttpNetwor
             break;
         }
     }
-#ifndef QT_NO_SSL
-    else { // SPDY
+    else { // SPDY, HTTP/2
         if (!pair.second->d_func()->requestIsPrepared)
             prepareRequest(pair);
         channels[0].spdyRequestsToSend.insertMulti(request.priority(), pair);
     }
-#endif // QT_NO_SSL
 
     // For Happy Eyeballs the networkLayerState is set to Unknown
     // untill we have started the first connection attempt. So no
@@ -705,7 +705,9 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
     if (channels[i].reply == 0)
         return;
 
-    if (! (defaultPipelineLength - channels[i].alreadyPipelinedRequests.length() >= defaultRePipelineLength)) {
+    // with a short pipeline, re-fill as soon as there's room for one more request
+    const int rePipelineLength = qMin(defaultRePipelineLength, pipelineLength);
+    if (! (pipelineLength - channels[i].alreadyPipelinedRequests.length() >= rePipelineLength)) {
         return;
     }
 
@@ -749,7 +751,7 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
         lengthBefore = channels[i].alreadyPipelinedRequests.length();
         fillPipeline(highPriorityQueue, channels[i]);
 
-        if (channels[i].alreadyPipelinedRequests.length() >= defaultPipelineLength) {
+        if (channels[i].alreadyPipelinedRequests.length() >= pipelineLength) {
             channels[i].pipelineFlush();
             return;
         }
@@ -762,7 +764,7 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
         lengthBefore = channels[i].alreadyPipelinedRequests.length();
         fillPipeline(lowPriorityQueue, channels[i]);
 
-        if (channels[i].alreadyPipelinedRequests.length() >= defaultPipelineLength) {
+        if (channels[i].alreadyPipelinedRequests.length() >= pipelineLength) {
             channels[i].pipelineFlush();
             return;
         }
@@ -919,19 +921,18 @@ void QHttpNetworkConnectionPrivate::removeReply(QHttpNetworkReply *reply)
                return;
             }
         }
-#ifndef QT_NO_SSL
-        // is the reply inside the SPDY pipeline of this channel already?
+        // is the reply inside the SPDY or HTTP/2 queue of this channel already?
         QMultiMap<int, HttpMessagePair>::iterator it = channels[i].spdyRequestsToSend.begin();
         QMultiMap<int, HttpMessagePair>::iterator end = channels[i].spdyRequestsToSend.end();
         for (; it != end; ++it) {
             if (it.value().second == reply) {
-                channels[i].spdyRequestsToSend.remove(it.key());
+                // erase only this entry, other requests may share its priority
+                channels[i].spdyRequestsToSend.erase(it);
 
                 QMetaObject::invokeMethod(q, "_q_startNextRequest", Qt::QueuedConnection);
                 return;
             }
         }
-#endif
     }
     // remove from the high priority queue
     if (!highPriorityQueue.isEmpty()) {
@@ -1003,8 +1004,8 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
         }
         break;
     }
-    case QHttpNetworkConnection::ConnectionTypeSPDY: {
-#ifndef QT_NO_SSL
+    case QHttpNetworkConnection::ConnectionTypeSPDY:
+    case QHttpNetworkConnection::ConnectionTypeHTTP2: {
         if (channels[0].spdyRequestsToSend.isEmpty())
             return;
 
@@ -1016,7 +1017,6 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
         if (channels[0].socket && channels[0].socket->state() == QAbstractSocket::ConnectedState
                 && !channels[0].pendingEncrypt)
             channels[0].sendRequest();
-#endif // QT_NO_SSL
         break;
     }
     }
@@ -1168,8 +1168,8 @@ void QHttpNetworkConnectionPrivate::_q_hostLookupFinished(const QHostInfo &info)
             emitReplyError(channels[0].socket, channels[0].reply, QNetworkReply::HostNotFoundError);
             networkLayerState = QHttpNetworkConnectionPrivate::Unknown;
         }
-#ifndef QT_NO_SSL
-        else if (connectionType == QHttpNetworkConnection::ConnectionTypeSPDY) {
+        else if (connectionType == QHttpNetworkConnection::ConnectionTypeSPDY
+                 || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2) {
             QList<HttpMessagePair> spdyPairs = channels[0].spdyRequestsToSend.values();
             for (int a = 0; a < spdyPairs.count(); ++a) {
                 // emit error for all replies
@@ -1178,7 +1178,6 @@ void QHttpNetworkConnectionPrivate::_q_hostLookupFinished(const QHostInfo &info)
                 emitReplyError(channels[0].socket, currentReply, QNetworkReply::HostNotFoundError);
             }
         }
-#endif // QT_NO_SSL
         else {
             // Should not happen
             qWarning() << "QHttpNetworkConnectionPrivate::_q_hostLookupFinished could not dequeu request";
@@ -1321,6 +1320,18 @@ QHttpNetworkConnectionChannel *QHttpNetworkConnection::channels() const
     return d_func()->channels;
 }
 
+void QHttpNetworkConnection::setMaximumPipelineLength(int length)
+{
+    Q_D(QHttpNetworkConnection);
+    d->pipelineLength = qMax(1, length);
+}
+
+int QHttpNetworkConnection::maximumPipelineLength() const
+{
+    Q_D(const QHttpNetworkConnection);
+    return d->pipelineLength;
+}
+
 #ifndef QT_NO_NETWORKPROXY
 void QHttpNetworkConnection::setCacheProxy(const QNetworkProxy &networkProxy)
 {
@@ -1441,19 +1452,16 @@ void QHttpNetworkConnectionPrivate::emitProxyAuthenticationRequired(const QHttpN
     // dialog is displaying
     pauseConnection();
     QHttpNetworkReply *reply;
-#ifndef QT_NO_SSL
-    if (connectionType == QHttpNetworkConnection::ConnectionTypeSPDY) {
+    if (connectionType == QHttpNetworkConnection::ConnectionTypeSPDY
+            || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2) {
         // we choose the reply to emit the proxyAuth signal from somewhat arbitrarily,
         // but that does not matter because the signal will ultimately be emitted
         // by the QNetworkAccessManager.
         Q_ASSERT(chan->spdyRequestsToSend.count() > 0);
         reply = chan->spdyRequestsToSend.cbegin().value().second;
     } else { // HTTP
-#endif // QT_NO_SSL
         reply = chan->reply;
-#ifndef QT_NO_SSL
     }
-#endif // QT_NO_SSL
 
     Q_ASSERT(reply);
     emit reply->proxyAuthenticationRequired(proxy, auth);
@@ -91,7 +91,8 @@ public:
 
     enum ConnectionType {
         ConnectionTypeHTTP,
-        ConnectionTypeSPDY
+        ConnectionTypeSPDY,
+        ConnectionTypeHTTP2
     };
 
 #ifndef QT_NO_BEARERMANAGEMENT
@@ -133,6 +134,10 @@ public:
 
     QHttpNetworkConnectionChannel *channels() const;
 
+    // maximum number of requests pipelined on one channel
+    void setMaximumPipelineLength(int length);
+    int maximumPipelineLength() const;
+
     ConnectionType connectionType();
     void setConnectionType(ConnectionType type);
 
@@ -155,6 +160,7 @@ private:
     friend class QHttpNetworkConnectionChannel;
     friend class QHttpProtocolHandler;
     friend class QSpdyProtocolHandler;
+    friend class QHttp2ProtocolHandler;
 
     Q_PRIVATE_SLOT(d_func(), void _q_startNextRequest())
     Q_PRIVATE_SLOT(d_func(), void _q_hostLookupFinished(QHostInfo))
@@ -262,6 +268,7 @@ public:
     QList<HttpMessagePair> lowPriorityQueue;
 
     int preConnectRequests;
+    int pipelineLength;
 
     QHttpNetworkConnection::ConnectionType connectionType;
 
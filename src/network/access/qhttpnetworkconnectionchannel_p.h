@@ -113,17 +113,17 @@ public:
     bool authenticationCredentialsSent;
     bool proxyCredentialsSent;
     QScopedPointer<QAbstractProtocolHandler> protocolHandler;
+    QMultiMap<int, HttpMessagePair> spdyRequestsToSend; // sorted by priority, also used for HTTP/2
+    void requeueSpdyRequests(); // when we wanted SPDY or HTTP/2 but got HTTP
+    // to emit the signal for all in-flight replies:
+    void emitFinishedWithError(QNetworkReply::NetworkError error, const char *message);
 #ifndef QT_NO_SSL
     bool ignoreAllSslErrors;
     QList<QSslError> ignoreSslErrorsList;
     QSslConfiguration sslConfiguration;
-    QMultiMap<int, HttpMessagePair> spdyRequestsToSend; // sorted by priority
     void ignoreSslErrors();
     void ignoreSslErrors(const QList<QSslError> &errors);
     void setSslConfiguration(const QSslConfiguration &config);
-    void requeueSpdyRequests(); // when we wanted SPDY but got HTTP
-    // to emit the signal for all in-flight replies:
-    void emitFinishedWithError(QNetworkReply::NetworkError error, const char *message);
 #endif
 #ifndef QT_NO_BEARERMANAGEMENT
     QSharedPointer<QNetworkSession> networkSession;
@@ -44,9 +44,7 @@
 #    include <QtNetwork/qsslconfiguration.h>
 #endif
 
-#ifndef QT_NO_COMPRESS
-#include <zlib.h>
-#endif
+#include "private/qhttpcontentdecoder_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -61,11 +59,6 @@ QHttpNetworkReply::~QHttpNetworkReply()
     if (d->connection) {
         d->connection->d_func()->removeReply(this);
     }
-
-#ifndef QT_NO_COMPRESS
-    if (d->autoDecompress && d->isCompressed() && d->inflateStrm)
-        inflateEnd(d->inflateStrm);
-#endif
 }
 
 QUrl QHttpNetworkReply::url() const
@@ -295,6 +288,16 @@ void QHttpNetworkReply::setSpdyWasUsed(bool spdy)
     d_func()->spdyUsed = spdy;
 }
 
+bool QHttpNetworkReply::isHttp2Used() const
+{
+    return d_func()->http2Used;
+}
+
+void QHttpNetworkReply::setHttp2WasUsed(bool http2)
+{
+    d_func()->http2Used = http2;
+}
+
 bool QHttpNetworkReply::isRedirecting() const
 {
     return d_func()->isRedirecting();
@@ -324,12 +327,9 @@ QHttpNetworkReplyPrivate::QHttpNetworkReplyPrivate(const QUrl &newUrl)
       totallyUploadedData(0),
       connection(0),
       autoDecompress(false), responseData(), requestIsPrepared(false)
-      ,pipeliningUsed(false), spdyUsed(false), downstreamLimited(false)
+      ,pipeliningUsed(false), spdyUsed(false), http2Used(false), downstreamLimited(false)
       ,userProvidedDownloadBuffer(0)
-#ifndef QT_NO_COMPRESS
-      ,inflateStrm(0)
-#endif
-
+      ,contentDecoder(0)
 {
     QString scheme = newUrl.scheme();
     if (scheme == QLatin1String("preconnect-http")
@@ -340,10 +340,7 @@ QHttpNetworkReplyPrivate::QHttpNetworkReplyPrivate(const QUrl &newUrl)
 
 QHttpNetworkReplyPrivate::~QHttpNetworkReplyPrivate()
 {
-#ifndef QT_NO_COMPRESS
-      if (inflateStrm)
-          delete inflateStrm;
-#endif
+    delete contentDecoder;
 }
 
 void QHttpNetworkReplyPrivate::clearHttpLayerInformation()
@@ -357,10 +354,9 @@ void QHttpNetworkReplyPrivate::clearHttpLayerInformation()
     currentChunkRead = 0;
     lastChunkRead = false;
     connectionCloseEnabled = true;
-#ifndef QT_NO_COMPRESS
-    if (autoDecompress && inflateStrm)
-        inflateEnd(inflateStrm);
-#endif
+    delete contentDecoder;
+    contentDecoder = 0;
+    compressedData.clear();
     fields.clear();
 }
 
@@ -381,8 +377,7 @@ qint64 QHttpNetworkReplyPrivate::bytesAvailable() const
 
 bool QHttpNetworkReplyPrivate::isCompressed()
 {
-    QByteArray encoding = headerField("content-encoding");
-    return qstricmp(encoding.constData(), "gzip") == 0 || qstricmp(encoding.constData(), "deflate") == 0;
+    return QHttpContentDecoderFactory::isSupported(headerField("content-encoding"));
 }
 
 void QHttpNetworkReplyPrivate::removeAutoDecompressHeader()
@@ -586,16 +581,10 @@ qint64 QHttpNetworkReplyPrivate::readHeader(QAbstractSocket *socket)
             (majorVersion == 1 && minorVersion == 0 &&
             (connectionHeaderField.isEmpty() && !headerField("proxy-connection").toLower().contains("keep-alive")));
 
-#ifndef QT_NO_COMPRESS
         if (autoDecompress && isCompressed()) {
-            // allocate inflate state
-            if (!inflateStrm)
-                inflateStrm = new z_stream;
-            int ret = initializeInflateStream();
-            if (ret != Z_OK)
+            if (!initializeContentDecoder())
                 return -1;
         }
-#endif
 
     }
     return bytes;
@@ -700,113 +689,70 @@ qint64 QHttpNetworkReplyPrivate::readBody(QAbstractSocket *socket, QByteDataBuff
 {
     qint64 bytes = 0;
 
-#ifndef QT_NO_COMPRESS
-    // for gzip we'll allocate a temporary one that we then decompress
-    QByteDataBuffer *tempOutDataBuffer = (autoDecompress ? new QByteDataBuffer : out);
-#else
-    QByteDataBuffer *tempOutDataBuffer = out;
-#endif
-
-
-    if (isChunked()) {
+    if (autoDecompress) {
+        // Compressed data is decoded as it arrives, straight into the blocks
+        // of out; only the compressed bytes of the current read are buffered.
+        if (isChunked()) {
+            QByteDataBuffer chunks;
+            bytes += readReplyBodyChunked(socket, &chunks);
+            for (int i = 0; i < chunks.bufferCount(); ++i) {
+                const QByteArray &chunk = chunks[i];
+                if (decodeBodyData(chunk.constData(), chunk.size(), out) < 0)
+                    return -1;
+            }
+        } else {
+            qint64 size = bodyLength > 0 ? bodyLength - contentRead : socket->bytesAvailable();
+            int toBeRead = qMin<qint64>(128*1024, qMin<qint64>(size, socket->bytesAvailable()));
+            if (readBufferMaxSize)
+                toBeRead = qMin<qint64>(toBeRead, readBufferMaxSize);
+            while (toBeRead > 0) {
+                // resizing keeps the capacity, so the buffer is allocated once per reply
+                compressedData.resize(toBeRead);
+                qint64 haveRead = socket->read(compressedData.data(), toBeRead);
+                if (haveRead <= 0)
+                    break;
+                if (decodeBodyData(compressedData.constData(), haveRead, out) < 0)
+                    return -1;
+                bytes += haveRead;
+                size -= haveRead;
+                toBeRead = qMin<qint64>(128*1024, qMin<qint64>(size, socket->bytesAvailable()));
+            }
+            if (bodyLength > 0 && contentRead + bytes == bodyLength)
+                state = AllDoneState;
+        }
+        if (state == AllDoneState)
+            compressedData.clear();
+    } else if (isChunked()) {
         // chunked transfer encoding (rfc 2616, sec 3.6)
-        bytes += readReplyBodyChunked(socket, tempOutDataBuffer);
+        bytes += readReplyBodyChunked(socket, out);
     } else if (bodyLength > 0) {
         // we have a Content-Length
-        bytes += readReplyBodyRaw(socket, tempOutDataBuffer, bodyLength - contentRead);
+        bytes += readReplyBodyRaw(socket, out, bodyLength - contentRead);
         if (contentRead + bytes == bodyLength)
             state = AllDoneState;
     } else {
         // no content length. just read what's possible
-        bytes += readReplyBodyRaw(socket, tempOutDataBuffer, socket->bytesAvailable());
+        bytes += readReplyBodyRaw(socket, out, socket->bytesAvailable());
     }
 
-#ifndef QT_NO_COMPRESS
-    // This is true if there is compressed encoding and we're supposed to use it.
-    if (autoDecompress) {
-        qint64 uncompressRet = uncompressBodyData(tempOutDataBuffer, out);
-        delete tempOutDataBuffer;
-        if (uncompressRet < 0)
-            return -1;
-    }
-#endif
-
     contentRead += bytes;
     return bytes;
 }
 
-#ifndef QT_NO_COMPRESS
-int QHttpNetworkReplyPrivate::initializeInflateStream()
+bool QHttpNetworkReplyPrivate::initializeContentDecoder()
 {
-    inflateStrm->zalloc = Z_NULL;
-    inflateStrm->zfree = Z_NULL;
-    inflateStrm->opaque = Z_NULL;
-    inflateStrm->avail_in = 0;
-    inflateStrm->next_in = Z_NULL;
-    // "windowBits can also be greater than 15 for optional gzip decoding.
-    // Add 32 to windowBits to enable zlib and gzip decoding with automatic header detection"
-    // http://www.zlib.net/manual.html
-    int ret = inflateInit2(inflateStrm, MAX_WBITS+32);
-    Q_ASSERT(ret == Z_OK);
-    return ret;
+    delete contentDecoder;
+    contentDecoder = QHttpContentDecoderFactory::createDecoder(headerField("content-encoding"));
+    return contentDecoder != 0;
 }
 
-qint64 QHttpNetworkReplyPrivate::uncompressBodyData(QByteDataBuffer *in, QByteDataBuffer *out)
+qint64 QHttpNetworkReplyPrivate::decodeBodyData(const char *data, qint64 size, QByteDataBuffer *out)
 {
-    if (!inflateStrm) { // happens when called from the SPDY protocol handler
-        inflateStrm = new z_stream;
-        initializeInflateStream();
-    }
-
-    if (!inflateStrm)
+    // the SPDY and HTTP/2 protocol handlers get here without readHeader()
+    if (!contentDecoder && !initializeContentDecoder())
         return -1;
-
-    bool triedRawDeflate = false;
-    for (int i = 0; i < in->bufferCount(); i++) {
-        QByteArray &bIn = (*in)[i];
-
-        inflateStrm->avail_in = bIn.size();
-        inflateStrm->next_in = reinterpret_cast<Bytef*>(bIn.data());
-
-        do {
-            QByteArray bOut;
-            // make a wild guess about the uncompressed size.
-            bOut.reserve(inflateStrm->avail_in * 3 + 512);
-            inflateStrm->avail_out = bOut.capacity();
-            inflateStrm->next_out = reinterpret_cast<Bytef*>(bOut.data());
-
-            int ret = inflate(inflateStrm, Z_NO_FLUSH);
-            //All negative return codes are errors, in the context of HTTP compression, Z_NEED_DICT is also an error.
-            // in the case where we get Z_DATA_ERROR this could be because we received raw deflate compressed data.
-            if (ret == Z_DATA_ERROR && !triedRawDeflate) {
-                inflateEnd(inflateStrm);
-                triedRawDeflate = true;
-                inflateStrm->zalloc = Z_NULL;
-                inflateStrm->zfree = Z_NULL;
-                inflateStrm->opaque = Z_NULL;
-                inflateStrm->avail_in = 0;
-                inflateStrm->next_in = Z_NULL;
-                int ret = inflateInit2(inflateStrm, -MAX_WBITS);
-                if (ret != Z_OK) {
-                    return -1;
-                } else {
-                    inflateStrm->avail_in = bIn.size();
-                    inflateStrm->next_in = reinterpret_cast<Bytef*>(bIn.data());
-                    continue;
-                }
-            } else if (ret < 0 || ret == Z_NEED_DICT) {
-                return -1;
-            }
-            bOut.resize(bOut.capacity() - inflateStrm->avail_out);
-            out->append(bOut);
-            if (ret == Z_STREAM_END)
-                return out->byteAmount();
-        } while (inflateStrm->avail_in > 0);
-    }
-
-    return out->byteAmount();
+    return contentDecoder->decode(data, size, out);
 }
-#endif
 
 qint64 QHttpNetworkReplyPrivate::readReplyBodyRaw(QAbstractSocket *socket, QByteDataBuffer *out, qint64 size)
 {
@@ -47,10 +47,6 @@
 #include <qplatformdefs.h>
 #ifndef QT_NO_HTTP
 
-#ifndef QT_NO_COMPRESS
-struct z_stream_s;
-#endif
-
 #include <QtNetwork/qtcpsocket.h>
 // it's safe to include these even if SSL support is not enabled
 #include <QtNetwork/qsslsocket.h>
@@ -74,6 +70,7 @@ class QHttpNetworkConnectionChannel;
 class QHttpNetworkRequest;
 class QHttpNetworkConnectionPrivate;
 class QHttpNetworkReplyPrivate;
+class QHttpContentDecoder;
 class Q_AUTOTEST_EXPORT QHttpNetworkReply : public QObject, public QHttpNetworkHeader
 {
     Q_OBJECT
@@ -129,6 +126,8 @@ public:
     bool isPipeliningUsed() const;
     bool isSpdyUsed() const;
     void setSpdyWasUsed(bool spdy);
+    bool isHttp2Used() const;
+    void setHttp2WasUsed(bool http2);
 
     bool isRedirecting() const;
 
@@ -172,6 +171,7 @@ private:
     friend class QHttpNetworkConnectionChannel;
     friend class QHttpProtocolHandler;
     friend class QSpdyProtocolHandler;
+    friend class QHttp2ProtocolHandler;
 };
 
 
@@ -243,28 +243,27 @@ public:
     qint32 windowSizeUpload; // only for SPDY
     qint32 currentlyReceivedDataInWindow; // only for SPDY
     qint32 currentlyUploadedDataInWindow; // only for SPDY
-    qint64 totallyUploadedData; // only for SPDY
+    qint64 totallyUploadedData; // only for SPDY and HTTP/2
     QPointer<QHttpNetworkConnection> connection;
     QPointer<QHttpNetworkConnectionChannel> connectionChannel;
 
     bool autoDecompress;
 
     QByteDataBuffer responseData; // uncompressed body
-    QByteArray compressedData; // compressed body (temporary)
+    QByteArray compressedData; // scratch buffer for compressed body data read from the socket
     bool requestIsPrepared;
 
     bool pipeliningUsed;
     bool spdyUsed;
+    bool http2Used;
     bool downstreamLimited;
 
     char* userProvidedDownloadBuffer;
     QUrl redirectUrl;
 
-#ifndef QT_NO_COMPRESS
-    z_stream_s *inflateStrm;
-    int initializeInflateStream();
-    qint64 uncompressBodyData(QByteDataBuffer *in, QByteDataBuffer *out);
-#endif
+    QHttpContentDecoder *contentDecoder;
+    bool initializeContentDecoder();
+    qint64 decodeBodyData(const char *data, qint64 size, QByteDataBuffer *out);
 };
 
 
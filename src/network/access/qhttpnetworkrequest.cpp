@@ -41,7 +41,7 @@ QT_BEGIN_NAMESPACE
 QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(QHttpNetworkRequest::Operation op,
         QHttpNetworkRequest::Priority pri, const QUrl &newUrl)
     : QHttpNetworkHeaderPrivate(newUrl), operation(op), priority(pri), uploadByteDevice(0),
-      autoDecompress(false), pipeliningAllowed(false), spdyAllowed(false),
+      autoDecompress(false), pipeliningAllowed(false), spdyAllowed(false), http2Allowed(false),
       withCredentials(true), preConnect(false), followRedirect(false), redirectCount(0)
 {
 }
@@ -55,6 +55,7 @@ QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(const QHttpNetworkRequest
     autoDecompress = other.autoDecompress;
     pipeliningAllowed = other.pipeliningAllowed;
     spdyAllowed = other.spdyAllowed;
+    http2Allowed = other.http2Allowed;
     customVerb = other.customVerb;
     withCredentials = other.withCredentials;
     ssl = other.ssl;
@@ -76,6 +77,7 @@ bool QHttpNetworkRequestPrivate::operator==(const QHttpNetworkRequestPrivate &ot
         && (autoDecompress == other.autoDecompress)
         && (pipeliningAllowed == other.pipeliningAllowed)
         && (spdyAllowed == other.spdyAllowed)
+        && (http2Allowed == other.http2Allowed)
         // we do not clear the customVerb in setOperation
         && (operation != QHttpNetworkRequest::Custom || (customVerb == other.customVerb))
         && (withCredentials == other.withCredentials)
@@ -325,6 +327,16 @@ void QHttpNetworkRequest::setSPDYAllowed(bool b)
     d->spdyAllowed = b;
 }
 
+bool QHttpNetworkRequest::isHTTP2Allowed() const
+{
+    return d->http2Allowed;
+}
+
+void QHttpNetworkRequest::setHTTP2Allowed(bool b)
+{
+    d->http2Allowed = b;
+}
+
 bool QHttpNetworkRequest::withCredentials() const
 {
     return d->withCredentials;
@@ -109,6 +109,9 @@ public:
     bool isSPDYAllowed() const;
     void setSPDYAllowed(bool b);
 
+    bool isHTTP2Allowed() const;
+    void setHTTP2Allowed(bool b);
+
     bool withCredentials() const;
     void setWithCredentials(bool b);
 
@@ -137,6 +140,7 @@ private:
     friend class QHttpNetworkConnectionChannel;
     friend class QHttpProtocolHandler;
     friend class QSpdyProtocolHandler;
+    friend class QHttp2ProtocolHandler;
 };
 
 class QHttpNetworkRequestPrivate : public QHttpNetworkHeaderPrivate
@@ -157,6 +161,7 @@ public:
     bool autoDecompress;
     bool pipeliningAllowed;
     bool spdyAllowed;
+    bool http2Allowed;
     bool withCredentials;
     bool ssl;
     bool preConnect;
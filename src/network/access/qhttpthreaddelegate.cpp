@@ -172,21 +172,28 @@ class QNetworkAccessCachedHttpConnection: public QHttpNetworkConnection,
     // Q_OBJECT
 public:
 #ifdef QT_NO_BEARERMANAGEMENT
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+    QNetworkAccessCachedHttpConnection(quint16 channelCount, const QString &hostName, quint16 port,
+                                       bool encrypt,
                                        QHttpNetworkConnection::ConnectionType connectionType)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType)
+        : QHttpNetworkConnection(channelCount, hostName, port, encrypt, /*parent=*/0, connectionType)
 #else
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+    QNetworkAccessCachedHttpConnection(quint16 channelCount, const QString &hostName, quint16 port,
+                                       bool encrypt,
                                        QHttpNetworkConnection::ConnectionType connectionType,
                                        QSharedPointer<QNetworkSession> networkSession)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType, /*parent=*/0,
-                                 qMove(networkSession))
+        : QHttpNetworkConnection(channelCount, hostName, port, encrypt, /*parent=*/0,
+                                 qMove(networkSession), connectionType)
 #endif
     {
         setExpires(true);
         setShareable(true);
     }
 
+    void setIdleTimeout(int seconds)
+    {
+        setExpiryTimeout(seconds);
+    }
+
     virtual void dispose() Q_DECL_OVERRIDE
     {
 #if 0  // sample code; do this right with the API
@@ -227,6 +234,7 @@ QHttpThreadDelegate::QHttpThreadDelegate(QObject *parent) :
     , incomingStatusCode(0)
     , isPipeliningUsed(false)
     , isSpdyUsed(false)
+    , isHttp2Used(false)
     , incomingContentLength(-1)
     , incomingErrorCode(QNetworkReply::NoError)
     , downloadBuffer(0)
@@ -290,6 +298,30 @@ void QHttpThreadDelegate::startRequest()
         incomingSslConfiguration.setAllowedNextProtocols(nextProtocols);
     }
 #endif // QT_NO_SSL
+    if (httpRequest.isHTTP2Allowed()) {
+        if (ssl) {
+#ifndef QT_NO_SSL
+            connectionType = QHttpNetworkConnection::ConnectionTypeHTTP2;
+            urlCopy.setScheme(QStringLiteral("h2")); // to differentiate HTTP/2 requests from HTTPS requests
+            QList<QByteArray> nextProtocols;
+            nextProtocols << QSslConfiguration::NextProtocolHttp2
+                          << QSslConfiguration::NextProtocolHttp1_1;
+            incomingSslConfiguration.setAllowedNextProtocols(nextProtocols);
+#endif // QT_NO_SSL
+        }
+#ifndef QT_NO_NETWORKPROXY
+        // a plain HTTP proxy would forward the request as HTTP/1.x
+        else if (transparentProxy.type() != QNetworkProxy::HttpProxy
+                 && cacheProxy.type() != QNetworkProxy::HttpProxy)
+#else
+        else
+#endif
+        {
+            // cleartext HTTP/2 with prior knowledge
+            connectionType = QHttpNetworkConnection::ConnectionTypeHTTP2;
+            urlCopy.setScheme(QStringLiteral("h2c"));
+        }
+    }
 
 #ifndef QT_NO_NETWORKPROXY
     if (transparentProxy.type() != QNetworkProxy::NoProxy)
@@ -300,6 +332,12 @@ void QHttpThreadDelegate::startRequest()
 #endif
         cacheKey = makeCacheKey(urlCopy, 0);
 
+    // SPDY and HTTP/2 multiplex everything over a single channel; for HTTP
+    // the channel count is part of the connection's identity
+    const quint16 channelCount = connectionType == QHttpNetworkConnection::ConnectionTypeSPDY
+            || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2
+            ? 1 : quint16(connectionPolicy.maximumConnectionCount());
+    cacheKey += '#' + QByteArray::number(channelCount);
 
     // the http object is actually a QHttpNetworkConnection
     httpConnection = static_cast<QNetworkAccessCachedHttpConnection *>(connections.localData()->requestEntryNow(cacheKey));
@@ -307,10 +345,12 @@ void QHttpThreadDelegate::startRequest()
         // no entry in cache; create an object
         // the http object is actually a QHttpNetworkConnection
 #ifdef QT_NO_BEARERMANAGEMENT
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
+        httpConnection = new QNetworkAccessCachedHttpConnection(channelCount, urlCopy.host(),
+                                                                urlCopy.port(), ssl,
                                                                 connectionType);
 #else
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
+        httpConnection = new QNetworkAccessCachedHttpConnection(channelCount, urlCopy.host(),
+                                                                urlCopy.port(), ssl,
                                                                 connectionType,
                                                                 networkSession);
 #endif
@@ -341,6 +381,10 @@ void QHttpThreadDelegate::startRequest()
     }
 
 
+    // the policy may have changed since the connection was cached
+    httpConnection->setMaximumPipelineLength(connectionPolicy.maximumPipelineLength());
+    httpConnection->setIdleTimeout(connectionPolicy.idleTimeout());
+
     // Send the request to the connection
     httpReply = httpConnection->sendRequest(httpRequest);
     httpReply->setParent(this);
@@ -611,6 +655,7 @@ void QHttpThreadDelegate::headerChangedSlot()
     isPipeliningUsed = httpReply->isPipeliningUsed();
     incomingContentLength = httpReply->contentLength();
     isSpdyUsed = httpReply->isSpdyUsed();
+    isHttp2Used = httpReply->isHttp2Used();
 
     emit downloadMetaData(incomingHeaders,
                           incomingStatusCode,
@@ -618,7 +663,8 @@ void QHttpThreadDelegate::headerChangedSlot()
                           isPipeliningUsed,
                           downloadBuffer,
                           incomingContentLength,
-                          isSpdyUsed);
+                          isSpdyUsed,
+                          isHttp2Used);
 }
 
 void QHttpThreadDelegate::synchronousHeaderChangedSlot()
@@ -635,6 +681,7 @@ void QHttpThreadDelegate::synchronousHeaderChangedSlot()
     incomingReasonPhrase = httpReply->reasonPhrase();
     isPipeliningUsed = httpReply->isPipeliningUsed();
     isSpdyUsed = httpReply->isSpdyUsed();
+    isHttp2Used = httpReply->isHttp2Used();
     incomingContentLength = httpReply->contentLength();
 }
 
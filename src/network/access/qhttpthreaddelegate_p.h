@@ -59,6 +59,7 @@
 #include "qsslconfiguration.h"
 #include "private/qnoncontiguousbytedevice_p.h"
 #include "qnetworkaccessauthenticationmanager_p.h"
+#include "qhttpconnectionpolicy.h"
 
 #ifndef QT_NO_HTTP
 
@@ -95,6 +96,7 @@ public:
     QNetworkProxy transparentProxy;
 #endif
     QSharedPointer<QNetworkAccessAuthenticationManager> authenticationManager;
+    QHttpConnectionPolicy connectionPolicy;
     bool synchronous;
 
     // outgoing, Retrieved in the synchronous HTTP case
@@ -104,6 +106,7 @@ public:
     QString incomingReasonPhrase;
     bool isPipeliningUsed;
     bool isSpdyUsed;
+    bool isHttp2Used;
     qint64 incomingContentLength;
     QNetworkReply::NetworkError incomingErrorCode;
     QString incomingErrorDetail;
@@ -134,7 +137,7 @@ signals:
     void preSharedKeyAuthenticationRequired(QSslPreSharedKeyAuthenticator *);
 #endif
     void downloadMetaData(const QList<QPair<QByteArray,QByteArray> > &, int, const QString &, bool,
-                          QSharedPointer<char>, qint64, bool);
+                          QSharedPointer<char>, qint64, bool, bool);
     void downloadProgress(qint64, qint64);
     void downloadData(const QByteArray &);
     void error(QNetworkReply::NetworkError, const QString &);
@@ -71,8 +71,9 @@ struct QNetworkAccessCache::Node
 };
 
 QNetworkAccessCache::CacheableObject::CacheableObject()
+    : expiryTimeout(ExpiryTime)
 {
-    // leave the members uninitialized
+    // leave the other members uninitialized
     // they must be initialized by the derived class's constructor
 }
 
@@ -95,6 +96,15 @@ void QNetworkAccessCache::CacheableObject::setShareable(bool enable)
     shareable = enable;
 }
 
+/*!
+    Sets the number of seconds an unused entry is kept in the cache before
+    it is disposed of. The default is 120 seconds.
+ */
+void QNetworkAccessCache::CacheableObject::setExpiryTimeout(int seconds)
+{
+    expiryTimeout = qMax(0, seconds);
+}
+
 QNetworkAccessCache::QNetworkAccessCache()
     : oldest(0), newest(0)
 {
@@ -127,8 +137,9 @@ void QNetworkAccessCache::clear()
 }
 
 /*!
-    Appends the entry given by \a key to the end of the linked list.
-    (i.e., makes it the newest entry)
+    Inserts the entry given by \a key into the linked list, which is kept
+    sorted by expiry time. Entries usually share the same expiry timeout, so
+    this normally makes it the newest entry.
  */
 void QNetworkAccessCache::linkEntry(const QByteArray &key)
 {
@@ -141,18 +152,25 @@ void QNetworkAccessCache::linkEntry(const QByteArray &key)
     Q_ASSERT(node->older == 0 && node->newer == 0);
     Q_ASSERT(node->useCount == 0);
 
-    if (newest) {
-        Q_ASSERT(newest->newer == 0);
-        newest->newer = node;
-        node->older = newest;
-    }
-    if (!oldest) {
-        // there are no entries, so this is the oldest one too
+    node->timestamp = QDateTime::currentDateTimeUtc().addSecs(node->object->expiryTimeout);
+
+    // find the newest entry that expires no later than this one
+    Node *older = newest;
+    while (older && node->timestamp < older->timestamp)
+        older = older->older;
+
+    node->older = older;
+    if (older) {
+        node->newer = older->newer;
+        older->newer = node;
+    } else {
+        node->newer = oldest;
         oldest = node;
     }
-
-    node->timestamp = QDateTime::currentDateTimeUtc().addSecs(ExpiryTime);
-    newest = node;
+    if (node->newer)
+        node->newer->older = node;
+    else
+        newest = node;
 }
 
 /*!
@@ -72,6 +72,7 @@ public:
         QByteArray key;
         bool expires;
         bool shareable;
+        int expiryTimeout;
     public:
         CacheableObject();
         virtual ~CacheableObject();
@@ -81,6 +82,7 @@ public:
     protected:
         void setExpires(bool enable);
         void setShareable(bool enable);
+        void setExpiryTimeout(int seconds);
     };
 
     QNetworkAccessCache();
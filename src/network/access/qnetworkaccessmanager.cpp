@@ -61,6 +61,7 @@
 #include "QtNetwork/qsslconfiguration.h"
 #include "QtNetwork/qnetworkconfigmanager.h"
 #include "QtNetwork/qhttpmultipart.h"
+#include "QtNetwork/qhttpconnectionpolicy.h"
 #include "qhttpmultipart_p.h"
 
 #include "qnetworkreplyhttpimpl_p.h"
@@ -630,6 +631,59 @@ void QNetworkAccessManager::setCache(QAbstractNetworkCache *cache)
     }
 }
 
+/*!
+    \since 5.7
+
+    Returns the connection policy used for HTTP and HTTPS requests to
+    \a hostName. If no policy was set for \a hostName, or \a hostName is
+    empty, the default policy is returned.
+
+    \sa setHttpConnectionPolicy()
+*/
+QHttpConnectionPolicy QNetworkAccessManager::httpConnectionPolicy(const QString &hostName) const
+{
+    Q_D(const QNetworkAccessManager);
+    return d->httpConnectionPolicy(hostName);
+}
+
+/*!
+    \since 5.7
+
+    Sets the default connection \a policy, used for all hosts that do not
+    have a policy of their own.
+
+    The policy applies to requests dispatched after this call; connections
+    that are already open keep their number of channels.
+
+    \sa httpConnectionPolicy()
+*/
+void QNetworkAccessManager::setHttpConnectionPolicy(const QHttpConnectionPolicy &policy)
+{
+    Q_D(QNetworkAccessManager);
+    d->defaultHttpConnectionPolicy = policy;
+}
+
+/*!
+    \since 5.7
+    \overload
+
+    Sets the connection \a policy used for requests to \a hostName. Host
+    names are compared case-insensitively.
+
+    \snippet code/src_network_access_qhttpconnectionpolicy.cpp 0
+
+    \sa httpConnectionPolicy()
+*/
+void QNetworkAccessManager::setHttpConnectionPolicy(const QString &hostName,
+                                                    const QHttpConnectionPolicy &policy)
+{
+    Q_D(QNetworkAccessManager);
+    if (hostName.isEmpty())
+        d->defaultHttpConnectionPolicy = policy;
+    else
+        d->httpConnectionPolicies.insert(hostName.toLower(), policy);
+}
+
 /*!
     Returns the QNetworkCookieJar that is used to store cookies
     obtained from the network as well as cookies that are about to be
@@ -1391,6 +1445,13 @@ QNetworkReply *QNetworkAccessManagerPrivate::postProcess(QNetworkReply *reply)
     return reply;
 }
 
+QHttpConnectionPolicy QNetworkAccessManagerPrivate::httpConnectionPolicy(const QString &hostName) const
+{
+    if (hostName.isEmpty() || httpConnectionPolicies.isEmpty())
+        return defaultHttpConnectionPolicy;
+    return httpConnectionPolicies.value(hostName.toLower(), defaultHttpConnectionPolicy);
+}
+
 void QNetworkAccessManagerPrivate::createCookieJar() const
 {
     if (!cookieJarCreated) {
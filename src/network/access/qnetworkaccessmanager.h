@@ -59,6 +59,7 @@ class QSslError;
 class QNetworkConfiguration;
 #endif
 class QHttpMultiPart;
+class QHttpConnectionPolicy;
 
 class QNetworkReplyImplPrivate;
 class QNetworkAccessManagerPrivate;
@@ -111,6 +112,10 @@ public:
     QNetworkCookieJar *cookieJar() const;
     void setCookieJar(QNetworkCookieJar *cookieJar);
 
+    QHttpConnectionPolicy httpConnectionPolicy(const QString &hostName = QString()) const;
+    void setHttpConnectionPolicy(const QHttpConnectionPolicy &policy);
+    void setHttpConnectionPolicy(const QString &hostName, const QHttpConnectionPolicy &policy);
+
     QNetworkReply *head(const QNetworkRequest &request);
     QNetworkReply *get(const QNetworkRequest &request);
     QNetworkReply *post(const QNetworkRequest &request, QIODevice *data);
@@ -52,6 +52,7 @@
 #include "QtNetwork/qnetworkproxy.h"
 #include "QtNetwork/qnetworksession.h"
 #include "qnetworkaccessauthenticationmanager_p.h"
+#include "qhttpconnectionpolicy.h"
 #ifndef QT_NO_BEARERMANAGEMENT
 #include "QtNetwork/qnetworkconfigmanager.h"
 #endif
@@ -107,6 +108,7 @@ public:
     void _q_replyPreSharedKeyAuthenticationRequired(QSslPreSharedKeyAuthenticator *authenticator);
     QNetworkReply *postProcess(QNetworkReply *reply);
     void createCookieJar() const;
+    QHttpConnectionPolicy httpConnectionPolicy(const QString &hostName) const;
 
     void authenticationRequired(QAuthenticator *authenticator,
                                 QNetworkReply *reply,
@@ -152,6 +154,10 @@ public:
 
     QNetworkCookieJar *cookieJar;
 
+    // per-host HTTP connection tuning; keys are lower-case host names
+    QHttpConnectionPolicy defaultHttpConnectionPolicy;
+    QHash<QString, QHttpConnectionPolicy> httpConnectionPolicies;
+
     QThread *httpThread;
 
 
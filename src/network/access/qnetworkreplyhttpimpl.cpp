@@ -750,12 +750,18 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     foreach (const QByteArray &header, headers)
         httpRequest.setHeaderField(header, newHttpRequest.rawHeader(header));
 
-    if (newHttpRequest.attribute(QNetworkRequest::HttpPipeliningAllowedAttribute).toBool() == true)
+    // an explicit request attribute overrides the per-host policy
+    const QHttpConnectionPolicy connectionPolicy = managerPrivate->httpConnectionPolicy(url.host());
+    const QVariant pipeliningAllowed = newHttpRequest.attribute(QNetworkRequest::HttpPipeliningAllowedAttribute);
+    if (pipeliningAllowed.isValid() ? pipeliningAllowed.toBool() : connectionPolicy.isPipeliningEnabled())
         httpRequest.setPipeliningAllowed(true);
 
     if (request.attribute(QNetworkRequest::SpdyAllowedAttribute).toBool() == true)
         httpRequest.setSPDYAllowed(true);
 
+    if (request.attribute(QNetworkRequest::Http2AllowedAttribute).toBool() == true)
+        httpRequest.setHTTP2Allowed(true);
+
     if (static_cast<QNetworkRequest::LoadControl>
         (newHttpRequest.attribute(QNetworkRequest::AuthenticationReuseAttribute,
                              QNetworkRequest::Automatic).toInt()) == QNetworkRequest::Manual)
@@ -793,6 +799,7 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     // The authentication manager is used to avoid the BlockingQueuedConnection communication
     // from HTTP thread to user thread in some cases.
     delegate->authenticationManager = managerPrivate->authenticationManager;
+    delegate->connectionPolicy = connectionPolicy;
 
     if (!synchronous) {
         // Tell our zerocopy policy to the delegate
@@ -820,10 +827,10 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
                 Qt::QueuedConnection);
         QObject::connect(delegate, SIGNAL(downloadMetaData(QList<QPair<QByteArray,QByteArray> >,
                                                            int, QString, bool,
-                                                           QSharedPointer<char>, qint64, bool)),
+                                                           QSharedPointer<char>, qint64, bool, bool)),
                 q, SLOT(replyDownloadMetaData(QList<QPair<QByteArray,QByteArray> >,
                                               int, QString, bool,
-                                              QSharedPointer<char>, qint64, bool)),
+                                              QSharedPointer<char>, qint64, bool, bool)),
                 Qt::QueuedConnection);
         QObject::connect(delegate, SIGNAL(downloadProgress(qint64,qint64)),
                 q, SLOT(replyDownloadProgressSlot(qint64,qint64)),
@@ -928,7 +935,8 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
                      delegate->isPipeliningUsed,
                      QSharedPointer<char>(),
                      delegate->incomingContentLength,
-                     delegate->isSpdyUsed);
+                     delegate->isSpdyUsed,
+                     delegate->isHttp2Used);
             replyDownloadData(delegate->synchronousDownloadData);
             httpError(delegate->incomingErrorCode, delegate->incomingErrorDetail);
         } else {
@@ -939,7 +947,8 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
                      delegate->isPipeliningUsed,
                      QSharedPointer<char>(),
                      delegate->incomingContentLength,
-                     delegate->isSpdyUsed);
+                     delegate->isSpdyUsed,
+                     delegate->isHttp2Used);
             replyDownloadData(delegate->synchronousDownloadData);
         }
 
@@ -1165,7 +1174,8 @@ void QNetworkReplyHttpImplPrivate::checkForRedirect(const int statusCode)
 void QNetworkReplyHttpImplPrivate::replyDownloadMetaData(const QList<QPair<QByteArray,QByteArray> > &hm,
                                                          int sc, const QString &rp, bool pu,
                                                          QSharedPointer<char> db,
-                                                         qint64 contentLength, bool spdyWasUsed)
+                                                         qint64 contentLength, bool spdyWasUsed,
+                                                         bool http2WasUsed)
 {
     Q_Q(QNetworkReplyHttpImpl);
     Q_UNUSED(contentLength);
@@ -1183,6 +1193,7 @@ void QNetworkReplyHttpImplPrivate::replyDownloadMetaData(const QList<QPair<QByte
 
     q->setAttribute(QNetworkRequest::HttpPipeliningWasUsedAttribute, pu);
     q->setAttribute(QNetworkRequest::SpdyWasUsedAttribute, spdyWasUsed);
+    q->setAttribute(QNetworkRequest::Http2WasUsedAttribute, http2WasUsed);
 
     // reconstruct the HTTP header
     QList<QPair<QByteArray, QByteArray> > headerMap = hm;
@@ -182,7 +182,8 @@ QT_BEGIN_NAMESPACE
     \value HttpPipeliningAllowedAttribute
         Requests only, type: QMetaType::Bool (default: false)
         Indicates whether the QNetworkAccessManager code is
-        allowed to use HTTP pipelining with this request.
+        allowed to use HTTP pipelining with this request. If the
+        attribute is not set, the host's QHttpConnectionPolicy decides.
 
     \value HttpPipeliningWasUsedAttribute
         Replies only, type: QMetaType::Bool
@@ -264,6 +265,21 @@ QT_BEGIN_NAMESPACE
         HTTP redirect response or not. Currently redirects that are insecure,
         that is redirecting from "https" to "http" protocol, are not allowed.
 
+    \value Http2AllowedAttribute
+        Requests only, type: QMetaType::Bool (default: false)
+        Indicates whether the QNetworkAccessManager code is
+        allowed to use HTTP/2 with this request. For "https" URLs
+        HTTP/2 is negotiated through TLS ALPN and depends on the server
+        supporting it; for "http" URLs the server is assumed to support
+        cleartext HTTP/2 (prior knowledge). Redirects and authentication
+        challenges are not handled for HTTP/2 replies.
+        (This value was introduced in 5.7.)
+
+    \value Http2WasUsedAttribute
+        Replies only, type: QMetaType::Bool
+        Indicates whether HTTP/2 was used for receiving this reply.
+        (This value was introduced in 5.7.)
+
     \value User
         Special type. Additional information can be passed in
         QVariants with types ranging from User to UserMax. The default
@@ -1230,16 +1230,11 @@ void QSpdyProtocolHandler::handleDataFrame(const QByteArray &frameHeaders)
         replyPrivate->currentlyReceivedDataInWindow = 0;
     }
 
-    httpReply->d_func()->compressedData.append(data);
-
-
     replyPrivate->totalProgress += length;
 
-    if (httpRequest.d->autoDecompress && httpReply->d_func()->isCompressed()) {
-        QByteDataBuffer inDataBuffer; // ### should we introduce one in the http reply?
-        inDataBuffer.append(data);
-        qint64 compressedCount = httpReply->d_func()->uncompressBodyData(&inDataBuffer,
-                                                                         &replyPrivate->responseData);
+    if (httpRequest.d->autoDecompress && replyPrivate->isCompressed()) {
+        qint64 compressedCount = replyPrivate->decodeBodyData(data.constData(), data.size(),
+                                                              &replyPrivate->responseData);
         Q_ASSERT(compressedCount >= 0);
         Q_UNUSED(compressedCount); // silence -Wunused-variable
     } else {
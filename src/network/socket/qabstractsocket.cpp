@@ -482,6 +482,8 @@
 #ifndef QABSTRACTSOCKET_BUFFERSIZE
 #define QABSTRACTSOCKET_BUFFERSIZE 32768
 #endif
+// maximum number of write buffer blocks handed to one vectored write
+#define QABSTRACTSOCKET_MAX_WRITE_BLOCKS 16
 #define QT_CONNECT_TIMEOUT 30000
 #define QT_TRANSFER_TIMEOUT 120000
 
@@ -558,6 +560,10 @@ QAbstractSocketPrivate::QAbstractSocketPrivate()
       cachedSocketDescriptor(-1),
       readBufferMaxSize(0),
       writeBuffer(QABSTRACTSOCKET_BUFFERSIZE),
+      transferOffset(0),
+      transferRemaining(0),
+      bytesBeforeTransfer(0),
+      transferEmulated(false),
       isBuffered(false),
       connectTimer(0),
       disconnectTimer(0),
@@ -811,10 +817,10 @@ bool QAbstractSocketPrivate::canWriteNotification()
 
     if (socketEngine) {
 #if defined (Q_OS_WIN)
-        if (!writeBuffer.isEmpty())
+        if (hasPendingWrites())
             socketEngine->setWriteNotificationEnabled(true);
 #else
-        if (writeBuffer.isEmpty() && socketEngine->bytesToWrite() == 0)
+        if (!hasPendingWrites() && socketEngine->bytesToWrite() == 0)
             socketEngine->setWriteNotificationEnabled(false);
 #endif
     }
@@ -851,7 +857,7 @@ void QAbstractSocketPrivate::connectionNotification()
 bool QAbstractSocketPrivate::writeToSocket()
 {
     Q_Q(QAbstractSocket);
-    if (!socketEngine || !socketEngine->isValid() || (writeBuffer.isEmpty()
+    if (!socketEngine || !socketEngine->isValid() || (!hasPendingWrites()
         && socketEngine->bytesToWrite() == 0)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::writeToSocket() nothing to do: valid ? %s, writeBuffer.isEmpty() ? %s",
@@ -865,11 +871,49 @@ bool QAbstractSocketPrivate::writeToSocket()
         return false;
     }
 
-    qint64 nextSize = writeBuffer.nextDataBlockSize();
-    const char *ptr = writeBuffer.readPointer();
+    // Once everything queued before writeFromFile() is out, send the
+    // file, either directly or by copying it through the write buffer.
+    qint64 written = 0;
+    if (transferRemaining > 0 && bytesBeforeTransfer == 0 && !transferEmulated)
+        written = writeFileTransfer();
+    if (transferRemaining > 0 && bytesBeforeTransfer == 0 && transferEmulated) {
+        if (!readFileTransferChunk())
+            return false;
+    }
+
+    if (written == 0 && !writeBuffer.isEmpty()
+        && (transferRemaining == 0 || bytesBeforeTransfer > 0)) {
+        // Attempt to write it all in one chunk, handing all blocks of the
+        // buffer to the socket engine at once if the data is fragmented.
+        // While a file transfer is pending, only the data queued before
+        // it may go out.
+        const char *blocks[QABSTRACTSOCKET_MAX_WRITE_BLOCKS];
+        qint64 blockSizes[QABSTRACTSOCKET_MAX_WRITE_BLOCKS];
+        int blockCount = writeBuffer.readPointers(blocks, blockSizes, QABSTRACTSOCKET_MAX_WRITE_BLOCKS);
+        if (transferRemaining > 0) {
+            qint64 allowed = bytesBeforeTransfer;
+            for (int i = 0; i < blockCount; ++i) {
+                if (blockSizes[i] >= allowed) {
+                    blockSizes[i] = allowed;
+                    blockCount = i + 1;
+                    break;
+                }
+                allowed -= blockSizes[i];
+            }
+        }
+        if (blockCount > 1)
+            written = socketEngine->writeVectored(blocks, blockSizes, blockCount);
+        else if (blockCount == 1)
+            written = socketEngine->write(blocks[0], blockSizes[0]);
+
+        if (written > 0) {
+            // Remove what we wrote so far.
+            writeBuffer.free(written);
+            if (transferRemaining > 0)
+                bytesBeforeTransfer -= written;
+        }
+    }
 
-    // Attempt to write it all in one chunk.
-    qint64 written = socketEngine->write(ptr, nextSize);
     if (written < 0) {
 #if defined (QABSTRACTSOCKET_DEBUG)
         qDebug() << "QAbstractSocketPrivate::writeToSocket() write error, aborting."
@@ -886,8 +930,6 @@ bool QAbstractSocketPrivate::writeToSocket()
            written);
 #endif
 
-    // Remove what we wrote so far.
-    writeBuffer.free(written);
     if (written > 0) {
         // Don't emit bytesWritten() recursively.
         if (!emittedBytesWritten) {
@@ -897,7 +939,7 @@ bool QAbstractSocketPrivate::writeToSocket()
         }
     }
 
-    if (writeBuffer.isEmpty() && socketEngine && socketEngine->isWriteNotificationEnabled()
+    if (!hasPendingWrites() && socketEngine && socketEngine->isWriteNotificationEnabled()
         && !socketEngine->bytesToWrite())
         socketEngine->setWriteNotificationEnabled(false);
     if (state == QAbstractSocket::ClosingState)
@@ -906,6 +948,95 @@ bool QAbstractSocketPrivate::writeToSocket()
     return written > 0;
 }
 
+/*! \internal
+
+    Hands the next part of the file queued by writeFromFile() to the
+    socket engine, which sends it without copying it through user
+    space. If the engine cannot do that, switches the transfer to
+    buffered copying and returns 0.
+
+    Returns the number of bytes written, or -1 if an error occurred.
+*/
+qint64 QAbstractSocketPrivate::writeFileTransfer()
+{
+    if (!transferFile) {
+        qWarning("QAbstractSocket::writeFromFile: file destroyed during the transfer");
+        clearFileTransfer();
+        return 0;
+    }
+
+    const qint64 written = socketEngine->writeFromFile(transferFile->handle(),
+                                                       transferOffset, transferRemaining);
+    if (written < 0) {
+        if (socketEngine->error() != QAbstractSocket::UnsupportedSocketOperationError)
+            return -1;
+        transferEmulated = true;
+        return 0;
+    }
+
+    if (written == 0 && transferFile->size() <= transferOffset) {
+        qWarning("QAbstractSocket::writeFromFile: file truncated during the transfer");
+        clearFileTransfer();
+        return 0;
+    }
+
+    transferOffset += written;
+    transferRemaining -= written;
+    return written;
+}
+
+/*! \internal
+
+    Copies the next chunk of the file queued by writeFromFile() to the
+    front of the write buffer, for socket engines that cannot send
+    from a file directly. Returns false if the file could not be read.
+*/
+bool QAbstractSocketPrivate::readFileTransferChunk()
+{
+    Q_Q(QAbstractSocket);
+    if (!transferFile) {
+        qWarning("QAbstractSocket::writeFromFile: file destroyed during the transfer");
+        clearFileTransfer();
+        return true;
+    }
+
+    const qint64 chunkSize = qMin(transferRemaining, qint64(QABSTRACTSOCKET_BUFFERSIZE));
+    QByteArray chunk(int(chunkSize), Qt::Uninitialized);
+    qint64 readBytes = -1;
+    if (transferFile->seek(transferOffset))
+        readBytes = transferFile->read(chunk.data(), chunkSize);
+    if (readBytes < 0) {
+        setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                        QAbstractSocket::tr("Error reading from file: %1").arg(transferFile->errorString()));
+        q->abort();
+        return false;
+    }
+    if (readBytes == 0) {
+        qWarning("QAbstractSocket::writeFromFile: file truncated during the transfer");
+        clearFileTransfer();
+        return true;
+    }
+
+    memcpy(writeBuffer.reserveFront(readBytes), chunk.constData(), readBytes);
+    transferOffset += readBytes;
+    transferRemaining -= readBytes;
+    bytesBeforeTransfer = readBytes;
+    return true;
+}
+
+/*! \internal
+
+    Drops the file transfer queued by writeFromFile(), if any.
+*/
+void QAbstractSocketPrivate::clearFileTransfer()
+{
+    transferFile = 0;
+    transferOffset = 0;
+    transferRemaining = 0;
+    bytesBeforeTransfer = 0;
+    transferEmulated = false;
+}
+
 /*! \internal
 
     Writes pending data in the write buffers to the socket. The function
@@ -916,7 +1047,7 @@ bool QAbstractSocketPrivate::flush()
 {
     bool dataWasWritten = false;
 
-    while (!writeBuffer.isEmpty() && writeToSocket())
+    while (hasPendingWrites() && writeToSocket())
         dataWasWritten = true;
 
     return dataWasWritten;
@@ -1649,6 +1780,7 @@ void QAbstractSocket::connectToHost(const QString &hostName, quint16 port,
     d->port = port;
     d->buffer.clear();
     d->writeBuffer.clear();
+    d->clearFileTransfer();
     d->abortCalled = false;
     d->pendingClose = false;
     if (d->state != BoundState) {
@@ -1745,9 +1877,9 @@ qint64 QAbstractSocket::bytesToWrite() const
 {
     Q_D(const QAbstractSocket);
 #if defined(QABSTRACTSOCKET_DEBUG)
-    qDebug("QAbstractSocket::bytesToWrite() == %lld", d->writeBuffer.size());
+    qDebug("QAbstractSocket::bytesToWrite() == %lld", d->writeBuffer.size() + d->transferRemaining);
 #endif
-    return d->writeBuffer.size();
+    return d->writeBuffer.size() + d->transferRemaining;
 }
 
 /*!
@@ -1887,6 +2019,7 @@ bool QAbstractSocket::setSocketDescriptor(qintptr socketDescriptor, SocketState
 
     d->resetSocketLayer();
     d->writeBuffer.clear();
+    d->clearFileTransfer();
     d->buffer.clear();
     d->socketEngine = QAbstractSocketEngine::createSocketEngine(socketDescriptor, this);
     if (!d->socketEngine) {
@@ -2169,7 +2302,7 @@ bool QAbstractSocket::waitForReadyRead(int msecs)
     do {
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !d->writeBuffer.isEmpty(),
+        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, d->hasPendingWrites(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2224,7 +2357,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         return false;
     }
 
-    if (d->writeBuffer.isEmpty())
+    if (!d->hasPendingWrites())
         return false;
 
     QElapsedTimer stopWatch;
@@ -2239,7 +2372,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
     forever {
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !d->writeBuffer.isEmpty(),
+        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, d->hasPendingWrites(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForBytesWritten(%i) failed (%i, %s)",
@@ -2319,7 +2452,7 @@ bool QAbstractSocket::waitForDisconnected(int msecs)
         bool readyToRead = false;
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, state() == ConnectedState,
-                                               !d->writeBuffer.isEmpty(),
+                                               d->hasPendingWrites(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2356,6 +2489,7 @@ void QAbstractSocket::abort()
     qDebug("QAbstractSocket::abort()");
 #endif
     d->writeBuffer.clear();
+    d->clearFileTransfer();
     if (d->state == UnconnectedState)
         return;
 #ifndef QT_NO_SSL
@@ -2426,6 +2560,83 @@ bool QAbstractSocket::flush()
     return d->flush();
 }
 
+/*!
+    \since 5.7
+
+    Queues \a length bytes of \a file, starting at \a offset, to be written
+    to the socket after any data that is already waiting to be written. If
+    \a length is -1, everything from \a offset to the end of the file is
+    queued. Returns the number of bytes queued, or -1 if an error occurred.
+
+    Where the platform supports it, the data is sent by the operating
+    system directly from the file to the network, without being copied
+    into the socket's write buffer; otherwise it is read from \a file in
+    chunks as the socket becomes ready for writing. Either way, progress
+    is reported through bytesWritten(), and bytesToWrite() includes the
+    bytes of the file that have not been sent yet. Data written after
+    this call is sent once the file has been transferred.
+
+    \a file must be open for reading and must stay valid, and must not
+    be truncated, until the transfer has completed. Its current position
+    may be changed by the transfer.
+
+    If the socket encrypts the data itself, as QSslSocket does, or if
+    another file transfer is still in progress, the file contents are
+    copied with write() before this function returns.
+
+    \sa write(), bytesToWrite(), bytesWritten()
+*/
+qint64 QAbstractSocket::writeFromFile(QFileDevice *file, qint64 offset, qint64 length)
+{
+    Q_D(QAbstractSocket);
+    if (!file || !file->isReadable()) {
+        qWarning("QAbstractSocket::writeFromFile: file not open for reading");
+        return -1;
+    }
+    if (!isWritable()) {
+        qWarning("QAbstractSocket::writeFromFile: device not open for writing");
+        return -1;
+    }
+    if (offset < 0) {
+        qWarning("QAbstractSocket::writeFromFile: Called with offset < 0");
+        return -1;
+    }
+    if (d->state == QAbstractSocket::UnconnectedState) {
+        d->setError(UnknownSocketError, tr("Socket is not connected"));
+        return -1;
+    }
+
+    const qint64 available = qMax(file->size() - offset, qint64(0));
+    if (length < 0 || length > available)
+        length = available;
+    if (length == 0)
+        return 0;
+
+    if (!d->socketEngine || d->socketType != TcpSocket || d->transferRemaining > 0) {
+        if (!file->seek(offset))
+            return -1;
+        qint64 copied = 0;
+        while (copied < length) {
+            const QByteArray chunk = file->read(qMin(length - copied, qint64(QABSTRACTSOCKET_BUFFERSIZE)));
+            if (chunk.isEmpty())
+                break;
+            const qint64 written = write(chunk);
+            if (written < 0)
+                return copied > 0 ? copied : -1;
+            copied += written;
+        }
+        return copied;
+    }
+
+    d->transferFile = file;
+    d->transferOffset = offset;
+    d->transferRemaining = length;
+    d->bytesBeforeTransfer = d->writeBuffer.size();
+    d->transferEmulated = file->handle() == -1;
+    d->socketEngine->setWriteNotificationEnabled(true);
+    return length;
+}
+
 /*! \reimp
 */
 qint64 QAbstractSocket::readData(char *data, qint64 maxSize)
@@ -2492,7 +2703,7 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
     }
 
     if (!d->isBuffered && d->socketType == TcpSocket
-        && d->socketEngine && d->writeBuffer.isEmpty()) {
+        && d->socketEngine && !d->hasPendingWrites()) {
         // This code is for the new Unbuffered QTcpSocket use case
         qint64 written = d->socketEngine->write(data, size);
         if (written < 0) {
@@ -2733,14 +2944,14 @@ void QAbstractSocket::disconnectFromHost()
         }
 
         // Wait for pending data to be written.
-        if (d->socketEngine && d->socketEngine->isValid() && (d->writeBuffer.size() > 0
+        if (d->socketEngine && d->socketEngine->isValid() && (d->hasPendingWrites()
             || d->socketEngine->bytesToWrite() > 0)) {
             // hack: when we are waiting for the socket engine to write bytes (only
             // possible when using Socks5 or HTTP socket engine), then close
             // anyway after 2 seconds. This is to prevent a timeout on Mac, where we
             // sometimes just did not get the write notifier from the underlying
             // CFSocket and no progress was made.
-            if (d->writeBuffer.size() == 0 && d->socketEngine->bytesToWrite() > 0) {
+            if (!d->hasPendingWrites() && d->socketEngine->bytesToWrite() > 0) {
                 if (!d->disconnectTimer) {
                     d->disconnectTimer = new QTimer(this);
                     connect(d->disconnectTimer, SIGNAL(timeout()), this,
@@ -2777,6 +2988,7 @@ void QAbstractSocket::disconnectFromHost()
     d->localAddress.clear();
     d->peerAddress.clear();
     d->writeBuffer.clear();
+    d->clearFileTransfer();
 
 #if defined(QABSTRACTSOCKET_DEBUG)
         qDebug("QAbstractSocket::disconnectFromHost() disconnected!");
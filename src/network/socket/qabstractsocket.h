@@ -49,6 +49,7 @@ class QNetworkProxy;
 #endif
 class QAbstractSocketPrivate;
 class QAuthenticator;
+class QFileDevice;
 
 class Q_NETWORK_EXPORT QAbstractSocket : public QIODevice
 {
@@ -179,6 +180,8 @@ public:
     bool atEnd() const Q_DECL_OVERRIDE; // ### Qt6: remove me
     bool flush();
 
+    qint64 writeFromFile(QFileDevice *file, qint64 offset = 0, qint64 length = -1);
+
     // for synchronous access
     virtual bool waitForConnected(int msecs = 30000);
     bool waitForReadyRead(int msecs = 30000) Q_DECL_OVERRIDE;
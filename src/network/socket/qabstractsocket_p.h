@@ -47,7 +47,9 @@
 
 #include "QtNetwork/qabstractsocket.h"
 #include "QtCore/qbytearray.h"
+#include "QtCore/qfiledevice.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qpointer.h"
 #include "QtCore/qtimer.h"
 #include "private/qringbuffer_p.h"
 #include "private/qiodevice_p.h"
@@ -136,6 +138,11 @@ public:
     void setupSocketNotifiers();
     bool readFromSocket();
     bool writeToSocket();
+    qint64 writeFileTransfer();
+    bool readFileTransferChunk();
+    void clearFileTransfer();
+    inline bool hasPendingWrites() const
+    { return !writeBuffer.isEmpty() || transferRemaining > 0; }
     void emitReadyRead();
 
     void setError(QAbstractSocket::SocketError errorCode, const QString &errorString);
@@ -144,6 +151,14 @@ public:
     qint64 readBufferMaxSize;
     QRingBuffer writeBuffer;
 
+    // file queued by writeFromFile(); it is sent once the first
+    // bytesBeforeTransfer bytes of writeBuffer have been written
+    QPointer<QFileDevice> transferFile;
+    qint64 transferOffset;
+    qint64 transferRemaining;
+    qint64 bytesBeforeTransfer;
+    bool transferEmulated;
+
     bool isBuffered;
 
     QTimer *connectTimer;
@@ -124,6 +124,96 @@ QAbstractSocketEngine *QAbstractSocketEngine::createSocketEngine(qintptr socketD
     return new QNativeSocketEngine(parent);
 }
 
+/*!
+    Writes the \a count blocks of data in \a data, with the sizes given in
+    \a lengths, to the socket as if they were one contiguous block. Returns
+    the number of bytes written, or -1 if an error occurred.
+
+    The default implementation calls write() for each block until one of
+    them is only partially written; engines that can hand all blocks to the
+    operating system at once reimplement it.
+*/
+qint64 QAbstractSocketEngine::writeVectored(const char * const *data, const qint64 *lengths, int count)
+{
+    qint64 totalWritten = 0;
+    for (int i = 0; i < count; ++i) {
+        const qint64 written = write(data[i], lengths[i]);
+        if (written < 0)
+            return totalWritten > 0 ? totalWritten : written;
+        totalWritten += written;
+        if (written < lengths[i])
+            break;
+    }
+    return totalWritten;
+}
+
+/*!
+    Writes up to \a length bytes, starting at \a offset, from the file
+    referred to by \a fileDescriptor directly to the socket without
+    copying them through user space. Returns the number of bytes
+    written, or -1 if an error occurred.
+
+    The default implementation does not support this and fails with
+    QAbstractSocket::UnsupportedSocketOperationError; callers are
+    expected to fall back to reading the file themselves.
+*/
+qint64 QAbstractSocketEngine::writeFromFile(int fileDescriptor, qint64 offset, qint64 length)
+{
+    Q_UNUSED(fileDescriptor);
+    Q_UNUSED(offset);
+    Q_UNUSED(length);
+    setError(QAbstractSocket::UnsupportedSocketOperationError,
+             QAbstractSocket::tr("Operation on socket is not supported"));
+    return -1;
+}
+
+#ifndef QT_NO_UDPSOCKET
+/*!
+    Reads up to \a count pending datagrams. The datagram at index \e i
+    is stored at \a data + \e i * \a maxlen, truncated to \a maxlen
+    bytes, its size in \a lengths[\e i] and, if \a headers is not null,
+    the IP header fields requested in \a options in \a headers[\e i].
+
+    Returns the number of datagrams read, which is 0 if none were
+    pending, or -1 if an error occurred before any datagram was read.
+
+    The default implementation calls readDatagram() for each datagram.
+*/
+int QAbstractSocketEngine::readDatagrams(char *data, qint64 maxlen, qint64 *lengths, int count,
+                                         QIpPacketHeader *headers, PacketHeaderOptions options)
+{
+    int received = 0;
+    while (received < count && hasPendingDatagrams()) {
+        const qint64 readBytes = readDatagram(data + received * maxlen, maxlen,
+                                              headers ? headers + received : 0, options);
+        if (readBytes < 0)
+            return received > 0 ? received : -1;
+        lengths[received++] = readBytes;
+    }
+    return received;
+}
+
+/*!
+    Sends the \a count datagrams in \a data, of sizes \a lengths, to
+    the destination contained in \a header.
+
+    Returns the number of datagrams sent, or -1 if an error occurred
+    before any datagram was sent.
+
+    The default implementation calls writeDatagram() for each datagram.
+*/
+int QAbstractSocketEngine::writeDatagrams(const char * const *data, const qint64 *lengths, int count,
+                                          const QIpPacketHeader &header)
+{
+    int sent = 0;
+    for ( ; sent < count; ++sent) {
+        if (writeDatagram(data[sent], lengths[sent], header) < 0)
+            return sent > 0 ? sent : -1;
+    }
+    return sent;
+}
+#endif // QT_NO_UDPSOCKET
+
 QAbstractSocket::SocketError QAbstractSocketEngine::error() const
 {
     return d_func()->socketError;
@@ -120,7 +120,8 @@ public:
         MulticastLoopbackOption,
         TypeOfServiceOption,
         ReceivePacketInformation,
-        ReceiveHopLimit
+        ReceiveHopLimit,
+        ReusePortOption
     };
 
     enum PacketHeaderOption {
@@ -152,6 +153,8 @@ public:
 
     virtual qint64 read(char *data, qint64 maxlen) = 0;
     virtual qint64 write(const char *data, qint64 len) = 0;
+    virtual qint64 writeVectored(const char * const *data, const qint64 *lengths, int count);
+    virtual qint64 writeFromFile(int fileDescriptor, qint64 offset, qint64 length);
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -166,6 +169,10 @@ public:
     virtual qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader *header = 0,
                                 PacketHeaderOptions = WantNone) = 0;
     virtual qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &header) = 0;
+    virtual int readDatagrams(char *data, qint64 maxlen, qint64 *lengths, int count,
+                              QIpPacketHeader *headers = 0, PacketHeaderOptions = WantNone);
+    virtual int writeDatagrams(const char * const *data, const qint64 *lengths, int count,
+                               const QIpPacketHeader &header);
     virtual bool hasPendingDatagrams() const = 0;
     virtual qint64 pendingDatagramSize() const = 0;
 #endif // QT_NO_UDPSOCKET
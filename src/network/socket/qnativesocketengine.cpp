@@ -835,6 +835,62 @@ qint64 QNativeSocketEngine::writeDatagram(const char *data, qint64 size, const Q
 
     return d->nativeSendDatagram(data, size, header);
 }
+
+/*!
+    Reads up to \a count pending datagrams into \a data, each one into
+    its own slot of \a maxSize bytes, and stores their sizes in \a
+    lengths and the fields requested in \a options in \a headers.
+    Where the platform allows it, all datagrams are read with a single
+    system call.
+
+    Returns the number of datagrams read, 0 if none were pending, or -1
+    if an error occurred.
+
+    \sa readDatagram()
+*/
+int QNativeSocketEngine::readDatagrams(char *data, qint64 maxSize, qint64 *lengths, int count,
+                                       QIpPacketHeader *headers, PacketHeaderOptions options)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::readDatagrams(), QAbstractSocket::UdpSocket, -1);
+
+#ifdef QT_HAVE_MMSG
+    // the ancillary data is only parsed by the one-by-one path
+    if (maxSize > 0 && !(options & ~WantDatagramSender))
+        return d->nativeReceiveDatagrams(data, maxSize, lengths, count, headers, options);
+#else
+    Q_UNUSED(d);
+#endif
+    return QAbstractSocketEngine::readDatagrams(data, maxSize, lengths, count, headers, options);
+}
+
+/*!
+    Sends the \a count datagrams in \a data, of sizes \a lengths, to
+    the destination contained in \a header. Where the platform allows
+    it, all datagrams are sent with a single system call.
+
+    Returns the number of datagrams sent, or -1 if an error occurred
+    before any datagram was sent.
+
+    \sa writeDatagram()
+*/
+int QNativeSocketEngine::writeDatagrams(const char * const *data, const qint64 *lengths, int count,
+                                        const QIpPacketHeader &header)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::UdpSocket, -1);
+
+#ifdef QT_HAVE_MMSG
+    // the ancillary data is only passed on by the one-by-one path
+    if (header.hopLimit == -1 && header.ifindex == 0 && header.senderAddress.isNull())
+        return d->nativeSendDatagrams(data, lengths, count, header);
+#else
+    Q_UNUSED(d);
+#endif
+    return QAbstractSocketEngine::writeDatagrams(data, lengths, count, header);
+}
 #endif // QT_NO_UDPSOCKET
 
 /*!
@@ -849,6 +905,38 @@ qint64 QNativeSocketEngine::write(const char *data, qint64 size)
     return d->nativeWrite(data, size);
 }
 
+/*!
+    Writes the \a count blocks in \a data, of sizes \a lengths, to the
+    socket with a single vectored write. Returns the number of bytes
+    written, or -1 if an error occurred.
+*/
+qint64 QNativeSocketEngine::writeVectored(const char * const *data, const qint64 *lengths, int count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeVectored(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::writeVectored(), QAbstractSocket::ConnectedState, -1);
+    return d->nativeWriteVectored(data, lengths, count);
+}
+
+/*!
+    Writes up to \a length bytes at \a offset in the file referred to by
+    \a fileDescriptor to the socket, letting the kernel copy the data
+    directly. Returns the number of bytes written, or -1 if an error
+    occurred. Fails with QAbstractSocket::UnsupportedSocketOperationError
+    on platforms and file types that cannot do this.
+*/
+qint64 QNativeSocketEngine::writeFromFile(int fileDescriptor, qint64 offset, qint64 length)
+{
+#ifdef Q_OS_LINUX
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeFromFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::writeFromFile(), QAbstractSocket::ConnectedState, -1);
+    return d->nativeWriteFromFile(fileDescriptor, offset, length);
+#else
+    return QAbstractSocketEngine::writeFromFile(fileDescriptor, offset, length);
+#endif
+}
+
 
 qint64 QNativeSocketEngine::bytesToWrite() const
 {
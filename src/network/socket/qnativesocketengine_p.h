@@ -58,6 +58,11 @@
 
 QT_BEGIN_NAMESPACE
 
+// recvmmsg() and sendmmsg() move several datagrams per system call
+#if defined(Q_OS_LINUX) && !defined(Q_OS_ANDROID)
+#  define QT_HAVE_MMSG
+#endif
+
 #ifdef Q_OS_WIN
 #define QT_SOCKLEN_T int
 #define QT_SOCKOPTLEN_T int
@@ -139,6 +144,8 @@ public:
 
     qint64 read(char *data, qint64 maxlen) Q_DECL_OVERRIDE;
     qint64 write(const char *data, qint64 len) Q_DECL_OVERRIDE;
+    qint64 writeVectored(const char * const *data, const qint64 *lengths, int count) Q_DECL_OVERRIDE;
+    qint64 writeFromFile(int fileDescriptor, qint64 offset, qint64 length) Q_DECL_OVERRIDE;
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -153,6 +160,10 @@ public:
     qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader * = 0,
                         PacketHeaderOptions = WantNone) Q_DECL_OVERRIDE;
     qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &) Q_DECL_OVERRIDE;
+    int readDatagrams(char *data, qint64 maxlen, qint64 *lengths, int count,
+                      QIpPacketHeader *headers = 0, PacketHeaderOptions = WantNone) Q_DECL_OVERRIDE;
+    int writeDatagrams(const char * const *data, const qint64 *lengths, int count,
+                       const QIpPacketHeader &header) Q_DECL_OVERRIDE;
     bool hasPendingDatagrams() const Q_DECL_OVERRIDE;
     qint64 pendingDatagramSize() const Q_DECL_OVERRIDE;
 #endif // QT_NO_UDPSOCKET
@@ -266,8 +277,18 @@ public:
     qint64 nativeReceiveDatagram(char *data, qint64 maxLength, QIpPacketHeader *header,
                                  QAbstractSocketEngine::PacketHeaderOptions options);
     qint64 nativeSendDatagram(const char *data, qint64 length, const QIpPacketHeader &header);
+#ifdef QT_HAVE_MMSG
+    int nativeReceiveDatagrams(char *data, qint64 maxLength, qint64 *lengths, int count,
+                               QIpPacketHeader *headers, QAbstractSocketEngine::PacketHeaderOptions options);
+    int nativeSendDatagrams(const char * const *data, const qint64 *lengths, int count,
+                            const QIpPacketHeader &header);
+#endif
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+    qint64 nativeWriteVectored(const char * const *data, const qint64 *lengths, int count);
+#ifdef Q_OS_LINUX
+    qint64 nativeWriteFromFile(int fileDescriptor, qint64 offset, qint64 length);
+#endif
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
@@ -43,6 +43,11 @@
 #include <time.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#ifdef Q_OS_LINUX
+#include <sys/sendfile.h>
+#endif
 #ifndef QT_NO_IPV6IFNAME
 #include <net/if.h>
 #endif
@@ -147,6 +152,11 @@ static void convertToLevelAndOption(QNativeSocketEngine::SocketOption opt,
     case QNativeSocketEngine::AddressReusable:
         n = SO_REUSEADDR;
         break;
+    case QNativeSocketEngine::ReusePortOption:
+#ifdef SO_REUSEPORT
+        n = SO_REUSEPORT;
+#endif
+        break;
     case QNativeSocketEngine::ReceiveOutOfBandData:
         n = SO_OOBINLINE;
         break;
@@ -348,6 +358,8 @@ bool QNativeSocketEnginePrivate::setOption(QNativeSocketEngine::SocketOption opt
 
     int n, level;
     convertToLevelAndOption(opt, socketProtocol, level, n);
+    if (n == -1)
+        return false;
 #if defined(SO_REUSEPORT) && !defined(Q_OS_LINUX)
     if (opt == QNativeSocketEngine::AddressReusable) {
         // on OS X, SO_REUSEADDR isn't sufficient to allow multiple binds to the
@@ -1006,6 +1018,117 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     return qint64(sentBytes);
 }
 
+#ifdef QT_HAVE_MMSG
+int QNativeSocketEnginePrivate::nativeReceiveDatagrams(char *data, qint64 maxSize, qint64 *lengths, int count,
+                                                       QIpPacketHeader *headers,
+                                                       QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    // the kernel handles at most UIO_MAXIOV messages per call
+    count = qMin(count, 1024);
+    if (count <= 0)
+        return 0;
+
+    const bool wantSender = options & QAbstractSocketEngine::WantDatagramSender;
+    QVarLengthArray<mmsghdr, 64> msgs(count);
+    QVarLengthArray<iovec, 64> vecs(count);
+    QVarLengthArray<qt_sockaddr, 64> addresses(wantSender ? count : 0);
+    memset(msgs.data(), 0, count * sizeof(mmsghdr));
+    if (wantSender)
+        memset(addresses.data(), 0, count * sizeof(qt_sockaddr));
+
+    for (int i = 0; i < count; ++i) {
+        vecs[i].iov_base = data + i * maxSize;
+        vecs[i].iov_len = maxSize;
+        msgs[i].msg_hdr.msg_iov = &vecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        if (wantSender) {
+            msgs[i].msg_hdr.msg_name = &addresses[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(qt_sockaddr);
+        }
+    }
+
+    int received;
+    EINTR_LOOP(received, ::recvmmsg(socketDescriptor, msgs.data(), count, 0, 0));
+
+    if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return 0;
+        setError(QAbstractSocket::NetworkError, ReceiveDatagramErrorString);
+        return -1;
+    }
+
+    for (int i = 0; i < received; ++i) {
+        lengths[i] = msgs[i].msg_len;
+        if (headers && options != QAbstractSocketEngine::WantNone) {
+            headers[i].clear();
+            qt_socket_getPortAndAddress(&addresses[i], &headers[i].senderPort, &headers[i].senderAddress);
+            headers[i].destinationPort = localPort;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeReceiveDatagrams(%p, %lli, %i) == %i",
+           data, maxSize, count, received);
+#endif
+
+    return received;
+}
+
+int QNativeSocketEnginePrivate::nativeSendDatagrams(const char * const *data, const qint64 *lengths, int count,
+                                                    const QIpPacketHeader &header)
+{
+    // the kernel handles at most UIO_MAXIOV messages per call
+    count = qMin(count, 1024);
+    if (count <= 0)
+        return 0;
+
+    qt_sockaddr aa;
+    QT_SOCKLEN_T sockAddrSize;
+    memset(&aa, 0, sizeof(aa));
+    setPortAndAddress(header.destinationPort, header.destinationAddress, &aa, &sockAddrSize);
+
+    QVarLengthArray<mmsghdr, 64> msgs(count);
+    QVarLengthArray<iovec, 64> vecs(count);
+    memset(msgs.data(), 0, count * sizeof(mmsghdr));
+    for (int i = 0; i < count; ++i) {
+        vecs[i].iov_base = const_cast<char *>(data[i]);
+        vecs[i].iov_len = lengths[i];
+        msgs[i].msg_hdr.msg_name = &aa.a;
+        msgs[i].msg_hdr.msg_namelen = sockAddrSize;
+        msgs[i].msg_hdr.msg_iov = &vecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int sent;
+    EINTR_LOOP(sent, ::sendmmsg(socketDescriptor, msgs.data(), count, MSG_NOSIGNAL));
+
+    if (sent < 0) {
+        switch (errno) {
+        case EMSGSIZE:
+            setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
+            break;
+#if EAGAIN != EWOULDBLOCK
+        case EWOULDBLOCK:
+#endif
+        case EAGAIN:
+            // the send buffer is full; nothing was sent
+            setError(QAbstractSocket::TemporaryError, TemporaryErrorString);
+            break;
+        default:
+            setError(QAbstractSocket::NetworkError, SendDatagramErrorString);
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendDatagrams(%p, %i, \"%s\", %i) == %i", data, count,
+           header.destinationAddress.toString().toLatin1().constData(),
+           header.destinationPort, sent);
+#endif
+
+    return sent;
+}
+#endif // QT_HAVE_MMSG
+
 bool QNativeSocketEnginePrivate::fetchConnectionParameters()
 {
     localPort = 0;
@@ -1137,6 +1260,93 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 
     return qint64(writtenBytes);
 }
+
+qint64 QNativeSocketEnginePrivate::nativeWriteVectored(const char * const *data, const qint64 *lengths, int count)
+{
+    Q_Q(QNativeSocketEngine);
+
+#ifdef IOV_MAX
+    count = qMin(count, int(IOV_MAX));
+#endif
+    QVarLengthArray<iovec, 16> vec(count);
+    for (int i = 0; i < count; ++i) {
+        vec[i].iov_base = const_cast<char *>(data[i]);
+        vec[i].iov_len = lengths[i];
+    }
+
+    qt_ignore_sigpipe();
+    ssize_t writtenBytes;
+    EINTR_LOOP(writtenBytes, ::writev(socketDescriptor, vec.constData(), count));
+
+    if (writtenBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            writtenBytes = -1;
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+        case EAGAIN:
+            writtenBytes = 0;
+            break;
+        default:
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeWriteVectored(%p, %d blocks) == %i",
+           data, count, (int) writtenBytes);
+#endif
+
+    return qint64(writtenBytes);
+}
+
+#ifdef Q_OS_LINUX
+qint64 QNativeSocketEnginePrivate::nativeWriteFromFile(int fileDescriptor, qint64 offset, qint64 length)
+{
+    Q_Q(QNativeSocketEngine);
+
+    // sendfile() transfers at most 0x7ffff000 bytes per call
+    length = qMin(length, qint64(0x7ffff000));
+
+    off64_t fileOffset = off64_t(offset);
+    qt_ignore_sigpipe();
+    ssize_t writtenBytes;
+    EINTR_LOOP(writtenBytes, ::sendfile64(socketDescriptor, fileDescriptor, &fileOffset, size_t(length)));
+
+    if (writtenBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            writtenBytes = -1;
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+        case EAGAIN:
+            writtenBytes = 0;
+            break;
+        case EINVAL:
+        case ENOSYS:
+        case EOPNOTSUPP:
+            // the file cannot be mmap()ed, e.g. a pipe or a special file
+            setError(QAbstractSocket::UnsupportedSocketOperationError, OperationUnsupportedErrorString);
+            break;
+        default:
+            setError(QAbstractSocket::UnknownSocketError, WriteErrorString);
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeWriteFromFile(%d, %lld, %lld) == %i",
+           fileDescriptor, offset, length, (int) writtenBytes);
+#endif
+
+    return qint64(writtenBytes);
+}
+#endif
+
 /*
 */
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxSize)
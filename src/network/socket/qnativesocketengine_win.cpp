@@ -37,6 +37,7 @@
 
 #include <winsock2.h>
 #include <ws2tcpip.h>
+#include <limits.h>
 
 #include "qnativesocketengine_p.h"
 
@@ -45,6 +46,7 @@
 #include <qdebug.h>
 #include <qdatetime.h>
 #include <qnetworkinterface.h>
+#include <qvarlengtharray.h>
 
 //#define QNATIVESOCKETENGINE_DEBUG
 #if defined(QNATIVESOCKETENGINE_DEBUG)
@@ -208,6 +210,7 @@ static void convertToLevelAndOption(QNativeSocketEngine::SocketOption opt,
     switch (opt) {
     case QNativeSocketEngine::NonBlockingSocketOption:      // WSAIoctl
     case QNativeSocketEngine::TypeOfServiceOption:          // not supported
+    case QNativeSocketEngine::ReusePortOption:              // not supported
         Q_UNREACHABLE();
 
     case QNativeSocketEngine::ReceiveBufferSocketOption:
@@ -460,6 +463,7 @@ int QNativeSocketEnginePrivate::option(QNativeSocketEngine::SocketOption opt) co
         break;
     }
     case QNativeSocketEngine::TypeOfServiceOption:
+    case QNativeSocketEngine::ReusePortOption:
         return -1;
 
     default:
@@ -510,6 +514,7 @@ bool QNativeSocketEnginePrivate::setOption(QNativeSocketEngine::SocketOption opt
         break;
         }
     case QNativeSocketEngine::TypeOfServiceOption:
+    case QNativeSocketEngine::ReusePortOption:
         return false;
 
     default:
@@ -1469,6 +1474,52 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
     return ret;
 }
 
+qint64 QNativeSocketEnginePrivate::nativeWriteVectored(const char * const *data, const qint64 *lengths, int count)
+{
+    Q_Q(QNativeSocketEngine);
+
+    QVarLengthArray<WSABUF, 16> bufs(count);
+    int bufferCount = 0;
+    for (int i = 0; i < count; ++i) {
+        bufs[i].buf = const_cast<char *>(data[i]);
+        bufs[i].len = ULONG(qMin<qint64>(lengths[i], ULONG_MAX));
+        ++bufferCount;
+        // WSABUF lengths are 32 bits; the rest of a longer block, and the
+        // blocks after it, go out with the next write
+        if (lengths[i] > qint64(ULONG_MAX))
+            break;
+    }
+
+    DWORD flags = 0;
+    DWORD bytesWritten = 0;
+    qint64 ret = 0;
+    if (::WSASend(socketDescriptor, bufs.data(), DWORD(bufferCount), &bytesWritten, flags, 0, 0) != SOCKET_ERROR) {
+        ret = qint64(bytesWritten);
+    } else {
+        int err = WSAGetLastError();
+        if (err != WSAEWOULDBLOCK && err != WSAENOBUFS) {
+            WS_ERROR_DEBUG(err);
+            switch (err) {
+            case WSAECONNRESET:
+            case WSAECONNABORTED:
+                ret = -1;
+                setError(QAbstractSocket::NetworkError, WriteErrorString);
+                q->close();
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeWriteVectored(%p, %d blocks) == %d",
+           data, count, (int)ret);
+#endif
+
+    return ret;
+}
+
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxLength)
 {
     qint64 ret = -1;
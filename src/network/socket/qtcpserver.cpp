@@ -117,6 +117,7 @@ QTcpServerPrivate::QTcpServerPrivate()
  , socketEngine(0)
  , serverSocketError(QAbstractSocket::UnknownSocketError)
  , maxConnections(30)
+ , portSharing(false)
 {
 }
 
@@ -303,6 +304,12 @@ bool QTcpServer::listen(const QHostAddress &address, quint16 port)
 
     d->configureCreatedSocket();
 
+    if (d->portSharing && !d->socketEngine->setOption(QAbstractSocketEngine::ReusePortOption, 1)) {
+        d->serverSocketError = QAbstractSocket::UnsupportedSocketOperationError;
+        d->serverSocketErrorString = tr("Port sharing is not supported on this platform");
+        return false;
+    }
+
     if (!d->socketEngine->bind(addr, port)) {
         d->serverSocketError = d->socketEngine->error();
         d->serverSocketErrorString = d->socketEngine->errorString();
@@ -628,6 +635,45 @@ int QTcpServer::maxPendingConnections() const
     return d_func()->maxConnections;
 }
 
+/*!
+    \since 5.7
+
+    If \a enabled is true, subsequent calls to listen() allow other
+    sockets that enabled port sharing to listen on the same address and
+    port at the same time. The default is false.
+
+    This makes it possible to run several QTcpServer objects on the same
+    port, each living in its own thread and event loop, and let the
+    operating system distribute incoming connections between them. This
+    scales the accepting of connections across CPU cores without handing
+    socket descriptors from one thread to another.
+
+    All servers sharing a port must enable this option and, on most
+    systems, must be owned by the same user. Port sharing is implemented
+    with the \c SO_REUSEPORT socket option; on platforms that do not
+    support it, listen() fails with
+    QAbstractSocket::UnsupportedSocketOperationError.
+
+    \sa isPortSharingEnabled(), listen()
+*/
+void QTcpServer::setPortSharingEnabled(bool enabled)
+{
+    d_func()->portSharing = enabled;
+}
+
+/*!
+    \since 5.7
+
+    Returns \c true if port sharing is enabled for this server; otherwise
+    returns \c false.
+
+    \sa setPortSharingEnabled()
+*/
+bool QTcpServer::isPortSharingEnabled() const
+{
+    return d_func()->portSharing;
+}
+
 /*!
     Returns an error code for the last error that occurred.
 
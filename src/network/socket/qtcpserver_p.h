@@ -74,6 +74,7 @@ public:
     QString serverSocketErrorString;
 
     int maxConnections;
+    bool portSharing;
 
 #ifndef QT_NO_NETWORKPROXY
     QNetworkProxy proxy;
@@ -93,6 +93,7 @@
 #include "qudpsocket.h"
 #include "qhostaddress.h"
 #include "qnetworkinterface.h"
+#include "qvarlengtharray.h"
 #include "qabstractsocket_p.h"
 
 QT_BEGIN_NAMESPACE
@@ -396,6 +397,116 @@ qint64 QUdpSocket::readDatagram(char *data, qint64 maxSize, QHostAddress *addres
         d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
     return readBytes;
 }
+
+/*!
+    \since 5.7
+
+    Receives up to \a count pending datagrams. The datagram at index \e i
+    is stored at \a data + \e i * \a maxSize, and its size in \a
+    sizes[\e i]; \a data must therefore point to at least \a count * \a
+    maxSize bytes. If \a hosts or \a ports is not null, the sender of
+    each datagram is stored in the corresponding element of these arrays.
+
+    Returns the number of datagrams received, which is 0 if there were
+    no pending datagrams, or -1 if an error occurred.
+
+    As with readDatagram(), a datagram larger than \a maxSize is
+    truncated. Where the platform supports it, all datagrams are
+    received with a single system call, which makes this function
+    considerably cheaper than calling readDatagram() in a loop when
+    datagrams arrive at a high rate.
+
+    \sa readDatagram(), writeDatagrams(), hasPendingDatagrams()
+*/
+int QUdpSocket::readDatagrams(char *data, qint64 maxSize, qint64 *sizes, int count,
+                              QHostAddress *hosts, quint16 *ports)
+{
+    Q_D(QUdpSocket);
+
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::readDatagrams(%p, %llu, %p, %i, %p, %p)", data, maxSize, sizes, count, hosts, ports);
+#endif
+    QT_CHECK_BOUND("QUdpSocket::readDatagrams()", -1);
+    if (count <= 0)
+        return 0;
+
+    int received;
+    if (hosts || ports) {
+        QVarLengthArray<QIpPacketHeader, 64> headers(count);
+        received = d->socketEngine->readDatagrams(data, maxSize, sizes, count, headers.data(),
+                                                  QAbstractSocketEngine::WantDatagramSender);
+        for (int i = 0; i < received; ++i) {
+            if (hosts)
+                hosts[i] = headers.at(i).senderAddress;
+            if (ports)
+                ports[i] = headers.at(i).senderPort;
+        }
+    } else {
+        received = d->socketEngine->readDatagrams(data, maxSize, sizes, count);
+    }
+
+    // canReadNotification() disables the notifier until datagrams are read
+    if (!d->socketEngine->isReadNotificationEnabled())
+        d->socketEngine->setReadNotificationEnabled(true);
+    if (received < 0)
+        d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+    return received;
+}
+
+/*!
+    \since 5.7
+
+    Sends the datagrams in \a datagrams to the host address \a host at
+    port \a port. Returns the number of datagrams sent, or -1 if an
+    error occurred before any datagram was sent.
+
+    If fewer datagrams than were passed are sent, for instance because
+    one of them is too large, the remaining ones are not sent and can
+    be passed to this function again. bytesWritten() is emitted once
+    with the total size of the datagrams that were sent.
+
+    Where the platform supports it, all datagrams are sent with a
+    single system call. If the socket's send buffer is full, nothing is
+    sent, -1 is returned and error() is QAbstractSocket::TemporaryError.
+
+    \sa writeDatagram(), readDatagrams()
+*/
+int QUdpSocket::writeDatagrams(const QList<QByteArray> &datagrams, const QHostAddress &host, quint16 port)
+{
+    Q_D(QUdpSocket);
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::writeDatagrams(%i datagrams, \"%s\", %i)", datagrams.size(),
+           host.toString().toLatin1().constData(), port);
+#endif
+    if (!d->doEnsureInitialized(QHostAddress::Any, 0, host))
+        return -1;
+    if (state() == UnconnectedState)
+        bind();
+    if (datagrams.isEmpty())
+        return 0;
+
+    const int count = datagrams.size();
+    QVarLengthArray<const char *, 64> data(count);
+    QVarLengthArray<qint64, 64> lengths(count);
+    for (int i = 0; i < count; ++i) {
+        data[i] = datagrams.at(i).constData();
+        lengths[i] = datagrams.at(i).size();
+    }
+
+    const int sent = d->socketEngine->writeDatagrams(data.constData(), lengths.constData(), count,
+                                                     QIpPacketHeader(host, port));
+    d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+
+    if (sent >= 0) {
+        qint64 bytes = 0;
+        for (int i = 0; i < sent; ++i)
+            bytes += lengths.at(i);
+        emit bytesWritten(bytes);
+    } else {
+        d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+    }
+    return sent;
+}
 #endif // QT_NO_UDPSOCKET
 
 QT_END_NAMESPACE
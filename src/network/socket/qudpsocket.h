@@ -71,6 +71,10 @@ public:
     inline qint64 writeDatagram(const QByteArray &datagram, const QHostAddress &host, quint16 port)
         { return writeDatagram(datagram.constData(), datagram.size(), host, port); }
 
+    int readDatagrams(char *data, qint64 maxSize, qint64 *sizes, int count,
+                      QHostAddress *hosts = Q_NULLPTR, quint16 *ports = Q_NULLPTR);
+    int writeDatagrams(const QList<QByteArray> &datagrams, const QHostAddress &host, quint16 port);
+
 private:
     Q_DISABLE_COPY(QUdpSocket)
     Q_DECLARE_PRIVATE(QUdpSocket)
@@ -49,6 +49,7 @@ const QSsl::SslOptions QSslConfigurationPrivate::defaultSslOptions = QSsl::SslOp
 
 const char QSslConfiguration::NextProtocolSpdy3_0[] = "spdy/3";
 const char QSslConfiguration::NextProtocolHttp1_1[] = "http/1.1";
+const char QSslConfiguration::NextProtocolHttp2[] = "h2";
 
 /*!
     \class QSslConfiguration
@@ -137,6 +138,17 @@ const char QSslConfiguration::NextProtocolHttp1_1[] = "http/1.1";
     Protocol Negotiation.
 */
 
+/*!
+    \variable QSslConfiguration::NextProtocolHttp2
+    \brief The value used for negotiating HTTP/2 during the Next
+    Protocol Negotiation.
+
+    HTTP/2 is negotiated through the TLS ALPN extension, which requires
+    OpenSSL 1.0.2 or later.
+
+    \since 5.7
+*/
+
 /*!
     Constructs an empty SSL configuration. This configuration contains
     no valid settings and the state will be empty. isNull() will
@@ -817,7 +829,7 @@ QByteArray QSslConfiguration::nextNegotiatedProtocol() const
   Whether or not the negotiation succeeded can be queried through
   nextProtocolNegotiationStatus().
 
-  \sa nextNegotiatedProtocol(), nextProtocolNegotiationStatus(), allowedNextProtocols(), QSslConfiguration::NextProtocolSpdy3_0, QSslConfiguration::NextProtocolHttp1_1
+  \sa nextNegotiatedProtocol(), nextProtocolNegotiationStatus(), allowedNextProtocols(), QSslConfiguration::NextProtocolSpdy3_0, QSslConfiguration::NextProtocolHttp1_1, QSslConfiguration::NextProtocolHttp2
  */
 #if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
 void QSslConfiguration::setAllowedNextProtocols(const QList<QByteArray> &protocols)
@@ -835,7 +847,7 @@ void QSslConfiguration::setAllowedNextProtocols(QList<QByteArray> protocols)
   server through the Next Protocol Negotiation (NPN) TLS extension, as set
   by setAllowedNextProtocols().
 
-  \sa nextNegotiatedProtocol(), nextProtocolNegotiationStatus(), setAllowedNextProtocols(), QSslConfiguration::NextProtocolSpdy3_0, QSslConfiguration::NextProtocolHttp1_1
+  \sa nextNegotiatedProtocol(), nextProtocolNegotiationStatus(), setAllowedNextProtocols(), QSslConfiguration::NextProtocolSpdy3_0, QSslConfiguration::NextProtocolHttp1_1, QSslConfiguration::NextProtocolHttp2
  */
 QList<QByteArray> QSslConfiguration::allowedNextProtocols() const
 {
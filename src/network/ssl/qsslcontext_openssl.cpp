@@ -442,6 +442,11 @@ SSL* QSslContext::createSsl()
         m_npnContext.len = m_supportedNPNVersions.count();
         m_npnContext.status = QSslConfiguration::NextProtocolNegotiationNone;
         q_SSL_CTX_set_next_proto_select_cb(ctx, next_proto_cb, &m_npnContext);
+#if OPENSSL_VERSION_NUMBER >= 0x10002000L
+        // offer the same list through ALPN, which HTTP/2 over TLS requires
+        if (q_SSL_set_alpn_protos(ssl, m_npnContext.data, m_npnContext.len) != 0)
+            qCWarning(lcSsl, "could not set the TLS ALPN protocol list");
+#endif // OPENSSL_VERSION_NUMBER >= 0x10002000L
     }
 #endif // OPENSSL_VERSION_NUMBER >= 0x1000100fL ...
 
@@ -1564,6 +1564,16 @@ void QSslSocketBackendPrivate::continueHandshake()
         else
             configuration.nextNegotiatedProtocol.clear();
     }
+#if OPENSSL_VERSION_NUMBER >= 0x10002000L
+    // a protocol selected by the server through ALPN takes precedence over NPN
+    const unsigned char *alpnProto = 0;
+    unsigned int alpnProtoLen = 0;
+    q_SSL_get0_alpn_selected(ssl, &alpnProto, &alpnProtoLen);
+    if (alpnProtoLen) {
+        configuration.nextProtocolNegotiationStatus = QSslConfiguration::NextProtocolNegotiationNegotiated;
+        configuration.nextNegotiatedProtocol = QByteArray(reinterpret_cast<const char *>(alpnProto), alpnProtoLen);
+    }
+#endif // OPENSSL_VERSION_NUMBER >= 0x10002000L
 #endif // OPENSSL_VERSION_NUMBER >= 0x1000100fL ...
 
     connectionEncrypted = true;
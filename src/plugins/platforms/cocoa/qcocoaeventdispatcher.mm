@@ -503,7 +503,9 @@ bool QCocoaEventDispatcher::processEvents(QEventLoop::ProcessEventsFlags flags)
             if (hadModalSession && d->currentModalSessionCached == 0)
                 interruptLater = true;
         }
+        // queued calls posted through the intake are not reflected in canWait
         bool canWait = (d->threadData->canWait
+                && !d->threadData->postEventList.hasIntake()
                 && !retVal
                 && !d->interrupt
                 && (d->processEventsFlags & QEventLoop::WaitForMoreEvents));
@@ -878,7 +880,7 @@ void QCocoaEventDispatcherPrivate::processPostedEvents()
     }
 
     int serial = serialNumber.load();
-    if (!threadData->canWait || (serial != lastSerial)) {
+    if (!threadData->canWait || threadData->postEventList.hasIntake() || (serial != lastSerial)) {
         lastSerial = serial;
         QCoreApplication::sendPostedEvents();
         QWindowSystemInterface::sendWindowSystemEvents(QEventLoop::AllEvents);
@@ -82,6 +82,9 @@ public:
         tc(0),
 #endif
         preparedQuerysEnabled(false) { dbmsType = QSqlDriver::MySqlServer; }
+    bool bulkInsert(const QString &tableName, const QSqlRecord &columns,
+                    const QVector<QVariantList> &values) Q_DECL_OVERRIDE;
+
     MYSQL *mysql;
     QTextCodec *tc;
 
@@ -1126,6 +1129,75 @@ bool QMYSQLResult::exec()
     return true;
 }
 #endif
+/*
+   Inserts the rows with INSERT statements that contain many rows each,
+   which saves a round trip and the parsing of a statement for each row.
+   The statements are kept well below the default max_allowed_packet.
+ */
+bool QMYSQLDriverPrivate::bulkInsert(const QString &tableName, const QSqlRecord &columns,
+                                     const QVector<QVariantList> &values)
+{
+    Q_Q(QMYSQLDriver);
+    enum { MaximumStatementSize = 1024 * 1024 };
+
+    QString prefix = QLatin1String("INSERT INTO ") + tableName + QLatin1String(" (");
+    for (int i = 0; i < columns.count(); ++i) {
+        if (i > 0)
+            prefix += QLatin1String(", ");
+        const QString name = columns.fieldName(i);
+        prefix += q->isIdentifierEscaped(name, QSqlDriver::FieldName)
+                  ? name : q->escapeIdentifier(name, QSqlDriver::FieldName);
+    }
+    prefix += QLatin1String(") VALUES ");
+    const QByteArray head = fromUnicode(tc, prefix);
+
+    // BEGIN would commit a transaction that the caller has started
+    const bool transaction = !(mysql->server_status & SERVER_STATUS_IN_TRANS)
+                             && q->hasFeature(QSqlDriver::Transactions)
+                             && mysql_query(mysql, "BEGIN WORK") == 0;
+
+    QVector<QSqlField> fields;
+    fields.reserve(columns.count());
+    for (int i = 0; i < columns.count(); ++i)
+        fields.append(columns.field(i));
+
+    QByteArray stmt;
+    stmt.reserve(MaximumStatementSize + 64 * 1024);
+    QString row;
+    const int rows = values.first().size();
+    for (int r = 0; r < rows; ++r) {
+        row = QLatin1Char('(');
+        for (int column = 0; column < fields.size(); ++column) {
+            if (column > 0)
+                row += QLatin1String(", ");
+            fields[column].setValue(values.at(column).at(r));
+            row += q->formatValue(fields.at(column));
+        }
+        row += QLatin1Char(')');
+
+        stmt.append(stmt.isEmpty() ? head : QByteArray(", ", 2));
+        stmt.append(fromUnicode(tc, row));
+        if (stmt.size() >= MaximumStatementSize || r == rows - 1) {
+            if (mysql_real_query(mysql, stmt.constData(), stmt.size())) {
+                q->setLastError(qMakeError(QCoreApplication::translate("QMYSQLDriver",
+                                "Unable to insert rows"), QSqlError::StatementError, this));
+                if (transaction)
+                    mysql_query(mysql, "ROLLBACK");
+                return false;
+            }
+            // keeps the capacity, as it has been reserved
+            stmt.resize(0);
+        }
+    }
+
+    if (transaction && mysql_query(mysql, "COMMIT")) {
+        q->setLastError(qMakeError(QCoreApplication::translate("QMYSQLDriver",
+                        "Unable to commit transaction"), QSqlError::TransactionError, this));
+        return false;
+    }
+    return true;
+}
+
 /////////////////////////////////////////////////////////
 
 static int qMySqlConnectionCount = 0;
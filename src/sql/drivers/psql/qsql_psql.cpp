@@ -36,6 +36,8 @@
 #include <qcoreapplication.h>
 #include <qvariant.h>
 #include <qdatetime.h>
+#include <qendian.h>
+#include <qnumeric.h>
 #include <qregexp.h>
 #include <qsqlerror.h>
 #include <qsqlfield.h>
@@ -45,6 +47,10 @@
 #include <qsocketnotifier.h>
 #include <qstringlist.h>
 #include <qmutex.h>
+#include <quuid.h>
+#ifndef QT_NO_QFUTURE
+#include <qfutureinterface.h>
+#endif
 #include <QtSql/private/qsqlresult_p.h>
 #include <QtSql/private/qsqldriver_p.h>
 
@@ -53,6 +59,7 @@
 
 #include <stdlib.h>
 #include <math.h>
+#include <limits>
 // below code taken from an example at http://www.gnu.org/software/hello/manual/autoconf/Function-Portability.html
 #ifndef isnan
     # define isnan(x) \
@@ -99,8 +106,25 @@
 #define QBITOID 1560
 #define QVARBITOID 1562
 
+#define QCHAROID 18
+#define QNAMEOID 19
+#define QTEXTOID 25
+#define QBPCHAROID 1042
+#define QVARCHAROID 1043
+#define QUUIDOID 2950
+
 #define VARHDRSZ 4
 
+// single-row mode (PQsetSingleRowMode) was introduced in libpq 9.2
+#if defined PG_VERSION_NUM && PG_VERSION_NUM-0 >= 90200
+#define QT_PSQL_SINGLE_ROW_MODE
+#endif
+
+// pipeline mode was introduced in libpq 14
+#if defined PG_VERSION_NUM && PG_VERSION_NUM-0 >= 140000
+#define QT_PSQL_PIPELINE_MODE
+#endif
+
 /* This is a compile time switch - if PQfreemem is declared, the compiler will use that one,
    otherwise it'll run in this template */
 template <typename T>
@@ -120,10 +144,12 @@ inline void qPQfreemem(void *buffer)
 }
 
 class QPSQLResultPrivate;
+class QPSQLAsyncQuery;
 
 class QPSQLResult: public QSqlResult
 {
     Q_DECLARE_PRIVATE(QPSQLResult)
+    friend class QPSQLAsyncQuery;
 
 public:
     QPSQLResult(const QPSQLDriver *db);
@@ -140,12 +166,23 @@ protected:
     QVariant data(int i) Q_DECL_OVERRIDE;
     bool isNull(int field) Q_DECL_OVERRIDE;
     bool reset (const QString &query) Q_DECL_OVERRIDE;
+    void detachFromResultSet() Q_DECL_OVERRIDE;
     int size() Q_DECL_OVERRIDE;
     int numRowsAffected() Q_DECL_OVERRIDE;
     QSqlRecord record() const Q_DECL_OVERRIDE;
     QVariant lastInsertId() const Q_DECL_OVERRIDE;
     bool prepare(const QString &query) Q_DECL_OVERRIDE;
     bool exec() Q_DECL_OVERRIDE;
+    bool execBatch(bool arrayBind = false) Q_DECL_OVERRIDE;
+};
+
+// bound values in the form expected by PQexecPrepared()
+struct QPSQLParameters
+{
+    QVector<QByteArray> data;
+    QVector<const char *> values;
+    QVector<int> lengths;
+    QVector<int> formats;
 };
 
 class QPSQLDriverPrivate : public QSqlDriverPrivate
@@ -158,9 +195,14 @@ public:
         pro(QPSQLDriver::Version6),
         sn(0),
         pendingNotifyCheck(false),
-        hasBackslashEscape(false)
+        hasBackslashEscape(false),
+        currentStmtId(InvalidStatementId),
+        stmtCount(InvalidStatementId),
+        asyncQuery(0)
     { dbmsType = QSqlDriver::PostgreSQL; }
 
+    enum { InvalidStatementId = 0 };
+
     PGconn *connection;
     bool isUtf8;
     QPSQLDriver::Protocol pro;
@@ -168,14 +210,32 @@ public:
     QStringList seid;
     mutable bool pendingNotifyCheck;
     bool hasBackslashEscape;
+    // statement whose rows are still being streamed from the connection
+    mutable int currentStmtId;
+    mutable int stmtCount;
+    // reads the results of currentStmtId in the event loop
+    QPSQLAsyncQuery *asyncQuery;
 
     void appendTables(QStringList &tl, QSqlQuery &t, QChar type);
     PGresult * exec(const char * stmt) const;
     PGresult * exec(const QString & stmt) const;
+    PGresult *execPrepared(const QByteArray &stmtName, const QPSQLParameters &params) const;
+    bool canStream() const;
+    int sendQuery(const QString &stmt) const;
+    int sendQueryPrepared(const QByteArray &stmtName, const QPSQLParameters &params, bool binaryResults) const;
+    int beginSingleRowMode() const;
+    PGresult *getResult(int stmtId) const;
+    void finishQuery(int stmtId) const;
+#ifndef QT_NO_QFUTURE
+    void waitForAsyncQuery() const;
+#endif
+    void checkPendingNotifications() const;
     QPSQLDriver::Protocol getPSQLVersion();
     bool setEncodingUtf8();
     void setDatestyle();
     void detectBackslashEscape();
+    bool bulkInsert(const QString &tableName, const QSqlRecord &columns,
+                    const QVector<QVariantList> &values) Q_DECL_OVERRIDE;
 };
 
 void QPSQLDriverPrivate::appendTables(QStringList &tl, QSqlQuery &t, QChar type)
@@ -202,14 +262,21 @@ void QPSQLDriverPrivate::appendTables(QStringList &tl, QSqlQuery &t, QChar type)
     }
 }
 
-PGresult * QPSQLDriverPrivate::exec(const char * stmt) const
+void QPSQLDriverPrivate::checkPendingNotifications() const
 {
     Q_Q(const QPSQLDriver);
-    PGresult *result = PQexec(connection, stmt);
     if (seid.size() && !pendingNotifyCheck) {
         pendingNotifyCheck = true;
         QMetaObject::invokeMethod(const_cast<QPSQLDriver*>(q), "_q_handleNotification", Qt::QueuedConnection, Q_ARG(int,0));
     }
+}
+
+PGresult * QPSQLDriverPrivate::exec(const char * stmt) const
+{
+    // the connection can only process one query at a time
+    finishQuery(currentStmtId);
+    PGresult *result = PQexec(connection, stmt);
+    checkPendingNotifications();
     return result;
 }
 
@@ -218,6 +285,93 @@ PGresult * QPSQLDriverPrivate::exec(const QString & stmt) const
     return exec(isUtf8 ? stmt.toUtf8().constData() : stmt.toLocal8Bit().constData());
 }
 
+PGresult *QPSQLDriverPrivate::execPrepared(const QByteArray &stmtName, const QPSQLParameters &params) const
+{
+    finishQuery(currentStmtId);
+    PGresult *result = PQexecPrepared(connection, stmtName.constData(), params.values.size(),
+                                      params.values.constData(), params.lengths.constData(),
+                                      params.formats.constData(), 0);
+    checkPendingNotifications();
+    return result;
+}
+
+bool QPSQLDriverPrivate::canStream() const
+{
+#ifdef QT_PSQL_SINGLE_ROW_MODE
+    return PQprotocolVersion(connection) >= 3;
+#else
+    return false;
+#endif
+}
+
+/*
+   Sends \a stmt without waiting for the result and switches the connection
+   to single-row mode, so that rows can be fetched one by one with getResult().
+   Returns the id of the statement, or InvalidStatementId if the query could
+   not be sent.
+ */
+int QPSQLDriverPrivate::sendQuery(const QString &stmt) const
+{
+    finishQuery(currentStmtId);
+    const QByteArray query = isUtf8 ? stmt.toUtf8() : stmt.toLocal8Bit();
+    if (!PQsendQuery(connection, query.constData()))
+        return InvalidStatementId;
+    return beginSingleRowMode();
+}
+
+int QPSQLDriverPrivate::sendQueryPrepared(const QByteArray &stmtName, const QPSQLParameters &params,
+                                          bool binaryResults) const
+{
+    finishQuery(currentStmtId);
+    if (!PQsendQueryPrepared(connection, stmtName.constData(), params.values.size(),
+                             params.values.constData(), params.lengths.constData(),
+                             params.formats.constData(), binaryResults ? 1 : 0)) {
+        return InvalidStatementId;
+    }
+    return beginSingleRowMode();
+}
+
+int QPSQLDriverPrivate::beginSingleRowMode() const
+{
+#ifdef QT_PSQL_SINGLE_ROW_MODE
+    // if this fails the complete result set is delivered at once, which is handled as well
+    PQsetSingleRowMode(connection);
+#endif
+    checkPendingNotifications();
+
+    if (++stmtCount == InvalidStatementId)
+        ++stmtCount;
+    currentStmtId = stmtCount;
+    return currentStmtId;
+}
+
+PGresult *QPSQLDriverPrivate::getResult(int stmtId) const
+{
+    // the rows are gone if another query has been executed in the meantime
+    if (stmtId == InvalidStatementId || stmtId != currentStmtId)
+        return 0;
+    PGresult *result = PQgetResult(connection);
+    if (!result)
+        currentStmtId = InvalidStatementId;
+    return result;
+}
+
+void QPSQLDriverPrivate::finishQuery(int stmtId) const
+{
+    if (stmtId == InvalidStatementId || stmtId != currentStmtId)
+        return;
+#ifndef QT_NO_QFUTURE
+    if (asyncQuery) {
+        // the connection is needed for something else, read the remaining rows now
+        waitForAsyncQuery();
+        return;
+    }
+#endif
+    while (PGresult *result = PQgetResult(connection))
+        PQclear(result);
+    currentStmtId = InvalidStatementId;
+}
+
 class QPSQLResultPrivate : public QSqlResultPrivate
 {
     Q_DECLARE_PUBLIC(QPSQLResult)
@@ -227,18 +381,35 @@ public:
       : QSqlResultPrivate(q, drv),
         result(0),
         currentSize(-1),
-        preparedQueriesEnabled(false)
+        stmtId(QPSQLDriverPrivate::InvalidStatementId),
+        preparedQueriesEnabled(false),
+        binaryResults(false)
     { }
 
     QString fieldSerial(int i) const Q_DECL_OVERRIDE { return QLatin1Char('$') + QString::number(i + 1); }
+#ifndef QT_NO_QFUTURE
+    void execAsync(const QSqlQuery &query, const QString &sql,
+                   QFutureInterface<QSqlRecord> &future) Q_DECL_OVERRIDE;
+#endif
     void deallocatePreparedStmt();
 
     PGresult *result;
     int currentSize;
+    // set while the rows of a forward-only query are streamed in single-row mode
+    int stmtId;
     bool preparedQueriesEnabled;
+    // the prepared statement only returns columns that can be transferred in binary format
+    bool binaryResults;
     QString preparedStmtId;
+    QVector<Oid> paramTypes;
 
+    bool execute(const QString &stmt);
+    bool executePrepared(const QPSQLParameters &params);
+    void bindParameters(const QVector<QVariant> &values, QPSQLParameters *params) const;
     bool processResults();
+    bool fetchNextRow();
+    int currentRow() const;
+    QVariant binaryValue(int row, int field) const;
 };
 
 static QSqlError qMakeError(const QString& err, QSqlError::ErrorType type,
@@ -254,11 +425,60 @@ static QSqlError qMakeError(const QString& err, QSqlError::ErrorType type,
     return QSqlError(QLatin1String("QPSQL: ") + err, msg, type, errorCode);
 }
 
+bool QPSQLResultPrivate::execute(const QString &stmt)
+{
+    Q_Q(QPSQLResult);
+    if (q->isForwardOnly() && drv_d_func()->canStream()) {
+        stmtId = drv_d_func()->sendQuery(stmt);
+        result = drv_d_func()->getResult(stmtId);
+    } else {
+        result = drv_d_func()->exec(stmt);
+    }
+    return processResults();
+}
+
+bool QPSQLResultPrivate::executePrepared(const QPSQLParameters &params)
+{
+    Q_Q(QPSQLResult);
+    const QByteArray stmtName = preparedStmtId.toLatin1();
+    if (q->isForwardOnly() && drv_d_func()->canStream()) {
+        stmtId = drv_d_func()->sendQueryPrepared(stmtName, params, binaryResults);
+        result = drv_d_func()->getResult(stmtId);
+    } else {
+        result = drv_d_func()->execPrepared(stmtName, params);
+    }
+    return processResults();
+}
+
 bool QPSQLResultPrivate::processResults()
 {
     Q_Q(QPSQLResult);
-    if (!result)
+    if (stmtId != QPSQLDriverPrivate::InvalidStatementId) {
+#ifdef QT_PSQL_SINGLE_ROW_MODE
+        if (PQresultStatus(result) == PGRES_SINGLE_TUPLE) {
+            q->setSelect(true);
+            q->setActive(true);
+            currentSize = -1;
+            return true;
+        }
+#endif
+        // like PQexec(), report the last result of a multi-statement query
+        while (PGresult *next = drv_d_func()->getResult(stmtId)) {
+            if (result && PQresultStatus(result) == PGRES_FATAL_ERROR) {
+                PQclear(next);
+                continue;
+            }
+            PQclear(result);
+            result = next;
+        }
+        stmtId = QPSQLDriverPrivate::InvalidStatementId;
+    }
+
+    if (!result) {
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                        "Unable to create query"), QSqlError::StatementError, drv_d_func()));
         return false;
+    }
 
     int status = PQresultStatus(result);
     if (status == PGRES_TUPLES_OK) {
@@ -277,6 +497,265 @@ bool QPSQLResultPrivate::processResults()
     return false;
 }
 
+int QPSQLResultPrivate::currentRow() const
+{
+    Q_Q(const QPSQLResult);
+#ifdef QT_PSQL_SINGLE_ROW_MODE
+    // in single-row mode every result holds exactly one row
+    if (PQresultStatus(result) == PGRES_SINGLE_TUPLE)
+        return 0;
+#endif
+    return q->at();
+}
+
+/*
+   Replaces the current row of a query in single-row mode with the next one.
+   When the end of the result set is reached the current row is kept, so
+   that fetchLast() can position on it.
+ */
+bool QPSQLResultPrivate::fetchNextRow()
+{
+    Q_Q(QPSQLResult);
+    if (stmtId == QPSQLDriverPrivate::InvalidStatementId)
+        return false;
+
+    if (drv_d_func()->currentStmtId != stmtId) {
+        stmtId = QPSQLDriverPrivate::InvalidStatementId;
+        PQclear(result);
+        result = 0;
+        q->setLastError(QSqlError(QLatin1String("QPSQL: ") + QCoreApplication::translate("QPSQLResult",
+                        "Unable to fetch row"), QCoreApplication::translate("QPSQLResult",
+                        "Query results lost - probably discarded on executing another SQL query."),
+                        QSqlError::StatementError));
+        return false;
+    }
+
+    PGresult *next = drv_d_func()->getResult(stmtId);
+    const int status = next ? PQresultStatus(next) : PGRES_FATAL_ERROR;
+#ifdef QT_PSQL_SINGLE_ROW_MODE
+    if (status == PGRES_SINGLE_TUPLE) {
+        PQclear(result);
+        result = next;
+        return true;
+    }
+#endif
+    if (status == PGRES_TUPLES_OK) {
+        PQclear(next);
+    } else {
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                        "Unable to fetch row"), QSqlError::StatementError, drv_d_func(), next));
+        PQclear(result);
+        result = next;
+    }
+    drv_d_func()->finishQuery(stmtId);
+    stmtId = QPSQLDriverPrivate::InvalidStatementId;
+    return false;
+}
+
+#ifndef QT_NO_QFUTURE
+/*
+   Reads the results of a query sent by QSqlQuery::execAsync() whenever the
+   socket of the connection becomes readable, and reports the rows to the
+   future. Deletes itself when the query has finished.
+ */
+class QPSQLAsyncQuery : public QObject
+{
+public:
+    QPSQLAsyncQuery(const QSqlQuery &query, QPSQLResult *result,
+                    const QFutureInterface<QSqlRecord> &future);
+
+    void readResults(bool wait);
+
+private:
+    void handleResult(PGresult *next);
+    void reportRows();
+    void finish();
+
+    QSqlQuery query; // keeps the result alive until the query has finished
+    QPSQLResult *q;
+    QFutureInterface<QSqlRecord> future;
+    QSocketNotifier *notifier;
+    QSqlRecord fields;
+    int rows;
+    bool canceled;
+    bool failed;
+};
+
+QPSQLAsyncQuery::QPSQLAsyncQuery(const QSqlQuery &query, QPSQLResult *result,
+                                 const QFutureInterface<QSqlRecord> &future)
+    : QObject(const_cast<QSqlDriver *>(result->driver())),
+      query(query),
+      q(result),
+      future(future),
+      notifier(0),
+      rows(0),
+      canceled(false),
+      failed(false)
+{
+    QPSQLDriverPrivate *drv = q->d_func()->drv_d_func();
+    drv->asyncQuery = this;
+    // the notifier for event notifications would steal our activations
+    if (drv->sn)
+        drv->sn->setEnabled(false);
+    notifier = new QSocketNotifier(PQsocket(drv->connection), QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, [this]() { readResults(false); });
+}
+
+/*
+   Processes the results that have arrived. If \a wait is true, blocks until
+   the query has finished instead.
+ */
+void QPSQLAsyncQuery::readResults(bool wait)
+{
+    QPSQLResultPrivate *d = q->d_func();
+    QPSQLDriverPrivate *drv = d->drv_d_func();
+    PGconn *connection = drv->connection;
+    if (!wait && !PQconsumeInput(connection)) {
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                        "Unable to fetch row"), QSqlError::ConnectionError, drv));
+        failed = true;
+        drv->currentStmtId = QPSQLDriverPrivate::InvalidStatementId;
+        finish();
+        return;
+    }
+
+    while (wait || !PQisBusy(connection)) {
+        if (future.isCanceled() && !canceled) {
+            canceled = true;
+            if (PGcancel *cancel = PQgetCancel(connection)) {
+                char errbuf[256];
+                PQcancel(cancel, errbuf, sizeof(errbuf));
+                PQfreeCancel(cancel);
+            }
+        }
+        PGresult *next = drv->getResult(d->stmtId);
+        if (!next) {
+            finish();
+            return;
+        }
+        handleResult(next);
+    }
+}
+
+void QPSQLAsyncQuery::handleResult(PGresult *next)
+{
+    QPSQLResultPrivate *d = q->d_func();
+    // like PQexec(), an error ends the query and the results after it are ignored
+    if (failed) {
+        PQclear(next);
+        return;
+    }
+
+    switch (PQresultStatus(next)) {
+#ifdef QT_PSQL_SINGLE_ROW_MODE
+    case PGRES_SINGLE_TUPLE:
+#endif
+    case PGRES_TUPLES_OK:
+        PQclear(d->result);
+        d->result = next;
+        q->setSelect(true);
+        q->setActive(true);
+        reportRows();
+        break;
+    case PGRES_COMMAND_OK:
+        PQclear(d->result);
+        d->result = next;
+        q->setSelect(false);
+        q->setActive(true);
+        break;
+    default:
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                        "Unable to create query"), QSqlError::StatementError, d->drv_d_func(), next));
+        PQclear(d->result);
+        d->result = next;
+        failed = true;
+        break;
+    }
+}
+
+void QPSQLAsyncQuery::reportRows()
+{
+    QPSQLResultPrivate *d = q->d_func();
+    if (fields.isEmpty())
+        fields = q->record();
+    if (!canceled) {
+        const int count = PQntuples(d->result);
+        for (int row = 0; row < count; ++row) {
+            q->setAt(row);
+            QSqlRecord rec = fields;
+            for (int i = 0; i < rec.count(); ++i)
+                rec.setValue(i, q->data(i));
+            future.reportResult(rec, rows++);
+        }
+    }
+    // the next result set of a multi-statement query may have other columns
+    if (PQresultStatus(d->result) == PGRES_TUPLES_OK)
+        fields = QSqlRecord();
+}
+
+void QPSQLAsyncQuery::finish()
+{
+    QPSQLResultPrivate *d = q->d_func();
+    QPSQLDriverPrivate *drv = d->drv_d_func();
+    d->stmtId = QPSQLDriverPrivate::InvalidStatementId;
+    d->currentSize = -1;
+    if (canceled) {
+        // the server reports the cancellation as an error, drop it like
+        // QSqlResultPrivate::runAsync() does
+        PQclear(d->result);
+        d->result = 0;
+        q->setLastError(QSqlError());
+        q->setAt(QSql::BeforeFirstRow);
+        q->setActive(false);
+    } else if (failed) {
+        q->setActive(false);
+    } else {
+        q->setAt(QSql::AfterLastRow);
+    }
+
+    drv->asyncQuery = 0;
+    notifier->setEnabled(false);
+    if (drv->sn)
+        drv->sn->setEnabled(true);
+    drv->checkPendingNotifications();
+    future.reportFinished();
+    deleteLater();
+}
+
+void QPSQLDriverPrivate::waitForAsyncQuery() const
+{
+    asyncQuery->readResults(true);
+}
+
+void QPSQLResultPrivate::execAsync(const QSqlQuery &query, const QString &sql,
+                                   QFutureInterface<QSqlRecord> &future)
+{
+    Q_Q(QPSQLResult);
+    QPSQLDriverPrivate *drv = drv_d_func();
+    // without single-row mode or server-side prepared statements use a worker thread
+    if (!drv->canStream() || (sql.isNull() && !preparedQueriesEnabled)) {
+        QSqlResultPrivate::execAsync(query, sql, future);
+        return;
+    }
+
+    q->cleanup();
+    if (sql.isNull()) {
+        QPSQLParameters params;
+        bindParameters(q->boundValues(), &params);
+        stmtId = drv->sendQueryPrepared(preparedStmtId.toLatin1(), params, binaryResults);
+    } else {
+        stmtId = drv->sendQuery(sql);
+    }
+    if (stmtId == QPSQLDriverPrivate::InvalidStatementId) {
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                        "Unable to send query"), QSqlError::StatementError, drv));
+        future.reportFinished();
+        return;
+    }
+    new QPSQLAsyncQuery(query, q, future);
+}
+#endif // QT_NO_QFUTURE
+
 static QVariant::Type qDecodePSQLType(int t)
 {
     QVariant::Type type = QVariant::Invalid;
@@ -323,6 +802,198 @@ static QVariant::Type qDecodePSQLType(int t)
     return type;
 }
 
+static QVariant qNumericValue(const QString &str, QSql::NumericalPrecisionPolicy policy)
+{
+    if (policy == QSql::HighPrecision)
+        return str;
+
+    QVariant retval;
+    bool convert;
+    double dbl = str.toDouble(&convert);
+    if (policy == QSql::LowPrecisionInt64)
+        retval = (qlonglong)dbl;
+    else if (policy == QSql::LowPrecisionInt32)
+        retval = (int)dbl;
+    else if (policy == QSql::LowPrecisionDouble)
+        retval = dbl;
+    if (!convert)
+        return QVariant();
+    return retval;
+}
+
+/*
+   Returns \c true if values of type \a ptype can be transferred in binary
+   format and converted by QPSQLResultPrivate::binaryValue() to exactly the
+   same QVariant as their text representation.
+ */
+static bool qIsBinaryTransferable(int ptype, const PGconn *connection)
+{
+    switch (ptype) {
+    case QBOOLOID:
+    case QINT8OID:
+    case QINT2OID:
+    case QINT4OID:
+    case QNUMERICOID:
+    case QFLOAT8OID:
+    case QBYTEAOID:
+    case QCHAROID:
+    case QNAMEOID:
+    case QTEXTOID:
+    case QBPCHAROID:
+    case QVARCHAROID:
+    case QUUIDOID:
+        return true;
+    case QDATEOID:
+    case QTIMEOID:
+    case QTIMESTAMPOID:
+    case QTIMESTAMPTZOID: {
+        // servers built with floating-point datetimes send doubles instead
+        const char *status = PQparameterStatus(connection, "integer_datetimes");
+        return status && qstrcmp(status, "on") == 0;
+    }
+    default:
+        return false;
+    }
+}
+
+// postgres dates and timestamps count from 2000-01-01
+static const qint64 qPsqlEpochJulianDay = 2451545;
+
+static QTime qPsqlTime(qint64 usecs)
+{
+    const int msecs = qMin(qRound((usecs % 1000000) / 1000.0), 999);
+    return QTime(0, 0).addMSecs(int(usecs / 1000000) * 1000 + msecs);
+}
+
+static QString qNumericToString(const char *val, int len)
+{
+    const int ndigits = qFromBigEndian<quint16>(reinterpret_cast<const uchar *>(val));
+    const int weight = qFromBigEndian<qint16>(reinterpret_cast<const uchar *>(val + 2));
+    const int sign = qFromBigEndian<quint16>(reinterpret_cast<const uchar *>(val + 4));
+    const int dscale = qFromBigEndian<quint16>(reinterpret_cast<const uchar *>(val + 6));
+    if (len < 8 + 2 * ndigits)
+        return QString();
+    switch (sign) {
+    case 0xC000:
+        return QStringLiteral("NaN");
+    case 0xD000:
+        return QStringLiteral("Infinity");
+    case 0xF000:
+        return QStringLiteral("-Infinity");
+    }
+
+    // the digits are stored in base 10000, the first one with the exponent weight
+    const uchar *digits = reinterpret_cast<const uchar *>(val + 8);
+    QString str;
+    if (sign == 0x4000)
+        str += QLatin1Char('-');
+    if (weight < 0)
+        str += QLatin1Char('0');
+    for (int i = 0; i <= weight; ++i) {
+        const int digit = i < ndigits ? qFromBigEndian<quint16>(digits + 2 * i) : 0;
+        if (i == 0)
+            str += QString::number(digit);
+        else
+            str += QString::number(digit).rightJustified(4, QLatin1Char('0'));
+    }
+    if (dscale > 0) {
+        QString fraction;
+        for (int i = weight + 1; fraction.size() < dscale; ++i) {
+            const int digit = i >= 0 && i < ndigits ? qFromBigEndian<quint16>(digits + 2 * i) : 0;
+            fraction += QString::number(digit).rightJustified(4, QLatin1Char('0'));
+        }
+        fraction.truncate(dscale);
+        str += QLatin1Char('.') + fraction;
+    }
+    return str;
+}
+
+QVariant QPSQLResultPrivate::binaryValue(int row, int field) const
+{
+    const uchar *val = reinterpret_cast<const uchar *>(PQgetvalue(result, row, field));
+    const int len = PQgetlength(result, row, field);
+    const int ptype = PQftype(result, field);
+
+    switch (ptype) {
+    case QBOOLOID:
+        if (len == 1)
+            return QVariant(val[0] != 0);
+        break;
+    case QINT2OID:
+        if (len == 2)
+            return QVariant(int(qFromBigEndian<qint16>(val)));
+        break;
+    case QINT4OID:
+        if (len == 4)
+            return QVariant(int(qFromBigEndian<qint32>(val)));
+        break;
+    case QINT8OID:
+        if (len == 8)
+            return QVariant(qlonglong(qFromBigEndian<qint64>(val)));
+        break;
+    case QFLOAT8OID:
+        if (len == 8) {
+            const quint64 bits = qFromBigEndian<quint64>(val);
+            double dbl;
+            memcpy(&dbl, &bits, sizeof(dbl));
+            return QVariant(dbl);
+        }
+        break;
+    case QNUMERICOID:
+        if (len >= 8)
+            return qNumericValue(qNumericToString(reinterpret_cast<const char *>(val), len), precisionPolicy);
+        break;
+    case QBYTEAOID:
+        return QVariant(QByteArray(reinterpret_cast<const char *>(val), len));
+    case QUUIDOID:
+        if (len == 16) {
+            const QUuid uuid = QUuid::fromRfc4122(QByteArray::fromRawData(reinterpret_cast<const char *>(val), len));
+            return QVariant(uuid.toString().mid(1, 36));
+        }
+        break;
+    case QDATEOID:
+        if (len == 4) {
+            const qint32 days = qFromBigEndian<qint32>(val);
+            // +-infinity
+            if (days == std::numeric_limits<qint32>::max() || days == std::numeric_limits<qint32>::min())
+                return QVariant(QDate());
+            return QVariant(QDate::fromJulianDay(qPsqlEpochJulianDay + days));
+        }
+        break;
+    case QTIMEOID:
+        if (len == 8)
+            return QVariant(qPsqlTime(qFromBigEndian<qint64>(val)));
+        break;
+    case QTIMESTAMPOID:
+    case QTIMESTAMPTZOID:
+        if (len == 8) {
+            const qint64 usecs = qFromBigEndian<qint64>(val);
+            if (usecs == std::numeric_limits<qint64>::max() || usecs == std::numeric_limits<qint64>::min())
+                return QVariant(QDateTime());
+            const qint64 usecsPerDay = Q_INT64_C(86400000000);
+            qint64 days = usecs / usecsPerDay;
+            qint64 usecsOfDay = usecs % usecsPerDay;
+            if (usecsOfDay < 0) {
+                --days;
+                usecsOfDay += usecsPerDay;
+            }
+            // timestamps without time zone are local times, the others are sent in UTC
+            const QDateTime dt(QDate::fromJulianDay(qPsqlEpochJulianDay + days), qPsqlTime(usecsOfDay),
+                               ptype == QTIMESTAMPOID ? Qt::LocalTime : Qt::UTC);
+            return QVariant(dt.toLocalTime());
+        }
+        break;
+    default: {
+        // textual types have the same representation in both formats
+        const char *str = reinterpret_cast<const char *>(val);
+        return drv_d_func()->isUtf8 ? QString::fromUtf8(str, len) : QString::fromLatin1(str, len);
+    }
+    }
+
+    qWarning("QPSQLResult::data: unexpected binary value of type %d", ptype);
+    return QVariant();
+}
+
 void QPSQLResultPrivate::deallocatePreparedStmt()
 {
     const QString stmt = QLatin1String("DEALLOCATE ") + preparedStmtId;
@@ -359,6 +1030,11 @@ QVariant QPSQLResult::handle() const
 void QPSQLResult::cleanup()
 {
     Q_D(QPSQLResult);
+    // finishing a pending asynchronous query stores its last result, so
+    // only clear the result once the connection has been drained
+    if (d->stmtId != QPSQLDriverPrivate::InvalidStatementId && driver())
+        d->drv_d_func()->finishQuery(d->stmtId);
+    d->stmtId = QPSQLDriverPrivate::InvalidStatementId;
     if (d->result)
         PQclear(d->result);
     d->result = 0;
@@ -369,15 +1045,27 @@ void QPSQLResult::cleanup()
 
 bool QPSQLResult::fetch(int i)
 {
-    Q_D(const QPSQLResult);
+    Q_D(QPSQLResult);
     if (!isActive())
         return false;
     if (i < 0)
         return false;
-    if (i >= d->currentSize)
-        return false;
     if (at() == i)
         return true;
+    if (d->stmtId != QPSQLDriverPrivate::InvalidStatementId) {
+        // single-row mode: the first row arrives with the result of the query
+        int row = at() == QSql::BeforeFirstRow ? 0 : at();
+        if (i < row)
+            return false;
+        for (; row < i; ++row) {
+            if (!d->fetchNextRow())
+                return false;
+        }
+        setAt(i);
+        return true;
+    }
+    if (i >= d->currentSize)
+        return false;
     setAt(i);
     return true;
 }
@@ -389,7 +1077,18 @@ bool QPSQLResult::fetchFirst()
 
 bool QPSQLResult::fetchLast()
 {
-    Q_D(const QPSQLResult);
+    Q_D(QPSQLResult);
+    if (d->stmtId != QPSQLDriverPrivate::InvalidStatementId) {
+        int row = at() == QSql::BeforeFirstRow ? 0 : at();
+        while (d->fetchNextRow())
+            ++row;
+#ifdef QT_PSQL_SINGLE_ROW_MODE
+        if (PQresultStatus(d->result) != PGRES_SINGLE_TUPLE)
+            return false;
+#endif
+        setAt(row);
+        return true;
+    }
     return fetch(PQntuples(d->result) - 1);
 }
 
@@ -400,11 +1099,14 @@ QVariant QPSQLResult::data(int i)
         qWarning("QPSQLResult::data: column %d out of range", i);
         return QVariant();
     }
+    const int row = d->currentRow();
     int ptype = PQftype(d->result, i);
     QVariant::Type type = qDecodePSQLType(ptype);
-    const char *val = PQgetvalue(d->result, at(), i);
-    if (PQgetisnull(d->result, at(), i))
+    const char *val = PQgetvalue(d->result, row, i);
+    if (PQgetisnull(d->result, row, i))
         return QVariant(type);
+    if (PQfformat(d->result, i) == 1)
+        return d->binaryValue(row, i);
     switch (type) {
     case QVariant::Bool:
         return QVariant((bool)(val[0] == 't'));
@@ -418,23 +1120,8 @@ QVariant QPSQLResult::data(int i)
     case QVariant::Int:
         return atoi(val);
     case QVariant::Double:
-        if (ptype == QNUMERICOID) {
-            if (numericalPrecisionPolicy() != QSql::HighPrecision) {
-                QVariant retval;
-                bool convert;
-                double dbl=QString::fromLatin1(val).toDouble(&convert);
-                if (numericalPrecisionPolicy() == QSql::LowPrecisionInt64)
-                    retval = (qlonglong)dbl;
-                else if (numericalPrecisionPolicy() == QSql::LowPrecisionInt32)
-                    retval = (int)dbl;
-                else if (numericalPrecisionPolicy() == QSql::LowPrecisionDouble)
-                    retval = dbl;
-                if (!convert)
-                    return QVariant();
-                return retval;
-            }
-            return QString::fromLatin1(val);
-        }
+        if (ptype == QNUMERICOID)
+            return qNumericValue(QString::fromLatin1(val), numericalPrecisionPolicy());
         return QString::fromLatin1(val).toDouble();
     case QVariant::Date:
         if (val[0] == '\0') {
@@ -488,8 +1175,9 @@ QVariant QPSQLResult::data(int i)
 bool QPSQLResult::isNull(int field)
 {
     Q_D(const QPSQLResult);
-    PQgetvalue(d->result, at(), field);
-    return PQgetisnull(d->result, at(), field);
+    const int row = d->currentRow();
+    PQgetvalue(d->result, row, field);
+    return PQgetisnull(d->result, row, field);
 }
 
 bool QPSQLResult::reset (const QString& query)
@@ -500,8 +1188,17 @@ bool QPSQLResult::reset (const QString& query)
         return false;
     if (!driver()->isOpen() || driver()->isOpenError())
         return false;
-    d->result = d->drv_d_func()->exec(query);
-    return d->processResults();
+    return d->execute(query);
+}
+
+void QPSQLResult::detachFromResultSet()
+{
+    Q_D(QPSQLResult);
+    // release the connection instead of keeping the remaining rows pending
+    if (d->stmtId != QPSQLDriverPrivate::InvalidStatementId) {
+        d->drv_d_func()->finishQuery(d->stmtId);
+        d->stmtId = QPSQLDriverPrivate::InvalidStatementId;
+    }
 }
 
 int QPSQLResult::size()
@@ -590,26 +1287,231 @@ void QPSQLResult::virtual_hook(int id, void *data)
     QSqlResult::virtual_hook(id, data);
 }
 
-static QString qCreateParamString(const QVector<QVariant> &boundValues, const QSqlDriver *driver)
+static bool qIsNumber(const QVariant &val, bool allowFloatingPoint)
 {
-    if (boundValues.isEmpty())
-        return QString();
+    switch (int(val.type())) {
+    case QMetaType::Bool:
+    case QMetaType::Char:
+    case QMetaType::SChar:
+    case QMetaType::UChar:
+    case QMetaType::Short:
+    case QMetaType::UShort:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::Long:
+    case QMetaType::ULong:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+        return true;
+    case QMetaType::Float:
+    case QMetaType::Double:
+        return allowFloatingPoint;
+    default:
+        return false;
+    }
+}
+
+/*
+   Converts the number \a val to an integer in the range of a signed
+   integer with \a bits bits. Fractional values are rounded half away
+   from zero, like the server's assignment cast from numeric does.
+ */
+static bool qIntegralParameter(const QVariant &val, int bits, qlonglong *n)
+{
+    const qlonglong min = bits == 64 ? std::numeric_limits<qlonglong>::min()
+                                     : -(Q_INT64_C(1) << (bits - 1));
+    const qlonglong max = -(min + 1);
+    if (qIsNumber(val, false)) {
+        bool ok = false;
+        *n = val.toLongLong(&ok);
+        if (!ok || (*n < 0 && val.type() == QVariant::ULongLong))
+            return false;
+        return *n >= min && *n <= max;
+    }
+    if (!qIsNumber(val, true))
+        return false;
+    const double d = val.toDouble();
+    if (!qIsFinite(d))
+        return false;
+    const double magnitude = floor(fabs(d));
+    double rounded = fabs(d) - magnitude >= 0.5 ? magnitude + 1 : magnitude;
+    if (d < 0)
+        rounded = -rounded;
+    // max + 1 is a power of two and exact as a double, max itself may not be
+    if (rounded < double(min) || rounded >= -double(min))
+        return false;
+    *n = qlonglong(rounded);
+    return true;
+}
+
+/*
+   Encodes \a val in the binary format of the parameter type \a ptype.
+   Returns \c false if the type has no binary encoding here or the value
+   cannot be converted; the value is then sent as text and converted by
+   the server.
+ */
+static bool qEncodeBinaryParameter(const QVariant &val, Oid ptype, QByteArray *data)
+{
+    // strings are converted by the server as before
+    bool ok = false;
+    qlonglong n = 0;
+    switch (ptype) {
+    case QBOOLOID:
+        if (!qIsNumber(val, false))
+            return false;
+        data->resize(1);
+        (*data)[0] = val.toBool() ? 1 : 0;
+        return true;
+    case QINT2OID:
+        if (!qIntegralParameter(val, 16, &n))
+            return false;
+        data->resize(2);
+        qToBigEndian<qint16>(qint16(n), reinterpret_cast<uchar *>(data->data()));
+        return true;
+    case QINT4OID:
+        if (!qIntegralParameter(val, 32, &n))
+            return false;
+        data->resize(4);
+        qToBigEndian<qint32>(qint32(n), reinterpret_cast<uchar *>(data->data()));
+        return true;
+    case QINT8OID:
+        if (!qIntegralParameter(val, 64, &n))
+            return false;
+        data->resize(8);
+        qToBigEndian<qint64>(n, reinterpret_cast<uchar *>(data->data()));
+        return true;
+    case QFLOAT4OID: {
+        if (!qIsNumber(val, true))
+            return false;
+        const float f = val.toFloat(&ok);
+        if (!ok)
+            return false;
+        quint32 bits;
+        memcpy(&bits, &f, sizeof(bits));
+        data->resize(4);
+        qToBigEndian<quint32>(bits, reinterpret_cast<uchar *>(data->data()));
+        return true;
+    }
+    case QFLOAT8OID: {
+        if (!qIsNumber(val, true))
+            return false;
+        const double dbl = val.toDouble(&ok);
+        if (!ok)
+            return false;
+        quint64 bits;
+        memcpy(&bits, &dbl, sizeof(bits));
+        data->resize(8);
+        qToBigEndian<quint64>(bits, reinterpret_cast<uchar *>(data->data()));
+        return true;
+    }
+    case QBYTEAOID:
+        // strings bound to bytea parameters are in the escaped input format
+        if (val.type() != QVariant::ByteArray)
+            return false;
+        *data = val.toByteArray();
+        return true;
+    default:
+        return false;
+    }
+}
 
-    QString params;
-    QSqlField f;
-    for (int i = 0; i < boundValues.count(); ++i) {
-        const QVariant &val = boundValues.at(i);
+template <class FloatType>
+static QByteArray qFloatParameter(FloatType val, int precision)
+{
+    if (isnan(val))
+        return QByteArrayLiteral("NaN");
+    switch (isinf(val)) {
+    case 1:
+        return QByteArrayLiteral("Infinity");
+    case -1:
+        return QByteArrayLiteral("-Infinity");
+    }
+    return QByteArray::number(val, 'g', precision);
+}
+
+/*
+   Returns the text representation of \a val for a parameter of type
+   \a ptype, or a null QByteArray if it is to be sent as NULL.
+ */
+static QByteArray qTextParameter(const QVariant &val, Oid ptype, bool isUtf8)
+{
+    switch (int(val.type())) {
+    case QVariant::DateTime: {
+#ifndef QT_NO_DATESTRING
+        const QDateTime dt = val.toDateTime();
+        if (!dt.isValid())
+            return QByteArray();
+        // only timestamps with time zone keep the offset, the other types get the local time
+        if (ptype == QTIMESTAMPTZOID)
+            return dt.toUTC().toString(QLatin1String("yyyy-MM-ddThh:mm:ss.zzz")).toLatin1() + 'Z';
+        const QDateTime local = dt.toLocalTime();
+        QByteArray text = local.toString(QLatin1String("yyyy-MM-ddThh:mm:ss.zzz")).toLatin1();
+        if (ptype == InvalidOid) {
+            // the column type is not known, as for COPY: timestamps without
+            // time zone ignore the offset, timestamps with time zone need it
+            // to not be read in the session time zone
+            const int offset = local.offsetFromUtc();
+            const int minutes = qAbs(offset) / 60;
+            text += offset < 0 ? '-' : '+';
+            text += QByteArray::number(minutes / 60).rightJustified(2, '0') + ':'
+                    + QByteArray::number(minutes % 60).rightJustified(2, '0');
+        }
+        return text;
+#else
+        return QByteArray();
+#endif
+    }
+    case QVariant::Time:
+#ifndef QT_NO_DATESTRING
+        if (val.toTime().isValid())
+            return val.toTime().toString(QLatin1String("hh:mm:ss.zzz")).toLatin1();
+#endif
+        return QByteArray();
+    case QVariant::Date:
+#ifndef QT_NO_DATESTRING
+        if (val.toDate().isValid())
+            return val.toDate().toString(Qt::ISODate).toLatin1();
+#endif
+        return QByteArray();
+    case QVariant::Bool:
+        return val.toBool() ? QByteArrayLiteral("true") : QByteArrayLiteral("false");
+    case QMetaType::Float:
+        return qFloatParameter(val.toFloat(), 9);
+    case QVariant::Double:
+        return qFloatParameter(val.toDouble(), 17);
+    case QVariant::ByteArray:
+        return val.toByteArray();
+    default: {
+        const QString str = val.toString();
+        return isUtf8 ? str.toUtf8() : str.toLocal8Bit();
+    }
+    }
+}
 
-        f.setType(val.type());
+void QPSQLResultPrivate::bindParameters(const QVector<QVariant> &values, QPSQLParameters *params) const
+{
+    const int count = values.size();
+    params->data.resize(count);
+    params->values.resize(count);
+    params->lengths.resize(count);
+    params->formats.resize(count);
+    for (int i = 0; i < count; ++i) {
+        const QVariant &val = values.at(i);
+        const Oid ptype = i < paramTypes.size() ? paramTypes.at(i) : 0;
+        QByteArray &data = params->data[i];
+        int format = 0;
         if (val.isNull())
-            f.clear();
+            data.clear();
+        else if (qEncodeBinaryParameter(val, ptype, &data))
+            format = 1;
         else
-            f.setValue(val);
-        if(!params.isNull())
-            params.append(QLatin1String(", "));
-        params.append(driver->formatValue(f));
+            data = qTextParameter(val, ptype, drv_d_func()->isUtf8);
+        if (format == 1 && data.isNull())
+            data = QByteArray("");
+        params->values[i] = data.isNull() ? 0 : data.constData();
+        params->lengths[i] = data.size();
+        params->formats[i] = format;
     }
-    return params;
 }
 
 Q_GLOBAL_STATIC(QMutex, qMutex)
@@ -629,14 +1531,20 @@ bool QPSQLResult::prepare(const QString &query)
         return QSqlResult::prepare(query);
 
     cleanup();
+    d->binaryResults = false;
+    d->paramTypes.clear();
 
     if (!d->preparedStmtId.isEmpty())
         d->deallocatePreparedStmt();
 
     const QString stmtId = qMakePreparedStmtId();
-    const QString stmt = QString::fromLatin1("PREPARE %1 AS ").arg(stmtId).append(d->positionalToNamedBinding(query));
+    const QByteArray stmtName = stmtId.toLatin1();
+    const QString stmt = d->positionalToNamedBinding(query);
+    const QByteArray stmtText = d->drv_d_func()->isUtf8 ? stmt.toUtf8() : stmt.toLocal8Bit();
 
-    PGresult *result = d->drv_d_func()->exec(stmt);
+    QPSQLDriverPrivate *drv = d->drv_d_func();
+    drv->finishQuery(drv->currentStmtId);
+    PGresult *result = PQprepare(drv->connection, stmtName.constData(), stmtText.constData(), 0, 0);
 
     if (PQresultStatus(result) != PGRES_COMMAND_OK) {
         setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
@@ -648,6 +1556,23 @@ bool QPSQLResult::prepare(const QString &query)
 
     PQclear(result);
     d->preparedStmtId = stmtId;
+
+    // the parameter types decide how bound values are encoded
+    result = PQdescribePrepared(drv->connection, stmtName.constData());
+    if (PQresultStatus(result) == PGRES_COMMAND_OK) {
+        d->paramTypes.resize(PQnparams(result));
+        for (int i = 0; i < d->paramTypes.size(); ++i)
+            d->paramTypes[i] = PQparamtype(result, i);
+
+        // rows of forward-only queries are streamed; if the column types are known
+        // to be convertible, fetch them in binary format to avoid parsing text
+        if (isForwardOnly() && drv->canStream() && PQnfields(result) > 0) {
+            d->binaryResults = true;
+            for (int i = 0; i < PQnfields(result) && d->binaryResults; ++i)
+                d->binaryResults = qIsBinaryTransferable(PQftype(result, i), drv->connection);
+        }
+    }
+    PQclear(result);
     return true;
 }
 
@@ -659,16 +1584,105 @@ bool QPSQLResult::exec()
 
     cleanup();
 
-    QString stmt;
-    const QString params = qCreateParamString(boundValues(), driver());
-    if (params.isEmpty())
-        stmt = QString::fromLatin1("EXECUTE %1").arg(d->preparedStmtId);
-    else
-        stmt = QString::fromLatin1("EXECUTE %1 (%2)").arg(d->preparedStmtId).arg(params);
+    QPSQLParameters params;
+    d->bindParameters(boundValues(), &params);
+    return d->executePrepared(params);
+}
+
+bool QPSQLResult::execBatch(bool arrayBind)
+{
+    Q_D(QPSQLResult);
+#ifdef QT_PSQL_PIPELINE_MODE
+    const QVector<QVariant> columns = boundValues();
+    if (!d->preparedQueriesEnabled || d->preparedStmtId.isEmpty()
+        || columns.isEmpty() || columns.at(0).toList().isEmpty()) {
+        return QSqlResult::execBatch(arrayBind);
+    }
+
+    cleanup();
+    QPSQLDriverPrivate *drv = d->drv_d_func();
+    drv->finishQuery(drv->currentStmtId);
+    PGconn *connection = drv->connection;
+    if (!PQenterPipelineMode(connection))
+        return QSqlResult::execBatch(arrayBind);
+
+    QVector<QVariantList> lists;
+    lists.reserve(columns.size());
+    for (int j = 0; j < columns.size(); ++j)
+        lists.append(columns.at(j).toList());
+    const int rows = lists.at(0).size();
+    const QByteArray stmtName = d->preparedStmtId.toLatin1();
+
+    // All rows are sent as a single pipeline that ends with one sync, so the
+    // batch succeeds or fails as a whole. Only a window of statements is kept
+    // in flight so that neither side blocks on a full socket buffer.
+    const int window = 256;
+    QVector<QVariant> values(columns.size());
+    QPSQLParameters params;
+    PGresult *error = 0;
+    bool failed = false;
+    int sent = 0;
+    int received = 0;
+    bool synced = false;
+    while (!synced) {
+        for (; sent < rows && sent - received < window; ++sent) {
+            for (int j = 0; j < lists.size(); ++j)
+                values[j] = lists.at(j).value(sent);
+            d->bindParameters(values, &params);
+            if (!PQsendQueryPrepared(connection, stmtName.constData(), params.values.size(),
+                                     params.values.constData(), params.lengths.constData(),
+                                     params.formats.constData(), 0)) {
+                failed = true;
+                break;
+            }
+        }
+        if (sent == rows || failed) {
+            PQpipelineSync(connection);
+            synced = true;
+        } else {
+            PQsendFlushRequest(connection);
+        }
+        PQflush(connection);
 
-    d->result = d->drv_d_func()->exec(stmt);
+        for (; received < sent; ++received) {
+            PGresult *result = PQgetResult(connection);
+            if (!result) {
+                failed = true;
+                continue;
+            }
+            const ExecStatusType status = PQresultStatus(result);
+            if (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK) {
+                PQclear(d->result);
+                d->result = result;
+            } else if (!error) {
+                error = result;
+            } else {
+                PQclear(result);
+            }
+            // the results of each statement are terminated by a null result
+            PQgetResult(connection);
+        }
+    }
+    while (PGresult *result = PQgetResult(connection)) {
+        const bool isSync = PQresultStatus(result) == PGRES_PIPELINE_SYNC;
+        PQclear(result);
+        if (isSync)
+            break;
+    }
+    PQexitPipelineMode(connection);
+    drv->checkPendingNotifications();
 
+    if (error || failed) {
+        setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                                "Unable to execute batch"), QSqlError::StatementError, drv, error));
+        PQclear(error);
+        cleanup();
+        return false;
+    }
     return d->processResults();
+#else
+    return QSqlResult::execBatch(arrayBind);
+#endif
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -707,6 +1721,130 @@ void QPSQLDriverPrivate::detectBackslashEscape()
     }
 }
 
+/*
+   Appends \a val to \a buffer in the text format of COPY.
+ */
+static void qAppendCopyValue(QByteArray *buffer, const QVariant &val, bool isUtf8, bool hexBytea)
+{
+    if (val.isNull()) {
+        buffer->append("\\N");
+        return;
+    }
+
+    static const char hexDigits[] = "0123456789abcdef";
+    if (val.type() == QVariant::ByteArray) {
+        // the backslashes of the bytea input format are escaped for COPY
+        const QByteArray ba = val.toByteArray();
+        if (hexBytea) {
+            buffer->append("\\\\x");
+            for (int i = 0; i < ba.size(); ++i) {
+                const uchar c = ba.at(i);
+                buffer->append(hexDigits[c >> 4]);
+                buffer->append(hexDigits[c & 0xf]);
+            }
+        } else {
+            for (int i = 0; i < ba.size(); ++i) {
+                const uchar c = ba.at(i);
+                buffer->append("\\\\");
+                buffer->append(char('0' + (c >> 6)));
+                buffer->append(char('0' + ((c >> 3) & 7)));
+                buffer->append(char('0' + (c & 7)));
+            }
+        }
+        return;
+    }
+
+    const QByteArray text = qTextParameter(val, InvalidOid, isUtf8);
+    if (text.isNull()) {
+        buffer->append("\\N");
+        return;
+    }
+    for (int i = 0; i < text.size(); ++i) {
+        const char c = text.at(i);
+        switch (c) {
+        case '\\':
+            buffer->append("\\\\");
+            break;
+        case '\n':
+            buffer->append("\\n");
+            break;
+        case '\r':
+            buffer->append("\\r");
+            break;
+        case '\t':
+            buffer->append("\\t");
+            break;
+        default:
+            buffer->append(c);
+            break;
+        }
+    }
+}
+
+/*
+   Sends the rows to the server with COPY FROM STDIN, in chunks of about
+   64 KB. COPY is a single statement, so it either inserts all rows or none.
+ */
+bool QPSQLDriverPrivate::bulkInsert(const QString &tableName, const QSqlRecord &columns,
+                                    const QVector<QVariantList> &values)
+{
+    Q_Q(QPSQLDriver);
+    if (PQprotocolVersion(connection) < 3)
+        return QSqlDriverPrivate::bulkInsert(tableName, columns, values);
+
+    QString stmt = QLatin1String("COPY ") + tableName + QLatin1String(" (");
+    for (int i = 0; i < columns.count(); ++i) {
+        if (i > 0)
+            stmt += QLatin1String(", ");
+        const QString name = columns.fieldName(i);
+        stmt += q->isIdentifierEscaped(name, QSqlDriver::FieldName)
+                ? name : q->escapeIdentifier(name, QSqlDriver::FieldName);
+    }
+    stmt += QLatin1String(") FROM STDIN");
+
+    PGresult *result = exec(stmt);
+    if (PQresultStatus(result) != PGRES_COPY_IN) {
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLDriver",
+                        "Unable to copy rows"), QSqlError::StatementError, this, result));
+        PQclear(result);
+        return false;
+    }
+    PQclear(result);
+
+    enum { ChunkSize = 64 * 1024 };
+    const bool hexBytea = pro >= QPSQLDriver::Version9;
+    const int rows = values.first().size();
+    QByteArray buffer;
+    buffer.reserve(ChunkSize + 1024);
+    bool ok = true;
+    for (int row = 0; row < rows && ok; ++row) {
+        for (int column = 0; column < values.size(); ++column) {
+            if (column > 0)
+                buffer.append('\t');
+            qAppendCopyValue(&buffer, values.at(column).at(row), isUtf8, hexBytea);
+        }
+        buffer.append('\n');
+        if (buffer.size() >= ChunkSize || row == rows - 1) {
+            ok = PQputCopyData(connection, buffer.constData(), buffer.size()) == 1;
+            // keeps the capacity, as it has been reserved
+            buffer.resize(0);
+        }
+    }
+    ok = PQputCopyEnd(connection, ok ? 0 : "sending the rows failed") == 1 && ok;
+
+    result = PQgetResult(connection);
+    ok = ok && PQresultStatus(result) == PGRES_COMMAND_OK;
+    if (!ok) {
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLDriver",
+                        "Unable to copy rows"), QSqlError::StatementError, this, result));
+    }
+    PQclear(result);
+    while ((result = PQgetResult(connection)))
+        PQclear(result);
+    checkPendingNotifications();
+    return ok;
+}
+
 static QPSQLDriver::Protocol qMakePSQLVersion(int vMaj, int vMin)
 {
     switch (vMaj) {
@@ -745,7 +1883,11 @@ static QPSQLDriver::Protocol qMakePSQLVersion(int vMaj, int vMin)
     case 9:
         return QPSQLDriver::Version9;
         break;
+    case 10:
+        return QPSQLDriver::Version10;
     default:
+        if (vMaj > 10)
+            return QPSQLDriver::UnknownLaterVersion;
         break;
     }
     return QPSQLDriver::VersionUnknown;
@@ -826,6 +1968,7 @@ QPSQLDriver::QPSQLDriver(PGconn *conn, QObject *parent)
 QPSQLDriver::~QPSQLDriver()
 {
     Q_D(QPSQLDriver);
+    d->finishQuery(d->currentStmtId);
     if (d->connection)
         PQfinish(d->connection);
 }
@@ -850,6 +1993,11 @@ bool QPSQLDriver::hasFeature(DriverFeature f) const
     case PositionalPlaceholders:
         return d->pro >= QPSQLDriver::Version82;
     case BatchOperations:
+#ifdef QT_PSQL_PIPELINE_MODE
+        return d->pro >= QPSQLDriver::Version82;
+#else
+        return false;
+#endif
     case NamedPlaceholders:
     case SimpleLocking:
     case FinishQuery:
@@ -930,6 +2078,7 @@ void QPSQLDriver::close()
 {
     Q_D(QPSQLDriver);
     if (isOpen()) {
+        d->finishQuery(d->currentStmtId);
 
         d->seid.clear();
         if (d->sn) {
@@ -941,6 +2090,7 @@ void QPSQLDriver::close()
         if (d->connection)
             PQfinish(d->connection);
         d->connection = 0;
+        d->currentStmtId = QPSQLDriverPrivate::InvalidStatementId;
         setOpen(false);
         setOpenError(false);
     }
@@ -984,12 +2134,7 @@ bool QPSQLDriver::commitTransaction()
     // This hack is used to tell if the transaction has succeeded for the protocol versions of
     // PostgreSQL below. For 7.x and other protocol versions we are left in the dark.
     // This hack can dissapear once there is an API to query this sort of information.
-    if (d->pro == QPSQLDriver::Version8 ||
-        d->pro == QPSQLDriver::Version81 ||
-        d->pro == QPSQLDriver::Version82 ||
-        d->pro == QPSQLDriver::Version83 ||
-        d->pro == QPSQLDriver::Version84 ||
-        d->pro == QPSQLDriver::Version9) {
+    if (d->pro >= QPSQLDriver::Version8) {
         transaction_failed = qstrcmp(PQcmdStatus(res), "ROLLBACK") == 0;
     }
 
@@ -1106,6 +2251,8 @@ QSqlIndex QPSQLDriver::primaryIndex(const QString& tablename) const
     case QPSQLDriver::Version83:
     case QPSQLDriver::Version84:
     case QPSQLDriver::Version9:
+    case QPSQLDriver::Version10:
+    case QPSQLDriver::UnknownLaterVersion:
         stmt = QLatin1String("SELECT pg_attribute.attname, pg_attribute.atttypid::int, "
                 "pg_class.relname "
                 "FROM pg_attribute, pg_class "
@@ -1196,6 +2343,8 @@ QSqlRecord QPSQLDriver::record(const QString& tablename) const
     case QPSQLDriver::Version83:
     case QPSQLDriver::Version84:
     case QPSQLDriver::Version9:
+    case QPSQLDriver::Version10:
+    case QPSQLDriver::UnknownLaterVersion:
         stmt = QLatin1String("select pg_attribute.attname, pg_attribute.atttypid::int, "
                 "pg_attribute.attnotnull, pg_attribute.attlen, pg_attribute.atttypmod, "
                 "pg_attrdef.adsrc "
@@ -78,7 +78,9 @@ public:
         Version82 = 13,
         Version83 = 14,
         Version84 = 15,
-        Version9 = 16
+        Version9 = 16,
+        Version10 = 17,
+        UnknownLaterVersion = 100000
     };
 
     explicit QPSQLDriver(QObject *parent=0);
@@ -44,6 +44,7 @@
 #include <QtSql/private/qsqldriver_p.h>
 #include <qstringlist.h>
 #include <qvector.h>
+#include <qcache.h>
 #include <qdebug.h>
 
 #if defined Q_OS_WIN
@@ -101,6 +102,65 @@ static QSqlError qMakeError(sqlite3 *access, const QString &descr, QSqlError::Er
                      type, QString::number(errorCode));
 }
 
+/*
+    Binds \a value to the parameter \a index of \a stmt. Strings and blobs
+    are not copied, so \a value must not be destroyed before the statement
+    has been executed.
+*/
+static int qBindValue(sqlite3_stmt *stmt, int index, const QVariant &value)
+{
+    int res = SQLITE_OK;
+    if (value.isNull()) {
+        res = sqlite3_bind_null(stmt, index);
+    } else {
+        switch (value.type()) {
+        case QVariant::ByteArray: {
+            const QByteArray *ba = static_cast<const QByteArray*>(value.constData());
+            res = sqlite3_bind_blob(stmt, index, ba->constData(),
+                                    ba->size(), SQLITE_STATIC);
+            break; }
+        case QVariant::Int:
+        case QVariant::Bool:
+            res = sqlite3_bind_int(stmt, index, value.toInt());
+            break;
+        case QVariant::Double:
+            res = sqlite3_bind_double(stmt, index, value.toDouble());
+            break;
+        case QVariant::UInt:
+        case QVariant::LongLong:
+            res = sqlite3_bind_int64(stmt, index, value.toLongLong());
+            break;
+        case QVariant::DateTime: {
+            const QDateTime dateTime = value.toDateTime();
+            const QString str = dateTime.toString(QStringLiteral("yyyy-MM-ddThh:mm:ss.zzz"));
+            res = sqlite3_bind_text16(stmt, index, str.utf16(),
+                                      str.size() * sizeof(ushort), SQLITE_TRANSIENT);
+            break;
+        }
+        case QVariant::Time: {
+            const QTime time = value.toTime();
+            const QString str = time.toString(QStringLiteral("hh:mm:ss.zzz"));
+            res = sqlite3_bind_text16(stmt, index, str.utf16(),
+                                      str.size() * sizeof(ushort), SQLITE_TRANSIENT);
+            break;
+        }
+        case QVariant::String: {
+            // lifetime of string == lifetime of its qvariant
+            const QString *str = static_cast<const QString*>(value.constData());
+            res = sqlite3_bind_text16(stmt, index, str->utf16(),
+                                      (str->size()) * sizeof(QChar), SQLITE_STATIC);
+            break; }
+        default: {
+            QString str = value.toString();
+            // SQLITE_TRANSIENT makes sure that sqlite buffers the data
+            res = sqlite3_bind_text16(stmt, index, str.utf16(),
+                                      (str.size()) * sizeof(QChar), SQLITE_TRANSIENT);
+            break; }
+        }
+    }
+    return res;
+}
+
 class QSQLiteResultPrivate;
 
 class QSQLiteResult : public QSqlCachedResult
@@ -114,7 +174,7 @@ public:
     QVariant handle() const Q_DECL_OVERRIDE;
 
 protected:
-    bool gotoNext(QSqlCachedResult::ValueCache& row, int idx) Q_DECL_OVERRIDE;
+    bool gotoNextRow(QSqlColumnCache &columns, int row) Q_DECL_OVERRIDE;
     bool reset(const QString &query) Q_DECL_OVERRIDE;
     bool prepare(const QString &query) Q_DECL_OVERRIDE;
     bool exec() Q_DECL_OVERRIDE;
@@ -126,17 +186,100 @@ protected:
     void virtual_hook(int id, void *data) Q_DECL_OVERRIDE;
 };
 
+// a prepared statement that is not used by any result
+struct QSQLiteCachedStatement
+{
+    explicit QSQLiteCachedStatement(sqlite3_stmt *stmt) : stmt(stmt) {}
+    ~QSQLiteCachedStatement() { sqlite3_finalize(stmt); }
+
+    sqlite3_stmt *take()
+    {
+        sqlite3_stmt *s = stmt;
+        stmt = 0;
+        return s;
+    }
+
+    sqlite3_stmt *stmt;
+};
+
+enum { QSQLiteDefaultStatementCacheSize = 32 };
+
 class QSQLiteDriverPrivate : public QSqlDriverPrivate
 {
     Q_DECLARE_PUBLIC(QSQLiteDriver)
 
 public:
-    inline QSQLiteDriverPrivate() : QSqlDriverPrivate(), access(0) { dbmsType = QSqlDriver::SQLite; }
+    inline QSQLiteDriverPrivate() : QSqlDriverPrivate(), access(0)
+    {
+        dbmsType = QSqlDriver::SQLite;
+        statements.setMaxCost(QSQLiteDefaultStatementCacheSize);
+    }
+    bool bulkInsert(const QString &tableName, const QSqlRecord &columns,
+                    const QVector<QVariantList> &values) Q_DECL_OVERRIDE;
+
     sqlite3 *access;
     QList <QSQLiteResult *> results;
+    // statements of finished queries, keyed by their SQL text, so that
+    // executing the same query again does not have to compile it again
+    QCache<QString, QSQLiteCachedStatement> statements;
 };
 
 
+/*
+    Executes one prepared INSERT statement for every row, binding the values
+    directly instead of going through QSqlQuery. The rows are inserted in a
+    savepoint, which starts a transaction if there is none yet and nests in
+    the caller's transaction otherwise.
+*/
+bool QSQLiteDriverPrivate::bulkInsert(const QString &tableName, const QSqlRecord &columns,
+                                      const QVector<QVariantList> &values)
+{
+    Q_Q(QSQLiteDriver);
+    QSqlRecord rec = columns;
+    for (int i = 0; i < rec.count(); ++i)
+        rec.setGenerated(i, true);
+    const QString query = q->sqlStatement(QSqlDriver::InsertStatement, tableName, rec, true);
+
+    sqlite3_stmt *stmt = 0;
+    int res = sqlite3_prepare16_v2(access, query.constData(), (query.size() + 1) * sizeof(QChar),
+                                   &stmt, NULL);
+    if (res != SQLITE_OK) {
+        q->setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteDriver",
+                        "Unable to execute statement"), QSqlError::StatementError, res));
+        sqlite3_finalize(stmt);
+        return false;
+    }
+
+    res = sqlite3_exec(access, "SAVEPOINT qt_bulk_insert", NULL, NULL, NULL);
+    const int rows = values.first().size();
+    for (int row = 0; row < rows && res == SQLITE_OK; ++row) {
+        for (int column = 0; column < values.size() && res == SQLITE_OK; ++column)
+            res = qBindValue(stmt, column + 1, values.at(column).at(row));
+        if (res == SQLITE_OK) {
+            res = sqlite3_step(stmt);
+            if (res == SQLITE_DONE)
+                res = SQLITE_OK;
+        }
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    if (res != SQLITE_OK) {
+        q->setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteDriver",
+                        "Unable to insert rows"), QSqlError::StatementError, res));
+        sqlite3_exec(access, "ROLLBACK TO qt_bulk_insert", NULL, NULL, NULL);
+        sqlite3_exec(access, "RELEASE qt_bulk_insert", NULL, NULL, NULL);
+        return false;
+    }
+    res = sqlite3_exec(access, "RELEASE qt_bulk_insert", NULL, NULL, NULL);
+    if (res != SQLITE_OK) {
+        q->setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteDriver",
+                        "Unable to commit rows"), QSqlError::TransactionError, res));
+        return false;
+    }
+    return true;
+}
+
 class QSQLiteResultPrivate: public QSqlCachedResultPrivate
 {
     Q_DECLARE_PUBLIC(QSQLiteResult)
@@ -145,17 +288,19 @@ public:
     Q_DECLARE_SQLDRIVER_PRIVATE(QSQLiteDriver)
     QSQLiteResultPrivate(QSQLiteResult *q, const QSQLiteDriver *drv);
     void cleanup();
-    bool fetchNext(QSqlCachedResult::ValueCache &values, int idx, bool initialFetch);
+    bool fetchNext(QSqlColumnCache &columns, int row, bool initialFetch);
     // initializes the recordInfo and the cache
     void initColumns(bool emptyResultset);
     void finalize();
 
     sqlite3_stmt *stmt;
+    // the SQL text of stmt, empty if stmt must not be reused
+    QString stmtQuery;
 
     bool skippedStatus; // the status of the fetchNext() that's skipped
     bool skipRow; // skip the next fetchNext()?
     QSqlRecord rInf;
-    QVector<QVariant> firstRow;
+    QSqlColumnCache firstRow;
 };
 
 QSQLiteResultPrivate::QSQLiteResultPrivate(QSQLiteResult *q, const QSQLiteDriver *drv)
@@ -183,8 +328,16 @@ void QSQLiteResultPrivate::finalize()
     if (!stmt)
         return;
 
-    sqlite3_finalize(stmt);
+    QSQLiteDriverPrivate *drv = drv_d_func();
+    if (drv && !stmtQuery.isEmpty() && drv->statements.maxCost() > 0) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        drv->statements.insert(stmtQuery, new QSQLiteCachedStatement(stmt));
+    } else {
+        sqlite3_finalize(stmt);
+    }
     stmt = 0;
+    stmtQuery.clear();
 }
 
 void QSQLiteResultPrivate::initColumns(bool emptyResultset)
@@ -194,7 +347,7 @@ void QSQLiteResultPrivate::initColumns(bool emptyResultset)
     if (nCols <= 0)
         return;
 
-    q->init(nCols);
+    q->initColumns(nCols, QVariant::String);
 
     for (int i = 0; i < nCols; ++i) {
         QString colName = QString(reinterpret_cast<const QChar *>(
@@ -239,7 +392,7 @@ void QSQLiteResultPrivate::initColumns(bool emptyResultset)
     }
 }
 
-bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int idx, bool initialFetch)
+bool QSQLiteResultPrivate::fetchNext(QSqlColumnCache &columns, int row, bool initialFetch)
 {
     Q_Q(QSQLiteResult);
     int res;
@@ -249,15 +402,15 @@ bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int i
         // already fetched
         Q_ASSERT(!initialFetch);
         skipRow = false;
-        for(int i=0;i<firstRow.count();i++)
-            values[i]=firstRow[i];
+        if (row >= 0 && skippedStatus)
+            columns.copyRow(row, firstRow, 0);
         return skippedStatus;
     }
     skipRow = initialFetch;
 
     if(initialFetch) {
-        firstRow.clear();
-        firstRow.resize(sqlite3_column_count(stmt));
+        firstRow.init(sqlite3_column_count(stmt), QVariant::String);
+        firstRow.appendRow();
     }
 
     if (!stmt) {
@@ -274,40 +427,38 @@ bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int i
         if (rInf.isEmpty())
             // must be first call.
             initColumns(false);
-        if (idx < 0 && !initialFetch)
+        if (row < 0 && !initialFetch)
             return true;
         for (i = 0; i < rInf.count(); ++i) {
             switch (sqlite3_column_type(stmt, i)) {
             case SQLITE_BLOB:
-                values[i + idx] = QByteArray(static_cast<const char *>(
-                            sqlite3_column_blob(stmt, i)),
-                            sqlite3_column_bytes(stmt, i));
+                columns.setBytes(row, i, static_cast<const char *>(sqlite3_column_blob(stmt, i)),
+                                 sqlite3_column_bytes(stmt, i));
                 break;
             case SQLITE_INTEGER:
-                values[i + idx] = sqlite3_column_int64(stmt, i);
+                columns.setInteger(row, i, sqlite3_column_int64(stmt, i));
                 break;
             case SQLITE_FLOAT:
                 switch(q->numericalPrecisionPolicy()) {
                     case QSql::LowPrecisionInt32:
-                        values[i + idx] = sqlite3_column_int(stmt, i);
+                        columns.setValue(row, i, sqlite3_column_int(stmt, i));
                         break;
                     case QSql::LowPrecisionInt64:
-                        values[i + idx] = sqlite3_column_int64(stmt, i);
+                        columns.setValue(row, i, sqlite3_column_int64(stmt, i));
                         break;
                     case QSql::LowPrecisionDouble:
                     case QSql::HighPrecision:
                     default:
-                        values[i + idx] = sqlite3_column_double(stmt, i);
+                        columns.setDouble(row, i, sqlite3_column_double(stmt, i));
                         break;
                 };
                 break;
             case SQLITE_NULL:
-                values[i + idx] = QVariant(QVariant::String);
+                columns.setNull(row, i);
                 break;
             default:
-                values[i + idx] = QString(reinterpret_cast<const QChar *>(
-                            sqlite3_column_text16(stmt, i)),
-                            sqlite3_column_bytes16(stmt, i) / sizeof(QChar));
+                columns.setString(row, i, reinterpret_cast<const QChar *>(sqlite3_column_text16(stmt, i)),
+                                  sqlite3_column_bytes16(stmt, i) / sizeof(QChar));
                 break;
             }
         }
@@ -378,6 +529,13 @@ bool QSQLiteResult::prepare(const QString &query)
 
     setSelect(false);
 
+    if (QSQLiteCachedStatement *cached = d->drv_d_func()->statements.take(query)) {
+        d->stmt = cached->take();
+        d->stmtQuery = query;
+        delete cached;
+        return true;
+    }
+
     const void *pzTail = NULL;
 
 #if (SQLITE_VERSION_NUMBER >= 3003011)
@@ -399,6 +557,7 @@ bool QSQLiteResult::prepare(const QString &query)
         d->finalize();
         return false;
     }
+    d->stmtQuery = query;
     return true;
 }
 
@@ -423,57 +582,7 @@ bool QSQLiteResult::exec()
     int paramCount = sqlite3_bind_parameter_count(d->stmt);
     if (paramCount == values.count()) {
         for (int i = 0; i < paramCount; ++i) {
-            res = SQLITE_OK;
-            const QVariant value = values.at(i);
-
-            if (value.isNull()) {
-                res = sqlite3_bind_null(d->stmt, i + 1);
-            } else {
-                switch (value.type()) {
-                case QVariant::ByteArray: {
-                    const QByteArray *ba = static_cast<const QByteArray*>(value.constData());
-                    res = sqlite3_bind_blob(d->stmt, i + 1, ba->constData(),
-                                            ba->size(), SQLITE_STATIC);
-                    break; }
-                case QVariant::Int:
-                case QVariant::Bool:
-                    res = sqlite3_bind_int(d->stmt, i + 1, value.toInt());
-                    break;
-                case QVariant::Double:
-                    res = sqlite3_bind_double(d->stmt, i + 1, value.toDouble());
-                    break;
-                case QVariant::UInt:
-                case QVariant::LongLong:
-                    res = sqlite3_bind_int64(d->stmt, i + 1, value.toLongLong());
-                    break;
-                case QVariant::DateTime: {
-                    const QDateTime dateTime = value.toDateTime();
-                    const QString str = dateTime.toString(QStringLiteral("yyyy-MM-ddThh:mm:ss.zzz"));
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
-                                              str.size() * sizeof(ushort), SQLITE_TRANSIENT);
-                    break;
-                }
-                case QVariant::Time: {
-                    const QTime time = value.toTime();
-                    const QString str = time.toString(QStringLiteral("hh:mm:ss.zzz"));
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
-                                              str.size() * sizeof(ushort), SQLITE_TRANSIENT);
-                    break;
-                }
-                case QVariant::String: {
-                    // lifetime of string == lifetime of its qvariant
-                    const QString *str = static_cast<const QString*>(value.constData());
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str->utf16(),
-                                              (str->size()) * sizeof(QChar), SQLITE_STATIC);
-                    break; }
-                default: {
-                    QString str = value.toString();
-                    // SQLITE_TRANSIENT makes sure that sqlite buffers the data
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
-                                              (str.size()) * sizeof(QChar), SQLITE_TRANSIENT);
-                    break; }
-                }
-            }
+            res = qBindValue(d->stmt, i + 1, values.at(i));
             if (res != SQLITE_OK) {
                 setLastError(qMakeError(d->drv_d_func()->access, QCoreApplication::translate("QSQLiteResult",
                              "Unable to bind parameters"), QSqlError::StatementError, res));
@@ -497,10 +606,10 @@ bool QSQLiteResult::exec()
     return true;
 }
 
-bool QSQLiteResult::gotoNext(QSqlCachedResult::ValueCache& row, int idx)
+bool QSQLiteResult::gotoNextRow(QSqlColumnCache &columns, int row)
 {
     Q_D(QSQLiteResult);
-    return d->fetchNext(row, idx, false);
+    return d->fetchNext(columns, row, false);
 }
 
 int QSQLiteResult::size()
@@ -603,9 +712,11 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
 
 
     int timeOut = 5000;
+    int statementCacheSize = QSQLiteDefaultStatementCacheSize;
     bool sharedCache = false;
     bool openReadOnlyOption = false;
     bool openUriOption = false;
+    QStringList pragmas;
 
     const QStringList opts = QString(conOpts).remove(QLatin1Char(' ')).split(QLatin1Char(';'));
     foreach (const QString &option, opts) {
@@ -620,6 +731,28 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
             openUriOption = true;
         } else if (option == QLatin1String("QSQLITE_ENABLE_SHARED_CACHE")) {
             sharedCache = true;
+        } else if (option.startsWith(QLatin1String("QSQLITE_STATEMENT_CACHE_SIZE="))) {
+            bool ok;
+            const int size = option.midRef(29).toInt(&ok);
+            if (ok && size >= 0)
+                statementCacheSize = size;
+        } else if (option.startsWith(QLatin1String("QSQLITE_JOURNAL_MODE="))) {
+            static const char *const modes[] = { "DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF" };
+            const QString mode = option.mid(21).toUpper();
+            for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); ++i) {
+                if (mode == QLatin1String(modes[i]))
+                    pragmas.append(QLatin1String("PRAGMA journal_mode=") + mode);
+            }
+        } else if (option.startsWith(QLatin1String("QSQLITE_MMAP_SIZE="))) {
+            bool ok;
+            const qint64 size = option.midRef(18).toLongLong(&ok);
+            if (ok && size >= 0)
+                pragmas.append(QLatin1String("PRAGMA mmap_size=") + QString::number(size));
+        } else if (option.startsWith(QLatin1String("QSQLITE_CACHE_SIZE="))) {
+            bool ok;
+            const int size = option.midRef(19).toInt(&ok);
+            if (ok)
+                pragmas.append(QLatin1String("PRAGMA cache_size=") + QString::number(size));
         }
     }
 
@@ -631,6 +764,13 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
 
     if (sqlite3_open_v2(db.toUtf8().constData(), &d->access, openMode, NULL) == SQLITE_OK) {
         sqlite3_busy_timeout(d->access, timeOut);
+        d->statements.setMaxCost(statementCacheSize);
+        foreach (const QString &pragma, pragmas) {
+            if (sqlite3_exec(d->access, pragma.toUtf8().constData(), 0, 0, 0) != SQLITE_OK) {
+                qWarning("QSQLiteDriver::open: %s failed: %s", pragma.toUtf8().constData(),
+                         sqlite3_errmsg(d->access));
+            }
+        }
         setOpen(true);
         setOpenError(false);
         return true;
@@ -654,6 +794,7 @@ void QSQLiteDriver::close()
         foreach (QSQLiteResult *result, d->results) {
             result->d_func()->finalize();
         }
+        d->statements.clear();
 
         if (sqlite3_close(d->access) != SQLITE_OK)
             setLastError(qMakeError(d->access, tr("Error closing database"),
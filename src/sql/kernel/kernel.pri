@@ -1,6 +1,7 @@
 HEADERS +=      kernel/qsql.h \
                 kernel/qsqlquery.h \
                 kernel/qsqldatabase.h \
+                kernel/qsqlconnectionpool.h \
                 kernel/qsqlfield.h \
                 kernel/qsqlrecord.h \
                 kernel/qsqldriver.h \
@@ -11,10 +12,12 @@ HEADERS +=      kernel/qsql.h \
                 kernel/qsqlresult.h \
                 kernel/qsqlresult_p.h \
                 kernel/qsqlcachedresult_p.h \
+                kernel/qsqlcolumncache_p.h \
                 kernel/qsqlindex.h
 
 SOURCES +=      kernel/qsqlquery.cpp \
                 kernel/qsqldatabase.cpp \
+                kernel/qsqlconnectionpool.cpp \
                 kernel/qsqlfield.cpp \
                 kernel/qsqlrecord.cpp \
                 kernel/qsqldriver.cpp \
@@ -22,5 +25,6 @@ SOURCES +=      kernel/qsqlquery.cpp \
                 kernel/qsqlerror.cpp \
                 kernel/qsqlresult.cpp \
                 kernel/qsqlindex.cpp \
-                kernel/qsqlcachedresult.cpp
+                kernel/qsqlcachedresult.cpp \
+                kernel/qsqlcolumncache.cpp
 
@@ -50,6 +50,13 @@ QT_BEGIN_NAMESPACE
    will give you an index where you can start filling in your data. Special
    case: If the user actually wants a forward-only query, idx will be -1
    to indicate that we are not interested in the actual values.
+
+   Drivers that know the types of their columns can call initColumns()
+   instead of init() and reimplement gotoNextRow(). The rows are then kept
+   in a QSqlColumnCache, which stores integers, doubles, strings and byte
+   arrays in typed per-column arrays and only creates the QVariant when
+   data() is called. gotoNextRow() gets the row to fill in, or -1 if the
+   values are not needed.
 */
 
 static const uint initial_cache_size = 128;
@@ -58,13 +65,16 @@ QSqlCachedResultPrivate::QSqlCachedResultPrivate(QSqlCachedResult *q, const QSql
     : QSqlResultPrivate(q, drv),
       rowCacheEnd(0),
       colCount(0),
-      atEnd(false)
+      atEnd(false),
+      columnar(false)
 {
 }
 
 void QSqlCachedResultPrivate::cleanup()
 {
     cache.clear();
+    columns.reset();
+    columnar = false;
     atEnd = false;
     colCount = 0;
     rowCacheEnd = 0;
@@ -84,8 +94,27 @@ void QSqlCachedResultPrivate::init(int count, bool fo)
     }
 }
 
+void QSqlCachedResultPrivate::initColumns(int count, bool fo, QVariant::Type nullType)
+{
+    Q_ASSERT(count);
+    cleanup();
+    forwardOnly = fo;
+    colCount = count;
+    columnar = true;
+    columns.init(count, nullType);
+    if (fo)
+        rowCacheEnd = count;
+}
+
 int QSqlCachedResultPrivate::nextIndex()
 {
+    if (columnar) {
+        if (forwardOnly)
+            columns.clear();
+        else
+            rowCacheEnd += colCount;
+        return columns.appendRow();
+    }
     if (forwardOnly)
         return 0;
     int newIdx = rowCacheEnd;
@@ -108,6 +137,8 @@ void QSqlCachedResultPrivate::revertLast()
     if (forwardOnly)
         return;
     rowCacheEnd -= colCount;
+    if (columnar)
+        columns.removeLastRow();
 }
 
 inline int QSqlCachedResultPrivate::cacheCount() const
@@ -130,6 +161,31 @@ void QSqlCachedResult::init(int colCount)
     d->init(colCount, isForwardOnly());
 }
 
+/*
+    Like init(), but keeps the rows in a QSqlColumnCache, which is filled by
+    gotoNextRow() instead of gotoNext(). Null values are reported as
+    QVariants of type \a nullType.
+*/
+void QSqlCachedResult::initColumns(int colCount, QVariant::Type nullType)
+{
+    Q_D(QSqlCachedResult);
+    d->initColumns(colCount, isForwardOnly(), nullType);
+}
+
+bool QSqlCachedResult::gotoNext(ValueCache &values, int index)
+{
+    Q_UNUSED(values);
+    Q_UNUSED(index);
+    return false;
+}
+
+bool QSqlCachedResult::gotoNextRow(QSqlColumnCache &columns, int row)
+{
+    Q_UNUSED(columns);
+    Q_UNUSED(row);
+    return false;
+}
+
 bool QSqlCachedResult::fetch(int i)
 {
     Q_D(QSqlCachedResult);
@@ -142,11 +198,11 @@ bool QSqlCachedResult::fetch(int i)
         if (at() > i || at() == QSql::AfterLastRow)
             return false;
         while(at() < i - 1) {
-            if (!gotoNext(d->cache, -1))
+            if (!fetchRow(-1))
                 return false;
             setAt(at() + 1);
         }
-        if (!gotoNext(d->cache, 0))
+        if (!fetchRow(d->nextIndex()))
             return false;
         setAt(at() + 1);
         return true;
@@ -225,6 +281,8 @@ QVariant QSqlCachedResult::data(int i)
     if (i >= d->colCount || i < 0 || at() < 0 || idx >= d->rowCacheEnd)
         return QVariant();
 
+    if (d->columnar)
+        return d->columns.value(d->forwardOnly ? 0 : at(), i);
     return d->cache.at(idx);
 }
 
@@ -235,6 +293,8 @@ bool QSqlCachedResult::isNull(int i)
     if (i >= d->colCount || i < 0 || at() < 0 || idx >= d->rowCacheEnd)
         return true;
 
+    if (d->columnar)
+        return d->columns.isNull(d->forwardOnly ? 0 : at(), i);
     return d->cache.at(idx).isNull();
 }
 
@@ -251,6 +311,7 @@ void QSqlCachedResult::clearValues()
     Q_D(QSqlCachedResult);
     setAt(QSql::BeforeFirstRow);
     d->rowCacheEnd = 0;
+    d->columns.clear();
     d->atEnd = false;
 }
 
@@ -260,12 +321,12 @@ bool QSqlCachedResult::cacheNext()
     if (d->atEnd)
         return false;
 
-    if(isForwardOnly()) {
+    if (isForwardOnly() && !d->columnar) {
         d->cache.clear();
         d->cache.resize(d->colCount);
     }
 
-    if (!gotoNext(d->cache, d->nextIndex())) {
+    if (!fetchRow(d->nextIndex())) {
         d->revertLast();
         d->atEnd = true;
         return false;
@@ -274,6 +335,14 @@ bool QSqlCachedResult::cacheNext()
     return true;
 }
 
+bool QSqlCachedResult::fetchRow(int index)
+{
+    Q_D(QSqlCachedResult);
+    if (d->columnar)
+        return gotoNextRow(d->columns, index);
+    return gotoNext(d->cache, index);
+}
+
 int QSqlCachedResult::colCount() const
 {
     Q_D(const QSqlCachedResult);
@@ -47,6 +47,7 @@
 
 #include "QtSql/qsqlresult.h"
 #include "QtSql/private/qsqlresult_p.h"
+#include "QtSql/private/qsqlcolumncache_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -66,10 +67,12 @@ protected:
     QSqlCachedResult(QSqlCachedResultPrivate &d);
 
     void init(int colCount);
+    void initColumns(int colCount, QVariant::Type nullType = QVariant::Invalid);
     void cleanup();
     void clearValues();
 
-    virtual bool gotoNext(ValueCache &values, int index) = 0;
+    virtual bool gotoNext(ValueCache &values, int index);
+    virtual bool gotoNextRow(QSqlColumnCache &columns, int row);
 
     QVariant data(int i) Q_DECL_OVERRIDE;
     bool isNull(int i) Q_DECL_OVERRIDE;
@@ -87,6 +90,7 @@ protected:
     void setNumericalPrecisionPolicy(QSql::NumericalPrecisionPolicy policy) Q_DECL_OVERRIDE;
 private:
     bool cacheNext();
+    bool fetchRow(int index);
 };
 
 class Q_SQL_EXPORT QSqlCachedResultPrivate: public QSqlResultPrivate
@@ -98,14 +102,17 @@ public:
     bool canSeek(int i) const;
     inline int cacheCount() const;
     void init(int count, bool fo);
+    void initColumns(int count, bool fo, QVariant::Type nullType);
     void cleanup();
     int nextIndex();
     void revertLast();
 
     QSqlCachedResult::ValueCache cache;
+    QSqlColumnCache columns;
     int rowCacheEnd;
     int colCount;
     bool atEnd;
+    bool columnar;
 };
 
 QT_END_NAMESPACE
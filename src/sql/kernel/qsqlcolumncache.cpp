@@ -0,0 +1,487 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "private/qsqlcolumncache_p.h"
+
+#include <qstring.h>
+#include <qbytearray.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+   QSqlColumnCache stores the rows fetched by a QSqlCachedResult column by
+   column instead of as one QVariant per cell. Integers and doubles are kept
+   in contiguous arrays, the characters of string and the bytes of blob
+   columns are appended to one arena per column, and nulls are kept in a bit
+   vector. QVariants are only created when a value is asked for.
+
+   A column adopts the storage matching the type of its first non-null value
+   unless setColumnType() declared it up front. If a later value does not
+   fit, the column falls back to storing QVariants, so values always come
+   back with the type they were stored with.
+
+   Strings and byte arrays can only be written to the last row; all other
+   values can be written to any row. Newly appended rows are all null.
+*/
+
+// QVector::resize() gives memory back when shrinking a lot, which would make
+// every forward-only fetch reallocate
+template <typename T>
+static inline void truncate(QVector<T> &vector, int size)
+{
+    vector.erase(vector.begin() + size, vector.end());
+}
+
+QSqlColumnCache::QSqlColumnCache()
+    : nullType(QVariant::Invalid),
+      rows(0)
+{
+}
+
+void QSqlColumnCache::init(int columnCount, QVariant::Type type)
+{
+    reset();
+    nullType = type;
+    columns.resize(columnCount);
+}
+
+/*
+    Declares the type of \a column. Must be called before the first row is
+    appended. Integral types share the integer storage and are converted back
+    to \a type when the value is read.
+*/
+void QSqlColumnCache::setColumnType(int column, QVariant::Type type)
+{
+    Q_ASSERT(rows == 0);
+    Column &c = columns[column];
+    c.storage = storageForType(type);
+    c.type = type;
+}
+
+/*
+    Removes all columns and rows.
+*/
+void QSqlColumnCache::reset()
+{
+    columns.clear();
+    rows = 0;
+}
+
+/*
+    Removes all rows, but keeps the columns with their types and the
+    allocated memory, so the cache can be refilled cheaply.
+*/
+void QSqlColumnCache::clear()
+{
+    for (int i = 0; i < columns.size(); ++i) {
+        Column &c = columns[i];
+        truncate(c.nulls, 0);
+        switch (c.storage) {
+        case NoStorage:
+            break;
+        case IntegerStorage:
+            truncate(c.integers, 0);
+            break;
+        case DoubleStorage:
+            truncate(c.doubles, 0);
+            break;
+        case StringStorage:
+            truncate(c.ends, 0);
+            truncate(c.chars, 0);
+            break;
+        case ByteArrayStorage:
+            truncate(c.ends, 0);
+            truncate(c.bytes, 0);
+            break;
+        case VariantStorage:
+            truncate(c.variants, 0);
+            break;
+        }
+    }
+    rows = 0;
+}
+
+/*
+    Appends a row with all values set to null and returns its index.
+*/
+int QSqlColumnCache::appendRow()
+{
+    const int row = rows++;
+    const bool newWord = (row & 31) == 0;
+    for (int i = 0; i < columns.size(); ++i) {
+        Column &c = columns[i];
+        if (newWord)
+            c.nulls.append(1u);
+        else
+            c.nulls[row >> 5] |= 1u << (row & 31);
+        switch (c.storage) {
+        case NoStorage:
+            break;
+        case IntegerStorage:
+            c.integers.append(0);
+            break;
+        case DoubleStorage:
+            c.doubles.append(0.0);
+            break;
+        case StringStorage:
+            c.ends.append(c.chars.size());
+            break;
+        case ByteArrayStorage:
+            c.ends.append(c.bytes.size());
+            break;
+        case VariantStorage:
+            c.variants.append(QVariant(nullType));
+            break;
+        }
+    }
+    return row;
+}
+
+void QSqlColumnCache::removeLastRow()
+{
+    Q_ASSERT(rows > 0);
+    --rows;
+    for (int i = 0; i < columns.size(); ++i) {
+        Column &c = columns[i];
+        truncate(c.nulls, (rows + 31) >> 5);
+        switch (c.storage) {
+        case NoStorage:
+            break;
+        case IntegerStorage:
+            truncate(c.integers, rows);
+            break;
+        case DoubleStorage:
+            truncate(c.doubles, rows);
+            break;
+        case StringStorage:
+            truncate(c.ends, rows);
+            truncate(c.chars, dataBegin(c, rows));
+            break;
+        case ByteArrayStorage:
+            truncate(c.ends, rows);
+            truncate(c.bytes, dataBegin(c, rows));
+            break;
+        case VariantStorage:
+            truncate(c.variants, rows);
+            break;
+        }
+    }
+}
+
+void QSqlColumnCache::setNull(int row, int column)
+{
+    Q_ASSERT(row >= 0 && row < rows);
+    Column &c = columns[column];
+    setNullBit(c, row, true);
+    switch (c.storage) {
+    case StringStorage:
+        Q_ASSERT(row == rows - 1);
+        truncate(c.chars, dataBegin(c, row));
+        c.ends[row] = c.chars.size();
+        break;
+    case ByteArrayStorage:
+        Q_ASSERT(row == rows - 1);
+        truncate(c.bytes, dataBegin(c, row));
+        c.ends[row] = c.bytes.size();
+        break;
+    case VariantStorage:
+        c.variants[row] = QVariant(nullType);
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+    Stores an integral value. Columns without a declared type report such
+    values as qlonglong.
+*/
+void QSqlColumnCache::setInteger(int row, int column, qint64 value)
+{
+    Q_ASSERT(row >= 0 && row < rows);
+    Column &c = columns[column];
+    if (c.storage == NoStorage)
+        setStorage(c, IntegerStorage, QVariant::LongLong);
+    if (c.storage == IntegerStorage) {
+        c.integers[row] = value;
+        setNullBit(c, row, false);
+    } else {
+        setVariant(column, row, QVariant(qlonglong(value)));
+    }
+}
+
+void QSqlColumnCache::setDouble(int row, int column, double value)
+{
+    Q_ASSERT(row >= 0 && row < rows);
+    Column &c = columns[column];
+    if (c.storage == NoStorage)
+        setStorage(c, DoubleStorage, QVariant::Double);
+    if (c.storage == DoubleStorage) {
+        c.doubles[row] = value;
+        setNullBit(c, row, false);
+    } else {
+        setVariant(column, row, QVariant(value));
+    }
+}
+
+void QSqlColumnCache::setString(int row, int column, const QChar *unicode, int size)
+{
+    Q_ASSERT(row >= 0 && row < rows);
+    Column &c = columns[column];
+    if (c.storage == NoStorage && unicode)
+        setStorage(c, StringStorage, QVariant::String);
+    if (c.storage == StringStorage && unicode) {
+        Q_ASSERT(row == rows - 1);
+        const int begin = dataBegin(c, row);
+        c.chars.resize(begin + size);
+        memcpy(c.chars.data() + begin, unicode, size * sizeof(QChar));
+        c.ends[row] = begin + size;
+        setNullBit(c, row, false);
+    } else {
+        // a null QString has to keep its type, so it can't be stored as null
+        setVariant(column, row, QVariant(QString(unicode, size)));
+    }
+}
+
+void QSqlColumnCache::setBytes(int row, int column, const char *data, int size)
+{
+    Q_ASSERT(row >= 0 && row < rows);
+    Column &c = columns[column];
+    if (c.storage == NoStorage && data)
+        setStorage(c, ByteArrayStorage, QVariant::ByteArray);
+    if (c.storage == ByteArrayStorage && data) {
+        Q_ASSERT(row == rows - 1);
+        const int begin = dataBegin(c, row);
+        c.bytes.resize(begin + size);
+        memcpy(c.bytes.data() + begin, data, size);
+        c.ends[row] = begin + size;
+        setNullBit(c, row, false);
+    } else {
+        setVariant(column, row, QVariant(QByteArray(data, size)));
+    }
+}
+
+/*
+    Stores \a value, using the typed storage of the column if the value fits
+    into it.
+*/
+void QSqlColumnCache::setValue(int row, int column, const QVariant &value)
+{
+    Q_ASSERT(row >= 0 && row < rows);
+    Column &c = columns[column];
+    const QVariant::Type type = value.type();
+    if (value.isNull()) {
+        if (type == nullType)
+            setNull(row, column);
+        else
+            setVariant(column, row, value);
+        return;
+    }
+
+    const Storage storage = storageForType(type);
+    if (c.storage == NoStorage && storage != VariantStorage)
+        setStorage(c, storage, type);
+    if (c.storage != storage || c.type != type) {
+        setVariant(column, row, value);
+        return;
+    }
+
+    switch (storage) {
+    case IntegerStorage:
+        c.integers[row] = type == QVariant::ULongLong ? qint64(value.toULongLong()) : value.toLongLong();
+        setNullBit(c, row, false);
+        break;
+    case DoubleStorage:
+        c.doubles[row] = value.toDouble();
+        setNullBit(c, row, false);
+        break;
+    case StringStorage: {
+        const QString str = value.toString();
+        setString(row, column, str.unicode(), str.size());
+        break;
+    }
+    case ByteArrayStorage: {
+        const QByteArray ba = value.toByteArray();
+        setBytes(row, column, ba.constData(), ba.size());
+        break;
+    }
+    default:
+        setVariant(column, row, value);
+        break;
+    }
+}
+
+/*
+    Copies row \a otherRow of \a other into \a row. Both caches must have
+    the same number of columns.
+*/
+void QSqlColumnCache::copyRow(int row, const QSqlColumnCache &other, int otherRow)
+{
+    Q_ASSERT(other.columnCount() == columnCount());
+    for (int i = 0; i < columns.size(); ++i)
+        setValue(row, i, other.value(otherRow, i));
+}
+
+QVariant QSqlColumnCache::value(int row, int column) const
+{
+    Q_ASSERT(row >= 0 && row < rows);
+    const Column &c = columns.at(column);
+    if (c.storage == VariantStorage)
+        return c.variants.at(row);
+    if (testNull(c, row))
+        return QVariant(nullType);
+
+    switch (c.storage) {
+    case IntegerStorage: {
+        const qint64 v = c.integers.at(row);
+        switch (c.type) {
+        case QVariant::Bool:
+            return QVariant(v != 0);
+        case QVariant::Int:
+            return QVariant(int(v));
+        case QVariant::UInt:
+            return QVariant(uint(v));
+        case QVariant::ULongLong:
+            return QVariant(qulonglong(v));
+        default:
+            return QVariant(qlonglong(v));
+        }
+    }
+    case DoubleStorage:
+        return QVariant(c.doubles.at(row));
+    case StringStorage: {
+        const int begin = dataBegin(c, row);
+        return QVariant(QString(reinterpret_cast<const QChar *>(c.chars.constData()) + begin,
+                                c.ends.at(row) - begin));
+    }
+    case ByteArrayStorage: {
+        const int begin = dataBegin(c, row);
+        return QVariant(QByteArray(c.bytes.constData() + begin, c.ends.at(row) - begin));
+    }
+    default:
+        Q_UNREACHABLE();
+        return QVariant();
+    }
+}
+
+bool QSqlColumnCache::isNull(int row, int column) const
+{
+    Q_ASSERT(row >= 0 && row < rows);
+    const Column &c = columns.at(column);
+    if (c.storage == VariantStorage)
+        return c.variants.at(row).isNull();
+    return testNull(c, row);
+}
+
+QSqlColumnCache::Storage QSqlColumnCache::storageForType(QVariant::Type type)
+{
+    switch (type) {
+    case QVariant::Bool:
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+        return IntegerStorage;
+    case QVariant::Double:
+        return DoubleStorage;
+    case QVariant::String:
+        return StringStorage;
+    case QVariant::ByteArray:
+        return ByteArrayStorage;
+    default:
+        return VariantStorage;
+    }
+}
+
+/*
+    Switches a column that so far only holds nulls to \a storage.
+*/
+void QSqlColumnCache::setStorage(Column &c, Storage storage, QVariant::Type type)
+{
+    Q_ASSERT(c.storage == NoStorage);
+    c.storage = storage;
+    c.type = type;
+    switch (storage) {
+    case IntegerStorage:
+        c.integers.fill(0, rows);
+        break;
+    case DoubleStorage:
+        c.doubles.fill(0.0, rows);
+        break;
+    case StringStorage:
+    case ByteArrayStorage:
+        c.ends.fill(0, rows);
+        break;
+    case VariantStorage:
+        c.variants.fill(QVariant(nullType), rows);
+        break;
+    case NoStorage:
+        break;
+    }
+}
+
+/*
+    Moves all values of a column into QVariants, for types the typed storage
+    can't represent.
+*/
+void QSqlColumnCache::convertToVariants(int column)
+{
+    if (columns.at(column).storage == VariantStorage)
+        return;
+
+    QVector<QVariant> variants;
+    variants.reserve(rows);
+    for (int row = 0; row < rows; ++row)
+        variants.append(value(row, column));
+
+    Column &c = columns[column];
+    c.integers = QVector<qint64>();
+    c.doubles = QVector<double>();
+    c.ends = QVector<int>();
+    c.chars = QVector<ushort>();
+    c.bytes = QVector<char>();
+    c.variants.swap(variants);
+    c.storage = VariantStorage;
+    c.type = QVariant::Invalid;
+}
+
+void QSqlColumnCache::setVariant(int column, int row, const QVariant &value)
+{
+    convertToVariants(column);
+    Column &c = columns[column];
+    c.variants[row] = value;
+    setNullBit(c, row, value.isNull());
+}
+
+QT_END_NAMESPACE
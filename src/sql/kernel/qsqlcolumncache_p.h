@@ -0,0 +1,132 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSQLCOLUMNCACHE_P_H
+#define QSQLCOLUMNCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtSql/qsql.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_SQL_EXPORT QSqlColumnCache
+{
+public:
+    QSqlColumnCache();
+
+    void init(int columnCount, QVariant::Type nullType = QVariant::Invalid);
+    void setColumnType(int column, QVariant::Type type);
+    void reset();
+    void clear();
+
+    int columnCount() const { return columns.size(); }
+    int rowCount() const { return rows; }
+
+    int appendRow();
+    void removeLastRow();
+
+    void setNull(int row, int column);
+    void setInteger(int row, int column, qint64 value);
+    void setDouble(int row, int column, double value);
+    void setString(int row, int column, const QChar *unicode, int size);
+    void setBytes(int row, int column, const char *data, int size);
+    void setValue(int row, int column, const QVariant &value);
+    void copyRow(int row, const QSqlColumnCache &other, int otherRow);
+
+    QVariant value(int row, int column) const;
+    bool isNull(int row, int column) const;
+
+private:
+    enum Storage {
+        NoStorage,          // only nulls so far, the type is decided by the first value
+        IntegerStorage,
+        DoubleStorage,
+        StringStorage,
+        ByteArrayStorage,
+        VariantStorage      // fallback for other types and columns with mixed types
+    };
+
+    struct Column
+    {
+        Column() : storage(NoStorage), type(QVariant::Invalid) {}
+
+        Storage storage;
+        QVariant::Type type;
+        QVector<quint32> nulls;
+        QVector<qint64> integers;
+        QVector<double> doubles;
+        // strings and byte arrays of all rows are stored back to back
+        QVector<int> ends;
+        QVector<ushort> chars;
+        QVector<char> bytes;
+        QVector<QVariant> variants;
+    };
+
+    static Storage storageForType(QVariant::Type type);
+    void setStorage(Column &c, Storage storage, QVariant::Type type);
+    void convertToVariants(int column);
+    void setVariant(int column, int row, const QVariant &value);
+    int dataBegin(const Column &c, int row) const { return row ? c.ends.at(row - 1) : 0; }
+
+    static bool testNull(const Column &c, int row)
+    { return c.nulls.at(row >> 5) & (1u << (row & 31)); }
+    static void setNullBit(Column &c, int row, bool null)
+    {
+        quint32 &word = c.nulls[row >> 5];
+        if (null)
+            word |= 1u << (row & 31);
+        else
+            word &= ~(1u << (row & 31));
+    }
+
+    QVector<Column> columns;
+    QVariant::Type nullType;
+    int rows;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSQLCOLUMNCACHE_P_H
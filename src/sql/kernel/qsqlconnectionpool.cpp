@@ -0,0 +1,585 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsqlconnectionpool.h"
+
+#include "qsqldriver.h"
+#include "qsqlerror.h"
+#include "qsqlquery.h"
+#include "qdebug.h"
+#include "qelapsedtimer.h"
+#include "qhash.h"
+#include "qmutex.h"
+#include "qthread.h"
+#include "qvector.h"
+#include "qwaitcondition.h"
+
+QT_BEGIN_NAMESPACE
+
+struct QSqlIdleConnection
+{
+    QSqlDatabase db;
+    qint64 since;
+};
+Q_DECLARE_TYPEINFO(QSqlIdleConnection, Q_MOVABLE_TYPE);
+
+struct QSqlCheckedOutConnection
+{
+    QSqlDatabase db;
+    int count;
+};
+
+class QSqlConnectionPoolPrivate
+{
+public:
+    QSqlConnectionPoolPrivate(const QString &name)
+        : connectionName(name),
+          minimumSize(0),
+          maximumSize(qMax(1, QThread::idealThreadCount())),
+          idleTimeout(60000),
+          size(0),
+          serial(0),
+          acquires(0),
+          hits(0),
+          timeouts(0),
+          totalWait(0),
+          maximumWait(0)
+    {
+        clock.start();
+    }
+
+    QSqlDatabase open();
+    static bool validate(const QSqlDatabase &db, const QString &validationQuery);
+    void takeExpired(QVector<QSqlDatabase> *expired);
+    static void close(QVector<QSqlDatabase> *connections);
+
+    mutable QMutex mutex;
+    QWaitCondition released;
+    const QString connectionName;
+    int minimumSize;
+    int maximumSize;
+    int idleTimeout;
+    QString validationQuery;
+
+    // open connections, including the ones that are being opened
+    int size;
+    int serial;
+    // the most recently used connection is at the back
+    QVector<QSqlIdleConnection> idle;
+    QHash<QThread *, QSqlCheckedOutConnection> checkedOut;
+    QElapsedTimer clock;
+
+    int acquires;
+    int hits;
+    int timeouts;
+    qint64 totalWait;
+    qint64 maximumWait;
+};
+
+/*
+    Opens a new connection with the settings of the template connection.
+    Called without holding the mutex, as opening can take long.
+*/
+QSqlDatabase QSqlConnectionPoolPrivate::open()
+{
+    QString name;
+    {
+        QMutexLocker locker(&mutex);
+        name = QString::fromLatin1("qt_sql_pool_%1_%2").arg(quintptr(this), 0, 16).arg(++serial);
+    }
+
+    QSqlDatabase db = QSqlDatabase::cloneDatabase(QSqlDatabase::database(connectionName, false), name);
+    if (!db.open()) {
+        qWarning("QSqlConnectionPool::acquire: unable to open a connection to '%s': %s",
+                 connectionName.toLocal8Bit().constData(),
+                 db.lastError().text().toLocal8Bit().constData());
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(name);
+    }
+    return db;
+}
+
+/*
+    Checks that the idle connection \a db still works by running
+    \a validationQuery on it. Called without holding the mutex, as the
+    query is a round trip to the server.
+*/
+bool QSqlConnectionPoolPrivate::validate(const QSqlDatabase &db, const QString &validationQuery)
+{
+    if (!db.isOpen() || db.isOpenError())
+        return false;
+    if (validationQuery.isEmpty())
+        return true;
+    QSqlQuery query(db);
+    return query.exec(validationQuery);
+}
+
+/*
+    Moves the connections that have been idle for longer than the timeout to
+    \a expired, keeping at least minimumSize connections open. Called with
+    the mutex locked.
+*/
+void QSqlConnectionPoolPrivate::takeExpired(QVector<QSqlDatabase> *expired)
+{
+    if (idleTimeout < 0)
+        return;
+    const qint64 now = clock.elapsed();
+    while (size > minimumSize && !idle.isEmpty() && now - idle.first().since >= idleTimeout) {
+        expired->append(idle.first().db);
+        idle.removeFirst();
+        --size;
+    }
+}
+
+/*
+    Closes and removes \a connections. Called without holding the mutex.
+*/
+void QSqlConnectionPoolPrivate::close(QVector<QSqlDatabase> *connections)
+{
+    if (connections->isEmpty())
+        return;
+
+    QStringList names;
+    for (int i = 0; i < connections->size(); ++i) {
+        QSqlDatabase &db = (*connections)[i];
+        // idle connections don't belong to any thread
+        if (QSqlDriver *driver = db.driver()) {
+            if (!driver->thread())
+                driver->moveToThread(QThread::currentThread());
+        }
+        names.append(db.connectionName());
+        db.close();
+    }
+    connections->clear();
+    for (int i = 0; i < names.size(); ++i)
+        QSqlDatabase::removeDatabase(names.at(i));
+}
+
+/*!
+    \class QSqlConnectionPool
+    \brief The QSqlConnectionPool class keeps a set of open database
+    connections for use by several threads.
+
+    \ingroup database
+    \inmodule QtSql
+    \since 5.7
+
+    A QSqlDatabase connection can only be used by one thread at a time, and
+    opening a connection for every task that a worker thread runs is
+    expensive. QSqlConnectionPool opens connections as clones of a template
+    connection (see QSqlDatabase::cloneDatabase()) and hands them out to the
+    threads that need them.
+
+    A thread checks out a connection with acquire() and returns it to the
+    pool with release() when it is done. Calling acquire() again in a thread
+    that already holds a connection returns the same connection; it goes
+    back to the pool when release() has been called as often as acquire().
+    Connections are only opened when no idle connection is left, and never
+    more than maximumSize() at a time: when all of them are in use,
+    acquire() waits for one to be released.
+
+    \code
+    QSqlConnectionPool pool("template");
+    pool.setMaximumSize(4);
+    pool.setValidationQuery("SELECT 1");
+
+    // in a worker thread
+    QSqlDatabase db = pool.acquire();
+    QSqlQuery query(db);
+    query.exec("UPDATE accounts SET balance = 0");
+    query.clear();
+    pool.release(db);
+    \endcode
+
+    Connections that have not been used for idleTimeout() milliseconds are
+    closed, except for the minimumSize() most recently used ones. Expired
+    connections are closed the next time a connection is acquired or
+    released. Before an idle connection is handed out, the pool runs the
+    validationQuery() on it, and replaces the connection with a new one if
+    that fails.
+
+    The pool keeps statistics about how the connections are used:
+    acquireCount(), hitCount() and hitRate() tell how often an open
+    connection could be reused, timeoutCount(), totalWaitTime() and
+    maximumWaitTime() tell how long threads had to wait for a connection.
+
+    All member functions are thread-safe. The template connection has to be
+    added with QSqlDatabase::addDatabase() before the first connection is
+    acquired, and the pool has to be destroyed before it is removed. Queries
+    and copies of a QSqlDatabase must not be kept after the connection has
+    been released.
+
+    \sa QSqlDatabase, {Threads and the SQL Module}
+*/
+
+/*!
+    Constructs a pool that opens clones of the connection called
+    \a connectionName.
+*/
+QSqlConnectionPool::QSqlConnectionPool(const QString &connectionName)
+    : d(new QSqlConnectionPoolPrivate(connectionName))
+{
+}
+
+/*!
+    Closes the idle connections and destroys the pool. All connections
+    should have been released before.
+*/
+QSqlConnectionPool::~QSqlConnectionPool()
+{
+    clear();
+    if (!d->checkedOut.isEmpty()) {
+        qWarning("QSqlConnectionPool: destroyed while %d connections are in use",
+                 d->checkedOut.size());
+    }
+    delete d;
+}
+
+/*!
+    Returns the name of the template connection.
+*/
+QString QSqlConnectionPool::connectionName() const
+{
+    return d->connectionName;
+}
+
+/*!
+    Sets the number of connections that are kept open even if they have
+    been idle for longer than idleTimeout() to \a size. The default is 0.
+
+    Connections are not opened in advance to reach this size.
+*/
+void QSqlConnectionPool::setMinimumSize(int size)
+{
+    QMutexLocker locker(&d->mutex);
+    d->minimumSize = qMax(0, size);
+}
+
+int QSqlConnectionPool::minimumSize() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->minimumSize;
+}
+
+/*!
+    Sets the maximum number of connections that are open at the same time
+    to \a size. The default is QThread::idealThreadCount(), which matches
+    the default size of QThreadPool.
+*/
+void QSqlConnectionPool::setMaximumSize(int size)
+{
+    QMutexLocker locker(&d->mutex);
+    d->maximumSize = qMax(1, size);
+    d->released.wakeAll();
+}
+
+int QSqlConnectionPool::maximumSize() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->maximumSize;
+}
+
+/*!
+    Sets the time after which idle connections are closed to \a msecs
+    milliseconds. The default is 60 seconds; a negative value keeps idle
+    connections open until clear() is called.
+*/
+void QSqlConnectionPool::setIdleTimeout(int msecs)
+{
+    QMutexLocker locker(&d->mutex);
+    d->idleTimeout = msecs;
+}
+
+int QSqlConnectionPool::idleTimeout() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->idleTimeout;
+}
+
+/*!
+    Sets the \a query that is executed on an idle connection before it is
+    handed out again, to check that the connection still works. By default
+    no query is executed and only QSqlDatabase::isOpen() is checked.
+*/
+void QSqlConnectionPool::setValidationQuery(const QString &query)
+{
+    QMutexLocker locker(&d->mutex);
+    d->validationQuery = query;
+}
+
+QString QSqlConnectionPool::validationQuery() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->validationQuery;
+}
+
+/*!
+    Checks out a connection for the current thread and returns it.
+
+    If the current thread already holds a connection, it is returned again.
+    Otherwise an idle connection is reused, or a new one is opened if
+    maximumSize() has not been reached yet. If all connections are in use,
+    waits up to \a timeout milliseconds for one to be released; a negative
+    \a timeout waits forever.
+
+    Returns an invalid QSqlDatabase if the timeout expired or the connection
+    could not be opened.
+
+    \sa release()
+*/
+QSqlDatabase QSqlConnectionPool::acquire(int timeout)
+{
+    QThread *thread = QThread::currentThread();
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<QSqlDatabase> expired;
+    QSqlDatabase db;
+    QString validationQuery;
+    {
+        QMutexLocker locker(&d->mutex);
+        ++d->acquires;
+        QHash<QThread *, QSqlCheckedOutConnection>::iterator it = d->checkedOut.find(thread);
+        if (it != d->checkedOut.end()) {
+            ++it->count;
+            ++d->hits;
+            return it->db;
+        }
+
+        forever {
+            d->takeExpired(&expired);
+            if (!d->idle.isEmpty()) {
+                db = d->idle.last().db;
+                d->idle.removeLast();
+                validationQuery = d->validationQuery;
+                break;
+            }
+            if (d->size < d->maximumSize) {
+                ++d->size;
+                break;
+            }
+            const qint64 remaining = timeout - timer.elapsed();
+            if ((timeout >= 0 && remaining <= 0)
+                || !d->released.wait(&d->mutex, timeout < 0 ? ULONG_MAX : ulong(remaining))) {
+                ++d->timeouts;
+                d->totalWait += timer.elapsed();
+                d->maximumWait = qMax(d->maximumWait, timer.elapsed());
+                locker.unlock();
+                QSqlConnectionPoolPrivate::close(&expired);
+                return QSqlDatabase();
+            }
+        }
+        d->totalWait += timer.elapsed();
+        d->maximumWait = qMax(d->maximumWait, timer.elapsed());
+    }
+    QSqlConnectionPoolPrivate::close(&expired);
+
+    bool reused = false;
+    if (db.isValid()) {
+        db.driver()->moveToThread(thread);
+        reused = QSqlConnectionPoolPrivate::validate(db, validationQuery);
+        if (!reused) {
+            expired.append(db);
+            db = QSqlDatabase();
+            QSqlConnectionPoolPrivate::close(&expired);
+        }
+    }
+    if (!db.isValid()) {
+        db = d->open();
+        if (!db.isValid()) {
+            QMutexLocker locker(&d->mutex);
+            --d->size;
+            d->released.wakeOne();
+            return db;
+        }
+    }
+
+    QMutexLocker locker(&d->mutex);
+    if (reused)
+        ++d->hits;
+    QSqlCheckedOutConnection connection = { db, 1 };
+    d->checkedOut.insert(thread, connection);
+    return db;
+}
+
+/*!
+    Returns the connection \a db, which has been checked out by acquire() in
+    the current thread, to the pool. If acquire() has been called several
+    times, the connection is only returned by the last call to release().
+
+    The connection is returned as it is; transactions that are still open
+    are not rolled back. Connections that have been closed are not reused.
+*/
+void QSqlConnectionPool::release(const QSqlDatabase &db)
+{
+    QVector<QSqlDatabase> expired;
+    {
+        QMutexLocker locker(&d->mutex);
+        QHash<QThread *, QSqlCheckedOutConnection>::iterator it = d->checkedOut.find(QThread::currentThread());
+        if (it == d->checkedOut.end() || it->db.connectionName() != db.connectionName()) {
+            qWarning("QSqlConnectionPool::release: connection '%s' was not acquired by this thread",
+                     db.connectionName().toLocal8Bit().constData());
+            return;
+        }
+        if (--it->count > 0)
+            return;
+
+        const QSqlDatabase connection = it->db;
+        d->checkedOut.erase(it);
+        // the caller still holds a copy of the released connection, so it
+        // must not expire right away
+        d->takeExpired(&expired);
+        if (connection.isOpen() && !connection.isOpenError()) {
+            // let the next thread that acquires the connection take it over
+            connection.driver()->moveToThread(0);
+            const QSqlIdleConnection idle = { connection, d->clock.elapsed() };
+            d->idle.append(idle);
+        } else {
+            expired.append(connection);
+            --d->size;
+        }
+        d->released.wakeOne();
+    }
+    QSqlConnectionPoolPrivate::close(&expired);
+}
+
+/*!
+    Closes all idle connections. Connections that are in use are not
+    affected.
+*/
+void QSqlConnectionPool::clear()
+{
+    QVector<QSqlDatabase> connections;
+    {
+        QMutexLocker locker(&d->mutex);
+        for (int i = 0; i < d->idle.size(); ++i)
+            connections.append(d->idle.at(i).db);
+        d->size -= d->idle.size();
+        d->idle.clear();
+        d->released.wakeAll();
+    }
+    QSqlConnectionPoolPrivate::close(&connections);
+}
+
+/*!
+    Returns the number of open connections, both idle and in use.
+*/
+int QSqlConnectionPool::size() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->size;
+}
+
+/*!
+    Returns the number of open connections that are not in use.
+*/
+int QSqlConnectionPool::idleCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->idle.size();
+}
+
+/*!
+    Returns how often acquire() has been called since the pool was created
+    or the statistics were reset.
+
+    \sa resetStatistics()
+*/
+int QSqlConnectionPool::acquireCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->acquires;
+}
+
+/*!
+    Returns how often acquire() returned a connection that was already
+    open, instead of opening a new one.
+*/
+int QSqlConnectionPool::hitCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->hits;
+}
+
+/*!
+    Returns hitCount() relative to acquireCount(), between 0 and 1.
+*/
+qreal QSqlConnectionPool::hitRate() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->acquires ? qreal(d->hits) / d->acquires : qreal(0);
+}
+
+/*!
+    Returns how often acquire() gave up waiting for a connection.
+*/
+int QSqlConnectionPool::timeoutCount() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->timeouts;
+}
+
+/*!
+    Returns the time in milliseconds that acquire() spent waiting for a
+    connection to be released, summed up over all calls.
+*/
+qint64 QSqlConnectionPool::totalWaitTime() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->totalWait;
+}
+
+/*!
+    Returns the longest time in milliseconds that a single call to acquire()
+    waited for a connection to be released.
+*/
+qint64 QSqlConnectionPool::maximumWaitTime() const
+{
+    QMutexLocker locker(&d->mutex);
+    return d->maximumWait;
+}
+
+/*!
+    Sets all statistics back to zero.
+*/
+void QSqlConnectionPool::resetStatistics()
+{
+    QMutexLocker locker(&d->mutex);
+    d->acquires = 0;
+    d->hits = 0;
+    d->timeouts = 0;
+    d->totalWait = 0;
+    d->maximumWait = 0;
+}
+
+QT_END_NAMESPACE
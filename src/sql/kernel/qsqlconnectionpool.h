@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSQLCONNECTIONPOOL_H
+#define QSQLCONNECTIONPOOL_H
+
+#include <QtSql/qsql.h>
+#include <QtSql/qsqldatabase.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QSqlConnectionPoolPrivate;
+
+class Q_SQL_EXPORT QSqlConnectionPool
+{
+public:
+    explicit QSqlConnectionPool(const QString &connectionName = QLatin1String(QSqlDatabase::defaultConnection));
+    ~QSqlConnectionPool();
+
+    QString connectionName() const;
+
+    void setMinimumSize(int size);
+    int minimumSize() const;
+    void setMaximumSize(int size);
+    int maximumSize() const;
+    void setIdleTimeout(int msecs);
+    int idleTimeout() const;
+    void setValidationQuery(const QString &query);
+    QString validationQuery() const;
+
+    QSqlDatabase acquire(int timeout = -1);
+    void release(const QSqlDatabase &db);
+    void clear();
+
+    int size() const;
+    int idleCount() const;
+
+    int acquireCount() const;
+    int hitCount() const;
+    qreal hitRate() const;
+    int timeoutCount() const;
+    qint64 totalWaitTime() const;
+    qint64 maximumWaitTime() const;
+    void resetStatistics();
+
+private:
+    Q_DISABLE_COPY(QSqlConnectionPool)
+    QSqlConnectionPoolPrivate *d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSQLCONNECTIONPOOL_H
@@ -87,7 +87,9 @@
 #include "qsqlindex.h"
 #include "private/qfactoryloader_p.h"
 #include "private/qsqlnulldriver_p.h"
+#include "private/qsqldriver_p.h"
 #include "qmutex.h"
+#include "qthreadpool.h"
 #include "qhash.h"
 #include <stdlib.h>
 
@@ -868,6 +870,11 @@ bool QSqlDatabase::open(const QString& user, const QString& password)
 
 void QSqlDatabase::close()
 {
+#ifndef QT_NO_QFUTURE
+    // let asynchronous queries finish before closing the connection under them
+    if (QThreadPool *pool = d->driver->d_func()->asyncPool)
+        pool->waitForDone();
+#endif
     d->driver->close();
 }
 
@@ -903,7 +910,10 @@ bool QSqlDatabase::transaction()
 {
     if (!d->driver->hasFeature(QSqlDriver::Transactions))
         return false;
-    return d->driver->beginTransaction();
+    if (!d->driver->beginTransaction())
+        return false;
+    d->driver->d_func()->transactionActive = true;
+    return true;
 }
 
 /*!
@@ -924,7 +934,10 @@ bool QSqlDatabase::commit()
 {
     if (!d->driver->hasFeature(QSqlDriver::Transactions))
         return false;
-    return d->driver->commitTransaction();
+    if (!d->driver->commitTransaction())
+        return false;
+    d->driver->d_func()->transactionActive = false;
+    return true;
 }
 
 /*!
@@ -945,7 +958,10 @@ bool QSqlDatabase::rollback()
 {
     if (!d->driver->hasFeature(QSqlDriver::Transactions))
         return false;
-    return d->driver->rollbackTransaction();
+    if (!d->driver->rollbackTransaction())
+        return false;
+    d->driver->d_func()->transactionActive = false;
+    return true;
 }
 
 /*!
@@ -1269,6 +1285,10 @@ QSqlRecord QSqlDatabase::record(const QString& tablename) const
     \li QSQLITE_OPEN_READONLY
     \li QSQLITE_OPEN_URI
     \li QSQLITE_ENABLE_SHARED_CACHE
+    \li QSQLITE_STATEMENT_CACHE_SIZE
+    \li QSQLITE_JOURNAL_MODE
+    \li QSQLITE_MMAP_SIZE
+    \li QSQLITE_CACHE_SIZE
     \endlist
 
     \li
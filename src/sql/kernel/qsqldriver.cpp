@@ -37,6 +37,7 @@
 #include "qsqlerror.h"
 #include "qsqlfield.h"
 #include "qsqlindex.h"
+#include "qsqlquery.h"
 #include "private/qobject_p.h"
 #include "private/qsqldriver_p.h"
 
@@ -278,6 +279,8 @@ void QSqlDriver::setOpen(bool open)
 {
     Q_D(QSqlDriver);
     d->isOpen = open;
+    // a new connection, or none, has no transaction
+    d->transactionActive = false;
 }
 
 /*!
@@ -801,6 +804,118 @@ QSqlDriver::DbmsType QSqlDriver::dbmsType() const
     return d->dbmsType;
 }
 
+/*!
+    \since 5.7
+
+    Inserts rows into the table \a tableName, in a way that is much faster
+    than executing an INSERT statement for each row. Returns \c true if all
+    rows have been inserted; otherwise returns \c false and sets lastError().
+
+    The fields of \a columns name the columns that are filled. \a values
+    contains one list of values for each field, in the same order; all lists
+    must have the same size. The types of the values should match the types
+    of the columns, as with QSqlQuery::addBindValue().
+
+    \code
+    QSqlRecord columns;
+    columns.append(QSqlField("id", QVariant::Int));
+    columns.append(QSqlField("name", QVariant::String));
+
+    QVector<QVariantList> values(2);
+    for (int i = 0; i < 100000; ++i) {
+        values[0] << i;
+        values[1] << QString("row %1").arg(i);
+    }
+
+    if (!db.driver()->bulkInsert("items", columns, values))
+        qDebug() << db.driver()->lastError();
+    \endcode
+
+    How the rows are transferred depends on the driver:
+
+    \table
+    \header \li Driver \li Method
+    \row \li QPSQL \li \c{COPY ... FROM STDIN}
+    \row \li QMYSQL \li INSERT statements with many rows each
+    \row \li QSQLITE \li one prepared statement that is executed for each row
+    \row \li others \li QSqlQuery::execBatch()
+    \endtable
+
+    If no transaction is active, the rows are inserted in a transaction of
+    their own, so that either all or none of them are inserted. Otherwise,
+    the rows become part of the active transaction.
+
+    \note With drivers that have no native method, only transactions
+    started with QSqlDatabase::transaction() are known to be active. Do not
+    call this function while a transaction started by executing SQL
+    statements is open with such a driver: depending on the database, the
+    transaction the rows are inserted in may commit it.
+
+    \sa QSqlQuery::execBatch()
+*/
+bool QSqlDriver::bulkInsert(const QString &tableName, const QSqlRecord &columns,
+                            const QVector<QVariantList> &values)
+{
+    Q_D(QSqlDriver);
+    if (!isOpen() || isOpenError())
+        return false;
+
+    if (columns.isEmpty() || columns.count() != values.size()) {
+        setLastError(QSqlError(tr("Column count mismatch"), QString(),
+                               QSqlError::StatementError));
+        return false;
+    }
+    const int rows = values.first().size();
+    for (int i = 1; i < values.size(); ++i) {
+        if (values.at(i).size() != rows) {
+            setLastError(QSqlError(tr("Row count mismatch"), QString(),
+                                   QSqlError::StatementError));
+            return false;
+        }
+    }
+    if (rows == 0)
+        return true;
+    return d->bulkInsert(tableName, columns, values);
+}
+
+/*
+    Inserts the rows with QSqlQuery::execBatch(), which executes the prepared
+    INSERT statement row by row unless the driver supports batch operations.
+    Drivers reimplement this with the native bulk loading mechanism.
+*/
+bool QSqlDriverPrivate::bulkInsert(const QString &tableName, const QSqlRecord &columns,
+                                   const QVector<QVariantList> &values)
+{
+    Q_Q(QSqlDriver);
+    QSqlRecord rec = columns;
+    for (int i = 0; i < rec.count(); ++i)
+        rec.setGenerated(i, true);
+
+    QSqlQuery query(q->createResult());
+    if (!query.prepare(q->sqlStatement(QSqlDriver::InsertStatement, tableName, rec, true))) {
+        q->setLastError(query.lastError());
+        return false;
+    }
+    for (int i = 0; i < values.size(); ++i)
+        query.addBindValue(values.at(i));
+
+    // Some drivers start a transaction even if the caller has started one
+    // already, and committing it would commit the caller's work as well;
+    // only start one if none was started with QSqlDatabase::transaction().
+    const QSqlError error = q->lastError();
+    const bool transaction = !transactionActive
+                             && q->hasFeature(QSqlDriver::Transactions) && q->beginTransaction();
+    if (!transaction)
+        q->setLastError(error);
+    if (!query.execBatch()) {
+        q->setLastError(query.lastError());
+        if (transaction)
+            q->rollbackTransaction();
+        return false;
+    }
+    return !transaction || q->commitTransaction();
+}
+
 /*!
     \since 5.0
     \internal
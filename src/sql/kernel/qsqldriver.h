@@ -37,6 +37,8 @@
 #include <QtCore/qobject.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qstringlist.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 #include <QtSql/qsql.h>
 
 QT_BEGIN_NAMESPACE
@@ -49,7 +51,6 @@ class QSqlField;
 class QSqlIndex;
 class QSqlRecord;
 class QSqlResult;
-class QVariant;
 
 class Q_SQL_EXPORT QSqlDriver : public QObject
 {
@@ -125,6 +126,9 @@ public:
 
     DbmsType dbmsType() const;
 
+    bool bulkInsert(const QString &tableName, const QSqlRecord &columns,
+                    const QVector<QVariantList> &values);
+
 public Q_SLOTS:
     virtual bool cancelQuery();
 
@@ -48,10 +48,15 @@
 #include "private/qobject_p.h"
 #include "qsqldriver.h"
 #include "qsqlerror.h"
+#include "qsqlrecord.h"
+#include "qvariant.h"
+#include "qvector.h"
 
 QT_BEGIN_NAMESPACE
 
-class QSqlDriverPrivate : public QObjectPrivate
+class QThreadPool;
+
+class Q_SQL_EXPORT QSqlDriverPrivate : public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QSqlDriver)
 
@@ -61,14 +66,23 @@ public:
         isOpen(false),
         isOpenError(false),
         precisionPolicy(QSql::LowPrecisionDouble),
-        dbmsType(QSqlDriver::UnknownDbms)
+        dbmsType(QSqlDriver::UnknownDbms),
+        transactionActive(false),
+        asyncPool(0)
     { }
 
+    virtual bool bulkInsert(const QString &tableName, const QSqlRecord &columns,
+                            const QVector<QVariantList> &values);
+
     uint isOpen;
     uint isOpenError;
     QSqlError error;
     QSql::NumericalPrecisionPolicy precisionPolicy;
     QSqlDriver::DbmsType dbmsType;
+    // a transaction started with QSqlDatabase::transaction() is open
+    bool transactionActive;
+    // runs QSqlQuery::execAsync() for drivers that can't execute queries without blocking
+    QThreadPool *asyncPool;
 };
 
 QT_END_NAMESPACE
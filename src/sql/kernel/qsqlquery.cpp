@@ -43,6 +43,7 @@
 #include "qsqldriver.h"
 #include "qsqldatabase.h"
 #include "private/qsqlnulldriver_p.h"
+#include "private/qsqlresult_p.h"
 #include "qvector.h"
 #include "qmap.h"
 
@@ -367,6 +368,24 @@ bool QSqlQuery::exec(const QString& query)
 #ifdef QT_DEBUG_SQL
     QElapsedTimer t;
     t.start();
+#endif
+    if (!beginExec(query))
+        return false;
+
+    bool retval = d->sqlResult->reset(query);
+#ifdef QT_DEBUG_SQL
+    qDebug().nospace() << "Executed query (" << t.elapsed() << "ms, " << d->sqlResult->size()
+                       << " results, " << d->sqlResult->numRowsAffected()
+                       << " affected): " << d->sqlResult->lastQuery();
+#endif
+    return retval;
+}
+
+// resets the query for executing \a query, detaching it from other copies
+bool QSqlQuery::beginExec(const QString &query)
+{
+#ifndef QT_NO_QFUTURE
+    d->sqlResult->d_func()->waitForAsyncQueries();
 #endif
     if (d->ref.load() != 1) {
         bool fo = isForwardOnly();
@@ -389,14 +408,7 @@ bool QSqlQuery::exec(const QString& query)
         qWarning("QSqlQuery::exec: empty query");
         return false;
     }
-
-    bool retval = d->sqlResult->reset(query);
-#ifdef QT_DEBUG_SQL
-    qDebug().nospace() << "Executed query (" << t.elapsed() << "ms, " << d->sqlResult->size()
-                       << " results, " << d->sqlResult->numRowsAffected()
-                       << " affected): " << d->sqlResult->lastQuery();
-#endif
-    return retval;
+    return true;
 }
 
 /*!
@@ -951,6 +963,9 @@ void QSqlQuery::clear()
 */
 bool QSqlQuery::prepare(const QString& query)
 {
+#ifndef QT_NO_QFUTURE
+    d->sqlResult->d_func()->waitForAsyncQueries();
+#endif
     if (d->ref.load() != 1) {
         bool fo = isForwardOnly();
         *this = QSqlQuery(driver()->createResult());
@@ -994,6 +1009,9 @@ bool QSqlQuery::exec()
 #ifdef QT_DEBUG_SQL
     QElapsedTimer t;
     t.start();
+#endif
+#ifndef QT_NO_QFUTURE
+    d->sqlResult->d_func()->waitForAsyncQueries();
 #endif
     d->sqlResult->resetBindCount();
 
@@ -1289,4 +1307,82 @@ bool QSqlQuery::nextResult()
     return false;
 }
 
+#ifndef QT_NO_QFUTURE
+static QFuture<QSqlRecord> qFinishedSqlFuture()
+{
+    QFutureInterface<QSqlRecord> future;
+    future.reportStarted();
+    future.reportFinished();
+    return future.future();
+}
+
+/*!
+  \since 5.7
+
+  Executes the SQL in \a query without blocking the calling thread and
+  returns a QFuture that receives the records of the result set as they
+  are fetched from the database. Use a QFutureWatcher to be notified when
+  new records are available and when the query has finished.
+
+  The query is executed forward-only. Its records are only delivered through
+  the future; once the future has finished the query is positioned after
+  the last record, and lastError(), numRowsAffected() and lastInsertId()
+  report the outcome of the execution.
+
+  The PostgreSQL driver waits for the server in the event loop of the
+  calling thread, which needs to be running. Other drivers execute the
+  query on a worker thread that is owned by the connection; asynchronous
+  queries on the same connection are executed one after the other.
+
+  The query must not be used until the future has finished. Executing or
+  preparing another query on the same connection first waits for the
+  asynchronous query to finish; other uses of the connection, such as
+  transactions, must wait for the future explicitly. Canceling the future
+  stops fetching records and finishes the query as finish() does.
+
+  \sa exec(), QFutureWatcher
+*/
+QFuture<QSqlRecord> QSqlQuery::execAsync(const QString &query)
+{
+    setForwardOnly(true);
+    if (!beginExec(query))
+        return qFinishedSqlFuture();
+
+    QFutureInterface<QSqlRecord> future;
+    future.reportStarted();
+    const QFuture<QSqlRecord> result = future.future();
+    d->sqlResult->d_func()->execAsync(*this, query, future);
+    return result;
+}
+
+/*!
+  \since 5.7
+  \overload
+
+  Executes a previously prepared SQL query without blocking the calling
+  thread. The bound values must not be changed until the returned future
+  has finished.
+
+  \sa prepare(), bindValue(), addBindValue()
+*/
+QFuture<QSqlRecord> QSqlQuery::execAsync()
+{
+    d->sqlResult->d_func()->waitForAsyncQueries();
+    setForwardOnly(true);
+    d->sqlResult->resetBindCount();
+    if (d->sqlResult->lastError().isValid())
+        d->sqlResult->setLastError(QSqlError());
+    if (!driver()->isOpen() || driver()->isOpenError()) {
+        qWarning("QSqlQuery::execAsync: database not open");
+        return qFinishedSqlFuture();
+    }
+
+    QFutureInterface<QSqlRecord> future;
+    future.reportStarted();
+    const QFuture<QSqlRecord> result = future.future();
+    d->sqlResult->d_func()->execAsync(*this, QString(), future);
+    return result;
+}
+#endif // QT_NO_QFUTURE
+
 QT_END_NAMESPACE
@@ -37,6 +37,10 @@
 #include <QtSql/qsql.h>
 #include <QtSql/qsqldatabase.h>
 #include <QtCore/qstring.h>
+#ifndef QT_NO_QFUTURE
+#include <QtCore/qfuture.h>
+#include <QtSql/qsqlrecord.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -107,7 +111,14 @@ public:
     void finish();
     bool nextResult();
 
+#ifndef QT_NO_QFUTURE
+    QFuture<QSqlRecord> execAsync(const QString &query);
+    QFuture<QSqlRecord> execAsync();
+#endif
+
 private:
+    bool beginExec(const QString &query);
+
     QSqlQueryPrivate* d;
 };
 
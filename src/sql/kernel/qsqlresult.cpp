@@ -42,12 +42,112 @@
 #include "qvector.h"
 #include "qsqldriver.h"
 #include "qpointer.h"
+#include "qsqlquery.h"
 #include "qsqlresult_p.h"
 #include "private/qsqldriver_p.h"
+#ifndef QT_NO_QFUTURE
+#include "qfutureinterface.h"
+#include "qrunnable.h"
+#include "qscopedpointer.h"
+#include "qthreadpool.h"
+#endif
 #include <QDebug>
 
 QT_BEGIN_NAMESPACE
 
+#ifndef QT_NO_QFUTURE
+class QSqlAsyncQueryRunnable : public QRunnable
+{
+public:
+    QSqlAsyncQueryRunnable(QSqlResultPrivate *d, const QSqlQuery &query, const QString &sql,
+                           const QFutureInterface<QSqlRecord> &future)
+        : d(d), query(new QSqlQuery(query)), sql(sql), future(future)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        d->runAsync(sql, future);
+        // release the result before the caller may use the connection again
+        query.reset();
+        future.reportFinished();
+    }
+
+private:
+    QSqlResultPrivate *d;
+    QScopedPointer<QSqlQuery> query; // keeps the result alive until the query has run
+    QString sql;
+    QFutureInterface<QSqlRecord> future;
+};
+
+/*
+    Starts executing \a sql, or the prepared query if \a sql is null,
+    without blocking. The rows are reported to \a future as they are fetched
+    and \a future is finished once the result set is exhausted. \a query
+    refers to this result and has to be kept until then.
+
+    Drivers that can wait for the server in the event loop reimplement this.
+    The default implementation runs the query on a worker thread owned by
+    the driver, which executes the asynchronous queries of a connection one
+    after the other.
+*/
+void QSqlResultPrivate::execAsync(const QSqlQuery &query, const QString &sql,
+                                  QFutureInterface<QSqlRecord> &future)
+{
+    QSqlDriverPrivate *drv = sqldriver->d_func();
+    if (!drv->asyncPool) {
+        drv->asyncPool = new QThreadPool(sqldriver);
+        drv->asyncPool->setMaxThreadCount(1);
+    }
+    drv->asyncPool->start(new QSqlAsyncQueryRunnable(this, query, sql, future));
+}
+
+/*
+    Executes the query in the calling thread and reports the rows to
+    \a future. A canceled query stops fetching rows and is finished like
+    QSqlQuery::finish() does. The caller finishes \a future.
+*/
+void QSqlResultPrivate::runAsync(const QString &sql, QFutureInterface<QSqlRecord> &future)
+{
+    Q_Q(QSqlResult);
+    if (!future.isCanceled()) {
+        const bool ok = sql.isNull() ? q->exec() : q->reset(sql);
+        if (ok && q->isSelect()) {
+            const QSqlRecord fields = q->record();
+            int row = 0;
+            bool fetched = q->fetchFirst();
+            while (fetched && !future.isCanceled()) {
+                QSqlRecord rec = fields;
+                for (int i = 0; i < rec.count(); ++i)
+                    rec.setValue(i, q->data(i));
+                future.reportResult(rec, row++);
+                fetched = q->fetchNext();
+            }
+            if (!fetched)
+                q->setAt(QSql::AfterLastRow);
+        }
+    }
+    if (future.isCanceled() && q->isActive()) {
+        q->setLastError(QSqlError());
+        q->setAt(QSql::BeforeFirstRow);
+        q->detachFromResultSet();
+        q->setActive(false);
+    }
+}
+
+/*
+    Blocks until the queries that the worker thread of the driver is running
+    for QSqlQuery::execAsync() have finished, so that the connection can be
+    used from the calling thread.
+*/
+void QSqlResultPrivate::waitForAsyncQueries() const
+{
+    if (!sqldriver)
+        return;
+    if (QThreadPool *pool = sqldriver->d_func()->asyncPool)
+        pool->waitForDone();
+}
+#endif // QT_NO_QFUTURE
+
 QString QSqlResultPrivate::holderAt(int index) const
 {
     return holders.size() > index ? holders.at(index).holderName : fieldSerial(index);
@@ -52,6 +52,10 @@
 
 QT_BEGIN_NAMESPACE
 
+class QSqlQuery;
+class QSqlRecord;
+template <typename T> class QFutureInterface;
+
 // convenience method Q*ResultPrivate::drv_d_func() returns pointer to private driver. Compare to Q_DECLARE_PRIVATE in qglobal.h.
 #define Q_DECLARE_SQLDRIVER_PRIVATE(Class) \
     inline const Class##Private* drv_d_func() const { return !sqldriver ? nullptr : reinterpret_cast<const Class *>(static_cast<const QSqlDriver*>(sqldriver))->d_func(); } \
@@ -108,6 +112,12 @@ public:
     }
 
     virtual QString fieldSerial(int) const;
+#ifndef QT_NO_QFUTURE
+    virtual void execAsync(const QSqlQuery &query, const QString &sql,
+                           QFutureInterface<QSqlRecord> &future);
+    void runAsync(const QString &sql, QFutureInterface<QSqlRecord> &future);
+    void waitForAsyncQueries() const;
+#endif
     QString positionalToNamedBinding(const QString &query) const;
     QString namedToPositionalBinding(const QString &query);
     QString holderAt(int index) const;
@@ -63,6 +63,9 @@ private slots:
     void invalidUtf8_data();
     void invalidUtf8();
 
+    void invalidUtf8AcrossBlocks_data();
+    void invalidUtf8AcrossBlocks();
+
     void nonCharacters_data();
     void nonCharacters();
 };
@@ -236,6 +239,74 @@ void tst_Utf8::invalidUtf8()
         qWarning("System codec does not report failure when it should. Should report bug upstream.");
 }
 
+// Long runs of multi-byte text are decoded in blocks of 16 bytes; check
+// that malformed and truncated sequences straddling a block boundary are
+// decoded the same way as on their own
+void tst_Utf8::invalidUtf8AcrossBlocks_data()
+{
+    QTest::addColumn<QByteArray>("before");
+    QTest::addColumn<QByteArray>("sequence");
+    QTest::addColumn<QByteArray>("after");
+
+    static const char *const sequences[][2] = {
+        { "truncated-2", "\xC3" "a" },
+        { "truncated-3-1", "\xE2" "a" },
+        { "truncated-3-2", "\xE2\x82" "a" },
+        { "truncated-4-3", "\xF0\x9F\x98" "a" },
+        { "truncated-3-lead", "\xE2\x82\xC3\xA9" },
+        { "continuation", "\x80" },
+        { "continuations", "\xA9\xA9\xA9" },
+        { "overlong-2", "\xC0\x80" },
+        { "overlong-3", "\xE0\x80\x80" },
+        { "hi-surrogate", "\xED\xA0\x80" },
+        { "lo-surrogate", "\xED\xBF\xBF" },
+        { "non-unicode", "\xF4\x90\x80\x80" },
+        { "f5", "\xF5\x80\x80\x80" },
+        { "ff", "\xFF" }
+    };
+
+    // two-byte characters, with an ASCII one to get to an odd length
+    const QByteArray e = "\xC3\xA9";
+    const QByteArray tail = e.repeated(4);
+    for (const auto &sequence : sequences) {
+        // the sequence starts in the last bytes of a block, or just after it
+        for (int offset = 13; offset < 18; ++offset) {
+            const QByteArray before = QByteArray(offset % 2, 'x') + e.repeated(offset / 2);
+            QTest::newRow(qPrintable(QString::fromLatin1("%1-at-%2").arg(QLatin1String(sequence[0])).arg(offset)))
+                    << before << QByteArray(sequence[1]) << tail;
+        }
+        QTest::newRow(qPrintable(QString::fromLatin1("%1-at-end").arg(QLatin1String(sequence[0]))))
+                << QByteArray("x") + e.repeated(8) << QByteArray(sequence[1]) << QByteArray();
+    }
+}
+
+void tst_Utf8::invalidUtf8AcrossBlocks()
+{
+    QFETCH(QByteArray, before);
+    QFETCH(QByteArray, sequence);
+    QFETCH(QByteArray, after);
+    QFETCH_GLOBAL(bool, useLocale);
+
+    // the system codec is not required to handle errors like ours
+    if (useLocale)
+        return;
+
+    const QByteArray utf8 = before + sequence + after;
+    QVERIFY(utf8.size() >= 18);
+
+    // each part is too short to be decoded in blocks
+    QCOMPARE(from8Bit(utf8), from8Bit(before) + from8Bit(sequence) + from8Bit(after));
+
+    QSharedPointer<QTextDecoder> decoder(codec->makeDecoder());
+    const QString decoded = decoder->toUnicode(utf8);
+    QSharedPointer<QTextDecoder> partDecoder(codec->makeDecoder());
+    QString expected = partDecoder->toUnicode(before);
+    expected += partDecoder->toUnicode(sequence);
+    expected += partDecoder->toUnicode(after);
+    QCOMPARE(decoded, expected);
+    QCOMPARE(decoder->hasFailure(), partDecoder->hasFailure());
+}
+
 void tst_Utf8::nonCharacters_data()
 {
     QTest::addColumn<QByteArray>("utf8");
@@ -37,6 +37,7 @@
 #include "qjsonobject.h"
 #include "qjsonvalue.h"
 #include "qjsondocument.h"
+#include "qjsonstream.h"
 #include <limits>
 
 #define INVALID_UNICODE "\xCE\xBA\xE1"
@@ -96,6 +97,9 @@ private Q_SLOTS:
     void fromJson();
     void fromJsonErrors();
     void fromBinary();
+    void fromBinaryFile();
+    void validateOnAccess();
+    void validateOnAccessCompaction();
     void toAndFromBinary_data();
     void toAndFromBinary();
     void parseNumbers();
@@ -142,6 +146,19 @@ private Q_SLOTS:
     void garbageAtEnd();
 
     void removeNonLatinKey();
+
+    void streamReaderTokens();
+    void streamReaderDocuments_data();
+    void streamReaderDocuments();
+    void streamReaderIncremental();
+    void streamReaderSequentialDevice();
+    void streamReaderLargeDevice();
+    void streamReaderErrors_data();
+    void streamReaderErrors();
+    void streamReaderSkip();
+    void streamWriter();
+    void streamWriterMisuse();
+    void streamWriterDeviceError();
 private:
     QString testDataDir;
 };
@@ -1741,6 +1758,114 @@ void tst_QtJson::fromBinary()
     QCOMPARE(doc, bdoc);
 }
 
+void tst_QtJson::fromBinaryFile()
+{
+    const QString fileName = testDataDir + "/test.bjson";
+    QFile bfile(fileName);
+    QVERIFY(bfile.open(QFile::ReadOnly));
+    const QByteArray binary = bfile.readAll();
+    bfile.close();
+
+    QJsonDocument expected = QJsonDocument::fromBinaryData(binary);
+    QVERIFY(!expected.isNull());
+
+    QJsonDocument doc = QJsonDocument::fromBinaryFile(fileName);
+    QVERIFY(!doc.isNull());
+    QCOMPARE(doc, expected);
+
+    doc = QJsonDocument::fromBinaryFile(fileName, QJsonDocument::BypassValidation);
+    QVERIFY(!doc.isNull());
+    QCOMPARE(doc, expected);
+
+    doc = QJsonDocument::fromBinaryFile(fileName, QJsonDocument::ValidateOnAccess);
+    QVERIFY(!doc.isNull());
+    QCOMPARE(doc, expected);
+    QCOMPARE(doc.toBinaryData(), binary);
+
+    // modifying a mapped document must not write through to the file
+    if (doc.isObject()) {
+        QJsonObject object = doc.object();
+        object.insert(QStringLiteral("added"), 42);
+        object.remove(object.keys().first());
+        doc.setObject(object);
+    } else {
+        QJsonArray array = doc.array();
+        array.append(42);
+        array.removeFirst();
+        doc.setArray(array);
+    }
+    QVERIFY(doc != expected);
+    QVERIFY(bfile.open(QFile::ReadOnly));
+    QCOMPARE(bfile.readAll(), binary);
+
+    QVERIFY(QJsonDocument::fromBinaryFile(testDataDir + "/nonexistent.bjson").isNull());
+    QVERIFY(QJsonDocument::fromBinaryFile(testDataDir + "/test.json").isNull());
+}
+
+void tst_QtJson::validateOnAccess()
+{
+    QJsonObject nested;
+    for (int i = 0; i < 5; ++i)
+        nested.insert(QString::number(i), i);
+    QJsonObject root;
+    root.insert(QStringLiteral("a"), nested);
+    root.insert(QStringLiteral("b"), QJsonArray() << 1 << 2 << 3);
+    QByteArray binary = QJsonDocument(root).toBinaryData();
+
+    // corrupt the table offset of the nested object; the root stays intact
+    const quint32 nestedHeader = 1 | (5 << 1);
+    int pos = 20;
+    for (; pos + 8 <= binary.size(); pos += 4) {
+        if (qFromLittleEndian<quint32>((const uchar *)binary.constData() + pos) == nestedHeader)
+            break;
+    }
+    QVERIFY(pos + 8 <= binary.size());
+    qToLittleEndian<quint32>(0x7ffffff0, (uchar *)binary.data() + pos + 4);
+
+    QVERIFY(QJsonDocument::fromBinaryData(binary).isNull());
+
+    QJsonDocument doc = QJsonDocument::fromBinaryData(binary, QJsonDocument::ValidateOnAccess);
+    QVERIFY(!doc.isNull());
+    QJsonObject object = doc.object();
+    QCOMPARE(object.size(), 2);
+    QCOMPARE(object.value(QStringLiteral("b")).toArray(), QJsonArray() << 1 << 2 << 3);
+    QVERIFY(object.value(QStringLiteral("a")).isUndefined());
+    QVERIFY(doc.toJson().isEmpty());
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(binary);
+    file.close();
+
+    QVERIFY(QJsonDocument::fromBinaryFile(file.fileName()).isNull());
+    doc = QJsonDocument::fromBinaryFile(file.fileName(), QJsonDocument::ValidateOnAccess);
+    QVERIFY(!doc.isNull());
+    QVERIFY(doc.object().value(QStringLiteral("a")).isUndefined());
+    QCOMPARE(doc.object().value(QStringLiteral("b")).toArray().size(), 3);
+}
+
+void tst_QtJson::validateOnAccessCompaction()
+{
+    QJsonObject root;
+    for (int i = 0; i < 10; ++i)
+        root.insert(QString::number(i), QJsonArray() << i << QString::number(i));
+    const QByteArray binary = QJsonDocument(root).toBinaryData();
+
+    QJsonDocument doc = QJsonDocument::fromBinaryData(binary, QJsonDocument::ValidateOnAccess);
+    QVERIFY(!doc.isNull());
+    QJsonObject object = doc.object();
+    // replacing values leaves garbage behind until the data is compacted
+    for (int i = 0; i < 100; ++i)
+        object.insert(QStringLiteral("0"), QString::number(i));
+    QCOMPARE(object.size(), 10);
+    QCOMPARE(object.value(QStringLiteral("0")).toString(), QStringLiteral("99"));
+    for (int i = 1; i < 10; ++i)
+        QCOMPARE(object.value(QString::number(i)).toArray(), QJsonArray() << i << QString::number(i));
+
+    doc.setObject(object);
+    QCOMPARE(QJsonDocument::fromJson(doc.toJson()).object(), object);
+}
+
 void tst_QtJson::toAndFromBinary_data()
 {
     QTest::addColumn<QString>("filename");
@@ -2786,5 +2911,505 @@ void tst_QtJson::removeNonLatinKey()
     QVERIFY(restoredObject.contains(nonLatinKeyName));
 }
 
+typedef QList<QPair<QJsonStreamReader::TokenType, QString> > TokenList;
+
+static TokenList readTokens(QJsonStreamReader &reader)
+{
+    TokenList tokens;
+    while (!reader.atEnd()) {
+        const QJsonStreamReader::TokenType type = reader.readNext();
+        QString description = reader.name();
+        if (reader.isValue())
+            description += QLatin1Char('=') + QString::fromUtf8(QJsonDocument(QJsonArray() << reader.value()).toJson(QJsonDocument::Compact));
+        tokens << qMakePair(type, description);
+    }
+    return tokens;
+}
+
+void tst_QtJson::streamReaderTokens()
+{
+    const QByteArray json = "\xef\xbb\xbf { \"a\": [1, -2.5e3, \"x\\ty\", true, false, null, {}, []],"
+                            " \"\": {\"b\\u00e9\": \"\\ud83d\\ude00" UNICODE_DJE "\"} }\n";
+    QJsonStreamReader reader(json);
+
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartDocument);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.depth(), 1);
+    QVERIFY(reader.name().isNull());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.name(), QString("a"));
+    QCOMPARE(reader.depth(), 2);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Double);
+    QCOMPARE(reader.value(), QJsonValue(1));
+    QVERIFY(reader.name().isNull());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Double);
+    QCOMPARE(reader.value(), QJsonValue(-2500));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.value(), QJsonValue(QLatin1String("x\ty")));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Bool);
+    QCOMPARE(reader.value(), QJsonValue(true));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Bool);
+    QCOMPARE(reader.value(), QJsonValue(false));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Null);
+    QVERIFY(reader.value().isNull());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QVERIFY(reader.value().isUndefined());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QVERIFY(!reader.name().isNull());
+    QVERIFY(reader.name().isEmpty());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.name(), QString::fromUtf8("b\xc3\xa9"));
+    QCOMPARE(reader.value().toString(), QString::fromUtf8("\xf0\x9f\x98\x80" UNICODE_DJE));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 0);
+    QVERIFY(!reader.atEnd());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.characterOffset(), qint64(json.size()));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+
+    // scalars are valid documents as well
+    QJsonStreamReader scalar(QByteArray(" 42 "));
+    QCOMPARE(readTokens(scalar), TokenList()
+             << qMakePair(QJsonStreamReader::StartDocument, QString())
+             << qMakePair(QJsonStreamReader::Double, QString("=[42]"))
+             << qMakePair(QJsonStreamReader::EndDocument, QString()));
+}
+
+void tst_QtJson::streamReaderDocuments_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("test.json") << (testDataDir + "/test.json");
+    QTest::newRow("test2.json") << (testDataDir + "/test2.json");
+    QTest::newRow("test3.json") << (testDataDir + "/test3.json");
+    QTest::newRow("bom.json") << (testDataDir + "/bom.json");
+}
+
+void tst_QtJson::streamReaderDocuments()
+{
+    QFETCH(QString, fileName);
+
+    QFile file(fileName);
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray json = file.readAll();
+    const QJsonDocument document = QJsonDocument::fromJson(json);
+    QVERIFY(!document.isNull());
+
+    // the values read from a device match the document
+    QVERIFY(file.seek(0));
+    QJsonStreamReader reader(&file);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartDocument);
+    reader.readNext();
+    const QJsonValue value = reader.readValue();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QVERIFY(!reader.hasError());
+    if (document.isObject())
+        QCOMPARE(value, QJsonValue(document.object()));
+    else
+        QCOMPARE(value, QJsonValue(document.array()));
+
+    // copying the tokens reproduces the document; QJsonObject sorts its keys,
+    // so only writing the value in one go matches toJson() byte for byte
+    const QJsonDocument::JsonFormat formats[] = { QJsonDocument::Indented, QJsonDocument::Compact };
+    for (int i = 0; i < 2; ++i) {
+        QByteArray output;
+        QJsonStreamWriter writer(&output);
+        writer.setFormat(formats[i]);
+        QJsonStreamReader copy(json);
+        while (!copy.atEnd()) {
+            copy.readNext();
+            writer.writeCurrentToken(copy);
+        }
+        QVERIFY(!copy.hasError());
+        QVERIFY(!writer.hasError());
+        QCOMPARE(QJsonDocument::fromJson(output), document);
+        if (formats[i] == QJsonDocument::Compact)
+            QVERIFY(!output.contains('\n'));
+        else
+            QVERIFY(output.endsWith('\n'));
+
+        output.clear();
+        QJsonStreamWriter valueWriter(&output);
+        valueWriter.setFormat(formats[i]);
+        valueWriter.writeValue(value);
+        QCOMPARE(output, document.toJson(formats[i]));
+    }
+}
+
+void tst_QtJson::streamReaderIncremental()
+{
+    const QByteArray json = "{\"name\": \"caf\xc3\xa9 \\\"x\\\"\", \"values\": [1.5, 200, true, null, "
+                            "\"\\u00e9\\u20ac\"], \"nested\": {\"a\": {\"b\": []}, \"c\": false}}";
+
+    QJsonStreamReader whole(json);
+    const TokenList expected = readTokens(whole);
+    QVERIFY(!whole.hasError());
+
+    // feeding the data one byte at a time reports the same tokens
+    QJsonStreamReader reader;
+    TokenList tokens;
+    int fed = 0;
+    while (!reader.isEndDocument()) {
+        const QJsonStreamReader::TokenType type = reader.readNext();
+        if (type == QJsonStreamReader::Invalid) {
+            QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+            QVERIFY(reader.atEnd());
+            // the end of the document is only reported at the end of the input
+            if (fed < json.size())
+                reader.addData(json.mid(fed++, 1));
+            else
+                reader.finishInput();
+            QVERIFY(!reader.atEnd());
+            continue;
+        }
+        QString description = reader.name();
+        if (reader.isValue())
+            description += QLatin1Char('=') + QString::fromUtf8(QJsonDocument(QJsonArray() << reader.value()).toJson(QJsonDocument::Compact));
+        tokens << qMakePair(type, description);
+    }
+    QCOMPARE(fed, json.size());
+    QCOMPARE(tokens, expected);
+    QCOMPARE(reader.characterOffset(), qint64(json.size()));
+
+    // a top level number is only complete at the end of the input
+    QJsonStreamReader number;
+    number.addData("1");
+    QCOMPARE(number.readNext(), QJsonStreamReader::StartDocument);
+    QCOMPARE(number.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(number.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+    number.addData("23");
+    QCOMPARE(number.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(number.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+    number.addData(" ");
+    QCOMPARE(number.readNext(), QJsonStreamReader::Double);
+    QCOMPARE(number.value().toDouble(), 123.);
+    QCOMPARE(number.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(number.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+    number.finishInput();
+    QVERIFY(!number.atEnd());
+    QCOMPARE(number.readNext(), QJsonStreamReader::EndDocument);
+
+    number.clear();
+    number.addData("4");
+    number.addData("5");
+    number.finishInput();
+    QCOMPARE(number.readNext(), QJsonStreamReader::StartDocument);
+    QCOMPARE(number.readNext(), QJsonStreamReader::Double);
+    QCOMPARE(number.value().toDouble(), 45.);
+    QCOMPARE(number.readNext(), QJsonStreamReader::EndDocument);
+
+    // a token following the root value in a later chunk is an error
+    QJsonStreamReader trailing;
+    trailing.addData("true");
+    QCOMPARE(trailing.readNext(), QJsonStreamReader::StartDocument);
+    QCOMPARE(trailing.readNext(), QJsonStreamReader::Bool);
+    QCOMPARE(trailing.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(trailing.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+    trailing.addData(" ");
+    QCOMPARE(trailing.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(trailing.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+    trailing.addData("false");
+    QCOMPARE(trailing.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(trailing.error(), QJsonStreamReader::NotWellFormedError);
+    QCOMPARE(trailing.parseError().error, QJsonParseError::GarbageAtEnd);
+    QCOMPARE(trailing.parseError().offset, 5);
+}
+
+// a pipe-like device: data arrives with append()
+class SequentialDevice : public QIODevice
+{
+public:
+    void append(const QByteArray &data) { pending += data; }
+    bool isSequential() const Q_DECL_OVERRIDE { return true; }
+    qint64 bytesAvailable() const Q_DECL_OVERRIDE
+    { return pending.size() + QIODevice::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) Q_DECL_OVERRIDE
+    {
+        const int n = int(qMin(maxSize, qint64(pending.size())));
+        memcpy(data, pending.constData(), n);
+        pending.remove(0, n);
+        return n;
+    }
+    qint64 writeData(const char *, qint64) Q_DECL_OVERRIDE { return -1; }
+
+private:
+    QByteArray pending;
+};
+
+void tst_QtJson::streamReaderSequentialDevice()
+{
+    // a sequential device without data yet is not the end of the input
+    SequentialDevice device;
+    QVERIFY(device.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&device);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartDocument);
+    device.append("1");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+    device.append("2 ");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Double);
+    QCOMPARE(reader.value().toDouble(), 12.);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+
+    // closing the device ends the input
+    device.close();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+
+    // and so does finishInput()
+    QVERIFY(device.open(QIODevice::ReadOnly));
+    reader.setDevice(&device);
+    device.append("[7]");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartDocument);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Double);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    reader.finishInput();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+}
+
+void tst_QtJson::streamReaderLargeDevice()
+{
+    // much larger than the reader's internal buffer, with strings spanning reads
+    const QString longString(100000, QLatin1Char('x'));
+    QByteArray json = "[";
+    for (int i = 0; i < 20000; ++i) {
+        if (i)
+            json += ',';
+        json += "{\"id\":" + QByteArray::number(i) + ",\"name\":\"item " + QByteArray::number(i) + "\"}";
+        if (i % 5000 == 0)
+            json += ",\"" + longString.toLatin1() + '"';
+    }
+    json += ']';
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartDocument);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+
+    int records = 0;
+    int strings = 0;
+    forever {
+        const QJsonStreamReader::TokenType type = reader.readNext();
+        if (type == QJsonStreamReader::StartObject) {
+            const QJsonObject object = reader.readValue().toObject();
+            QCOMPARE(object.value("id").toInt(), records);
+            QCOMPARE(object.value("name").toString(), QString("item %1").arg(records));
+            ++records;
+        } else if (type == QJsonStreamReader::String) {
+            QCOMPARE(reader.value().toString(), longString);
+            ++strings;
+        } else {
+            QCOMPARE(type, QJsonStreamReader::EndArray);
+            break;
+        }
+    }
+    QCOMPARE(records, 20000);
+    QCOMPARE(strings, 4);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QCOMPARE(reader.characterOffset(), qint64(json.size()));
+}
+
+void tst_QtJson::streamReaderErrors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<int>("error");
+    QTest::addColumn<int>("parseError");
+    QTest::addColumn<int>("offset");
+
+    const int wellFormed = QJsonStreamReader::NotWellFormedError;
+    const int premature = QJsonStreamReader::PrematureEndOfDocumentError;
+
+    QTest::newRow("empty") << QByteArray("") << premature << int(QJsonParseError::IllegalValue) << 0;
+    QTest::newRow("open object") << QByteArray("{\"a\": true") << premature << int(QJsonParseError::UnterminatedObject) << 10;
+    QTest::newRow("open array") << QByteArray("[1, [2]") << premature << int(QJsonParseError::UnterminatedArray) << 7;
+    QTest::newRow("open string") << QByteArray("[\"abc") << premature << int(QJsonParseError::UnterminatedString) << 5;
+    QTest::newRow("open number") << QByteArray("[12") << premature << int(QJsonParseError::TerminationByNumber) << 3;
+    QTest::newRow("garbage") << QByteArray("{} x") << wellFormed << int(QJsonParseError::GarbageAtEnd) << 3;
+    QTest::newRow("bad value") << QByteArray("[1, x]") << wellFormed << int(QJsonParseError::IllegalValue) << 4;
+    QTest::newRow("bad literal") << QByteArray("[trve]") << wellFormed << int(QJsonParseError::IllegalValue) << 1;
+    QTest::newRow("bad number") << QByteArray("[-]") << wellFormed << int(QJsonParseError::IllegalNumber) << 1;
+    QTest::newRow("missing comma") << QByteArray("[1 2]") << wellFormed << int(QJsonParseError::MissingValueSeparator) << 3;
+    QTest::newRow("missing colon") << QByteArray("{\"a\" 1}") << wellFormed << int(QJsonParseError::MissingNameSeparator) << 5;
+    QTest::newRow("missing member") << QByteArray("{\"a\": 1,}") << wellFormed << int(QJsonParseError::MissingObject) << 8;
+    QTest::newRow("unquoted name") << QByteArray("{a: 1}") << wellFormed << int(QJsonParseError::UnterminatedObject) << 1;
+    QTest::newRow("mismatched") << QByteArray("[1}") << wellFormed << int(QJsonParseError::UnterminatedArray) << 2;
+    QTest::newRow("bad escape") << QByteArray("[\"\\u12x4\"]") << wellFormed << int(QJsonParseError::IllegalEscapeSequence) << 2;
+    QTest::newRow("bad utf8") << QByteArray("[\"" INVALID_UNICODE "\"]") << wellFormed << int(QJsonParseError::IllegalUTF8String) << 4;
+    QTest::newRow("deep nesting") << QByteArray(1025, '[') << wellFormed << int(QJsonParseError::DeepNesting) << 1024;
+}
+
+void tst_QtJson::streamReaderErrors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(int, error);
+    QFETCH(int, parseError);
+    QFETCH(int, offset);
+
+    QJsonStreamReader reader(json);
+    while (!reader.atEnd())
+        reader.readNext();
+
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Invalid);
+    QVERIFY(reader.hasError());
+    QCOMPARE(int(reader.error()), error);
+    QCOMPARE(int(reader.parseError().error), parseError);
+    QCOMPARE(reader.parseError().offset, offset);
+    QVERIFY(!reader.errorString().isEmpty());
+
+    // errors are sticky, except for premature ends, which can be resumed
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(int(reader.error()), error);
+}
+
+void tst_QtJson::streamReaderSkip()
+{
+    QJsonStreamReader reader(QByteArray("{\"skip\": {\"a\": [1, {\"b\": [[]]}]}, \"keep\": [1, 2], \"last\": 3}"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartDocument);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.name(), QString("skip"));
+    reader.skipCurrentValue();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.name(), QString("keep"));
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonArray() << 1 << 2));
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Double);
+    QCOMPARE(reader.name(), QString("last"));
+    reader.skipCurrentValue();
+    QCOMPARE(reader.readValue(), QJsonValue(3));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+}
+
+void tst_QtJson::streamWriter()
+{
+    QJsonObject object;
+    object.insert("x", 1);
+    object.insert("y", QJsonArray() << true << QJsonValue());
+
+    QJsonObject expected;
+    expected.insert("string", QString::fromUtf8("\"quoted\"\n" UNICODE_DJE));
+    expected.insert("number", 2.5);
+    expected.insert("infinity", QJsonValue());
+    expected.insert("empty", QJsonArray());
+    expected.insert("object", object);
+    expected.insert("array", QJsonArray() << 1 << object << QJsonArray());
+
+    const QJsonDocument::JsonFormat formats[] = { QJsonDocument::Indented, QJsonDocument::Compact };
+    for (int i = 0; i < 2; ++i) {
+        QByteArray output;
+        QJsonStreamWriter writer(&output);
+        QCOMPARE(writer.format(), QJsonDocument::Indented);
+        writer.setFormat(formats[i]);
+        writer.writeStartObject();
+        writer.writeStartArray("array");
+        writer.writeValue(1);
+        writer.writeValue(object);
+        writer.writeStartArray();
+        writer.writeEndArray();
+        writer.writeEndArray();
+        writer.writeStartArray("empty");
+        writer.writeEndArray();
+        writer.writeValue("infinity", std::numeric_limits<double>::infinity());
+        writer.writeValue("number", 2.5);
+        writer.writeStartObject("object");
+        writer.writeValue("x", 1);
+        writer.writeValue("y", QJsonArray() << true << QJsonValue());
+        QCOMPARE(writer.depth(), 2);
+        writer.writeEndObject();
+        writer.writeValue("string", QString::fromUtf8("\"quoted\"\n" UNICODE_DJE));
+        writer.writeEndDocument();
+        QCOMPARE(writer.depth(), 0);
+        QVERIFY(!writer.hasError());
+
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(output, &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        // the members were written in key order, so the layout matches as well
+        QCOMPARE(document.object(), expected);
+        QCOMPARE(output, QJsonDocument(expected).toJson(formats[i]));
+    }
+
+    // scalars at the top level
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+    writer.setFormat(QJsonDocument::Compact);
+    writer.writeValue(QString("text"));
+    QCOMPARE(output, QByteArray("\"text\""));
+}
+
+void tst_QtJson::streamWriterMisuse()
+{
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+    writer.setFormat(QJsonDocument::Compact);
+
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeValue: Cannot write a named value outside of an object");
+    writer.writeValue("name", 1);
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeEndObject: No object is open");
+    writer.writeEndObject();
+
+    writer.writeStartObject();
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeStartArray: Object members need a name");
+    writer.writeStartArray();
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeEndArray: No array is open");
+    writer.writeEndArray();
+    writer.writeStartArray("list");
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeValue: Array elements cannot have a name");
+    writer.writeValue("name", 1);
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeValue: Cannot write an undefined value");
+    writer.writeValue(QJsonValue(QJsonValue::Undefined));
+    writer.writeEndDocument();
+
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeStartObject: The document has already been completed");
+    writer.writeStartObject();
+
+    QCOMPARE(output, QByteArray("{\"list\":[]}"));
+    QVERIFY(!writer.hasError());
+}
+
+void tst_QtJson::streamWriterDeviceError()
+{
+    QByteArray data;
+    QBuffer readOnly(&data);
+    readOnly.open(QIODevice::ReadOnly);
+
+    QJsonStreamWriter writer(&readOnly);
+    writer.setFormat(QJsonDocument::Compact);
+    QTest::ignoreMessage(QtWarningMsg, "QIODevice::write (QBuffer): ReadOnly device");
+    writer.writeStartArray();
+    QVERIFY(writer.hasError());
+
+    // the error sticks to the device it happened on
+    writer.writeEndArray();
+    QVERIFY(writer.hasError());
+
+    QBuffer writable;
+    writable.open(QIODevice::WriteOnly);
+    writer.setDevice(&writable);
+    QVERIFY(!writer.hasError());
+    writer.writeStartArray();
+    writer.writeValue(1);
+    writer.writeEndArray();
+    QVERIFY(!writer.hasError());
+    QCOMPARE(writable.data(), QByteArray("[1]"));
+}
+
 QTEST_MAIN(tst_QtJson)
 #include "tst_qtjson.moc"
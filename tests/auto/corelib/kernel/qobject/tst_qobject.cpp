@@ -82,6 +82,7 @@ private slots:
     void thread();
     void thread0();
     void moveToThread();
+    void moveToThreadWhileReceivingQueuedCalls();
     void senderTest();
     void declareInterface();
     void qpointerResetBeforeDestroyedSignal();
@@ -94,6 +95,9 @@ private slots:
     void recursiveSignalEmission();
     void signalBlocking();
     void blockingQueuedConnection();
+    void coalescedConnection();
+    void emitWhileConnectingFromOtherThread();
+    void emitWhileDisconnectingFromOtherThread();
     void childEvents();
     void installEventFilter();
     void deleteSelfInSlot();
@@ -1886,6 +1890,99 @@ void tst_QObject::moveToThread()
 }
 
 
+class QueuedCallProducer : public QThread
+{
+    Q_OBJECT
+public:
+    QueuedCallProducer(int id, int count)
+        : id(id), count(count)
+    { }
+
+signals:
+    void call(int id, int sequence);
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < count; ++i)
+            emit call(id, i);
+    }
+
+private:
+    int id;
+    int count;
+};
+
+class QueuedCallReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    QueuedCallReceiver(int producerCount)
+        : next(producerCount, 0), outOfOrder(0), wrongThread(0), received(0)
+    { }
+
+    QVector<int> next;
+    int outOfOrder;
+    int wrongThread;
+    QAtomicInt received;
+
+public slots:
+    void receive(int id, int sequence)
+    {
+        if (thread() != QThread::currentThread())
+            ++wrongThread;
+        if (next.at(id) != sequence)
+            ++outOfOrder;
+        next[id] = sequence + 1;
+        received.ref();
+    }
+
+    void moveTo(QThread *thread)
+    {
+        moveToThread(thread);
+    }
+};
+
+void tst_QObject::moveToThreadWhileReceivingQueuedCalls()
+{
+    const int producerCount = 4;
+    const int callsPerProducer = 5000;
+
+    QueuedCallReceiver receiver(producerCount);
+    QList<QueuedCallProducer *> producers;
+    for (int i = 0; i < producerCount; ++i) {
+        QueuedCallProducer *producer = new QueuedCallProducer(i, callsPerProducer);
+        connect(producer, &QueuedCallProducer::call,
+                &receiver, &QueuedCallReceiver::receive, Qt::QueuedConnection);
+        producers << producer;
+    }
+
+    MoveToThreadThread thread;
+    thread.start();
+    foreach (QueuedCallProducer *producer, producers)
+        producer->start();
+
+    // bounce the receiver between the threads while the calls are coming in;
+    // none may get lost, be delivered in the wrong thread or overtake another
+    for (int i = 0; i < 50; ++i) {
+        receiver.moveToThread(&thread);
+        QVERIFY(QMetaObject::invokeMethod(&receiver, "moveTo", Qt::BlockingQueuedConnection,
+                                          Q_ARG(QThread*, QThread::currentThread())));
+        QCOMPARE(receiver.thread(), QThread::currentThread());
+        QCoreApplication::processEvents();
+    }
+
+    foreach (QueuedCallProducer *producer, producers)
+        QVERIFY(producer->wait(30000));
+    QTRY_COMPARE(receiver.received.load(), producerCount * callsPerProducer);
+    QCOMPARE(receiver.outOfOrder, 0);
+    QCOMPARE(receiver.wrongThread, 0);
+
+    thread.quit();
+    QVERIFY(thread.wait(10000));
+    qDeleteAll(producers);
+}
+
 void tst_QObject::property()
 {
     PropertyObject object;
@@ -3050,6 +3147,201 @@ void tst_QObject::blockingQueuedConnection()
     }
 }
 
+class CoalescedReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    CoalescedReceiver()
+        : calls(0), last(-1), outOfOrder(0)
+    { }
+
+    int calls;
+    int last;
+    int outOfOrder;
+
+public slots:
+    void receive(int, int value)
+    {
+        if (value <= last)
+            ++outOfOrder;
+        last = value;
+        ++calls;
+    }
+};
+
+void tst_QObject::coalescedConnection()
+{
+    {
+        // emissions made before the event loop runs result in one call,
+        // with the latest arguments
+        QueuedCallProducer sender(0, 0);
+        CoalescedReceiver receiver;
+        QVERIFY(connect(&sender, &QueuedCallProducer::call,
+                        &receiver, &CoalescedReceiver::receive, Qt::CoalescedConnection));
+        for (int i = 0; i < 100; ++i)
+            emit sender.call(0, i);
+        QCOMPARE(receiver.calls, 0);
+        QCoreApplication::processEvents();
+        QCOMPARE(receiver.calls, 1);
+        QCOMPARE(receiver.last, 99);
+
+        // once it has been delivered, the next emission queues a new call
+        emit sender.call(0, 100);
+        QCoreApplication::processEvents();
+        QCOMPARE(receiver.calls, 2);
+        QCOMPARE(receiver.last, 100);
+    }
+
+    {
+        // string-based connection; the receiver is deleted with a call pending
+        QueuedCallProducer sender(0, 0);
+        CoalescedReceiver *receiver = new CoalescedReceiver;
+        QVERIFY(connect(&sender, SIGNAL(call(int,int)),
+                        receiver, SLOT(receive(int,int)), Qt::CoalescedConnection));
+        emit sender.call(0, 1);
+        emit sender.call(0, 2);
+        delete receiver;
+        emit sender.call(0, 3);
+        QCoreApplication::processEvents();
+    }
+
+    {
+        // across threads the values arrive in order and the last one is
+        // never lost
+        const int count = 20000;
+        QueuedCallProducer producer(0, count);
+        CoalescedReceiver receiver;
+        connect(&producer, &QueuedCallProducer::call,
+                &receiver, &CoalescedReceiver::receive, Qt::CoalescedConnection);
+        producer.start();
+        QTRY_VERIFY(producer.isFinished());
+        QTRY_COMPARE(receiver.last, count - 1);
+        QCOMPARE(receiver.outOfOrder, 0);
+        QVERIFY(receiver.calls <= count);
+    }
+
+    {
+        // without a connection to coalesce on, it behaves like a queued call
+        CoalescedReceiver receiver;
+        QVERIFY(QMetaObject::invokeMethod(&receiver, "receive", Qt::CoalescedConnection,
+                                          Q_ARG(int, 0), Q_ARG(int, 1)));
+        QVERIFY(QMetaObject::invokeMethod(&receiver, "receive", Qt::CoalescedConnection,
+                                          Q_ARG(int, 0), Q_ARG(int, 2)));
+        QCOMPARE(receiver.calls, 0);
+        QCoreApplication::processEvents();
+        QCOMPARE(receiver.calls, 2);
+        QCOMPARE(receiver.last, 2);
+    }
+}
+
+struct CountedFunctor
+{
+    static QAtomicInt instances;
+    QAtomicInt *calls;
+
+    explicit CountedFunctor(QAtomicInt *calls) : calls(calls) { instances.ref(); }
+    CountedFunctor(const CountedFunctor &other) : calls(other.calls) { instances.ref(); }
+    ~CountedFunctor() { instances.deref(); }
+    void operator()() { calls->ref(); }
+};
+
+QAtomicInt CountedFunctor::instances;
+
+class EmittingThread : public QThread
+{
+public:
+    SenderObject *sender;
+    int count;
+
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < count; ++i)
+            sender->emitSignal1();
+    }
+};
+
+void tst_QObject::emitWhileConnectingFromOtherThread()
+{
+    // emissions do not lock the sender; connections made and broken
+    // meanwhile must not disturb them, nor leak their functors
+    const int count = 20000;
+    SenderObject sender;
+    QAtomicInt permanentCalls;
+    QAtomicInt transientCalls;
+    connect(&sender, &SenderObject::signal1, &sender,
+            CountedFunctor(&permanentCalls), Qt::DirectConnection);
+
+    EmittingThread thread;
+    thread.sender = &sender;
+    thread.count = count;
+    thread.start();
+    while (!thread.isFinished()) {
+        QMetaObject::Connection connection =
+            connect(&sender, &SenderObject::signal1, &sender,
+                    CountedFunctor(&transientCalls), Qt::DirectConnection);
+        QVERIFY(connection);
+        QVERIFY(QObject::disconnect(connection));
+    }
+    QVERIFY(thread.wait());
+
+    QCOMPARE(permanentCalls.load(), count);
+    QCOMPARE(CountedFunctor::instances.load(), 1);
+}
+
+class EmitUntilStoppedThread : public QThread
+{
+public:
+    SenderObject *sender;
+    QAtomicInt stop;
+    int emitted;
+
+    void run() Q_DECL_OVERRIDE
+    {
+        emitted = 0;
+        while (!stop.loadAcquire()) {
+            sender->emitSignal1();
+            ++emitted;
+        }
+    }
+};
+
+void tst_QObject::emitWhileDisconnectingFromOtherThread()
+{
+    // emissions read the receivers of the connections without locking;
+    // receivers disconnected or destroyed meanwhile must not be called
+    SenderObject sender;
+    ReceiverObject permanent;
+    permanent.reset();
+    ReceiverObject transient;
+    transient.reset();
+    connect(&sender, &SenderObject::signal1, &permanent, &ReceiverObject::slot1,
+            Qt::DirectConnection);
+
+    EmitUntilStoppedThread thread;
+    thread.sender = &sender;
+    thread.start();
+    for (int i = 0; i < 500; ++i) {
+        QVERIFY(connect(&sender, &SenderObject::signal1, &transient, &ReceiverObject::slot1,
+                        Qt::DirectConnection));
+        QVERIFY(QObject::disconnect(&sender, &SenderObject::signal1,
+                                    &transient, &ReceiverObject::slot1));
+
+        ReceiverObject *destroyed = new ReceiverObject;
+        destroyed->reset();
+        connect(&sender, &SenderObject::signal1, destroyed, &ReceiverObject::slot1,
+                Qt::QueuedConnection);
+        QThread::yieldCurrentThread();
+        delete destroyed;
+    }
+    thread.stop.storeRelease(1);
+    QVERIFY(thread.wait());
+    QCOMPARE(permanent.count_slot1, thread.emitted);
+
+    // the calls queued to the destroyed receivers were removed with them
+    QCoreApplication::processEvents();
+    QCOMPARE(permanent.count_slot1, thread.emitted);
+}
+
 class EventSpy : public QObject
 {
     Q_OBJECT
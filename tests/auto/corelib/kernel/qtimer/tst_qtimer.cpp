@@ -73,6 +73,7 @@ private slots:
     void recurseOnTimeoutAndStopTimer();
     void singleShotToFunctors();
     void crossThreadSingleShotToFunctor();
+    void timerOrder();
 
     void dontBlockEvents();
     void postedEventsShouldNotStarveTimers();
@@ -901,5 +902,54 @@ void tst_QTimer::crossThreadSingleShotToFunctor()
     delete o;
 }
 
+class TimerOrderObject : public QObject
+{
+public:
+    QVector<int> timerIds;
+    QVector<int> fired;
+
+    void timerEvent(QTimerEvent *te) Q_DECL_OVERRIDE
+    {
+        killTimer(te->timerId());
+        fired.append(te->timerId());
+    }
+};
+
+void tst_QTimer::timerOrder()
+{
+    // Timers must fire by timeout, and in the order they were started when
+    // their timeouts are equal, whichever slot of the timer wheel they start
+    // out in. The intervals are 5 ms apart so that the time spent starting
+    // them does not reorder them.
+    TimerOrderObject object;
+    QVector<int> expected;
+    QElapsedTimer elapsed;
+    elapsed.start();
+    for (int i = 0; i < 244; ++i)
+        object.timerIds.append(object.startTimer(((i * 37) % 61) * 5, Qt::PreciseTimer));
+    if (elapsed.elapsed() >= 5)
+        QSKIP("Starting the timers took too long");
+
+    // stop every fourth timer
+    for (int i = 0; i < object.timerIds.count(); i += 4)
+        object.killTimer(object.timerIds.at(i));
+
+    for (int interval = 0; interval < 61; ++interval) {
+        for (int i = 0; i < object.timerIds.count(); ++i) {
+            if (i % 4 && (i * 37) % 61 == interval)
+                expected.append(object.timerIds.at(i));
+        }
+    }
+
+    // a long timer cascades through the upper levels of the wheel
+    QTimer longTimer;
+    longTimer.setTimerType(Qt::PreciseTimer);
+    longTimer.start(5000000);
+
+    QTRY_COMPARE(object.fired.count(), expected.count());
+    QCOMPARE(object.fired, expected);
+    QVERIFY(longTimer.remainingTime() > 5000000 - 5000);
+}
+
 QTEST_MAIN(tst_QTimer)
 #include "tst_qtimer.moc"
@@ -95,6 +95,7 @@ private slots:
     void cancel();
     void waitForDoneTimeout();
     void destroyingWaitsForTasksToFinish();
+    void startFromTaskAndWait();
     void stressTest();
 
 private:
@@ -1041,6 +1042,63 @@ void tst_QThreadPool::destroyingWaitsForTasksToFinish()
     }
 }
 
+void tst_QThreadPool::startFromTaskAndWait()
+{
+    // A task that starts another one and waits for it must get a second
+    // thread while the pool has room for one, even when the pool is busy.
+    class InnerTask : public QRunnable
+    {
+    public:
+        QSemaphore *done;
+        InnerTask(QSemaphore *done) : done(done) { }
+        void run() Q_DECL_OVERRIDE { done->release(); }
+    };
+
+    class OuterTask : public QRunnable
+    {
+    public:
+        QThreadPool *pool;
+        QAtomicInt *failures;
+        OuterTask(QThreadPool *pool, QAtomicInt *failures) : pool(pool), failures(failures) { }
+        void run() Q_DECL_OVERRIDE
+        {
+            QSemaphore done;
+            pool->start(new InnerTask(&done));
+            if (!done.tryAcquire(1, 10000))
+                failures->ref();
+        }
+    };
+
+    // keeps the pool mutex contended
+    class Poller : public QThread
+    {
+    public:
+        QThreadPool *pool;
+        QAtomicInt stop;
+        Poller(QThreadPool *pool) : pool(pool) { }
+        void run() Q_DECL_OVERRIDE
+        {
+            while (!stop.load())
+                pool->activeThreadCount();
+        }
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(2);
+    Poller poller(&pool);
+    poller.start();
+
+    QAtomicInt failures;
+    for (int i = 0; i < 200; ++i) {
+        pool.start(new OuterTask(&pool, &failures));
+        pool.waitForDone();
+    }
+
+    poller.stop.store(1);
+    poller.wait();
+    QCOMPARE(failures.load(), 0);
+}
+
 void tst_QThreadPool::stressTest()
 {
     class Task : public QRunnable
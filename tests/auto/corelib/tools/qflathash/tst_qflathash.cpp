@@ -0,0 +1,386 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QFlatHash>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+#include <algorithm>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void empty();
+    void insertValue();
+    void insertValueFromSelf();
+    void operatorBrackets();
+    void removeAndTake();
+    void erase();
+    void iterate();
+    void implicitSharing();
+    void reserveAndSqueeze();
+    void complexType();
+    void badHash();
+    void equality();
+    void initializerList();
+    void randomOperations();
+};
+
+struct Counted
+{
+    Counted(int v = 0) : value(QString::number(v)) { ++count; }
+    Counted(const Counted &o) : value(o.value) { ++count; }
+    ~Counted() { --count; }
+    Counted &operator=(const Counted &o) { value = o.value; return *this; }
+    bool operator==(const Counted &o) const { return value == o.value; }
+
+    QString value;
+    static int count;
+};
+int Counted::count = 0;
+
+// every key collides
+struct BadKey
+{
+    int v;
+    bool operator==(const BadKey &o) const { return v == o.v; }
+};
+uint qHash(const BadKey &, uint seed = 0) { return seed; }
+
+void tst_QFlatHash::empty()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.size(), 0);
+    QVERIFY(!hash.contains(1));
+    QCOMPARE(hash.value(1), 0);
+    QCOMPARE(hash.value(1, 42), 42);
+    QCOMPARE(hash.remove(1), 0);
+    QCOMPARE(hash.take(1), 0);
+    QVERIFY(hash.constBegin() == hash.constEnd());
+    QVERIFY(hash.constFind(1) == hash.constEnd());
+    QVERIFY(hash.keys().isEmpty());
+
+    const QFlatHash<int, int> &constHash = hash;
+    QCOMPARE(constHash[1], 0);
+    QVERIFY(constHash.isEmpty());
+}
+
+void tst_QFlatHash::insertValue()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i * 2);
+    QCOMPARE(hash.size(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(hash.contains(i));
+        QCOMPARE(hash.value(i), i * 2);
+    }
+    QVERIFY(!hash.contains(1000));
+    QVERIFY(!hash.contains(-1));
+
+    QFlatHash<int, int>::iterator it = hash.insert(7, 70);
+    QCOMPARE(hash.size(), 1000);
+    QCOMPARE(it.key(), 7);
+    QCOMPARE(it.value(), 70);
+    QCOMPARE(hash.value(7), 70);
+
+    it = hash.insert(5000, 1);
+    QCOMPARE(it.key(), 5000);
+    QCOMPARE(*it, 1);
+    QVERIFY(hash.find(5000) == it);
+}
+
+void tst_QFlatHash::insertValueFromSelf()
+{
+    // the value is read from the block that growing the hash frees
+    const QString expected = QStringLiteral("a value long enough to be allocated");
+    QFlatHash<int, QString> hash;
+    hash.insert(0, expected);
+    for (int i = 1; i < 100; ++i) {
+        QFlatHash<int, QString>::iterator it = hash.insert(i, hash.constBegin().value());
+        QCOMPARE(it.key(), i);
+        QCOMPARE(it.value(), expected);
+    }
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.value(i), expected);
+
+    // same when the overflow area grows
+    QFlatHash<BadKey, QString> badHash;
+    const BadKey first = { 0 };
+    badHash.insert(first, expected);
+    for (int i = 1; i < 100; ++i) {
+        const BadKey k = { i };
+        QFlatHash<BadKey, QString>::iterator it = badHash.insert(k, badHash.constBegin().value());
+        QCOMPARE(it.key().v, i);
+        QCOMPARE(it.value(), expected);
+    }
+    for (int i = 0; i < 100; ++i) {
+        const BadKey k = { i };
+        QCOMPARE(badHash.value(k), expected);
+    }
+}
+
+void tst_QFlatHash::operatorBrackets()
+{
+    QFlatHash<QString, int> hash;
+    hash["one"] = 1;
+    hash["two"] = 2;
+    ++hash["two"];
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value("two"), 3);
+    QCOMPARE(hash["three"], 0);
+    QCOMPARE(hash.size(), 3);
+}
+
+void tst_QFlatHash::removeAndTake()
+{
+    QFlatHash<int, QString> hash;
+    for (int i = 0; i < 500; ++i)
+        hash.insert(i, QString::number(i));
+
+    for (int i = 0; i < 500; i += 2)
+        QCOMPARE(hash.remove(i), 1);
+    QCOMPARE(hash.remove(0), 0);
+    QCOMPARE(hash.size(), 250);
+    for (int i = 0; i < 500; ++i)
+        QCOMPARE(hash.contains(i), bool(i & 1));
+
+    QCOMPARE(hash.take(1), QString("1"));
+    QCOMPARE(hash.take(1), QString());
+    QCOMPARE(hash.size(), 249);
+
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QVERIFY(!hash.contains(3));
+}
+
+void tst_QFlatHash::erase()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+
+    int visited = 0;
+    QFlatHash<int, int>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        ++visited;
+        if (it.value() % 3 == 0)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(visited, 1000);
+    QCOMPARE(hash.size(), 666);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(hash.contains(i), i % 3 != 0);
+}
+
+void tst_QFlatHash::iterate()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+
+    QSet<int> seen;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        QCOMPARE(it.key(), it.value());
+        seen.insert(it.key());
+    }
+    QCOMPARE(seen.size(), 100);
+
+    for (QFlatHash<int, int>::iterator it = hash.begin(); it != hash.end(); ++it)
+        *it += 1;
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.value(i), i + 1);
+
+    QList<int> keys = hash.keys();
+    std::sort(keys.begin(), keys.end());
+    QCOMPARE(keys.size(), 100);
+    QCOMPARE(keys.first(), 0);
+    QCOMPARE(keys.last(), 99);
+    QCOMPARE(hash.values().size(), 100);
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, QString> hash1;
+    hash1.insert(1, "one");
+    hash1.insert(2, "two");
+
+    QFlatHash<int, QString> hash2 = hash1;
+    QVERIFY(hash1.isSharedWith(hash2));
+    QCOMPARE(hash2.value(1), QString("one"));
+
+    hash2.insert(3, "three");
+    QVERIFY(!hash1.isSharedWith(hash2));
+    QCOMPARE(hash1.size(), 2);
+    QCOMPARE(hash2.size(), 3);
+    QVERIFY(!hash1.contains(3));
+
+    QFlatHash<int, QString> hash3 = hash1;
+    hash3.remove(1);
+    QCOMPARE(hash1.value(1), QString("one"));
+    QVERIFY(!hash3.contains(1));
+
+    QFlatHash<int, QString> hash4 = hash1;
+    QFlatHash<int, QString>::iterator it = hash4.begin();
+    QVERIFY(!hash1.isSharedWith(hash4));
+    const QString original = it.value();
+    *it = "changed";
+    QCOMPARE(hash1.value(it.key()), original);
+    QCOMPARE(hash4.value(it.key()), QString("changed"));
+
+    QFlatHash<int, QString> moved = std::move(hash2);
+    QCOMPARE(moved.size(), 3);
+    QVERIFY(hash2.isEmpty());
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    const int capacity = hash.capacity();
+    QVERIFY(capacity >= 1000);
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QVERIFY(hash.capacity() >= 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i), i);
+}
+
+void tst_QFlatHash::complexType()
+{
+    {
+        QFlatHash<int, Counted> hash;
+        for (int i = 0; i < 200; ++i)
+            hash.insert(i, Counted(i));
+        QCOMPARE(Counted::count, 200);
+        QFlatHash<int, Counted> copy = hash;
+        copy.insert(1000, Counted(1000));
+        QCOMPARE(Counted::count, 401);
+        for (int i = 0; i < 200; i += 2)
+            hash.remove(i);
+        QCOMPARE(Counted::count, 301);
+        QCOMPARE(hash.value(1).value, QString::number(1));
+    }
+    QCOMPARE(Counted::count, 0);
+}
+
+void tst_QFlatHash::badHash()
+{
+    QFlatHash<BadKey, int> hash;
+    for (int i = 0; i < 300; ++i) {
+        BadKey k = { i };
+        hash.insert(k, i);
+    }
+    QCOMPARE(hash.size(), 300);
+    for (int i = 0; i < 300; ++i) {
+        BadKey k = { i };
+        QCOMPARE(hash.value(k, -1), i);
+    }
+    for (int i = 0; i < 300; i += 2) {
+        BadKey k = { i };
+        QCOMPARE(hash.remove(k), 1);
+    }
+    for (int i = 0; i < 300; ++i) {
+        BadKey k = { i };
+        QCOMPARE(hash.contains(k), bool(i & 1));
+    }
+}
+
+void tst_QFlatHash::equality()
+{
+    QFlatHash<int, int> hash1, hash2;
+    QVERIFY(hash1 == hash2);
+    for (int i = 0; i < 50; ++i) {
+        hash1.insert(i, i);
+        hash2.insert(49 - i, 49 - i);
+    }
+    QVERIFY(hash1 == hash2);
+    hash2.insert(3, 4);
+    QVERIFY(hash1 != hash2);
+    hash2.insert(3, 3);
+    hash2.insert(100, 100);
+    QVERIFY(hash1 != hash2);
+}
+
+void tst_QFlatHash::initializerList()
+{
+#ifdef Q_COMPILER_INITIALIZER_LISTS
+    QFlatHash<int, QString> hash = { { 1, "bar" }, { 1, "hello" }, { 2, "initializer_list" } };
+    QCOMPARE(hash.count(), 2);
+    QCOMPARE(hash[1], QString("hello"));
+    QCOMPARE(hash[2], QString("initializer_list"));
+#else
+    QSKIP("Compiler doesn't support initializer lists");
+#endif
+}
+
+void tst_QFlatHash::randomOperations()
+{
+    QFlatHash<int, int> flat;
+    QHash<int, int> reference;
+    qsrand(1234);
+    for (int i = 0; i < 20000; ++i) {
+        const int key = qrand() % 2000;
+        switch (qrand() % 4) {
+        case 0:
+        case 1:
+            flat.insert(key, i);
+            reference.insert(key, i);
+            break;
+        case 2:
+            QCOMPARE(flat.remove(key), reference.remove(key));
+            break;
+        case 3:
+            QCOMPARE(flat.value(key, -1), reference.value(key, -1));
+            break;
+        }
+    }
+    QCOMPARE(flat.size(), reference.size());
+    for (QHash<int, int>::const_iterator it = reference.constBegin(); it != reference.constEnd(); ++it)
+        QCOMPARE(flat.value(it.key(), -1), it.value());
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
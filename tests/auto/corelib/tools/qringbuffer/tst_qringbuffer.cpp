@@ -44,6 +44,7 @@ private slots:
     void readPointerAtPositionEmptyRead();
     void readPointerAtPositionWithHead();
     void readPointerAtPositionReadTooMuch();
+    void readPointers();
     void sizeWhenReservedAndChopped();
     void sizeWhenReserved();
     void free();
@@ -131,6 +132,29 @@ void tst_QRingBuffer::readPointerAtPositionWithHead()
     QCOMPARE(length, Q_INT64_C(5));
 }
 
+void tst_QRingBuffer::readPointers()
+{
+    QRingBuffer ringBuffer;
+    const char *data[4];
+    qint64 lengths[4];
+    QCOMPARE(ringBuffer.readPointers(data, lengths, 4), 0);
+
+    // three blocks, the first one partially consumed
+    memcpy(ringBuffer.reserve(4), "0123", 4);
+    ringBuffer.append(QByteArray("45678", 5));
+    ringBuffer.append(QByteArray("9", 1));
+    ringBuffer.free(3);
+
+    QCOMPARE(ringBuffer.readPointers(data, lengths, 4), 3);
+    QCOMPARE(QByteArray(data[0], lengths[0]), QByteArray("3"));
+    QCOMPARE(QByteArray(data[1], lengths[1]), QByteArray("45678"));
+    QCOMPARE(QByteArray(data[2], lengths[2]), QByteArray("9"));
+
+    // limited by maxCount
+    QCOMPARE(ringBuffer.readPointers(data, lengths, 2), 2);
+    QCOMPARE(lengths[0] + lengths[1], Q_INT64_C(6));
+}
+
 void tst_QRingBuffer::readPointerAtPositionEmptyRead()
 {
     QRingBuffer ringBuffer;
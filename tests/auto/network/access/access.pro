@@ -8,6 +8,7 @@ SUBDIRS=\
    qhttpnetworkconnection \
    qnetworkreply \
    spdy \
+   http2 \
    qnetworkcachemetadata \
    qftp \
    qhttpnetworkreply \
@@ -17,4 +18,5 @@ SUBDIRS=\
           qhttpnetworkconnection \
           qhttpnetworkreply \
           qftp \
+          http2 \
 
@@ -0,0 +1,6 @@
+CONFIG += testcase
+TARGET = tst_http2
+HEADERS += http2srv.h
+SOURCES += tst_http2.cpp http2srv.cpp
+
+QT = core core-private network network-private testlib
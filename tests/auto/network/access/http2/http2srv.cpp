@@ -0,0 +1,413 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "http2srv.h"
+
+#include <QtNetwork/qtcpsocket.h>
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qendian.h>
+
+namespace {
+
+const char clientPreface[] = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+const int clientPrefaceLength = sizeof clientPreface - 1;
+const int frameHeaderSize = 9;
+const int maxFrameSize = 16384;
+const qint32 defaultWindowSize = 65535;
+
+enum {
+    FrameType_DATA = 0x0,
+    FrameType_HEADERS = 0x1,
+    FrameType_PRIORITY = 0x2,
+    FrameType_RST_STREAM = 0x3,
+    FrameType_SETTINGS = 0x4,
+    FrameType_PUSH_PROMISE = 0x5,
+    FrameType_PING = 0x6,
+    FrameType_GOAWAY = 0x7,
+    FrameType_WINDOW_UPDATE = 0x8,
+    FrameType_CONTINUATION = 0x9
+};
+
+enum {
+    FrameFlag_END_STREAM = 0x1,
+    FrameFlag_ACK = 0x1,
+    FrameFlag_END_HEADERS = 0x4,
+    FrameFlag_PADDED = 0x8,
+    FrameFlag_PRIORITY = 0x20
+};
+
+enum {
+    SETTINGS_MAX_CONCURRENT_STREAMS = 0x3,
+    SETTINGS_INITIAL_WINDOW_SIZE = 0x4
+};
+
+void appendSetting(QByteArray *payload, quint16 identifier, quint32 value)
+{
+    char setting[6];
+    qToBigEndian<quint16>(identifier, reinterpret_cast<uchar *>(setting));
+    qToBigEndian<quint32>(value, reinterpret_cast<uchar *>(setting + 2));
+    payload->append(setting, sizeof setting);
+}
+
+} // unnamed namespace
+
+Http2Server::Http2Server(QObject *parent)
+    : QTcpServer(parent),
+      connectionCount(0),
+      maxActiveStreams(0),
+      windowUpdatesReceived(0),
+      socket(0),
+      prefaceReceived(false),
+      continuedStreamID(0),
+      continuedEndStream(false),
+      maxConcurrentStreams(0),
+      initialWindowSize(0),
+      clientInitialWindowSize(defaultWindowSize),
+      connectionSendWindow(defaultWindowSize),
+      connectionReceiveWindow(defaultWindowSize)
+{
+}
+
+QByteArray Http2Server::responseBody(int size)
+{
+    QByteArray body(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i)
+        body[i] = char('a' + i % 26);
+    return body;
+}
+
+void Http2Server::incomingConnection(qintptr socketDescriptor)
+{
+    ++connectionCount;
+    if (socket) {
+        // the client is expected to multiplex everything over one connection
+        QTcpSocket *extra = new QTcpSocket(this);
+        extra->setSocketDescriptor(socketDescriptor);
+        extra->close();
+        return;
+    }
+
+    socket = new QTcpSocket(this);
+    socket->setSocketDescriptor(socketDescriptor);
+    connect(socket, SIGNAL(readyRead()), this, SLOT(readyRead()));
+
+    QByteArray settings;
+    if (maxConcurrentStreams)
+        appendSetting(&settings, SETTINGS_MAX_CONCURRENT_STREAMS, maxConcurrentStreams);
+    if (initialWindowSize)
+        appendSetting(&settings, SETTINGS_INITIAL_WINDOW_SIZE, initialWindowSize);
+    sendFrame(FrameType_SETTINGS, 0, 0, settings);
+}
+
+void Http2Server::readyRead()
+{
+    buffer += socket->readAll();
+
+    if (!prefaceReceived) {
+        if (buffer.size() < clientPrefaceLength)
+            return;
+        if (!buffer.startsWith(clientPreface))
+            return protocolError("invalid client connection preface");
+        buffer.remove(0, clientPrefaceLength);
+        prefaceReceived = true;
+    }
+
+    int offset = 0;
+    while (buffer.size() - offset >= frameHeaderSize) {
+        const uchar *header = reinterpret_cast<const uchar *>(buffer.constData() + offset);
+        const quint32 length = (quint32(header[0]) << 16) | (quint32(header[1]) << 8) | header[2];
+        if (length > quint32(maxFrameSize))
+            return protocolError("frame larger than SETTINGS_MAX_FRAME_SIZE");
+        if (buffer.size() - offset < frameHeaderSize + int(length))
+            break;
+        const quint32 streamID = qFromBigEndian<quint32>(header + 5) & 0x7fffffff;
+        const QByteArray payload = buffer.mid(offset + frameHeaderSize, length);
+        offset += frameHeaderSize + length;
+        if (!handleFrame(header[3], header[4], streamID, payload))
+            return;
+    }
+    buffer.remove(0, offset);
+
+    // answering only once everything that arrived has been read lets the
+    // streams the client opened in one go pile up
+    sendResponses();
+}
+
+bool Http2Server::handleFrame(quint8 type, quint8 flags, quint32 streamID, const QByteArray &payload)
+{
+    if (continuedStreamID && type != FrameType_CONTINUATION) {
+        protocolError("header block interrupted");
+        return false;
+    }
+
+    switch (type) {
+    case FrameType_DATA: {
+        QHash<quint32, Stream>::iterator it = streams.find(streamID);
+        if (it == streams.end() || it->requestComplete) {
+            protocolError("DATA on a stream that is not open");
+            return false;
+        }
+        // flow control covers the whole payload, padding included
+        const qint32 length = payload.size();
+        if (length > it->receiveWindow || length > connectionReceiveWindow) {
+            protocolError("DATA exceeds the flow control window");
+            return false;
+        }
+        it->receiveWindow -= length;
+        connectionReceiveWindow -= length;
+
+        int padding = 0;
+        int dataOffset = 0;
+        if (flags & FrameFlag_PADDED) {
+            padding = quint8(payload.at(0));
+            dataOffset = 1;
+        }
+        it->requestBody += payload.mid(dataOffset, payload.size() - dataOffset - padding);
+
+        // hand the window back right away; a small initial window then
+        // makes the client wait for every update
+        if (length) {
+            sendWindowUpdate(0, length);
+            connectionReceiveWindow += length;
+            if (!(flags & FrameFlag_END_STREAM)) {
+                sendWindowUpdate(streamID, length);
+                it->receiveWindow += length;
+            }
+        }
+        if (flags & FrameFlag_END_STREAM)
+            requestComplete(streamID);
+        return true;
+    }
+    case FrameType_HEADERS: {
+        if (!(streamID & 1) || streams.contains(streamID)) {
+            protocolError("HEADERS on an invalid stream");
+            return false;
+        }
+        int start = 0;
+        int padding = 0;
+        if (flags & FrameFlag_PADDED) {
+            padding = quint8(payload.at(0));
+            start = 1;
+        }
+        if (flags & FrameFlag_PRIORITY)
+            start += 5;
+
+        Stream stream;
+        stream.sendWindow = clientInitialWindowSize;
+        stream.receiveWindow = initialWindowSize ? qint32(initialWindowSize) : defaultWindowSize;
+        stream.responseOffset = 0;
+        stream.requestComplete = false;
+        stream.headersSent = false;
+        streams.insert(streamID, stream);
+
+        const int active = streams.size();
+        maxActiveStreams = qMax(maxActiveStreams, active);
+        if (maxConcurrentStreams && quint32(active) > maxConcurrentStreams) {
+            protocolError("SETTINGS_MAX_CONCURRENT_STREAMS exceeded");
+            return false;
+        }
+
+        headerBlock = payload.mid(start, payload.size() - start - padding);
+        if (flags & FrameFlag_END_HEADERS) {
+            handleHeaderBlock(streamID, flags & FrameFlag_END_STREAM);
+        } else {
+            continuedStreamID = streamID;
+            continuedEndStream = flags & FrameFlag_END_STREAM;
+        }
+        return violation.isEmpty();
+    }
+    case FrameType_CONTINUATION:
+        if (streamID != continuedStreamID) {
+            protocolError("unexpected CONTINUATION");
+            return false;
+        }
+        headerBlock += payload;
+        if (flags & FrameFlag_END_HEADERS) {
+            continuedStreamID = 0;
+            handleHeaderBlock(streamID, continuedEndStream);
+        }
+        return violation.isEmpty();
+    case FrameType_RST_STREAM:
+        streams.remove(streamID);
+        return true;
+    case FrameType_SETTINGS:
+        if (flags & FrameFlag_ACK)
+            return true;
+        for (int i = 0; i + 6 <= payload.size(); i += 6) {
+            const uchar *setting = reinterpret_cast<const uchar *>(payload.constData() + i);
+            if (qFromBigEndian<quint16>(setting) != SETTINGS_INITIAL_WINDOW_SIZE)
+                continue;
+            const qint32 newSize = qint32(qFromBigEndian<quint32>(setting + 2));
+            const qint32 delta = newSize - clientInitialWindowSize;
+            clientInitialWindowSize = newSize;
+            for (QHash<quint32, Stream>::iterator it = streams.begin(); it != streams.end(); ++it)
+                it->sendWindow += delta;
+        }
+        sendFrame(FrameType_SETTINGS, FrameFlag_ACK, 0, QByteArray());
+        return true;
+    case FrameType_PING:
+        if (!(flags & FrameFlag_ACK))
+            sendFrame(FrameType_PING, FrameFlag_ACK, 0, payload);
+        return true;
+    case FrameType_WINDOW_UPDATE: {
+        if (payload.size() != 4) {
+            protocolError("invalid WINDOW_UPDATE");
+            return false;
+        }
+        ++windowUpdatesReceived;
+        const qint32 increment = qint32(qFromBigEndian<quint32>(
+                reinterpret_cast<const uchar *>(payload.constData())) & 0x7fffffff);
+        if (!streamID) {
+            connectionSendWindow += increment;
+        } else {
+            QHash<quint32, Stream>::iterator it = streams.find(streamID);
+            if (it != streams.end())
+                it->sendWindow += increment;
+        }
+        return true;
+    }
+    case FrameType_PUSH_PROMISE:
+        protocolError("PUSH_PROMISE sent by the client");
+        return false;
+    default:
+        // PRIORITY, GOAWAY and unknown frames
+        return true;
+    }
+}
+
+void Http2Server::handleHeaderBlock(quint32 streamID, bool endStream)
+{
+    Stream &stream = streams[streamID];
+    if (!decoder.decode(headerBlock, &stream.requestHeaders))
+        return protocolError("invalid HPACK header block");
+    headerBlock.clear();
+    if (endStream)
+        requestComplete(streamID);
+}
+
+void Http2Server::requestComplete(quint32 streamID)
+{
+    Stream &stream = streams[streamID];
+    stream.requestComplete = true;
+
+    QByteArray method;
+    QByteArray path;
+    for (int i = 0; i < stream.requestHeaders.size(); ++i) {
+        const QHPackHeaderField &field = stream.requestHeaders.at(i);
+        if (field.first == ":method")
+            method = field.second;
+        else if (field.first == ":path")
+            path = field.second;
+    }
+
+    if (method == "POST")
+        stream.responseBody = QCryptographicHash::hash(stream.requestBody, QCryptographicHash::Sha1).toHex();
+    else
+        stream.responseBody = responseBody(path.mid(1).toInt());
+}
+
+void Http2Server::sendResponses()
+{
+    if (!violation.isEmpty())
+        return;
+
+    QHash<quint32, Stream>::iterator it = streams.begin();
+    while (it != streams.end()) {
+        if (!it->requestComplete) {
+            ++it;
+            continue;
+        }
+
+        const quint32 streamID = it.key();
+        if (!it->headersSent) {
+            QHPackHeaderList headers;
+            headers << qMakePair(QByteArray(":status"), QByteArray("200"))
+                    << qMakePair(QByteArray("content-length"), QByteArray::number(it->responseBody.size()));
+            sendFrame(FrameType_HEADERS,
+                      FrameFlag_END_HEADERS | (it->responseBody.isEmpty() ? FrameFlag_END_STREAM : 0),
+                      streamID, encoder.encode(headers));
+            it->headersSent = true;
+        }
+
+        while (it->responseOffset < it->responseBody.size()) {
+            const int chunk = qMin(qMin(maxFrameSize, it->responseBody.size() - it->responseOffset),
+                                   qMin(it->sendWindow, connectionSendWindow));
+            if (chunk <= 0)
+                break;
+            it->responseOffset += chunk;
+            sendFrame(FrameType_DATA,
+                      it->responseOffset == it->responseBody.size() ? FrameFlag_END_STREAM : 0,
+                      streamID, it->responseBody.mid(it->responseOffset - chunk, chunk));
+            it->sendWindow -= chunk;
+            connectionSendWindow -= chunk;
+        }
+
+        if (it->responseOffset == it->responseBody.size())
+            it = streams.erase(it);
+        else
+            ++it;
+    }
+}
+
+void Http2Server::sendFrame(quint8 type, quint8 flags, quint32 streamID, const QByteArray &payload)
+{
+    uchar header[frameHeaderSize];
+    header[0] = uchar(payload.size() >> 16);
+    header[1] = uchar(payload.size() >> 8);
+    header[2] = uchar(payload.size());
+    header[3] = type;
+    header[4] = flags;
+    qToBigEndian<quint32>(streamID, header + 5);
+    socket->write(reinterpret_cast<const char *>(header), frameHeaderSize);
+    socket->write(payload);
+}
+
+void Http2Server::sendWindowUpdate(quint32 streamID, quint32 increment)
+{
+    uchar payload[4];
+    qToBigEndian<quint32>(increment, payload);
+    sendFrame(FrameType_WINDOW_UPDATE, 0, streamID,
+              QByteArray(reinterpret_cast<const char *>(payload), sizeof payload));
+}
+
+void Http2Server::protocolError(const char *message)
+{
+    if (violation.isEmpty())
+        violation = message;
+    // GOAWAY with PROTOCOL_ERROR
+    uchar payload[8];
+    qToBigEndian<quint32>(0, payload);
+    qToBigEndian<quint32>(0x1, payload + 4);
+    sendFrame(FrameType_GOAWAY, 0, 0, QByteArray(reinterpret_cast<const char *>(payload), sizeof payload));
+    socket->disconnectFromHost();
+}
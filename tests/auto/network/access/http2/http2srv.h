@@ -0,0 +1,112 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef HTTP2SRV_H
+#define HTTP2SRV_H
+
+#include <QtNetwork/private/qhpack_p.h>
+
+#include <QtNetwork/qtcpserver.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+
+QT_BEGIN_NAMESPACE
+class QTcpSocket;
+QT_END_NAMESPACE
+
+// A minimal cleartext HTTP/2 server (prior knowledge, no upgrade) that
+// answers "GET /<n>" with n bytes of data and answers a POST with the SHA-1
+// of the request body. It enforces flow control and the concurrent stream
+// limit it announces, and records any protocol violation by the client.
+class Http2Server : public QTcpServer
+{
+    Q_OBJECT
+public:
+    explicit Http2Server(QObject *parent = 0);
+
+    // 0 means the setting is not sent
+    void setMaxConcurrentStreams(quint32 count) { maxConcurrentStreams = count; }
+    void setInitialWindowSize(quint32 size) { initialWindowSize = size; }
+
+    static QByteArray responseBody(int size);
+
+    int connectionCount;
+    int maxActiveStreams;
+    int windowUpdatesReceived;
+    QByteArray violation;
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) Q_DECL_OVERRIDE;
+
+private slots:
+    void readyRead();
+
+private:
+    struct Stream
+    {
+        QHPackHeaderList requestHeaders;
+        QByteArray requestBody;
+        QByteArray responseBody;
+        qint32 sendWindow;
+        qint32 receiveWindow;
+        int responseOffset;
+        bool requestComplete;
+        bool headersSent;
+    };
+
+    bool handleFrame(quint8 type, quint8 flags, quint32 streamID, const QByteArray &payload);
+    void handleHeaderBlock(quint32 streamID, bool endStream);
+    void requestComplete(quint32 streamID);
+    void sendResponses();
+    void sendFrame(quint8 type, quint8 flags, quint32 streamID, const QByteArray &payload);
+    void sendWindowUpdate(quint32 streamID, quint32 increment);
+    void protocolError(const char *message);
+
+    QTcpSocket *socket;
+    QByteArray buffer;
+    bool prefaceReceived;
+    QHPackEncoder encoder;
+    QHPackDecoder decoder;
+    QHash<quint32, Stream> streams;
+    QByteArray headerBlock;
+    quint32 continuedStreamID;
+    bool continuedEndStream;
+    quint32 maxConcurrentStreams;
+    quint32 initialWindowSize;
+    qint32 clientInitialWindowSize;
+    qint32 connectionSendWindow;
+    qint32 connectionReceiveWindow;
+};
+
+#endif // HTTP2SRV_H
@@ -0,0 +1,338 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkRequest>
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/private/qhpack_p.h>
+
+#include "http2srv.h"
+
+class tst_Http2 : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void hpackHuffman_data();
+    void hpackHuffman();
+    void hpackEncoder();
+    void hpackDecoder();
+    void hpackDecoderErrors_data();
+    void hpackDecoderErrors();
+    void singleRequest();
+    void multipleRequests_data();
+    void multipleRequests();
+    void flowControlClientSide();
+    void flowControlServerSide();
+
+private:
+    QNetworkRequest request(const Http2Server &server, const QString &path) const;
+    bool waitForReplies(const QList<QNetworkReply *> &replies);
+};
+
+static QHPackHeaderField field(const char *name, const char *value)
+{
+    return qMakePair(QByteArray(name), QByteArray(value));
+}
+
+void tst_Http2::hpackHuffman_data()
+{
+    QTest::addColumn<QByteArray>("plain");
+    QTest::addColumn<QByteArray>("encoded");
+
+    // RFC 7541, appendix C.4 and C.6
+    QTest::newRow("authority") << QByteArray("www.example.com")
+                               << QByteArray::fromHex("f1e3c2e5f23a6ba0ab90f4ff");
+    QTest::newRow("no-cache") << QByteArray("no-cache") << QByteArray::fromHex("a8eb10649cbf");
+    QTest::newRow("custom-value") << QByteArray("custom-value")
+                                  << QByteArray::fromHex("25a849e95bb8e8b4bf");
+    QTest::newRow("status") << QByteArray("302") << QByteArray::fromHex("6402");
+    QTest::newRow("date") << QByteArray("Mon, 21 Oct 2013 20:13:21 GMT")
+                          << QByteArray::fromHex("d07abe941054d444a8200595040b8166e082a62d1bff");
+    QTest::newRow("empty") << QByteArray() << QByteArray();
+}
+
+void tst_Http2::hpackHuffman()
+{
+    QFETCH(QByteArray, plain);
+    QFETCH(QByteArray, encoded);
+
+    QCOMPARE(QHPack::huffmanEncode(plain), encoded);
+    QByteArray decoded;
+    QVERIFY(QHPack::huffmanDecode(encoded.constData(), encoded.size(), &decoded));
+    QCOMPARE(decoded, plain);
+
+    // every byte value must survive a round trip
+    QByteArray all(256, Qt::Uninitialized);
+    for (int i = 0; i < 256; ++i)
+        all[i] = char(i);
+    const QByteArray allEncoded = QHPack::huffmanEncode(all);
+    decoded.clear();
+    QVERIFY(QHPack::huffmanDecode(allEncoded.constData(), allEncoded.size(), &decoded));
+    QCOMPARE(decoded, all);
+}
+
+void tst_Http2::hpackEncoder()
+{
+    // RFC 7541, appendix C.4: requests with Huffman coding
+    QHPackEncoder encoder;
+    QHPackHeaderList headers;
+    headers << field(":method", "GET") << field(":scheme", "http")
+            << field(":path", "/") << field(":authority", "www.example.com");
+    QCOMPARE(encoder.encode(headers).toHex(), QByteArray("828684418cf1e3c2e5f23a6ba0ab90f4ff"));
+    QCOMPARE(encoder.table().size(), 57u);
+
+    headers << field("cache-control", "no-cache");
+    QCOMPARE(encoder.encode(headers).toHex(), QByteArray("828684be5886a8eb10649cbf"));
+    QCOMPARE(encoder.table().size(), 110u);
+
+    headers.clear();
+    headers << field(":method", "GET") << field(":scheme", "https")
+            << field(":path", "/index.html") << field(":authority", "www.example.com")
+            << field("custom-key", "custom-value");
+    QCOMPARE(encoder.encode(headers).toHex(),
+             QByteArray("828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"));
+    QCOMPARE(encoder.table().size(), 164u);
+
+    // credentials must never enter the dynamic table
+    headers.clear();
+    headers << field("authorization", "Basic dXNlcjpwYXNz");
+    const QByteArray block = encoder.encode(headers);
+    QCOMPARE(quint8(block.at(0)) & 0xf0, 0x10);
+    QCOMPARE(encoder.table().size(), 164u);
+
+    // a reduced table size is announced at the start of the next block
+    encoder.setMaximumTableSize(0);
+    headers.clear();
+    headers << field(":method", "GET");
+    QCOMPARE(encoder.encode(headers).toHex(), QByteArray("2082"));
+    QCOMPARE(encoder.table().size(), 0u);
+}
+
+void tst_Http2::hpackDecoder()
+{
+    // RFC 7541, appendix C.6: responses with Huffman coding and a 256 octet table
+    QHPackDecoder decoder(256);
+    QHPackHeaderList headers;
+    QVERIFY(decoder.decode(QByteArray::fromHex("488264025885aec3771a4b6196d07abe941054d444a8"
+                                               "200595040b8166e082a62d1bff6e919d29ad171863c7"
+                                               "8f0b97c8e9ae82ae43d3"), &headers));
+    QHPackHeaderList expected;
+    expected << field(":status", "302") << field("cache-control", "private")
+             << field("date", "Mon, 21 Oct 2013 20:13:21 GMT")
+             << field("location", "https://www.example.com");
+    QCOMPARE(headers, expected);
+    QCOMPARE(decoder.table().size(), 222u);
+
+    headers.clear();
+    QVERIFY(decoder.decode(QByteArray::fromHex("4883640effc1c0bf"), &headers));
+    expected.clear();
+    expected << field(":status", "307") << field("cache-control", "private")
+             << field("date", "Mon, 21 Oct 2013 20:13:21 GMT")
+             << field("location", "https://www.example.com");
+    QCOMPARE(headers, expected);
+    QCOMPARE(decoder.table().size(), 222u);
+
+    // RFC 7541, appendix C.3: a request without Huffman coding
+    QHPackDecoder requestDecoder;
+    headers.clear();
+    QVERIFY(requestDecoder.decode(QByteArray::fromHex("828684410f7777772e6578616d706c652e636f6d"),
+                                  &headers));
+    expected.clear();
+    expected << field(":method", "GET") << field(":scheme", "http")
+             << field(":path", "/") << field(":authority", "www.example.com");
+    QCOMPARE(headers, expected);
+    QCOMPARE(requestDecoder.table().size(), 57u);
+}
+
+void tst_Http2::hpackDecoderErrors_data()
+{
+    QTest::addColumn<QByteArray>("block");
+
+    QTest::newRow("index-zero") << QByteArray::fromHex("80");
+    QTest::newRow("index-out-of-range") << QByteArray::fromHex("be");
+    QTest::newRow("truncated-string") << QByteArray::fromHex("4005637573746f");
+    QTest::newRow("integer-overflow") << QByteArray::fromHex("ffffffffffffff7f");
+    QTest::newRow("huffman-padding") << QByteArray::fromHex("4081000161");
+    QTest::newRow("size-update-too-large") << QByteArray::fromHex("3fe21f");
+    QTest::newRow("size-update-after-field") << QByteArray::fromHex("8220");
+}
+
+void tst_Http2::hpackDecoderErrors()
+{
+    QFETCH(QByteArray, block);
+
+    QHPackDecoder decoder;
+    QHPackHeaderList headers;
+    QVERIFY(!decoder.decode(block, &headers));
+}
+
+QNetworkRequest tst_Http2::request(const Http2Server &server, const QString &path) const
+{
+    QNetworkRequest request(QUrl(QStringLiteral("http://127.0.0.1:%1%2")
+                                 .arg(server.serverPort()).arg(path)));
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    return request;
+}
+
+bool tst_Http2::waitForReplies(const QList<QNetworkReply *> &replies)
+{
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < replies.size(); ++i) {
+        while (!replies.at(i)->isFinished()) {
+            if (timer.hasExpired(30000))
+                return false;
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        }
+    }
+    return true;
+}
+
+void tst_Http2::singleRequest()
+{
+    Http2Server server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QNetworkAccessManager manager;
+    QNetworkReply *reply = manager.get(request(server, QStringLiteral("/1000")));
+    QVERIFY(waitForReplies(QList<QNetworkReply *>() << reply));
+
+    QVERIFY2(server.violation.isEmpty(), server.violation.constData());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 200);
+    QVERIFY(reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool());
+    QCOMPARE(reply->header(QNetworkRequest::ContentLengthHeader).toLongLong(), qint64(1000));
+    QCOMPARE(reply->readAll(), Http2Server::responseBody(1000));
+    QCOMPARE(server.connectionCount, 1);
+    delete reply;
+}
+
+void tst_Http2::multipleRequests_data()
+{
+    QTest::addColumn<quint32>("maxConcurrentStreams");
+    QTest::addColumn<int>("requestCount");
+
+    QTest::newRow("default-limit") << 0u << 300;
+    QTest::newRow("limit-10") << 10u << 300;
+    QTest::newRow("limit-1") << 1u << 20;
+}
+
+void tst_Http2::multipleRequests()
+{
+    QFETCH(quint32, maxConcurrentStreams);
+    QFETCH(int, requestCount);
+
+    Http2Server server;
+    server.setMaxConcurrentStreams(maxConcurrentStreams);
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QNetworkAccessManager manager;
+    QList<QNetworkReply *> replies;
+    for (int i = 0; i < requestCount; ++i)
+        replies << manager.get(request(server, QLatin1Char('/') + QString::number(i * 10)));
+    QVERIFY(waitForReplies(replies));
+
+    QVERIFY2(server.violation.isEmpty(), server.violation.constData());
+    QCOMPARE(server.connectionCount, 1);
+    if (maxConcurrentStreams)
+        QVERIFY(server.maxActiveStreams <= int(maxConcurrentStreams));
+    for (int i = 0; i < requestCount; ++i) {
+        QNetworkReply *reply = replies.at(i);
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QVERIFY(reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool());
+        QCOMPARE(reply->readAll(), Http2Server::responseBody(i * 10));
+    }
+    qDeleteAll(replies);
+}
+
+void tst_Http2::flowControlClientSide()
+{
+    // the server allows only a small window per stream, so the upload has to
+    // wait for WINDOW_UPDATE frames
+    Http2Server server;
+    server.setInitialWindowSize(5000);
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QByteArray data(500 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < data.size(); ++i)
+        data[i] = char(i % 251);
+
+    QNetworkAccessManager manager;
+    QList<QNetworkReply *> replies;
+    for (int i = 0; i < 5; ++i) {
+        QNetworkRequest postRequest = request(server, QStringLiteral("/upload"));
+        postRequest.setHeader(QNetworkRequest::ContentTypeHeader, "application/octet-stream");
+        replies << manager.post(postRequest, data.left(data.size() - i * 1000));
+    }
+    QVERIFY(waitForReplies(replies));
+
+    QVERIFY2(server.violation.isEmpty(), server.violation.constData());
+    for (int i = 0; i < replies.size(); ++i) {
+        QCOMPARE(replies.at(i)->error(), QNetworkReply::NoError);
+        QCOMPARE(replies.at(i)->readAll(),
+                 QCryptographicHash::hash(data.left(data.size() - i * 1000),
+                                          QCryptographicHash::Sha1).toHex());
+    }
+    qDeleteAll(replies);
+}
+
+void tst_Http2::flowControlServerSide()
+{
+    // larger than the client's stream window, so the client has to send
+    // WINDOW_UPDATE frames to receive it completely
+    const int size = 5 * 1024 * 1024;
+
+    Http2Server server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QNetworkAccessManager manager;
+    QList<QNetworkReply *> replies;
+    replies << manager.get(request(server, QLatin1Char('/') + QString::number(size)))
+            << manager.get(request(server, QLatin1Char('/') + QString::number(size)));
+    QVERIFY(waitForReplies(replies));
+
+    QVERIFY2(server.violation.isEmpty(), server.violation.constData());
+    QVERIFY(server.windowUpdatesReceived > 0);
+    const QByteArray expected = Http2Server::responseBody(size);
+    for (int i = 0; i < replies.size(); ++i) {
+        QCOMPARE(replies.at(i)->error(), QNetworkReply::NoError);
+        QCOMPARE(replies.at(i)->readAll(), expected);
+    }
+    qDeleteAll(replies);
+}
+
+QTEST_MAIN(tst_Http2)
+
+#include "tst_http2.moc"
@@ -34,6 +34,8 @@
 
 #include <QtTest/QtTest>
 #include "private/qhttpnetworkconnection_p.h"
+#include "private/qhttpcontentdecoder_p.h"
+#include "private/qbytedata_p.h"
 
 class tst_QHttpNetworkReply: public QObject
 {
@@ -41,6 +43,10 @@ class tst_QHttpNetworkReply: public QObject
 private Q_SLOTS:
     void parseHeader_data();
     void parseHeader();
+#ifndef QT_NO_COMPRESS
+    void decodeCompressed_data();
+    void decodeCompressed();
+#endif
 };
 
 void tst_QHttpNetworkReply::parseHeader_data()
@@ -100,5 +106,55 @@ void tst_QHttpNetworkReply::parseHeader()
     }
 }
 
+#ifndef QT_NO_COMPRESS
+void tst_QHttpNetworkReply::decodeCompressed_data()
+{
+    QTest::addColumn<QByteArray>("body");
+    QTest::addColumn<bool>("raw");
+    QTest::addColumn<int>("pieceSize");
+
+    QByteArray text;
+    for (int i = 0; text.size() < 256 * 1024; ++i)
+        text += "line " + QByteArray::number(i) + " of the uncompressed body\n";
+    // compresses so well that the output of a small input does not fit the
+    // first output block
+    const QByteArray zeros(1024 * 1024, '\0');
+
+    const int pieceSizes[] = { 1, 1460, 16384, INT_MAX };
+    for (size_t i = 0; i < sizeof(pieceSizes) / sizeof(pieceSizes[0]); ++i) {
+        const int pieceSize = pieceSizes[i];
+        const QByteArray suffix = '-' + (pieceSize == INT_MAX ? QByteArray("whole") : QByteArray::number(pieceSize));
+        QTest::newRow("text" + suffix) << text << false << pieceSize;
+        QTest::newRow("text-raw" + suffix) << text << true << pieceSize;
+        QTest::newRow("zeros" + suffix) << zeros << false << pieceSize;
+        QTest::newRow("zeros-raw" + suffix) << zeros << true << pieceSize;
+    }
+}
+
+void tst_QHttpNetworkReply::decodeCompressed()
+{
+    QFETCH(QByteArray, body);
+    QFETCH(bool, raw);
+    QFETCH(int, pieceSize);
+
+    QByteArray data = qCompress(body).mid(4); // strip qCompress' size prefix
+    if (raw) // "deflate" without the zlib wrapper, which some servers send
+        data = data.mid(2, data.size() - 2 - 4);
+
+    QScopedPointer<QHttpContentDecoder> decoder(QHttpContentDecoderFactory::createDecoder("deflate"));
+    QVERIFY(decoder);
+    QByteDataBuffer out;
+    qint64 written = 0;
+    for (int offset = 0; offset < data.size(); offset += qMin(pieceSize, data.size() - offset)) {
+        const qint64 result = decoder->decode(data.constData() + offset,
+                                              qMin(pieceSize, data.size() - offset), &out);
+        QVERIFY(result >= 0);
+        written += result;
+    }
+    QCOMPARE(written, qint64(body.size()));
+    QCOMPARE(out.readAll(), body);
+}
+#endif
+
 QTEST_MAIN(tst_QHttpNetworkReply)
 #include "tst_qhttpnetworkreply.moc"
@@ -35,6 +35,7 @@
 
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QHttpConnectionPolicy>
 #ifndef QT_NO_BEARERMANAGEMENT
 #include <QtNetwork/QNetworkConfigurationManager>
 #endif
@@ -55,6 +56,7 @@ public:
 private slots:
     void networkAccessible();
     void alwaysCacheRequest();
+    void httpConnectionPolicy();
 };
 
 tst_QNetworkAccessManager::tst_QNetworkAccessManager()
@@ -134,5 +136,45 @@ void tst_QNetworkAccessManager::alwaysCacheRequest()
     delete reply;
 }
 
+void tst_QNetworkAccessManager::httpConnectionPolicy()
+{
+    QNetworkAccessManager manager;
+
+    const QHttpConnectionPolicy defaultPolicy = manager.httpConnectionPolicy();
+    QCOMPARE(defaultPolicy.maximumConnectionCount(), 6);
+    QVERIFY(!defaultPolicy.isPipeliningEnabled());
+    QCOMPARE(defaultPolicy.maximumPipelineLength(), 3);
+    QCOMPARE(defaultPolicy.idleTimeout(), 120);
+    QCOMPARE(manager.httpConnectionPolicy(QStringLiteral("example.com")), defaultPolicy);
+
+    // out-of-range values are clamped
+    QHttpConnectionPolicy policy;
+    policy.setMaximumConnectionCount(0);
+    policy.setMaximumPipelineLength(-1);
+    policy.setIdleTimeout(-5);
+    QCOMPARE(policy.maximumConnectionCount(), 1);
+    QCOMPARE(policy.maximumPipelineLength(), 1);
+    QCOMPARE(policy.idleTimeout(), 0);
+
+    policy.setMaximumConnectionCount(16);
+    policy.setPipeliningEnabled(true);
+    policy.setMaximumPipelineLength(8);
+    policy.setIdleTimeout(30);
+    QVERIFY(policy != defaultPolicy);
+
+    manager.setHttpConnectionPolicy(QStringLiteral("Example.COM"), policy);
+    QCOMPARE(manager.httpConnectionPolicy(QStringLiteral("example.com")), policy);
+    QCOMPARE(manager.httpConnectionPolicy(QStringLiteral("EXAMPLE.com")), policy);
+    QCOMPARE(manager.httpConnectionPolicy(QStringLiteral("example.org")), defaultPolicy);
+    QCOMPARE(manager.httpConnectionPolicy(), defaultPolicy);
+
+    // the default applies to every host without a policy of its own
+    QHttpConnectionPolicy newDefault;
+    newDefault.setMaximumConnectionCount(2);
+    manager.setHttpConnectionPolicy(newDefault);
+    QCOMPARE(manager.httpConnectionPolicy(QStringLiteral("example.org")), newDefault);
+    QCOMPARE(manager.httpConnectionPolicy(QStringLiteral("example.com")), policy);
+}
+
 QTEST_MAIN(tst_QNetworkAccessManager)
 #include "tst_qnetworkaccessmanager.moc"
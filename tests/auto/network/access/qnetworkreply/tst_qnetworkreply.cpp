@@ -60,6 +60,9 @@
 #include <QtNetwork/QHttpPart>
 #include <QtNetwork/QHttpMultiPart>
 #include <QtNetwork/QNetworkProxyQuery>
+#include <QtNetwork/QHttpConnectionPolicy>
+#include <QtNetwork/private/qhttpcontentdecoder_p.h>
+#include <QtCore/private/qbytedata_p.h>
 #ifndef QT_NO_SSL
 #include <QtNetwork/qsslerror.h>
 #include <QtNetwork/qsslconfiguration.h>
@@ -429,6 +432,11 @@ private Q_SLOTS:
 
     void qtbug18232gzipContentLengthZero();
     void qtbug22660gzipNoContentLengthEmptyContent();
+    void compressedHttpReplyChunked();
+    void compressedHttpReplyRawDeflate();
+    void contentDecoderFactory();
+    void httpConnectionPolicy_data();
+    void httpConnectionPolicy();
 
     void qtbug27161httpHeaderMayBeDamaged_data();
     void qtbug27161httpHeaderMayBeDamaged();
@@ -7113,6 +7121,216 @@ void tst_QNetworkReply::qtbug22660gzipNoContentLengthEmptyContent()
     QCOMPARE(reply->readAll(), QByteArray());
 }
 
+void tst_QNetworkReply::compressedHttpReplyChunked()
+{
+    // the gzip data of qtbug12908compressedHttpReply(), split over several chunks
+    QByteArray gzipped = QByteArray::fromBase64("H4sICDdDaUwAA3F0YnVnLTEyOTA4AO3BMQEAAADCoPVPbQwfoAAAAAAAAAAAAAAAAAAAAIC3AYbSVKsAQAAA");
+    QByteArray response("HTTP/1.1 200 OK\r\nContent-Encoding: gzip\r\nTransfer-Encoding: chunked\r\n"
+                        "Connection: close\r\n\r\n");
+    for (int i = 0; i < gzipped.size(); i += 10) {
+        const QByteArray chunk = gzipped.mid(i, 10);
+        response += QByteArray::number(chunk.size(), 16) + "\r\n" + chunk + "\r\n";
+    }
+    response += "0\r\n\r\n";
+
+    MiniHttpServer server(response);
+    server.doClose = true;
+
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    QNetworkReplyPtr reply(manager.get(request));
+
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->readAll(), QByteArray(16384, '\0'));
+}
+
+void tst_QNetworkReply::compressedHttpReplyRawDeflate()
+{
+    // "deflate" without the zlib wrapper, which some servers send
+    QByteArray body;
+    for (int i = 0; body.size() < 1024 * 1024; ++i)
+        body += "line " + QByteArray::number(i) + " of the uncompressed body\n";
+    const QByteArray zlibData = qCompress(body).mid(4); // strip qCompress' size prefix
+    const QByteArray rawDeflate = zlibData.mid(2, zlibData.size() - 2 - 4);
+
+    QByteArray response("HTTP/1.0 200 OK\r\nContent-Encoding: deflate\r\nContent-Length: ");
+    response += QByteArray::number(rawDeflate.size()) + "\r\n\r\n" + rawDeflate;
+    MiniHttpServer server(response);
+    server.doClose = true;
+
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    QNetworkReplyPtr reply(manager.get(request));
+
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->readAll(), body);
+}
+
+class XorContentDecoder : public QHttpContentDecoder
+{
+public:
+    qint64 decode(const char *data, qint64 size, QByteDataBuffer *out) Q_DECL_OVERRIDE
+    {
+        QByteArray block(int(size), Qt::Uninitialized);
+        for (int i = 0; i < block.size(); ++i)
+            block[i] = data[i] ^ 0x20;
+        out->append(block);
+        return size;
+    }
+};
+
+class XorContentDecoderFactory : public QHttpContentDecoderFactory
+{
+public:
+    QList<QByteArray> supportedEncodings() const Q_DECL_OVERRIDE
+    {
+        return QList<QByteArray>() << "x-test-xor";
+    }
+    QHttpContentDecoder *create(const QByteArray &) const Q_DECL_OVERRIDE
+    {
+        return new XorContentDecoder;
+    }
+};
+
+void tst_QNetworkReply::contentDecoderFactory()
+{
+    XorContentDecoderFactory factory;
+
+    QByteArray response("HTTP/1.0 200 OK\r\nContent-Encoding: X-Test-Xor\r\n\r\nHELLO\x01WORLD");
+    MiniHttpServer server(response);
+    server.doClose = true;
+
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    QNetworkReplyPtr reply(manager.get(request));
+
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+
+    QVERIFY(server.receivedData.contains("Accept-Encoding: gzip, deflate, x-test-xor\r\n"));
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->readAll(), QByteArray("hello!world"));
+}
+
+// Answers every request after a delay, so that requests queue up on the
+// connections, and keeps track of how the client uses its connections.
+class ConnectionCountingServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    int openConnections;
+    int maximumOpenConnections;
+    int closedConnections;
+    int maximumPipelinedRequests;
+
+    ConnectionCountingServer()
+        : openConnections(0), maximumOpenConnections(0), closedConnections(0),
+          maximumPipelinedRequests(0)
+    {
+        listen(QHostAddress::LocalHost);
+    }
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) Q_DECL_OVERRIDE
+    {
+        QTcpSocket *socket = new QTcpSocket(this);
+        socket->setSocketDescriptor(socketDescriptor);
+        pendingRequests.insert(socket, 0);
+        maximumOpenConnections = qMax(maximumOpenConnections, ++openConnections);
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readRequests()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(connectionClosed()));
+    }
+
+private slots:
+    void readRequests()
+    {
+        QTcpSocket *socket = static_cast<QTcpSocket *>(sender());
+        // the requests are GETs without a body
+        while (socket->canReadLine()) {
+            if (socket->readLine() != "\r\n")
+                continue;
+            int &pending = pendingRequests[socket];
+            if (++pending == 1)
+                QTimer::singleShot(100, socket, [this, socket]() { sendReplies(socket); });
+            maximumPipelinedRequests = qMax(maximumPipelinedRequests, pending);
+        }
+    }
+
+    void connectionClosed()
+    {
+        QTcpSocket *socket = static_cast<QTcpSocket *>(sender());
+        pendingRequests.remove(socket);
+        --openConnections;
+        ++closedConnections;
+        socket->deleteLater();
+    }
+
+private:
+    void sendReplies(QTcpSocket *socket)
+    {
+        int &pending = pendingRequests[socket];
+        for (; pending > 0; --pending)
+            socket->write("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok");
+    }
+
+    QHash<QTcpSocket *, int> pendingRequests;
+};
+
+void tst_QNetworkReply::httpConnectionPolicy_data()
+{
+    QTest::addColumn<int>("connectionCount");
+    QTest::addColumn<bool>("pipelining");
+    QTest::addColumn<int>("pipelineLength");
+
+    QTest::newRow("one-connection") << 1 << false << 3;
+    QTest::newRow("two-connections") << 2 << false << 3;
+    QTest::newRow("pipelined") << 1 << true << 2;
+    QTest::newRow("pipelined-long") << 2 << true << 4;
+}
+
+void tst_QNetworkReply::httpConnectionPolicy()
+{
+    QFETCH(int, connectionCount);
+    QFETCH(bool, pipelining);
+    QFETCH(int, pipelineLength);
+
+    ConnectionCountingServer server;
+    QVERIFY(server.isListening());
+
+    QHttpConnectionPolicy policy;
+    policy.setMaximumConnectionCount(connectionCount);
+    policy.setPipeliningEnabled(pipelining);
+    policy.setMaximumPipelineLength(pipelineLength);
+    policy.setIdleTimeout(1);
+    QNetworkAccessManager policyManager;
+    policyManager.setHttpConnectionPolicy(QStringLiteral("127.0.0.1"), policy);
+
+    const int requestCount = 12;
+    const QUrl url(QLatin1String("http://127.0.0.1:") + QString::number(server.serverPort()) + QLatin1Char('/'));
+    QList<QNetworkReplyPtr> replies;
+    for (int i = 0; i < requestCount; ++i)
+        replies << QNetworkReplyPtr(policyManager.get(QNetworkRequest(url)));
+    for (int i = 0; i < requestCount; ++i) {
+        QVERIFY2(waitForFinish(replies[i]) == Success, msgWaitForFinished(replies[i]));
+        QCOMPARE(replies[i]->readAll(), QByteArray("ok"));
+    }
+
+    // all connections that are allowed are used, and no more
+    QCOMPARE(server.maximumOpenConnections, connectionCount);
+    QCOMPARE(server.openConnections, connectionCount);
+    // the request being answered plus the ones pipelined behind it
+    if (pipelining)
+        QCOMPARE(server.maximumPipelinedRequests, 1 + pipelineLength);
+    else
+        QCOMPARE(server.maximumPipelinedRequests, 1);
+
+    // idle connections are closed after the timeout, the default is two minutes
+    QElapsedTimer idle;
+    idle.start();
+    QTRY_COMPARE_WITH_TIMEOUT(server.closedConnections, connectionCount, 10000);
+    QVERIFY2(idle.elapsed() >= 500, QByteArray::number(idle.elapsed()));
+}
+
 class QtBug27161Helper : public QObject {
     Q_OBJECT
 public:
@@ -91,6 +91,7 @@ private slots:
 #endif
     void listenWhileListening();
     void addressReusable();
+    void portSharing();
     void setNewSocketDescriptorBlocking();
 #ifndef QT_NO_NETWORKPROXY
     void invalidProxy_data();
@@ -130,6 +131,13 @@ void tst_QTcpServer::getSetCheck()
     QCOMPARE(INT_MIN, obj1.maxPendingConnections());
     obj1.setMaxPendingConnections(INT_MAX);
     QCOMPARE(INT_MAX, obj1.maxPendingConnections());
+    // bool QTcpServer::isPortSharingEnabled()
+    // void QTcpServer::setPortSharingEnabled(bool)
+    QVERIFY(!obj1.isPortSharingEnabled());
+    obj1.setPortSharingEnabled(true);
+    QVERIFY(obj1.isPortSharingEnabled());
+    obj1.setPortSharingEnabled(false);
+    QVERIFY(!obj1.isPortSharingEnabled());
 }
 
 void tst_QTcpServer::initTestCase_data()
@@ -605,6 +613,60 @@ void tst_QTcpServer::addressReusable()
 #endif
 }
 
+void tst_QTcpServer::portSharing()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        QSKIP("Port sharing is not supported through proxies");
+
+    QTcpServer first;
+    first.setPortSharingEnabled(true);
+    if (!first.listen(QHostAddress::LocalHost)) {
+        if (first.serverError() == QAbstractSocket::UnsupportedSocketOperationError)
+            QSKIP("Port sharing is not supported on this platform");
+        QFAIL(qPrintable(first.errorString()));
+    }
+    const quint16 port = first.serverPort();
+
+    // without the option, the port is still taken
+    QTcpServer exclusive;
+    QVERIFY(!exclusive.listen(QHostAddress::LocalHost, port));
+    QCOMPARE(exclusive.serverError(), QAbstractSocket::AddressInUseError);
+
+    QTcpServer second;
+    second.setPortSharingEnabled(true);
+    QVERIFY2(second.listen(QHostAddress::LocalHost, port), qPrintable(second.errorString()));
+    QCOMPARE(second.serverPort(), port);
+
+    // every connection must be accepted by exactly one of the servers
+    const int connectionCount = 32;
+    first.setMaxPendingConnections(connectionCount);
+    second.setMaxPendingConnections(connectionCount);
+    QSignalSpy firstSpy(&first, SIGNAL(newConnection()));
+    QSignalSpy secondSpy(&second, SIGNAL(newConnection()));
+    QList<QTcpSocket *> clients;
+    for (int i = 0; i < connectionCount; ++i) {
+        QTcpSocket *client = new QTcpSocket;
+        client->connectToHost(QHostAddress::LocalHost, port);
+        clients << client;
+    }
+
+    QTRY_COMPARE(firstSpy.count() + secondSpy.count(), connectionCount);
+    int firstCount = 0;
+    while (QTcpSocket *socket = first.nextPendingConnection()) {
+        delete socket;
+        ++firstCount;
+    }
+    int secondCount = 0;
+    while (QTcpSocket *socket = second.nextPendingConnection()) {
+        delete socket;
+        ++secondCount;
+    }
+    QCOMPARE(firstCount + secondCount, connectionCount);
+
+    qDeleteAll(clients);
+}
+
 void tst_QTcpServer::setNewSocketDescriptorBlocking()
 {
     QFETCH_GLOBAL(bool, setProxy);
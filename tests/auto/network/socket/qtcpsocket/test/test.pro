@@ -2,6 +2,7 @@ CONFIG += testcase
 
 QT = core-private network-private testlib
 SOURCES += ../tst_qtcpsocket.cpp
+RESOURCES += ../qtcpsocket.qrc
 win32: {
 wince {
 	LIBS += -lws2
@@ -60,6 +60,7 @@
 #include <QPointer>
 #include <QProcess>
 #include <QStringList>
+#include <QTemporaryFile>
 #include <QTcpServer>
 #include <QTcpSocket>
 #ifndef QT_NO_SSL
@@ -201,6 +202,8 @@ private slots:
     void clientSendDataOnDelayedDisconnect();
     void serverDisconnectWithBuffered();
     void socketDiscardDataInWriteMode();
+    void writeFromFile_data();
+    void writeFromFile();
 
 protected slots:
     void nonBlockingIMAP_hostFound();
@@ -3054,5 +3057,81 @@ void tst_QTcpSocket::socketDiscardDataInWriteMode()
     delete socket;
 }
 
+void tst_QTcpSocket::writeFromFile_data()
+{
+    QTest::addColumn<bool>("fromResource");
+
+    QTest::newRow("regular-file") << false;
+    // a resource has no file descriptor, so it is copied through the
+    // write buffer instead of being handed to the socket engine
+    QTest::newRow("resource") << true;
+}
+
+// Test that a file queued with writeFromFile() is sent in order with
+// the data written around it
+void tst_QTcpSocket::writeFromFile()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+    QFETCH(bool, fromResource);
+
+    QByteArray fileData;
+    QScopedPointer<QFile> file;
+    if (fromResource) {
+        file.reset(new QFile(QStringLiteral(":/writefromfile.data")));
+        QVERIFY(file->open(QIODevice::ReadOnly));
+        QCOMPARE(file->handle(), -1);
+        fileData = file->readAll();
+        QVERIFY(fileData.size() > 3 * 32768);
+    } else {
+        for (int i = 0; i < 200000; ++i)
+            fileData += char('a' + i % 26);
+        QTemporaryFile *temporaryFile = new QTemporaryFile;
+        file.reset(temporaryFile);
+        QVERIFY(temporaryFile->open());
+        QCOMPARE(file->write(fileData), qint64(fileData.size()));
+        QVERIFY(file->flush());
+    }
+
+    QTcpServer tcpServer;
+    QTcpSocket *socket = newSocket();
+
+    QVERIFY(tcpServer.listen(QHostAddress::LocalHost));
+    socket->connectToHost(tcpServer.serverAddress(), tcpServer.serverPort());
+    QVERIFY(socket->waitForConnected(5000)); // ready for write
+    QVERIFY2(tcpServer.waitForNewConnection(5000), "Network timeout");
+    QTcpSocket *newConnection = tcpServer.nextPendingConnection();
+    QVERIFY(newConnection != NULL);
+
+    qint64 totalWritten = 0;
+    connect(socket, &QIODevice::bytesWritten, [&totalWritten](qint64 bytes) { totalWritten += bytes; });
+
+    const QByteArray head("head");
+    const QByteArray tail("tail");
+    const QByteArray expected = head + fileData.mid(10, fileData.size() - 20) + tail;
+    QCOMPARE(socket->write(head), qint64(head.size()));
+    QCOMPARE(socket->writeFromFile(file.data(), 10, fileData.size() - 20), qint64(fileData.size() - 20));
+    QCOMPARE(socket->write(tail), qint64(tail.size()));
+    QCOMPARE(socket->bytesToWrite(), qint64(expected.size()));
+    QCOMPARE(socket->writeFromFile(file.data(), fileData.size()), qint64(0));
+
+    QByteArray received;
+    while (received.size() < expected.size()) {
+        if (socket->bytesToWrite() > 0)
+            socket->waitForBytesWritten(0);
+        if (newConnection->waitForReadyRead(socket->bytesToWrite() > 0 ? 0 : 5000))
+            received += newConnection->readAll();
+        else if (socket->bytesToWrite() == 0)
+            break;
+    }
+    QCOMPARE(received, expected);
+    QCOMPARE(socket->bytesToWrite(), qint64(0));
+    QCOMPARE(totalWritten, qint64(expected.size()));
+
+    delete newConnection;
+    delete socket;
+}
+
 QTEST_MAIN(tst_QTcpSocket)
 #include "tst_qtcpsocket.moc"
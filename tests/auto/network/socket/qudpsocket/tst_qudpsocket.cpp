@@ -91,6 +91,7 @@ private slots:
     void outOfProcessConnectedClientServerTest();
     void outOfProcessUnconnectedClientServerTest();
     void zeroLengthDatagram();
+    void readWriteDatagrams();
     void multicastTtlOption_data();
     void multicastTtlOption();
     void multicastLoopbackOption_data();
@@ -1094,6 +1095,59 @@ void tst_QUdpSocket::zeroLengthDatagram()
     QCOMPARE(receiver.readDatagram(&buf, 1), qint64(0));
 }
 
+void tst_QUdpSocket::readWriteDatagrams()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QUdpSocket receiver;
+#ifdef FORCE_SESSION
+    receiver.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost), 0));
+
+    QUdpSocket sender;
+#ifdef FORCE_SESSION
+    sender.setProperty("_q_networksession", QVariant::fromValue(networkSession));
+#endif
+    QSignalSpy bytesSpy(&sender, SIGNAL(bytesWritten(qint64)));
+
+    QList<QByteArray> datagrams;
+    qint64 totalSize = 0;
+    for (int i = 0; i < 10; ++i) {
+        datagrams << QByteArray(10 + i, char('a' + i));
+        totalSize += datagrams.last().size();
+    }
+    QCOMPARE(sender.writeDatagrams(datagrams, QHostAddress::LocalHost, receiver.localPort()), 10);
+    QCOMPARE(bytesSpy.count(), 1);
+    QCOMPARE(bytesSpy.at(0).at(0).toLongLong(), totalSize);
+
+    // read in batches smaller than the number of pending datagrams
+    const int slotSize = 32;
+    char data[16 * slotSize];
+    qint64 sizes[16];
+    QHostAddress hosts[16];
+    quint16 ports[16];
+    int received = 0;
+    while (received < datagrams.size() && receiver.waitForReadyRead(5000)) {
+        const int count = receiver.readDatagrams(data + received * slotSize, slotSize, sizes + received,
+                                                 qMin(4, 16 - received), hosts + received, ports + received);
+        QVERIFY(count >= 0);
+        received += count;
+    }
+    QCOMPARE(received, datagrams.size());
+    for (int i = 0; i < received; ++i) {
+        QCOMPARE(sizes[i], qint64(datagrams.at(i).size()));
+        QCOMPARE(QByteArray(data + i * slotSize, int(sizes[i])), datagrams.at(i));
+        QCOMPARE(hosts[i], QHostAddress(QHostAddress::LocalHost));
+        QCOMPARE(ports[i], sender.localPort());
+    }
+
+    // nothing is pending any more
+    QCOMPARE(receiver.readDatagrams(data, slotSize, sizes, 16), 0);
+}
+
 void tst_QUdpSocket::multicastTtlOption_data()
 {
     QTest::addColumn<QHostAddress>("bindAddress");
@@ -9,3 +9,5 @@ SUBDIRS=\
    qsqlthread \
    qsql \
    qsqlresult \
+   qsqlcolumncache \
+   qsqlconnectionpool \
@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qsqlcolumncache
+SOURCES += tst_qsqlcolumncache.cpp
+
+QT = core sql sql-private testlib
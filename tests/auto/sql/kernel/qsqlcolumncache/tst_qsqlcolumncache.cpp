@@ -0,0 +1,237 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtSql/private/qsqlcolumncache_p.h>
+
+class tst_QSqlColumnCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void typedValues();
+    void nulls();
+    void mixedTypes();
+    void declaredTypes();
+    void removeLastRow();
+    void clear();
+    void copyRow();
+};
+
+void tst_QSqlColumnCache::typedValues()
+{
+    QSqlColumnCache cache;
+    cache.init(4);
+    QCOMPARE(cache.columnCount(), 4);
+
+    for (int i = 0; i < 100; ++i) {
+        const QString str = QString::number(i);
+        const QByteArray ba(i, 'x');
+        const int row = cache.appendRow();
+        QCOMPARE(row, i);
+        cache.setInteger(row, 0, i);
+        cache.setDouble(row, 1, i / 2.0);
+        cache.setString(row, 2, str.unicode(), str.size());
+        cache.setBytes(row, 3, ba.constData(), ba.size());
+    }
+    QCOMPARE(cache.rowCount(), 100);
+
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(cache.value(i, 0), QVariant(qlonglong(i)));
+        QCOMPARE(cache.value(i, 1), QVariant(i / 2.0));
+        QCOMPARE(cache.value(i, 2), QVariant(QString::number(i)));
+        QCOMPARE(cache.value(i, 3), QVariant(QByteArray(i, 'x')));
+        for (int col = 0; col < 4; ++col)
+            QVERIFY(!cache.isNull(i, col));
+    }
+
+    // an empty string is not null
+    QVERIFY(!cache.value(0, 2).toString().isNull());
+}
+
+void tst_QSqlColumnCache::nulls()
+{
+    QSqlColumnCache cache;
+    cache.init(2, QVariant::String);
+
+    for (int i = 0; i < 70; ++i) {
+        const QString str = QString::number(i);
+        const int row = cache.appendRow();
+        if (i % 3)
+            cache.setInteger(row, 0, i);
+        if (i % 5)
+            cache.setString(row, 1, str.unicode(), str.size());
+    }
+
+    for (int i = 0; i < 70; ++i) {
+        QCOMPARE(cache.isNull(i, 0), i % 3 == 0);
+        QCOMPARE(cache.isNull(i, 1), i % 5 == 0);
+        const QVariant v0 = cache.value(i, 0);
+        const QVariant v1 = cache.value(i, 1);
+        if (i % 3 == 0) {
+            QCOMPARE(v0.type(), QVariant::String);
+            QVERIFY(v0.isNull());
+        } else {
+            QCOMPARE(v0, QVariant(qlonglong(i)));
+        }
+        if (i % 5 == 0) {
+            QCOMPARE(v1.type(), QVariant::String);
+            QVERIFY(v1.isNull());
+        } else {
+            QCOMPARE(v1, QVariant(QString::number(i)));
+        }
+    }
+
+    // overwriting the last row with null drops its string data
+    const int row = cache.appendRow();
+    const QString str = QStringLiteral("gone");
+    cache.setString(row, 1, str.unicode(), str.size());
+    cache.setNull(row, 1);
+    QVERIFY(cache.isNull(row, 1));
+    QCOMPARE(cache.value(row - 1, 1), QVariant(QString::number(row - 1)));
+}
+
+void tst_QSqlColumnCache::mixedTypes()
+{
+    QSqlColumnCache cache;
+    cache.init(1);
+
+    int row = cache.appendRow();
+    cache.setInteger(row, 0, 42);
+    row = cache.appendRow();
+    const QString str = QStringLiteral("text");
+    cache.setString(row, 0, str.unicode(), str.size());
+    row = cache.appendRow();
+    cache.setValue(row, 0, QDate(2016, 1, 1));
+    row = cache.appendRow();
+
+    QCOMPARE(cache.value(0, 0), QVariant(qlonglong(42)));
+    QCOMPARE(cache.value(1, 0), QVariant(str));
+    QCOMPARE(cache.value(2, 0), QVariant(QDate(2016, 1, 1)));
+    QVERIFY(cache.isNull(3, 0));
+
+    // setValue() keeps the type of the value
+    QSqlColumnCache ints;
+    ints.init(1);
+    row = ints.appendRow();
+    ints.setValue(row, 0, 1);
+    row = ints.appendRow();
+    ints.setValue(row, 0, qlonglong(2));
+    QCOMPARE(ints.value(0, 0).type(), QVariant::Int);
+    QCOMPARE(ints.value(1, 0).type(), QVariant::LongLong);
+}
+
+void tst_QSqlColumnCache::declaredTypes()
+{
+    QSqlColumnCache cache;
+    cache.init(3);
+    cache.setColumnType(0, QVariant::Bool);
+    cache.setColumnType(1, QVariant::Int);
+    cache.setColumnType(2, QVariant::Date);
+
+    const int row = cache.appendRow();
+    cache.setInteger(row, 0, 1);
+    cache.setInteger(row, 1, -7);
+    cache.setValue(row, 2, QDate(2016, 2, 29));
+
+    QCOMPARE(cache.value(row, 0), QVariant(true));
+    QCOMPARE(cache.value(row, 1), QVariant(-7));
+    QCOMPARE(cache.value(row, 2), QVariant(QDate(2016, 2, 29)));
+}
+
+void tst_QSqlColumnCache::removeLastRow()
+{
+    QSqlColumnCache cache;
+    cache.init(2);
+
+    const QString a = QStringLiteral("first"), b = QStringLiteral("second");
+    int row = cache.appendRow();
+    cache.setString(row, 0, a.unicode(), a.size());
+    cache.setInteger(row, 1, 1);
+    row = cache.appendRow();
+    cache.setString(row, 0, b.unicode(), b.size());
+    cache.removeLastRow();
+    QCOMPARE(cache.rowCount(), 1);
+
+    row = cache.appendRow();
+    QCOMPARE(row, 1);
+    QVERIFY(cache.isNull(row, 0));
+    QVERIFY(cache.isNull(row, 1));
+    cache.setString(row, 0, a.unicode(), 2);
+    QCOMPARE(cache.value(0, 0), QVariant(a));
+    QCOMPARE(cache.value(1, 0), QVariant(a.left(2)));
+}
+
+void tst_QSqlColumnCache::clear()
+{
+    QSqlColumnCache cache;
+    cache.init(1);
+
+    for (int i = 0; i < 3; ++i) {
+        cache.clear();
+        QCOMPARE(cache.rowCount(), 0);
+        const int row = cache.appendRow();
+        QCOMPARE(row, 0);
+        QVERIFY(cache.isNull(row, 0));
+        cache.setDouble(row, 0, i);
+        QCOMPARE(cache.value(row, 0), QVariant(double(i)));
+    }
+    QCOMPARE(cache.columnCount(), 1);
+
+    cache.reset();
+    QCOMPARE(cache.columnCount(), 0);
+    QCOMPARE(cache.rowCount(), 0);
+}
+
+void tst_QSqlColumnCache::copyRow()
+{
+    QSqlColumnCache source;
+    source.init(3, QVariant::String);
+    const QString str = QStringLiteral("copied");
+    const int sourceRow = source.appendRow();
+    source.setInteger(sourceRow, 0, 5);
+    source.setString(sourceRow, 1, str.unicode(), str.size());
+
+    QSqlColumnCache cache;
+    cache.init(3, QVariant::String);
+    const int row = cache.appendRow();
+    cache.copyRow(row, source, sourceRow);
+    QCOMPARE(cache.value(row, 0), QVariant(qlonglong(5)));
+    QCOMPARE(cache.value(row, 1), QVariant(str));
+    QVERIFY(cache.isNull(row, 2));
+    QCOMPARE(cache.value(row, 2).type(), QVariant::String);
+}
+
+QTEST_APPLESS_MAIN(tst_QSqlColumnCache)
+#include "tst_qsqlcolumncache.moc"
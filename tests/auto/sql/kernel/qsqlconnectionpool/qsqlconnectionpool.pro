@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qsqlconnectionpool
+SOURCES += tst_qsqlconnectionpool.cpp
+
+QT = core sql testlib
@@ -0,0 +1,324 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+class tst_QSqlConnectionPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void cleanup();
+
+    void reuse();
+    void nestedAcquire();
+    void timeout();
+    void idleTimeout();
+    void validation();
+    void releaseFromOtherThread();
+    void concurrentUse();
+
+private:
+    QTemporaryDir dir;
+};
+
+static QString templateName() { return QStringLiteral("tst_qsqlconnectionpool"); }
+
+void tst_QSqlConnectionPool::initTestCase()
+{
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE")))
+        QSKIP("The SQLite driver is not available");
+    QVERIFY(dir.isValid());
+
+    QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), templateName());
+    db.setDatabaseName(dir.path() + QLatin1String("/pool.db"));
+    QVERIFY2(db.open(), qPrintable(db.lastError().text()));
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QStringLiteral("create table items (id integer, thread integer)")));
+    q.clear();
+    db.close();
+}
+
+void tst_QSqlConnectionPool::cleanupTestCase()
+{
+    QSqlDatabase::removeDatabase(templateName());
+}
+
+void tst_QSqlConnectionPool::cleanup()
+{
+    // every pool must have removed the connections it has added
+    QCOMPARE(QSqlDatabase::connectionNames(), QStringList(templateName()));
+}
+
+void tst_QSqlConnectionPool::reuse()
+{
+    QSqlConnectionPool pool(templateName());
+    QCOMPARE(pool.size(), 0);
+
+    QSqlDatabase db = pool.acquire();
+    QVERIFY(db.isOpen());
+    QVERIFY(db.connectionName() != templateName());
+    QCOMPARE(pool.size(), 1);
+    QCOMPARE(pool.idleCount(), 0);
+    const QString name = db.connectionName();
+    pool.release(db);
+    db = QSqlDatabase();
+    QCOMPARE(pool.idleCount(), 1);
+
+    db = pool.acquire();
+    QCOMPARE(db.connectionName(), name);
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QStringLiteral("select count(*) from items")));
+    q.clear();
+    pool.release(db);
+    db = QSqlDatabase();
+
+    QCOMPARE(pool.size(), 1);
+    QCOMPARE(pool.acquireCount(), 2);
+    QCOMPARE(pool.hitCount(), 1);
+    QCOMPARE(pool.hitRate(), qreal(0.5));
+
+    pool.resetStatistics();
+    QCOMPARE(pool.acquireCount(), 0);
+    QCOMPARE(pool.hitRate(), qreal(0));
+
+    pool.clear();
+    QCOMPARE(pool.size(), 0);
+}
+
+void tst_QSqlConnectionPool::nestedAcquire()
+{
+    QSqlConnectionPool pool(templateName());
+    QSqlDatabase outer = pool.acquire();
+    QSqlDatabase inner = pool.acquire();
+    QCOMPARE(inner.connectionName(), outer.connectionName());
+    QCOMPARE(pool.size(), 1);
+
+    pool.release(inner);
+    inner = QSqlDatabase();
+    QCOMPARE(pool.idleCount(), 0);
+    pool.release(outer);
+    outer = QSqlDatabase();
+    QCOMPARE(pool.idleCount(), 1);
+}
+
+class HoldingThread : public QThread
+{
+public:
+    HoldingThread(QSqlConnectionPool *pool) : pool(pool) {}
+
+    QSqlConnectionPool *pool;
+    QSemaphore acquired;
+    QSemaphore done;
+    QString name;
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        QSqlDatabase db = pool->acquire();
+        name = db.connectionName();
+        acquired.release();
+        done.acquire();
+        pool->release(db);
+    }
+};
+
+void tst_QSqlConnectionPool::timeout()
+{
+    QSqlConnectionPool pool(templateName());
+    pool.setMaximumSize(1);
+    QCOMPARE(pool.maximumSize(), 1);
+
+    HoldingThread thread(&pool);
+    thread.start();
+    thread.acquired.acquire();
+
+    QSqlDatabase db = pool.acquire(50);
+    QVERIFY(!db.isValid());
+    QCOMPARE(pool.timeoutCount(), 1);
+    QVERIFY(pool.maximumWaitTime() >= 40);
+
+    // the connection held by the thread is handed over once released
+    QTimer::singleShot(50, [&thread]() { thread.done.release(); });
+    QElapsedTimer timer;
+    timer.start();
+    while (!db.isValid()) {
+        QCoreApplication::processEvents();
+        db = pool.acquire(10);
+        QVERIFY(timer.elapsed() < 5000);
+    }
+    QVERIFY(thread.wait());
+    QCOMPARE(db.connectionName(), thread.name);
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QStringLiteral("select count(*) from items")));
+    q.clear();
+    pool.release(db);
+    db = QSqlDatabase();
+    QCOMPARE(pool.size(), 1);
+}
+
+void tst_QSqlConnectionPool::idleTimeout()
+{
+    QSqlConnectionPool pool(templateName());
+    pool.setIdleTimeout(0);
+    QCOMPARE(pool.idleTimeout(), 0);
+
+    QSqlDatabase db = pool.acquire();
+    const QString name = db.connectionName();
+    pool.release(db);
+    db = QSqlDatabase();
+    QCOMPARE(pool.size(), 1);
+
+    // the expired connection is closed instead of being reused
+    db = pool.acquire();
+    QVERIFY(db.connectionName() != name);
+    pool.release(db);
+    db = QSqlDatabase();
+    QCOMPARE(pool.size(), 1);
+    pool.clear();
+
+    pool.setMinimumSize(1);
+    db = pool.acquire();
+    const QString kept = db.connectionName();
+    pool.release(db);
+    db = QSqlDatabase();
+    db = pool.acquire();
+    QCOMPARE(db.connectionName(), kept);
+    pool.release(db);
+    db = QSqlDatabase();
+    QCOMPARE(pool.size(), 1);
+    QCOMPARE(pool.idleCount(), 1);
+}
+
+void tst_QSqlConnectionPool::validation()
+{
+    QSqlConnectionPool pool(templateName());
+    pool.setValidationQuery(QStringLiteral("select 1"));
+    QSqlDatabase db = pool.acquire();
+    const QString name = db.connectionName();
+    pool.release(db);
+    db = QSqlDatabase();
+    db = pool.acquire();
+    QCOMPARE(db.connectionName(), name);
+    pool.release(db);
+    db = QSqlDatabase();
+    QCOMPARE(pool.hitCount(), 1);
+
+    // a connection that fails validation is replaced
+    pool.setValidationQuery(QStringLiteral("select * from no_such_table"));
+    db = pool.acquire();
+    QVERIFY(db.isOpen());
+    QVERIFY(db.connectionName() != name);
+    pool.release(db);
+    db = QSqlDatabase();
+    QCOMPARE(pool.hitCount(), 1);
+    QCOMPARE(pool.size(), 1);
+}
+
+void tst_QSqlConnectionPool::releaseFromOtherThread()
+{
+    QSqlConnectionPool pool(templateName());
+    HoldingThread thread(&pool);
+    thread.start();
+    thread.acquired.acquire();
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("was not acquired by this thread")));
+    pool.release(QSqlDatabase::database(thread.name, false));
+    QCOMPARE(pool.idleCount(), 0);
+
+    thread.done.release();
+    QVERIFY(thread.wait());
+    QCOMPARE(pool.idleCount(), 1);
+}
+
+class WorkerThread : public QThread
+{
+public:
+    WorkerThread(QSqlConnectionPool *pool, int id) : pool(pool), id(id), ok(true) {}
+
+    QSqlConnectionPool *pool;
+    int id;
+    bool ok;
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < 20; ++i) {
+            QSqlDatabase db = pool->acquire();
+            {
+                QSqlQuery q(db);
+                q.prepare(QStringLiteral("insert into items values (?, ?)"));
+                q.addBindValue(i);
+                q.addBindValue(id);
+                ok = ok && db.driver()->thread() == this && q.exec();
+            }
+            pool->release(db);
+        }
+    }
+};
+
+void tst_QSqlConnectionPool::concurrentUse()
+{
+    QSqlConnectionPool pool(templateName());
+    pool.setMaximumSize(2);
+
+    QList<WorkerThread *> threads;
+    for (int i = 0; i < 4; ++i)
+        threads.append(new WorkerThread(&pool, i));
+    foreach (WorkerThread *thread, threads)
+        thread->start();
+    foreach (WorkerThread *thread, threads) {
+        QVERIFY(thread->wait());
+        QVERIFY(thread->ok);
+    }
+    qDeleteAll(threads);
+
+    QVERIFY(pool.size() <= 2);
+    QCOMPARE(pool.acquireCount(), 80);
+    QVERIFY(pool.hitCount() >= 78);
+
+    QSqlDatabase db = pool.acquire();
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QStringLiteral("select count(*) from items")));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 80);
+    q.clear();
+    pool.release(db);
+}
+
+QTEST_MAIN(tst_QSqlConnectionPool)
+#include "tst_qsqlconnectionpool.moc"
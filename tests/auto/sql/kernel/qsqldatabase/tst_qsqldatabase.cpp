@@ -36,6 +36,7 @@
 #include <qsqldatabase.h>
 #include <qsqlquery.h>
 #include <qsqldriver.h>
+#include <qsqlresult.h>
 #include <qsqlrecord.h>
 #include <qsqlfield.h>
 #include <qsqlindex.h>
@@ -189,6 +190,10 @@ private slots:
 
     void sqlite_enable_cache_mode_data() { generic_data("QSQLITE"); }
     void sqlite_enable_cache_mode();
+    void sqlite_tuningOptions_data() { generic_data("QSQLITE"); }
+    void sqlite_tuningOptions();
+    void sqlite_statementCache_data() { generic_data("QSQLITE"); }
+    void sqlite_statementCache();
 
 private:
     void createTestTables(QSqlDatabase db);
@@ -2224,5 +2229,79 @@ void tst_QSqlDatabase::sqlite_enable_cache_mode()
     db2.close();
 }
 
+void tst_QSqlDatabase::sqlite_tuningOptions()
+{
+    QFETCH(QString, dbName);
+    if (dbName.endsWith(":memory:"))
+        QSKIP("journal modes other than MEMORY are not available for :memory: databases");
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    db.close();
+    db.setConnectOptions("QSQLITE_JOURNAL_MODE=WAL;QSQLITE_MMAP_SIZE=1048576;QSQLITE_CACHE_SIZE=-4096");
+    QVERIFY_SQL(db, open());
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("PRAGMA journal_mode"));
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toString().toLower(), QString("wal"));
+    QVERIFY_SQL(q, exec("PRAGMA cache_size"));
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toInt(), -4096);
+    QVERIFY_SQL(q, exec("PRAGMA journal_mode=DELETE"));
+    q.clear();
+
+    db.close();
+    db.setConnectOptions();
+    QVERIFY_SQL(db, open());
+}
+
+void tst_QSqlDatabase::sqlite_statementCache()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString statement = "select * from " + qTableName("qtest", __FILE__, db) + " where id = ?";
+
+    QVariant handle;
+    {
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, prepare(statement));
+        handle = q.result()->handle();
+        q.addBindValue(1);
+        QVERIFY_SQL(q, exec());
+        QVERIFY_SQL(q, next());
+    }
+    {
+        // the statement of the finished query is reused
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, prepare(statement));
+        QCOMPARE(*static_cast<void *const *>(q.result()->handle().constData()),
+                 *static_cast<void *const *>(handle.constData()));
+        q.addBindValue(2);
+        QVERIFY_SQL(q, exec());
+        QVERIFY_SQL(q, next());
+        QCOMPARE(q.value(0).toInt(), 2);
+
+        // a query that is still active gets its own statement
+        QSqlQuery q2(db);
+        QVERIFY_SQL(q2, prepare(statement));
+        QVERIFY(*static_cast<void *const *>(q2.result()->handle().constData())
+                != *static_cast<void *const *>(handle.constData()));
+    }
+
+    db.close();
+    db.setConnectOptions("QSQLITE_STATEMENT_CACHE_SIZE=0");
+    QVERIFY_SQL(db, open());
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, prepare(statement));
+    q.addBindValue(1);
+    QVERIFY_SQL(q, exec());
+    QVERIFY_SQL(q, next());
+    q.clear();
+    db.close();
+    db.setConnectOptions();
+    QVERIFY_SQL(db, open());
+}
+
 QTEST_MAIN(tst_QSqlDatabase)
 #include "tst_qsqldatabase.moc"
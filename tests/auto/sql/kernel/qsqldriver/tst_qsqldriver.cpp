@@ -57,6 +57,9 @@ private slots:
     void record();
     void primaryIndex();
     void formatValue();
+    void bulkInsert();
+    void bulkInsertTimestamps();
+    void bulkInsertFallbackTransaction();
 };
 
 
@@ -97,6 +100,8 @@ void tst_QSqlDriver::cleanupTestCase()
     foreach (const QString &dbName, dbs.dbNames) {
         QSqlDatabase db = QSqlDatabase::database(dbName);
         tst_Databases::safeDropTable(db, qTableName("relTEST1", __FILE__, db));
+        tst_Databases::safeDropTable(db, qTableName("bulkTEST", __FILE__, db));
+        tst_Databases::safeDropTable(db, qTableName("bulkTSTEST", __FILE__, db));
     }
     dbs.close();
 }
@@ -228,5 +233,182 @@ void tst_QSqlDriver::formatValue()
     QCOMPARE(db.driver()->formatValue(rec.field("more_data")), QString("1.234567"));
 }
 
+void tst_QSqlDriver::bulkInsert()
+{
+    QFETCH_GLOBAL(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    const QString tableName(qTableName("bulkTEST", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("create table " + tableName + " (id int not null, name varchar(40))"));
+
+    QSqlRecord columns;
+    columns.append(QSqlField("id", QVariant::Int));
+    columns.append(QSqlField("name", QVariant::String));
+
+    const QStringList specialNames = QStringList() << QString("tab\there") << QString("back\\slash")
+                                                   << QString("new\nline") << QString("quote'd");
+    QVector<QVariantList> values(2);
+    for (int i = 0; i < 1000; ++i) {
+        values[0] << i;
+        if (i < specialNames.size())
+            values[1] << specialNames.at(i);
+        else if (i == specialNames.size())
+            values[1] << QVariant(QVariant::String);
+        else
+            values[1] << QString("row %1").arg(i);
+    }
+    QVERIFY2(db.driver()->bulkInsert(tableName, columns, values), qPrintable(db.driver()->lastError().text()));
+
+    QVERIFY_SQL(q, exec("select count(*) from " + tableName));
+    QVERIFY_SQL(q, next());
+    QCOMPARE(q.value(0).toInt(), 1000);
+    QVERIFY_SQL(q, exec("select id, name from " + tableName + " where id < 10 order by id"));
+    for (int i = 0; i < 10; ++i) {
+        QVERIFY_SQL(q, next());
+        QCOMPARE(q.value(0).toInt(), i);
+        QCOMPARE(q.value(1).isNull(), i == specialNames.size());
+        QCOMPARE(q.value(1).toString(), values.at(1).at(i).toString());
+    }
+    q.clear();
+
+    // the rows become part of the transaction of the caller
+    if (db.driver()->hasFeature(QSqlDriver::Transactions)) {
+        QVERIFY_SQL(db, transaction());
+        QVERIFY(db.driver()->bulkInsert(tableName, columns, values));
+        QVERIFY_SQL(db, rollback());
+        QVERIFY_SQL(q, exec("select count(*) from " + tableName));
+        QVERIFY_SQL(q, next());
+        QCOMPARE(q.value(0).toInt(), 1000);
+        q.clear();
+    }
+
+    values[1].removeLast();
+    QVERIFY(!db.driver()->bulkInsert(tableName, columns, values));
+    QCOMPARE(db.driver()->lastError().type(), QSqlError::StatementError);
+    values.removeLast();
+    QVERIFY(!db.driver()->bulkInsert(tableName, columns, values));
+    QCOMPARE(db.driver()->lastError().type(), QSqlError::StatementError);
+}
+
+void tst_QSqlDriver::bulkInsertTimestamps()
+{
+    QFETCH_GLOBAL(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    if (tst_Databases::getDatabaseType(db) != QSqlDriver::PostgreSQL)
+        QSKIP("Test requires PostgreSQL");
+
+    const QString tableName(qTableName("bulkTSTEST", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("create table " + tableName + " (id int, tz timestamptz, local timestamp)"));
+    // a session time zone that differs from the client's
+    QVERIFY_SQL(q, exec(QDateTime::currentDateTime().offsetFromUtc() == 11 * 3600
+                        ? "set time zone 'America/Los_Angeles'" : "set time zone 'Australia/Sydney'"));
+
+    QSqlRecord columns;
+    columns.append(QSqlField("id", QVariant::Int));
+    columns.append(QSqlField("tz", QVariant::DateTime));
+    columns.append(QSqlField("local", QVariant::DateTime));
+
+    const QDateTime dt(QDate(2016, 1, 15), QTime(12, 30, 45, 250));
+    const QDateTime utc(QDate(2016, 7, 1), QTime(23, 0), Qt::UTC);
+    QVector<QVariantList> values(3);
+    values[0] << 1 << 2;
+    values[1] << dt << utc;
+    values[2] << dt << utc;
+    QVERIFY2(db.driver()->bulkInsert(tableName, columns, values), qPrintable(db.driver()->lastError().text()));
+
+    QVERIFY_SQL(q, exec("select extract(epoch from tz), local from " + tableName + " order by id"));
+    QVERIFY_SQL(q, next());
+    QCOMPARE(qint64(q.value(0).toDouble() * 1000), dt.toMSecsSinceEpoch());
+    QCOMPARE(q.value(1).toDateTime(), dt);
+    QVERIFY_SQL(q, next());
+    QCOMPARE(qint64(q.value(0).toDouble() * 1000), utc.toMSecsSinceEpoch());
+    QCOMPARE(q.value(1).toDateTime(), utc.toLocalTime());
+}
+
+// records the statements and transactions of the generic bulkInsert()
+class RecordingResult : public QSqlResult
+{
+public:
+    explicit RecordingResult(const QSqlDriver *driver, QStringList *log)
+        : QSqlResult(driver), log(log) {}
+
+protected:
+    bool reset(const QString &query) Q_DECL_OVERRIDE
+    {
+        *log << query.left(query.indexOf(QLatin1Char(' ')));
+        setActive(true);
+        return true;
+    }
+    QVariant data(int) Q_DECL_OVERRIDE { return QVariant(); }
+    bool isNull(int) Q_DECL_OVERRIDE { return false; }
+    bool fetch(int) Q_DECL_OVERRIDE { return false; }
+    bool fetchFirst() Q_DECL_OVERRIDE { return false; }
+    bool fetchLast() Q_DECL_OVERRIDE { return false; }
+    int size() Q_DECL_OVERRIDE { return -1; }
+    int numRowsAffected() Q_DECL_OVERRIDE { return 1; }
+
+private:
+    QStringList *log;
+};
+
+// like the ODBC driver, starts a transaction even if one is open already
+class RecordingDriver : public QSqlDriver
+{
+public:
+    QStringList log;
+
+    bool hasFeature(DriverFeature f) const Q_DECL_OVERRIDE { return f == Transactions; }
+    bool open(const QString &, const QString &, const QString &, const QString &, int,
+              const QString &) Q_DECL_OVERRIDE
+    {
+        setOpen(true);
+        setOpenError(false);
+        return true;
+    }
+    void close() Q_DECL_OVERRIDE { setOpen(false); }
+    QSqlResult *createResult() const Q_DECL_OVERRIDE
+    { return new RecordingResult(this, const_cast<QStringList *>(&log)); }
+    bool beginTransaction() Q_DECL_OVERRIDE { log << "BEGIN"; return true; }
+    bool commitTransaction() Q_DECL_OVERRIDE { log << "COMMIT"; return true; }
+    bool rollbackTransaction() Q_DECL_OVERRIDE { log << "ROLLBACK"; return true; }
+};
+
+void tst_QSqlDriver::bulkInsertFallbackTransaction()
+{
+    const QString connectionName = QStringLiteral("bulkInsertFallbackTransaction");
+    {
+        RecordingDriver *driver = new RecordingDriver;
+        QSqlDatabase db = QSqlDatabase::addDatabase(driver, connectionName);
+        QVERIFY(db.open());
+
+        QSqlRecord columns;
+        columns.append(QSqlField("id", QVariant::Int));
+        QVector<QVariantList> values(1);
+        values[0] << 1 << 2;
+
+        // without a transaction, the rows get one of their own
+        QVERIFY(driver->bulkInsert("items", columns, values));
+        QCOMPARE(driver->log, QStringList() << "BEGIN" << "INSERT" << "INSERT" << "COMMIT");
+
+        // the rows join the transaction of the caller, which stays open
+        driver->log.clear();
+        QVERIFY(db.transaction());
+        QVERIFY(driver->bulkInsert("items", columns, values));
+        QCOMPARE(driver->log, QStringList() << "BEGIN" << "INSERT" << "INSERT");
+        QVERIFY(db.rollback());
+
+        driver->log.clear();
+        QVERIFY(driver->bulkInsert("items", columns, values));
+        QCOMPARE(driver->log, QStringList() << "BEGIN" << "INSERT" << "INSERT" << "COMMIT");
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
 QTEST_MAIN(tst_QSqlDriver)
 #include "tst_qsqldriver.moc"
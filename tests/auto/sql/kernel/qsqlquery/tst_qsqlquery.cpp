@@ -163,6 +163,14 @@ private slots:
     void psql_bindWithDoubleColonCastOperator();
     void psql_specialFloatValues_data() { generic_data("QPSQL"); }
     void psql_specialFloatValues();
+    void psql_forwardOnlyStreaming_data() { generic_data("QPSQL"); }
+    void psql_forwardOnlyStreaming();
+    void psql_batchExecPipeline_data() { generic_data("QPSQL"); }
+    void psql_batchExecPipeline();
+    void psql_fractionalIntegerParameters_data() { generic_data("QPSQL"); }
+    void psql_fractionalIntegerParameters();
+    void execAsync_data() { generic_data(); }
+    void execAsync();
     void queryOnInvalidDatabase_data() { generic_data(); }
     void queryOnInvalidDatabase();
     void createQueryOnClosedDatabase_data() { generic_data(); }
@@ -363,7 +371,10 @@ void tst_QSqlQuery::dropTestTables( QSqlDatabase db )
                << qTableName("bug2192", __FILE__, db);
 
     if (dbType == QSqlDriver::PostgreSQL)
-        tablenames << qTableName("task_233829", __FILE__, db);
+        tablenames << qTableName("task_233829", __FILE__, db)
+                   << qTableName("streamtest", __FILE__, db)
+                   << qTableName("pipelinetest", __FILE__, db)
+                   << qTableName("fracinttest", __FILE__, db);
 
     if (dbType == QSqlDriver::SQLite)
         tablenames << qTableName("record_sqlite", __FILE__, db);
@@ -2477,6 +2488,235 @@ void tst_QSqlQuery::psql_specialFloatValues()
     QVERIFY_SQL( query, exec("drop table " + tableName) );
 }
 
+void tst_QSqlQuery::psql_forwardOnlyStreaming()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    const QString tableName = qTableName("streamtest", __FILE__, db);
+    QSqlQuery q( db );
+    QVERIFY_SQL( q, exec( "create table " + tableName + " (id int, big bigint, num numeric(12,4), "
+                          "dbl float8, txt varchar(20), bin bytea, d date, t time, ts timestamp)" ) );
+    QVERIFY_SQL( q, exec( "insert into " + tableName + " select i, i * 10000000000, i / 7.0, i / 3.0, "
+                          "'row' || i, decode(md5(i::text), 'hex'), date '2016-01-01' + i, "
+                          "time '12:00:00.123' + i * interval '1 second', "
+                          "timestamp '2016-01-01 12:00:00.5' + i * interval '1 hour' "
+                          "from generate_series(0, 999) i" ) );
+
+    QVector<QSqlRecord> expected;
+    QVERIFY_SQL( q, exec( "select * from " + tableName + " order by id" ) );
+    while (q.next())
+        expected.append(q.record());
+    QCOMPARE(expected.size(), 1000);
+
+    // text format when executed directly, binary format when prepared
+    for (int prepared = 0; prepared < 2; ++prepared) {
+        QSqlQuery stream( db );
+        stream.setForwardOnly(true);
+        if (prepared) {
+            QVERIFY_SQL( stream, prepare( "select * from " + tableName + " where id >= ? order by id" ) );
+            stream.addBindValue(0);
+            QVERIFY_SQL( stream, exec() );
+        } else {
+            QVERIFY_SQL( stream, exec( "select * from " + tableName + " order by id" ) );
+        }
+        int row = 0;
+        while (stream.next()) {
+            QCOMPARE(stream.record(), expected.at(row));
+            ++row;
+        }
+        QVERIFY2(!stream.lastError().isValid(), qPrintable(stream.lastError().text()));
+        QCOMPARE(row, expected.size());
+
+        if (prepared)
+            QVERIFY_SQL( stream, exec() );
+        else
+            QVERIFY_SQL( stream, exec( "select * from " + tableName + " order by id" ) );
+        QVERIFY(stream.last());
+        QCOMPARE(stream.value(0).toInt(), 999);
+    }
+
+    // executing another query discards the rows that have not been fetched
+    QSqlQuery stream( db );
+    stream.setForwardOnly(true);
+    QVERIFY_SQL( stream, exec( "select id from " + tableName + " order by id" ) );
+    QVERIFY_SQL( stream, next() );
+    QCOMPARE(stream.value(0).toInt(), 0);
+    QVERIFY_SQL( q, exec( "select count(*) from " + tableName ) );
+    QVERIFY_SQL( q, next() );
+    QCOMPARE(q.value(0).toInt(), 1000);
+    QVERIFY(!stream.next());
+    QVERIFY(stream.lastError().isValid());
+
+    // finish() releases the connection
+    QVERIFY_SQL( stream, exec( "select id from " + tableName + " order by id" ) );
+    QVERIFY_SQL( stream, next() );
+    stream.finish();
+    QVERIFY_SQL( q, exec( "drop table " + tableName ) );
+}
+
+void tst_QSqlQuery::psql_batchExecPipeline()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    if ( !db.driver()->hasFeature( QSqlDriver::BatchOperations ) )
+        QSKIP( "Database can't do BatchOperations");
+
+    const QString tableName = qTableName("pipelinetest", __FILE__, db);
+    QSqlQuery q( db );
+    QVERIFY_SQL( q, exec( "create table " + tableName + " (id int primary key, val float8, data bytea)" ) );
+
+    // more rows than the driver keeps in flight at once
+    QVariantList ids, vals, blobs;
+    for (int i = 0; i < 1000; ++i) {
+        ids << i;
+        vals << i / 4.0;
+        blobs << QByteArray(i % 16, char(i));
+    }
+    QVERIFY_SQL( q, prepare( "insert into " + tableName + " values (?, ?, ?)" ) );
+    q.addBindValue(ids);
+    q.addBindValue(vals);
+    q.addBindValue(blobs);
+    QVERIFY_SQL( q, execBatch() );
+
+    QVERIFY_SQL( q, exec( "select id, val, data from " + tableName + " order by id" ) );
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY_SQL( q, next() );
+        QCOMPARE(q.value(0).toInt(), i);
+        QCOMPARE(q.value(1).toDouble(), i / 4.0);
+        QCOMPARE(q.value(2).toByteArray(), QByteArray(i % 16, char(i)));
+    }
+    QVERIFY(!q.next());
+
+    // a failing row rejects the whole batch
+    ids.clear();
+    ids << 1000 << 1001 << 0 << 1002;
+    QVERIFY_SQL( q, prepare( "insert into " + tableName + " (id) values (?)" ) );
+    q.addBindValue(ids);
+    QVERIFY(!q.execBatch());
+    QVERIFY(q.lastError().isValid());
+    QVERIFY_SQL( q, exec( "select count(*) from " + tableName ) );
+    QVERIFY_SQL( q, next() );
+    QCOMPARE(q.value(0).toInt(), 1000);
+
+    QVERIFY_SQL( q, exec( "drop table " + tableName ) );
+}
+
+void tst_QSqlQuery::execAsync()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    QSqlQuery q( db );
+    QFutureWatcher<QSqlRecord> watcher;
+    QSignalSpy readySpy(&watcher, SIGNAL(resultsReadyAt(int,int)));
+    watcher.setFuture(q.execAsync("select id, t_varchar from " + qtest + " order by id"));
+    QTRY_VERIFY(watcher.isFinished());
+    QVERIFY(readySpy.count() > 0);
+    QVERIFY2(!q.lastError().isValid(), qPrintable(q.lastError().text()));
+    QVERIFY(q.isActive());
+    QVERIFY(q.isForwardOnly());
+    QVERIFY(!q.next());
+
+    QList<QSqlRecord> records = watcher.future().results();
+    QCOMPARE(records.size(), 5);
+    for (int i = 0; i < records.size(); ++i) {
+        QCOMPARE(records.at(i).count(), 2);
+        QCOMPARE(records.at(i).value(0).toInt(), i + 1);
+        QCOMPARE(records.at(i).value(1).toString(), QString("VarChar%1").arg(i + 1));
+    }
+
+    // prepared query
+    QVERIFY_SQL( q, prepare( "select id from " + qtest + " where id > ? order by id" ) );
+    q.addBindValue(3);
+    QFuture<QSqlRecord> future = q.execAsync();
+    QTRY_VERIFY(future.isFinished());
+    QCOMPARE(future.resultCount(), 2);
+    QCOMPARE(future.resultAt(0).value(0).toInt(), 4);
+    QCOMPARE(future.resultAt(1).value(0).toInt(), 5);
+
+    // non-select statement
+    future = q.execAsync("update " + qtest + " set t_varchar = t_varchar where id < 3");
+    QTRY_VERIFY(future.isFinished());
+    QCOMPARE(future.resultCount(), 0);
+    QVERIFY2(q.isActive(), qPrintable(q.lastError().text()));
+    QVERIFY(!q.isSelect());
+    if (db.driver()->hasFeature(QSqlDriver::QuerySize))
+        QCOMPARE(q.numRowsAffected(), 2);
+
+    // errors are reported by the query
+    future = q.execAsync("select * from " + qTableName("nosuchtable", __FILE__, db));
+    QTRY_VERIFY(future.isFinished());
+    QCOMPARE(future.resultCount(), 0);
+    QVERIFY(q.lastError().isValid());
+    QVERIFY(!q.isActive());
+
+    // the connection waits for the asynchronous query before executing the next one
+    future = q.execAsync("select id from " + qtest);
+    QSqlQuery q2( db );
+    QVERIFY_SQL( q2, exec( "select count(*) from " + qtest ) );
+    QVERIFY_SQL( q2, next() );
+    QCOMPARE(q2.value(0).toInt(), 5);
+    QTRY_VERIFY(future.isFinished());
+    QCOMPARE(future.resultCount(), 5);
+
+    // re-executing finishes the pending query first
+    future = q.execAsync("select id from " + qtest);
+    QVERIFY_SQL( q, exec( "select count(*) from " + qtest ) );
+    QVERIFY(future.isFinished());
+    QVERIFY_SQL( q, next() );
+    QCOMPARE(q.value(0).toInt(), 5);
+
+    // a canceled query is not an error
+    const bool canSleep = tst_Databases::getDatabaseType(db) == QSqlDriver::PostgreSQL;
+    future = q.execAsync(canSleep ? QString("select pg_sleep(30)") : "select id from " + qtest);
+    future.cancel();
+    QTRY_VERIFY(future.isFinished());
+    QVERIFY2(!q.lastError().isValid(), qPrintable(q.lastError().text()));
+    if (canSleep)
+        QVERIFY(!q.isActive());
+}
+
+void tst_QSqlQuery::psql_fractionalIntegerParameters()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    const QString tableName = qTableName("fracinttest", __FILE__, db);
+    QSqlQuery q( db );
+    QVERIFY_SQL( q, exec( "create table " + tableName + " (id int4, s int2, l int8)" ) );
+
+    // rounded like the server's assignment cast from numeric
+    const double values[] = { 1.5, -2.5, 2.4, -0.5 };
+    const int expected[] = { 2, -3, 2, -1 };
+    QVERIFY_SQL( q, prepare( "insert into " + tableName + " values (?, ?, ?)" ) );
+    for (int i = 0; i < 4; ++i) {
+        q.addBindValue(i);
+        q.addBindValue(values[i]);
+        q.addBindValue(QVariant(float(values[i])));
+        QVERIFY_SQL( q, exec() );
+    }
+
+    QVERIFY_SQL( q, exec( "select s, l from " + tableName + " order by id" ) );
+    for (int i = 0; i < 4; ++i) {
+        QVERIFY_SQL( q, next() );
+        QCOMPARE(q.value(0).toInt(), expected[i]);
+        QCOMPARE(q.value(1).toLongLong(), qlonglong(expected[i]));
+    }
+
+    // out of range for int2
+    QVERIFY_SQL( q, prepare( "insert into " + tableName + " (s) values (?)" ) );
+    q.addBindValue(40000.5);
+    QVERIFY(!q.exec());
+
+    QVERIFY_SQL( q, exec( "drop table " + tableName ) );
+}
+
 /* For task 157397: Using QSqlQuery with an invalid QSqlDatabase
    does not set the last error of the query.
    This test function will output some warnings, that's ok.
@@ -1,3 +1,3 @@
 TEMPLATE = subdirs
-SUBDIRS = qtextcodec
+SUBDIRS = qtextcodec utf8
 	
@@ -0,0 +1,175 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QString>
+#include <QTextCodec>
+#include <qtest.h>
+
+class tst_Utf8 : public QObject
+{
+    Q_OBJECT
+private slots:
+    void fromUtf8_data();
+    void fromUtf8();
+    void codecToUnicode_data();
+    void codecToUnicode();
+    void toUtf8_data();
+    void toUtf8();
+};
+
+// Builds roughly 64 kB of text by cycling through the given words, separated
+// by spaces, so that each corpus has the character mix of real prose rather
+// than a single repeated code point.
+static QByteArray corpus(const char *const *words, int count)
+{
+    QByteArray result;
+    result.reserve(65536 + 64);
+    for (int i = 0; result.size() < 65536; ++i) {
+        result += words[i % count];
+        result += (i % 11 == 10) ? '\n' : ' ';
+    }
+    return result;
+}
+
+template <int N>
+static QByteArray corpus(const char *const (&words)[N])
+{
+    return corpus(words, N);
+}
+
+static void addCorpora()
+{
+    QTest::addColumn<QByteArray>("utf8");
+
+    static const char *const ascii[] = {
+        "The", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog.",
+        "Pack", "my", "box", "with", "five", "dozen", "liquor", "jugs."
+    };
+    static const char *const latin[] = {
+        "Falsches", "\xc3\x9c" "ben", "von", "Xylophonmusik", "qu\xc3\xa4lt",
+        "jeden", "gr\xc3\xb6\xc3\x9f" "eren", "Zwerg.", "Voix", "ambigu\xc3\xab",
+        "d'un", "c\xc5\x93ur", "qui", "au", "z\xc3\xa9phyr", "pr\xc3\xa9" "f\xc3\xa8re",
+        "les", "jattes", "de", "kiwis."
+    };
+    static const char *const greekCyrillic[] = {
+        "\xce\x93\xce\xb1\xce\xb6\xce\xad\xce\xb5\xcf\x82",
+        "\xce\xba\xce\xb1\xe1\xbd\xb6",
+        "\xce\xbc\xcf\x85\xcf\x81\xcf\x84\xce\xb9\xe1\xbd\xb2\xcf\x82",
+        "\xce\xb4\xe1\xbd\xb2\xce\xbd",
+        "\xd0\xa1\xd1\x8a\xd0\xb5\xd1\x88\xd1\x8c",
+        "\xd0\xb6\xd0\xb5",
+        "\xd0\xb5\xd1\x89\xd1\x91",
+        "\xd1\x8d\xd1\x82\xd0\xb8\xd1\x85",
+        "\xd0\xbc\xd1\x8f\xd0\xb3\xd0\xba\xd0\xb8\xd1\x85",
+        "\xd1\x84\xd1\x80\xd0\xb0\xd0\xbd\xd1\x86\xd1\x83\xd0\xb7\xd1\x81\xd0\xba\xd0\xb8\xd1\x85",
+        "\xd0\xb1\xd1\x83\xd0\xbb\xd0\xbe\xd0\xba,"
+    };
+    static const char *const cjk[] = {
+        "\xe3\x81\x84\xe3\x82\x8d\xe3\x81\xaf\xe3\x81\xab\xe3\x81\xbb\xe3\x81\xb8\xe3\x81\xa8",
+        "\xe3\x81\xa1\xe3\x82\x8a\xe3\x81\xac\xe3\x82\x8b\xe3\x82\x92",
+        "\xe6\x95\x8f\xe6\x8d\xb7\xe7\x9a\x84\xe6\xa3\x95\xe8\x89\xb2\xe7\x8b\x90\xe7\x8b\xb8",
+        "\xe8\xb7\xb3\xe8\xbf\x87\xe4\xba\x86\xe9\x82\xa3\xe5\x8f\xaa\xe6\x87\x92\xe7\x8b\x97",
+        "\xed\x82\xa4\xec\x8a\xa4\xec\x9d\x98",
+        "\xea\xb3\xa0\xec\x9c\xa0\xec\xa1\xb0\xea\xb1\xb4\xec\x9d\x80"
+    };
+    static const char *const mixed[] = {
+        "Qt", "\xe2\x80\x94", "caf\xc3\xa9", "\xe6\x9d\xb1\xe4\xba\xac", "2016",
+        "\xf0\x9f\x98\x80", "\xd0\x9c\xd0\xbe\xd1\x81\xd0\xba\xd0\xb2\xd0\xb0",
+        "na\xc3\xafve", "\xe2\x82\xac" "42", "\xce\xb1\xce\xb2\xce\xb3", "ok",
+        "\xf0\x9f\x91\x8d", "\xed\x95\x9c\xea\xb8\x80"
+    };
+
+    QTest::newRow("ascii") << corpus(ascii);
+    QTest::newRow("latin") << corpus(latin);
+    QTest::newRow("greek-cyrillic") << corpus(greekCyrillic);
+    QTest::newRow("cjk") << corpus(cjk);
+    QTest::newRow("mixed-emoji") << corpus(mixed);
+}
+
+void tst_Utf8::fromUtf8_data()
+{
+    addCorpora();
+}
+
+void tst_Utf8::fromUtf8()
+{
+    QFETCH(QByteArray, utf8);
+
+    QString result;
+    QBENCHMARK {
+        result = QString::fromUtf8(utf8);
+    }
+    QCOMPARE(result.toUtf8(), utf8);
+}
+
+void tst_Utf8::codecToUnicode_data()
+{
+    addCorpora();
+}
+
+void tst_Utf8::codecToUnicode()
+{
+    QFETCH(QByteArray, utf8);
+
+    // goes through the stateful decoder used by QTextStream and QTextDecoder
+    QTextCodec *codec = QTextCodec::codecForMib(106);
+    QVERIFY(codec);
+
+    QString result;
+    QBENCHMARK {
+        QTextCodec::ConverterState state;
+        result = codec->toUnicode(utf8.constData(), utf8.size(), &state);
+    }
+    QCOMPARE(result.toUtf8(), utf8);
+}
+
+void tst_Utf8::toUtf8_data()
+{
+    addCorpora();
+}
+
+void tst_Utf8::toUtf8()
+{
+    QFETCH(QByteArray, utf8);
+
+    const QString string = QString::fromUtf8(utf8);
+    QByteArray result;
+    QBENCHMARK {
+        result = string.toUtf8();
+    }
+    QCOMPARE(result, utf8);
+}
+
+QTEST_MAIN(tst_Utf8)
+
+#include "main.moc"
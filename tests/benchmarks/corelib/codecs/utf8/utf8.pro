@@ -0,0 +1,3 @@
+TARGET = tst_bench_utf8
+QT = core testlib
+SOURCES += main.cpp
@@ -5,7 +5,10 @@ SUBDIRS = \
         qmetatype \
         qobject \
         qvariant \
-        qcoreapplication
+        qcoreapplication \
+        queuedconnection
+
+linux:contains(QT_CONFIG, eventfd): SUBDIRS += qeventdispatcher
 
 !qtHaveModule(widgets): SUBDIRS -= \
     qmetaobject \
@@ -0,0 +1,239 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <private/qeventdispatcher_unix_p.h>
+#include <private/qeventdispatcher_epoll_p.h>
+
+#include <qtest.h>
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+enum DispatcherType {
+    Select,
+    EpollLevelTriggered,
+    EpollEdgeTriggered
+};
+Q_DECLARE_METATYPE(DispatcherType)
+
+// Lives in the dispatcher's thread: echoes every byte arriving on the active
+// socket while a configurable number of idle notifiers stay registered.
+class Echo : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Echo(int activeFd) : activeFd(activeFd) {}
+
+public slots:
+    void setup(const QVector<int> &idleFds)
+    {
+        QSocketNotifier *active = new QSocketNotifier(activeFd, QSocketNotifier::Read, this);
+        connect(active, SIGNAL(activated(int)), this, SLOT(echo(int)));
+        for (int i = 0; i < idleFds.size(); ++i)
+            new QSocketNotifier(idleFds.at(i), QSocketNotifier::Read, this);
+    }
+
+    void teardown()
+    {
+        qDeleteAll(children());
+        thread()->quit();
+    }
+
+    void echo(int fd)
+    {
+        char c[16];
+        ssize_t n;
+        // drain completely so that edge-triggered mode behaves
+        while ((n = ::read(fd, c, sizeof(c))) > 0)
+            ::write(fd, c, n);
+    }
+
+private:
+    int activeFd;
+};
+
+class tst_QEventDispatcher : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void idleNotifiers_data();
+    void idleNotifiers();
+    void restartTimer_data();
+    void restartTimer();
+};
+
+void tst_QEventDispatcher::initTestCase()
+{
+    qRegisterMetaType<QVector<int> >();
+
+    // the 10k rows need more descriptors than the usual soft limit
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+void tst_QEventDispatcher::idleNotifiers_data()
+{
+    QTest::addColumn<DispatcherType>("type");
+    QTest::addColumn<int>("idle");
+
+    const int counts[] = { 10, 1000, 10000 };
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+        const QByteArray n = QByteArray::number(counts[i]);
+        QTest::newRow(("select-" + n).constData()) << Select << counts[i];
+        QTest::newRow(("epoll-" + n).constData()) << EpollLevelTriggered << counts[i];
+        QTest::newRow(("epoll-edge-" + n).constData()) << EpollEdgeTriggered << counts[i];
+    }
+}
+
+void tst_QEventDispatcher::idleNotifiers()
+{
+    QFETCH(DispatcherType, type);
+    QFETCH(int, idle);
+
+    int sv[2];
+    QVERIFY(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) == 0);
+    ::fcntl(sv[1], F_SETFL, ::fcntl(sv[1], F_GETFL) | O_NONBLOCK);
+
+    // eventfds with a zero counter are never readable, one descriptor each
+    QVector<int> idleFds;
+    idleFds.reserve(idle);
+    int highest = sv[1];
+    for (int i = 0; i < idle; ++i) {
+        int fd = eventfd(0, EFD_CLOEXEC);
+        if (fd == -1)
+            break;
+        idleFds.append(fd);
+        highest = qMax(highest, fd);
+    }
+
+    const auto cleanup = [&]() {
+        for (int fd : idleFds)
+            ::close(fd);
+        ::close(sv[0]);
+        ::close(sv[1]);
+    };
+
+    if (idleFds.size() != idle) {
+        cleanup();
+        QSKIP("Not enough file descriptors available");
+    }
+    if (type == Select && highest >= FD_SETSIZE) {
+        cleanup();
+        QSKIP("select() cannot watch descriptors beyond FD_SETSIZE");
+    }
+
+    QThread thread;
+    switch (type) {
+    case Select:
+        thread.setEventDispatcher(new QEventDispatcherUNIX);
+        break;
+    case EpollLevelTriggered:
+        thread.setEventDispatcher(new QEventDispatcherEpoll(QEventDispatcherEpoll::LevelTriggered));
+        break;
+    case EpollEdgeTriggered:
+        thread.setEventDispatcher(new QEventDispatcherEpoll(QEventDispatcherEpoll::EdgeTriggered));
+        break;
+    }
+
+    Echo echo(sv[1]);
+    echo.moveToThread(&thread);
+    thread.start();
+    QMetaObject::invokeMethod(&echo, "setup", Qt::BlockingQueuedConnection,
+                              Q_ARG(QVector<int>, idleFds));
+
+    // one round trip through the dispatcher per iteration
+    char c = 'x';
+    QBENCHMARK {
+        QCOMPARE(::write(sv[0], &c, 1), ssize_t(1));
+        QCOMPARE(::read(sv[0], &c, 1), ssize_t(1));
+    }
+
+    QMetaObject::invokeMethod(&echo, "teardown", Qt::BlockingQueuedConnection);
+    thread.wait();
+    cleanup();
+}
+
+void tst_QEventDispatcher::restartTimer_data()
+{
+    QTest::addColumn<int>("idle");
+    QTest::addColumn<Qt::TimerType>("timerType");
+
+    const int counts[] = { 10, 1000, 50000 };
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+        const QByteArray n = QByteArray::number(counts[i]);
+        QTest::newRow(("precise-" + n).constData()) << counts[i] << Qt::PreciseTimer;
+        QTest::newRow(("coarse-" + n).constData()) << counts[i] << Qt::CoarseTimer;
+    }
+}
+
+// Restarting a timeout while many others are pending, like a server that
+// pushes back a connection timeout on every request.
+void tst_QEventDispatcher::restartTimer()
+{
+    QFETCH(int, idle);
+    QFETCH(Qt::TimerType, timerType);
+
+    // one object per timer, QObject::killTimer() is linear in the number of
+    // timers of the object
+    QVector<QObject *> connections(idle);
+    for (int i = 0; i < idle; ++i) {
+        connections[i] = new QObject;
+        connections[i]->startTimer(30000 + i % 10000, timerType);
+    }
+
+    QObject object;
+    int id = object.startTimer(30000, timerType);
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            object.killTimer(id);
+            id = object.startTimer(30000, timerType);
+        }
+    }
+
+    qDeleteAll(connections);
+}
+
+QTEST_MAIN(tst_QEventDispatcher)
+
+#include "main.moc"
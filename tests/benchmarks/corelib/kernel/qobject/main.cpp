@@ -48,6 +48,10 @@ Q_OBJECT
 private slots:
     void signal_slot_benchmark();
     void signal_slot_benchmark_data();
+    void signal_emission_benchmark_data();
+    void signal_emission_benchmark();
+    void signal_emission_threads_benchmark_data();
+    void signal_emission_threads_benchmark();
     void qproperty_benchmark_data();
     void qproperty_benchmark();
     void dynamic_property_benchmark();
@@ -132,6 +136,99 @@ void QObjectBenchmark::signal_slot_benchmark()
     }
 }
 
+void QObjectBenchmark::signal_emission_benchmark_data()
+{
+    QTest::addColumn<int>("receiverCount");
+    QTest::addColumn<int>("type");
+    const int counts[] = { 1, 4, 16, 64 };
+    for (int i = 0; i < int(sizeof counts / sizeof *counts); ++i) {
+        const QByteArray count = QByteArray::number(counts[i]);
+        QTest::newRow(count + " receivers, SLOT()") << counts[i] << 0;
+        QTest::newRow(count + " receivers, ptr") << counts[i] << 1;
+        QTest::newRow(count + " receivers, functor") << counts[i] << 2;
+    }
+}
+
+void QObjectBenchmark::signal_emission_benchmark()
+{
+    QFETCH(int, receiverCount);
+    QFETCH(int, type);
+
+    Object sender;
+    QVector<Object *> receivers;
+    Functor functor;
+    for (int i = 0; i < receiverCount; ++i) {
+        Object *receiver = new Object;
+        receivers << receiver;
+        if (type == 0)
+            QObject::connect(&sender, SIGNAL(signal0()), receiver, SLOT(slot0()));
+        else if (type == 1)
+            QObject::connect(&sender, &Object::signal0, receiver, &Object::slot0);
+        else
+            QObject::connect(&sender, &Object::signal0, receiver, functor);
+        // connections to other signals share the sender's lists
+        QObject::connect(&sender, &Object::signal1, receiver, &Object::slot1);
+    }
+
+    QBENCHMARK {
+        sender.emitSignal0();
+    }
+
+    qDeleteAll(receivers);
+}
+
+class EmitterThread : public QThread
+{
+public:
+    Object *sender;
+    QSemaphore *go;
+    void run() Q_DECL_OVERRIDE
+    {
+        go->acquire();
+        for (int i = 0; i < 100000; ++i)
+            sender->emitSignal0();
+    }
+};
+
+void QObjectBenchmark::signal_emission_threads_benchmark_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("8 threads") << 8;
+}
+
+// several threads emitting the same signal, connected directly to functors
+void QObjectBenchmark::signal_emission_threads_benchmark()
+{
+    QFETCH(int, threadCount);
+
+    Object sender;
+    Functor functor;
+    for (int i = 0; i < 4; ++i)
+        QObject::connect(&sender, &Object::signal0, &sender, functor, Qt::DirectConnection);
+
+    QVector<EmitterThread *> threads;
+    QSemaphore go;
+    for (int i = 0; i < threadCount; ++i) {
+        EmitterThread *thread = new EmitterThread;
+        thread->sender = &sender;
+        thread->go = &go;
+        threads << thread;
+    }
+
+    QBENCHMARK {
+        for (int i = 0; i < threadCount; ++i)
+            threads.at(i)->start();
+        go.release(threadCount);
+        for (int i = 0; i < threadCount; ++i)
+            threads.at(i)->wait();
+    }
+
+    qDeleteAll(threads);
+}
+
 void QObjectBenchmark::qproperty_benchmark_data()
 {
     QTest::addColumn<QByteArray>("name");
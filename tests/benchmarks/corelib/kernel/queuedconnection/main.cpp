@@ -0,0 +1,182 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEventLoop>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtTest/QtTest>
+
+class Producer : public QThread
+{
+    Q_OBJECT
+public:
+    Producer(QSemaphore *go, int count)
+        : go(go), count(count)
+    {}
+
+signals:
+    void ping(int value);
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        go->acquire();
+        for (int i = 0; i < count; ++i)
+            emit ping(i);
+    }
+
+private:
+    QSemaphore *go;
+    int count;
+};
+
+class Consumer : public QObject
+{
+    Q_OBJECT
+public:
+    Consumer() : loop(0), expected(0), received(0) {}
+
+    QEventLoop *loop;
+    int expected;
+    int received;
+
+public slots:
+    void pong(int)
+    {
+        if (++received == expected)
+            loop->quit();
+    }
+
+    void latest(int value)
+    {
+        ++received;
+        if (value == expected)
+            loop->quit();
+    }
+};
+
+class tst_QueuedConnection : public QObject
+{
+    Q_OBJECT
+private slots:
+    void crossThread_data();
+    void crossThread();
+    void coalesced_data();
+    void coalesced();
+};
+
+void tst_QueuedConnection::crossThread_data()
+{
+    QTest::addColumn<int>("producerCount");
+    QTest::addColumn<int>("signalsPerProducer");
+
+    QTest::newRow("1 producer") << 1 << 100000;
+    QTest::newRow("4 producers") << 4 << 25000;
+    QTest::newRow("16 producers") << 16 << 6250;
+}
+
+// Measures how fast one event loop receives queued signals emitted by a
+// number of threads at the same time; every row delivers 100000 calls.
+void tst_QueuedConnection::crossThread()
+{
+    QFETCH(int, producerCount);
+    QFETCH(int, signalsPerProducer);
+
+    Consumer consumer;
+    consumer.expected = producerCount * signalsPerProducer;
+
+    QBENCHMARK {
+        QSemaphore start;
+        QVector<Producer *> producers;
+        for (int i = 0; i < producerCount; ++i) {
+            Producer *producer = new Producer(&start, signalsPerProducer);
+            connect(producer, &Producer::ping, &consumer, &Consumer::pong, Qt::QueuedConnection);
+            producer->start();
+            producers.append(producer);
+        }
+
+        QEventLoop loop;
+        consumer.loop = &loop;
+        consumer.received = 0;
+        start.release(producerCount);
+        loop.exec();
+
+        foreach (Producer *producer, producers)
+            producer->wait();
+        qDeleteAll(producers);
+    }
+
+    QCOMPARE(consumer.received, consumer.expected);
+}
+
+void tst_QueuedConnection::coalesced_data()
+{
+    QTest::addColumn<int>("connectionType");
+
+    QTest::newRow("queued") << int(Qt::QueuedConnection);
+    QTest::newRow("coalesced") << int(Qt::CoalescedConnection);
+}
+
+// Measures how long it takes until an event loop has seen the last of
+// 100000 values emitted by another thread.
+void tst_QueuedConnection::coalesced()
+{
+    QFETCH(int, connectionType);
+    const int count = 100000;
+
+    Consumer consumer;
+    consumer.expected = count - 1;
+
+    QBENCHMARK {
+        QSemaphore start;
+        Producer producer(&start, count);
+        connect(&producer, &Producer::ping, &consumer, &Consumer::latest,
+                Qt::ConnectionType(connectionType));
+        producer.start();
+
+        QEventLoop loop;
+        consumer.loop = &loop;
+        consumer.received = 0;
+        start.release();
+        loop.exec();
+        producer.wait();
+    }
+
+    QVERIFY(consumer.received <= count);
+}
+
+QTEST_MAIN(tst_QueuedConnection)
+
+#include "main.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = tst_bench_queuedconnection
+
+QT = core testlib
+CONFIG += release
+
+SOURCES += main.cpp
@@ -0,0 +1,197 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtCore/QtCore>
+#include <QtTest/QtTest>
+
+class tst_QReadWriteLock : public QObject
+{
+    Q_OBJECT
+private slots:
+    void uncontended_data();
+    void uncontended();
+    void readOnly_data();
+    void readOnly();
+    void readMostly_data();
+    void readMostly();
+};
+
+enum LockType {
+    Mutex,
+    ReadLock,
+    WriteLock,
+    RecursiveReadLock
+};
+Q_DECLARE_METATYPE(LockType)
+
+void tst_QReadWriteLock::uncontended_data()
+{
+    QTest::addColumn<LockType>("type");
+
+    QTest::newRow("QMutex") << Mutex;
+    QTest::newRow("QReadWriteLock, read") << ReadLock;
+    QTest::newRow("QReadWriteLock, write") << WriteLock;
+    QTest::newRow("QReadWriteLock, recursive read") << RecursiveReadLock;
+}
+
+void tst_QReadWriteLock::uncontended()
+{
+    QFETCH(LockType, type);
+
+    QMutex mutex;
+    QReadWriteLock lock;
+    QReadWriteLock recursiveLock(QReadWriteLock::Recursive);
+
+    switch (type) {
+    case Mutex:
+        QBENCHMARK {
+            for (int i = 0; i < 10000; ++i) {
+                mutex.lock();
+                mutex.unlock();
+            }
+        }
+        break;
+    case ReadLock:
+        QBENCHMARK {
+            for (int i = 0; i < 10000; ++i) {
+                lock.lockForRead();
+                lock.unlock();
+            }
+        }
+        break;
+    case WriteLock:
+        QBENCHMARK {
+            for (int i = 0; i < 10000; ++i) {
+                lock.lockForWrite();
+                lock.unlock();
+            }
+        }
+        break;
+    case RecursiveReadLock:
+        QBENCHMARK {
+            for (int i = 0; i < 10000; ++i) {
+                recursiveLock.lockForRead();
+                recursiveLock.unlock();
+            }
+        }
+        break;
+    }
+}
+
+class LockThread : public QThread
+{
+public:
+    QReadWriteLock *lock;
+    QMap<int, int> *map;
+    int iterations;
+    int writeInterval; // 0 for never
+
+    LockThread(QReadWriteLock *lock, QMap<int, int> *map, int iterations, int writeInterval)
+        : lock(lock), map(map), iterations(iterations), writeInterval(writeInterval)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        int sum = 0;
+        for (int i = 0; i < iterations; ++i) {
+            if (writeInterval && i % writeInterval == 0) {
+                QWriteLocker locker(lock);
+                map->insert(i % 64, i);
+            } else {
+                QReadLocker locker(lock);
+                sum += map->value(i % 64);
+            }
+        }
+        result = sum;
+    }
+
+    int result;
+};
+
+static void runThreads(int threadCount, int writeInterval)
+{
+    QReadWriteLock lock;
+    QMap<int, int> map;
+    for (int i = 0; i < 64; ++i)
+        map.insert(i, i);
+
+    QBENCHMARK {
+        QVector<LockThread *> threads(threadCount);
+        for (int i = 0; i < threadCount; ++i) {
+            threads[i] = new LockThread(&lock, &map, 100000, writeInterval);
+            threads[i]->start();
+        }
+        for (int i = 0; i < threadCount; ++i)
+            threads[i]->wait();
+        qDeleteAll(threads);
+    }
+}
+
+void tst_QReadWriteLock::readOnly_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("8 threads") << 8;
+}
+
+void tst_QReadWriteLock::readOnly()
+{
+    QFETCH(int, threadCount);
+    runThreads(threadCount, 0);
+}
+
+void tst_QReadWriteLock::readMostly_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<int>("writeInterval");
+
+    QTest::newRow("2 threads, 1% writes") << 2 << 100;
+    QTest::newRow("4 threads, 1% writes") << 4 << 100;
+    QTest::newRow("8 threads, 1% writes") << 8 << 100;
+    QTest::newRow("4 threads, 10% writes") << 4 << 10;
+}
+
+void tst_QReadWriteLock::readMostly()
+{
+    QFETCH(int, threadCount);
+    QFETCH(int, writeInterval);
+    runThreads(threadCount, writeInterval);
+}
+
+QTEST_MAIN(tst_QReadWriteLock)
+
+#include "tst_qreadwritelock.moc"
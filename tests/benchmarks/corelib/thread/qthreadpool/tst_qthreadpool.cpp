@@ -45,6 +45,8 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void manyTinyTasks_data();
+    void manyTinyTasks();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -80,5 +82,65 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+class CountingRunnable : public QRunnable
+{
+public:
+    explicit CountingRunnable(QAtomicInt *counter) : counter(counter) {}
+    void run() Q_DECL_OVERRIDE {
+        counter->ref();
+    }
+
+    QAtomicInt *counter;
+};
+
+// starts its share of tasks from inside the pool
+class SpawningRunnable : public QRunnable
+{
+public:
+    SpawningRunnable(QThreadPool *pool, QAtomicInt *counter, int count)
+        : pool(pool), counter(counter), count(count) {}
+    void run() Q_DECL_OVERRIDE {
+        for (int i = 0; i < count; ++i)
+            pool->start(new CountingRunnable(counter));
+    }
+
+    QThreadPool *pool;
+    QAtomicInt *counter;
+    int count;
+};
+
+void tst_QThreadPool::manyTinyTasks_data()
+{
+    QTest::addColumn<int>("tasks");
+    QTest::addColumn<bool>("fromPool");
+
+    QTest::newRow("10000 from outside") << 10000 << false;
+    QTest::newRow("100000 from outside") << 100000 << false;
+    QTest::newRow("10000 from pool threads") << 10000 << true;
+    QTest::newRow("100000 from pool threads") << 100000 << true;
+}
+
+void tst_QThreadPool::manyTinyTasks()
+{
+    QFETCH(int, tasks);
+    QFETCH(bool, fromPool);
+
+    QThreadPool threadPool;
+    const int threads = threadPool.maxThreadCount();
+
+    QBENCHMARK {
+        QAtomicInt counter;
+        if (fromPool) {
+            for (int i = 0; i < threads; ++i)
+                threadPool.start(new SpawningRunnable(&threadPool, &counter, tasks / threads));
+        } else {
+            for (int i = 0; i < tasks; ++i)
+                threadPool.start(new CountingRunnable(&counter));
+        }
+        threadPool.waitForDone();
+        QCOMPARE(counter.load(), fromPool ? tasks / threads * threads : tasks);
+    }
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
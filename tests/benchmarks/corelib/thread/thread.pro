@@ -1,6 +1,7 @@
 TEMPLATE = subdirs
 SUBDIRS = \
         qmutex \
+        qreadwritelock \
         qthreadstorage \
         qthreadpool \
         qwaitcondition \
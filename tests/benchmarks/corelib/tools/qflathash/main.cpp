@@ -0,0 +1,238 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QFlatHash>
+#include <QHash>
+#include <QString>
+#include <QTest>
+#include <QVector>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertInt_data() { data(); }
+    void insertInt();
+    void lookupHitInt_data() { data(); }
+    void lookupHitInt();
+    void lookupMissInt_data() { data(); }
+    void lookupMissInt();
+    void iterateInt_data() { data(); }
+    void iterateInt();
+
+    void insertString_data() { data(); }
+    void insertString();
+    void lookupHitString_data() { data(); }
+    void lookupHitString();
+    void lookupMissString_data() { data(); }
+    void lookupMissString();
+
+private:
+    void data();
+};
+
+enum Container { UseQHash, UseQFlatHash };
+
+void tst_QFlatHash::data()
+{
+    QTest::addColumn<int>("container");
+    QTest::addColumn<int>("size");
+
+    static const int sizes[] = { 100, 10000, 1000000 };
+    for (int i = 0; i < int(sizeof(sizes) / sizeof(sizes[0])); ++i) {
+        const QByteArray n = QByteArray::number(sizes[i]);
+        QTest::newRow(("QHash:" + n).constData()) << int(UseQHash) << sizes[i];
+        QTest::newRow(("QFlatHash:" + n).constData()) << int(UseQFlatHash) << sizes[i];
+    }
+}
+
+// spread the keys, so that lookups do not walk the table in order
+static inline int intKey(int i)
+{
+    return int(uint(i) * 2654435761U);
+}
+
+static QVector<QString> stringKeys(int size, int offset = 0)
+{
+    QVector<QString> keys;
+    keys.reserve(size);
+    for (int i = 0; i < size; ++i)
+        keys << QStringLiteral("/usr/share/item/") + QString::number(intKey(i + offset));
+    return keys;
+}
+
+template <typename Hash>
+static void insertIntTemplate(int size)
+{
+    QBENCHMARK {
+        Hash hash;
+        for (int i = 0; i < size; ++i)
+            hash.insert(intKey(i), i);
+    }
+}
+
+template <typename Hash>
+static void lookupIntTemplate(int size, int offset)
+{
+    Hash hash;
+    for (int i = 0; i < size; ++i)
+        hash.insert(intKey(i), i);
+
+    int found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (int i = 0; i < size; ++i)
+            found += hash.contains(intKey(i + offset));
+    }
+    QCOMPARE(found, offset ? 0 : size);
+}
+
+template <typename Hash>
+static void iterateIntTemplate(int size)
+{
+    Hash hash;
+    for (int i = 0; i < size; ++i)
+        hash.insert(intKey(i), i);
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        sum = 0;
+        for (typename Hash::const_iterator it = hash.constBegin(), end = hash.constEnd(); it != end; ++it)
+            sum += it.value();
+    }
+    QCOMPARE(sum, qint64(size) * (size - 1) / 2);
+}
+
+template <typename Hash>
+static void insertStringTemplate(int size)
+{
+    const QVector<QString> keys = stringKeys(size);
+    QBENCHMARK {
+        Hash hash;
+        for (int i = 0; i < size; ++i)
+            hash.insert(keys.at(i), i);
+    }
+}
+
+template <typename Hash>
+static void lookupStringTemplate(int size, bool hit)
+{
+    const QVector<QString> keys = stringKeys(size);
+    const QVector<QString> lookups = hit ? keys : stringKeys(size, size);
+    Hash hash;
+    for (int i = 0; i < size; ++i)
+        hash.insert(keys.at(i), i);
+
+    int found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (int i = 0; i < size; ++i)
+            found += hash.contains(lookups.at(i));
+    }
+    QCOMPARE(found, hit ? size : 0);
+}
+
+void tst_QFlatHash::insertInt()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+    if (container == UseQHash)
+        insertIntTemplate<QHash<int, int> >(size);
+    else
+        insertIntTemplate<QFlatHash<int, int> >(size);
+}
+
+void tst_QFlatHash::lookupHitInt()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+    if (container == UseQHash)
+        lookupIntTemplate<QHash<int, int> >(size, 0);
+    else
+        lookupIntTemplate<QFlatHash<int, int> >(size, 0);
+}
+
+void tst_QFlatHash::lookupMissInt()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+    if (container == UseQHash)
+        lookupIntTemplate<QHash<int, int> >(size, size);
+    else
+        lookupIntTemplate<QFlatHash<int, int> >(size, size);
+}
+
+void tst_QFlatHash::iterateInt()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+    if (container == UseQHash)
+        iterateIntTemplate<QHash<int, int> >(size);
+    else
+        iterateIntTemplate<QFlatHash<int, int> >(size);
+}
+
+void tst_QFlatHash::insertString()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+    if (container == UseQHash)
+        insertStringTemplate<QHash<QString, int> >(size);
+    else
+        insertStringTemplate<QFlatHash<QString, int> >(size);
+}
+
+void tst_QFlatHash::lookupHitString()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+    if (container == UseQHash)
+        lookupStringTemplate<QHash<QString, int> >(size, true);
+    else
+        lookupStringTemplate<QFlatHash<QString, int> >(size, true);
+}
+
+void tst_QFlatHash::lookupMissString()
+{
+    QFETCH(int, container);
+    QFETCH(int, size);
+    if (container == UseQHash)
+        lookupStringTemplate<QHash<QString, int> >(size, false);
+    else
+        lookupStringTemplate<QFlatHash<QString, int> >(size, false);
+}
+
+QTEST_MAIN(tst_QFlatHash)
+
+#include "main.moc"
@@ -3,4 +3,5 @@ SUBDIRS = \
         qfile_vs_qnetworkaccessmanager \
         qnetworkreply \
         qnetworkreply_from_cache \
-        qnetworkdiskcache
+        qnetworkdiskcache \
+        qhttpcontentdecoder
@@ -0,0 +1,9 @@
+TEMPLATE = app
+TARGET = tst_bench_qhttpcontentdecoder
+
+QT -= gui
+QT += core-private network-private testlib
+
+CONFIG += release
+
+SOURCES += tst_qhttpcontentdecoder.cpp
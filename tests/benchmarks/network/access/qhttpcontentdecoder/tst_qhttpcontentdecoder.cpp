@@ -0,0 +1,151 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtNetwork/private/qhttpcontentdecoder_p.h>
+#include <QtCore/private/qbytedata_p.h>
+
+// Decodes a compressed reply body the way the HTTP protocol handlers feed it:
+// in pieces the size of a socket read or an HTTP/2 DATA frame.
+class tst_qhttpcontentdecoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void decode_data();
+    void decode();
+    void bytesAllocatedPerReply_data();
+    void bytesAllocatedPerReply();
+
+private:
+    void addRows();
+    // returns the size of the decoded output, or -1 on failure
+    qint64 decodeReply(const QByteArray &encoding, const QByteArray &data, int pieceSize,
+                       qint64 *allocated = 0, QByteArray *decoded = 0);
+
+    QByteArray body;
+    QByteArray zlibData;
+    QByteArray rawDeflateData;
+};
+
+void tst_qhttpcontentdecoder::initTestCase()
+{
+    // text compresses at a ratio typical for HTML, JSON and the like
+    for (int i = 0; body.size() < 8 * 1024 * 1024; ++i)
+        body += "<tr><td>row " + QByteArray::number(i) + "</td><td>" + QByteArray::number(i * 7919 % 10007)
+                + "</td><td>some repeated cell content</td></tr>\n";
+    zlibData = qCompress(body).mid(4); // strip qCompress' size prefix
+    rawDeflateData = zlibData.mid(2, zlibData.size() - 2 - 4);
+}
+
+void tst_qhttpcontentdecoder::addRows()
+{
+    QTest::addColumn<QByteArray>("encoding");
+    QTest::addColumn<bool>("raw");
+    QTest::addColumn<int>("pieceSize");
+
+    QTest::newRow("deflate-1460") << QByteArray("deflate") << false << 1460;
+    QTest::newRow("deflate-16384") << QByteArray("deflate") << false << 16384;
+    QTest::newRow("deflate-131072") << QByteArray("deflate") << false << 131072;
+    QTest::newRow("raw-deflate-16384") << QByteArray("deflate") << true << 16384;
+}
+
+qint64 tst_qhttpcontentdecoder::decodeReply(const QByteArray &encoding, const QByteArray &data,
+                                            int pieceSize, qint64 *allocated, QByteArray *decoded)
+{
+    QScopedPointer<QHttpContentDecoder> decoder(QHttpContentDecoderFactory::createDecoder(encoding));
+    if (!decoder)
+        return -1;
+
+    QByteDataBuffer out;
+    qint64 size = 0;
+    for (int offset = 0; offset < data.size(); offset += pieceSize) {
+        const int before = int(out.bufferCount());
+        if (decoder->decode(data.constData() + offset, qMin(pieceSize, data.size() - offset), &out) < 0)
+            return -1;
+        if (allocated) {
+            for (int i = before; i < out.bufferCount(); ++i)
+                *allocated += out[i].capacity();
+        }
+        // a reader takes the blocks as they are, like QHttpNetworkReply::readAny()
+        while (!out.isEmpty()) {
+            const QByteArray block = out.read();
+            size += block.size();
+            if (decoded)
+                decoded->append(block);
+        }
+    }
+    return size;
+}
+
+void tst_qhttpcontentdecoder::decode_data()
+{
+    addRows();
+}
+
+void tst_qhttpcontentdecoder::decode()
+{
+    QFETCH(QByteArray, encoding);
+    QFETCH(bool, raw);
+    QFETCH(int, pieceSize);
+
+    const QByteArray &data = raw ? rawDeflateData : zlibData;
+    QBENCHMARK {
+        QCOMPARE(decodeReply(encoding, data, pieceSize), qint64(body.size()));
+    }
+}
+
+void tst_qhttpcontentdecoder::bytesAllocatedPerReply_data()
+{
+    addRows();
+}
+
+void tst_qhttpcontentdecoder::bytesAllocatedPerReply()
+{
+    QFETCH(QByteArray, encoding);
+    QFETCH(bool, raw);
+    QFETCH(int, pieceSize);
+
+    // The decoded body is written once, into the blocks the reader gets;
+    // anything above the body size is slack from guessing the block size.
+    qint64 allocated = 0;
+    QByteArray decoded;
+    decodeReply(encoding, raw ? rawDeflateData : zlibData, pieceSize, &allocated, &decoded);
+    QCOMPARE(decoded, body);
+    QTest::setBenchmarkResult(allocated, QTest::BytesAllocated);
+}
+
+QTEST_MAIN(tst_qhttpcontentdecoder)
+
+#include "tst_qhttpcontentdecoder.moc"
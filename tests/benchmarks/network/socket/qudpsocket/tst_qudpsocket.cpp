@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2015 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <qudpsocket.h>
+#include <qhostaddress.h>
+
+class tst_QUdpSocket : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void pingPong_data();
+    void pingPong();
+};
+
+void tst_QUdpSocket::pingPong_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::addColumn<int>("datagramSize");
+
+    QTest::newRow("single-64") << false << 64;
+    QTest::newRow("batched-64") << true << 64;
+    QTest::newRow("single-1024") << false << 1024;
+    QTest::newRow("batched-1024") << true << 1024;
+}
+
+// Sends bursts of datagrams over the loopback interface and reads them back,
+// either one call per datagram or one call per burst.
+void tst_QUdpSocket::pingPong()
+{
+    QFETCH(bool, batched);
+    QFETCH(int, datagramSize);
+
+    enum { Burst = 32, Bursts = 500 };
+
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress(QHostAddress::LocalHost), 0));
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress(QHostAddress::LocalHost), 0));
+    const quint16 port = receiver.localPort();
+
+    QList<QByteArray> burst;
+    for (int i = 0; i < Burst; ++i)
+        burst << QByteArray(datagramSize, char('a' + i % 26));
+
+    QByteArray buffer(Burst * datagramSize, Qt::Uninitialized);
+    qint64 sizes[Burst];
+
+    QBENCHMARK {
+        for (int b = 0; b < Bursts; ++b) {
+            if (batched) {
+                QCOMPARE(sender.writeDatagrams(burst, QHostAddress::LocalHost, port), int(Burst));
+            } else {
+                for (int i = 0; i < Burst; ++i)
+                    QCOMPARE(sender.writeDatagram(burst.at(i), QHostAddress::LocalHost, port), qint64(datagramSize));
+            }
+
+            int received = 0;
+            while (received < Burst) {
+                if (!receiver.hasPendingDatagrams() && !receiver.waitForReadyRead(5000))
+                    QFAIL("Datagrams lost on the loopback interface");
+                if (batched) {
+                    const int n = receiver.readDatagrams(buffer.data(), datagramSize, sizes, Burst - received);
+                    QVERIFY(n >= 0);
+                    received += n;
+                } else {
+                    QCOMPARE(receiver.readDatagram(buffer.data(), datagramSize), qint64(datagramSize));
+                    ++received;
+                }
+            }
+        }
+    }
+}
+
+QTEST_MAIN(tst_QUdpSocket)
+#include "tst_qudpsocket.moc"
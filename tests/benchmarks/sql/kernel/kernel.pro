@@ -1,3 +1,5 @@
 TEMPLATE = subdirs
 SUBDIRS = \
        qsqlquery \
+       qsqlcachedresult \
+       qsqlitedriver
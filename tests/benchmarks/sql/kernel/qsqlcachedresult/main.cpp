@@ -0,0 +1,208 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+#include <QtSql/private/qsqlcolumncache_p.h>
+
+static const int columnCount = 4;
+
+class tst_QSqlCachedResult : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void fillVariantCache_data() { rows_data(); }
+    void fillVariantCache();
+    void fillColumnCache_data() { rows_data(); }
+    void fillColumnCache();
+    void readVariantCache_data() { rows_data(); }
+    void readVariantCache();
+    void readColumnCache_data() { rows_data(); }
+    void readColumnCache();
+
+    void iterateQuery_data();
+    void iterateQuery();
+
+private:
+    void rows_data();
+    static QString text(int row) { return QStringLiteral("row number %1").arg(row); }
+    static void fill(QVector<QVariant> &cache, int rows);
+    static void fill(QSqlColumnCache &cache, int rows);
+};
+
+void tst_QSqlCachedResult::initTestCase()
+{
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE")))
+        return;
+
+    QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"));
+    db.setDatabaseName(QStringLiteral(":memory:"));
+    QVERIFY2(db.open(), qPrintable(db.lastError().text()));
+
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QStringLiteral("create table bench (id integer, value double, name text, data blob)")));
+    QVERIFY(db.transaction());
+    QVERIFY(q.prepare(QStringLiteral("insert into bench values (?, ?, ?, ?)")));
+    for (int i = 0; i < 10000; ++i) {
+        q.addBindValue(i);
+        q.addBindValue(i * 0.5);
+        q.addBindValue(text(i));
+        q.addBindValue(QByteArray(16, char(i)));
+        QVERIFY(q.exec());
+    }
+    QVERIFY(db.commit());
+}
+
+void tst_QSqlCachedResult::cleanupTestCase()
+{
+    const QString name = QSqlDatabase::database().connectionName();
+    QSqlDatabase::database().close();
+    QSqlDatabase::removeDatabase(name);
+}
+
+void tst_QSqlCachedResult::rows_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::newRow("100") << 100;
+    QTest::newRow("10000") << 10000;
+}
+
+void tst_QSqlCachedResult::fill(QVector<QVariant> &cache, int rows)
+{
+    cache.resize(rows * columnCount);
+    for (int row = 0; row < rows; ++row) {
+        const QString str = text(row);
+        const QByteArray ba(16, char(row));
+        const int idx = row * columnCount;
+        cache[idx] = qlonglong(row);
+        cache[idx + 1] = row * 0.5;
+        cache[idx + 2] = QString(str.unicode(), str.size());
+        cache[idx + 3] = QByteArray(ba.constData(), ba.size());
+    }
+}
+
+void tst_QSqlCachedResult::fill(QSqlColumnCache &cache, int rows)
+{
+    cache.clear();
+    for (int i = 0; i < rows; ++i) {
+        const QString str = text(i);
+        const QByteArray ba(16, char(i));
+        const int row = cache.appendRow();
+        cache.setInteger(row, 0, i);
+        cache.setDouble(row, 1, i * 0.5);
+        cache.setString(row, 2, str.unicode(), str.size());
+        cache.setBytes(row, 3, ba.constData(), ba.size());
+    }
+}
+
+void tst_QSqlCachedResult::fillVariantCache()
+{
+    QFETCH(int, rows);
+    QVector<QVariant> cache;
+    QBENCHMARK {
+        cache.clear();
+        fill(cache, rows);
+    }
+}
+
+void tst_QSqlCachedResult::fillColumnCache()
+{
+    QFETCH(int, rows);
+    QSqlColumnCache cache;
+    cache.init(columnCount);
+    QBENCHMARK {
+        fill(cache, rows);
+    }
+}
+
+void tst_QSqlCachedResult::readVariantCache()
+{
+    QFETCH(int, rows);
+    QVector<QVariant> cache;
+    fill(cache, rows);
+    qlonglong sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < cache.size(); i += columnCount)
+            sum += cache.at(i).toLongLong() + cache.at(i + 2).toString().size();
+    }
+    QVERIFY(sum > 0);
+}
+
+void tst_QSqlCachedResult::readColumnCache()
+{
+    QFETCH(int, rows);
+    QSqlColumnCache cache;
+    cache.init(columnCount);
+    fill(cache, rows);
+    qlonglong sum = 0;
+    QBENCHMARK {
+        for (int row = 0; row < rows; ++row)
+            sum += cache.value(row, 0).toLongLong() + cache.value(row, 2).toString().size();
+    }
+    QVERIFY(sum > 0);
+}
+
+void tst_QSqlCachedResult::iterateQuery_data()
+{
+    QTest::addColumn<bool>("forwardOnly");
+    QTest::newRow("scrollable") << false;
+    QTest::newRow("forward-only") << true;
+}
+
+void tst_QSqlCachedResult::iterateQuery()
+{
+    QFETCH(bool, forwardOnly);
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE")))
+        QSKIP("This benchmark needs the QSQLITE driver");
+
+    QSqlQuery q;
+    q.setForwardOnly(forwardOnly);
+    QBENCHMARK {
+        QVERIFY(q.exec(QStringLiteral("select id, value, name, data from bench")));
+        int rows = 0;
+        while (q.next()) {
+            q.value(0);
+            q.value(2);
+            ++rows;
+        }
+        QCOMPARE(rows, 10000);
+    }
+}
+
+QTEST_MAIN(tst_QSqlCachedResult)
+#include "main.moc"
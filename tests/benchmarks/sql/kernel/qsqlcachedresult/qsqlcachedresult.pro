@@ -0,0 +1,5 @@
+TARGET = tst_bench_qsqlcachedresult
+
+SOURCES += main.cpp
+
+QT = core sql testlib core-private sql-private
@@ -0,0 +1,147 @@
+/****************************************************************************
+**
+** Copyright (C) 2016 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL21$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 or version 3 as published by the Free
+** Software Foundation and appearing in the file LICENSE.LGPLv21 and
+** LICENSE.LGPLv3 included in the packaging of this file. Please review the
+** following information to ensure the GNU Lesser General Public License
+** requirements will be met: https://www.gnu.org/licenses/lgpl.html and
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** As a special exception, The Qt Company gives you certain additional
+** rights. These rights are described in The Qt Company LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtSql/QtSql>
+
+class tst_QSQLiteDriver : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void prepareAndExec_data();
+    void prepareAndExec();
+    void insert_data();
+    void insert();
+
+private:
+    QSqlDatabase open(const QString &options);
+
+    QTemporaryDir dir;
+};
+
+void tst_QSQLiteDriver::initTestCase()
+{
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE")))
+        QSKIP("This benchmark needs the QSQLITE driver");
+    QVERIFY(dir.isValid());
+
+    QSqlDatabase db = open(QString());
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QStringLiteral("create table bench (id integer primary key, name text)")));
+    QVERIFY(db.transaction());
+    QVERIFY(q.prepare(QStringLiteral("insert into bench values (?, ?)")));
+    for (int i = 0; i < 1000; ++i) {
+        q.addBindValue(i);
+        q.addBindValue(QStringLiteral("row number %1").arg(i));
+        QVERIFY(q.exec());
+    }
+    QVERIFY(db.commit());
+}
+
+void tst_QSQLiteDriver::cleanupTestCase()
+{
+    QSqlDatabase::database(QSqlDatabase::defaultConnection, false).close();
+    QSqlDatabase::removeDatabase(QLatin1String(QSqlDatabase::defaultConnection));
+}
+
+QSqlDatabase tst_QSQLiteDriver::open(const QString &options)
+{
+    QSqlDatabase db = QSqlDatabase::database(QSqlDatabase::defaultConnection, false);
+    if (!db.isValid())
+        db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"));
+    db.close();
+    db.setDatabaseName(dir.path() + QLatin1String("/bench.db"));
+    db.setConnectOptions(options);
+    if (!db.open())
+        qWarning() << db.lastError();
+    return db;
+}
+
+void tst_QSQLiteDriver::prepareAndExec_data()
+{
+    QTest::addColumn<QString>("options");
+    QTest::newRow("cold") << QStringLiteral("QSQLITE_STATEMENT_CACHE_SIZE=0");
+    QTest::newRow("cached") << QString();
+}
+
+// runs a short-lived query for every lookup, as code that creates a
+// QSqlQuery in a function that is called often does
+void tst_QSQLiteDriver::prepareAndExec()
+{
+    QFETCH(QString, options);
+    QSqlDatabase db = open(options);
+    QVERIFY(db.isOpen());
+
+    int id = 0;
+    QBENCHMARK {
+        QSqlQuery q(db);
+        q.setForwardOnly(true);
+        q.prepare(QStringLiteral("select name from bench where id = ?"));
+        q.addBindValue(id);
+        q.exec();
+        q.next();
+        id = (id + 1) % 1000;
+    }
+}
+
+void tst_QSQLiteDriver::insert_data()
+{
+    QTest::addColumn<QString>("options");
+    QTest::newRow("default") << QString();
+    QTest::newRow("wal") << QStringLiteral("QSQLITE_JOURNAL_MODE=WAL");
+    QTest::newRow("wal+mmap") << QStringLiteral("QSQLITE_JOURNAL_MODE=WAL;QSQLITE_MMAP_SIZE=67108864");
+}
+
+// one small transaction per insert, so the journal mode dominates
+void tst_QSQLiteDriver::insert()
+{
+    QFETCH(QString, options);
+    QSqlDatabase db = open(options);
+    QVERIFY(db.isOpen());
+
+    QSqlQuery q(db);
+    QVERIFY(q.exec(QStringLiteral("create table if not exists log (msg text)")));
+    QBENCHMARK {
+        QVERIFY(q.exec(QStringLiteral("insert into log values ('message')")));
+    }
+    QVERIFY(q.exec(QStringLiteral("drop table log")));
+    QVERIFY(q.exec(QStringLiteral("PRAGMA journal_mode=DELETE")));
+}
+
+QTEST_MAIN(tst_QSQLiteDriver)
+#include "main.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_bench_qsqlitedriver
+
+SOURCES += main.cpp
+
+QT = core sql testlib